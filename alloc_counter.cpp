@@ -0,0 +1,70 @@
+#include "alloc_counter.h"
+
+#if defined(MW_COUNT_ALLOCATIONS)
+
+#include <cstdlib>
+#include <new>
+
+static thread_local uint64_t t_allocations = 0;
+
+bool AllocationCountingEnabled()
+{
+    return true;
+}
+
+uint64_t ThreadAllocations()
+{
+    return t_allocations;
+}
+
+// 数组、对齐和 nothrow 版本的默认实现都转到这两个函数
+void* operator new(std::size_t size)
+{
+    ++t_allocations;
+    if (void* block = std::malloc(size ? size : 1))
+        return block;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++t_allocations;
+    std::size_t align = (std::size_t)alignment;
+    if (void* block = std::aligned_alloc(align, (size + align - 1) / align * align))
+        return block;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* block) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept
+{
+    std::free(block);
+}
+
+void operator delete(void* block, std::size_t, std::align_val_t) noexcept
+{
+    std::free(block);
+}
+
+#else
+
+bool AllocationCountingEnabled()
+{
+    return false;
+}
+
+uint64_t ThreadAllocations()
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+// 调试用的堆分配计数
+// 用 -DMOVABLE_WINDOW_COUNT_ALLOCATIONS=ON 构建时替换全局 operator new，按线程统计调用次数；
+// 否则不替换，计数始终为 0，AllocationCountingEnabled() 返回 false。
+bool AllocationCountingEnabled();
+
+// 当前线程到目前为止调用 operator new 的次数
+uint64_t ThreadAllocations();
+
+// 作用域内当前线程的分配次数
+class ScopedAllocationCount
+{
+public:
+    ScopedAllocationCount() : m_start(ThreadAllocations()) {}
+
+    uint64_t Count() const { return ThreadAllocations() - m_start; }
+
+private:
+    uint64_t m_start;
+};
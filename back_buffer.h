@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// 后备缓冲尺寸策略：需要更大时按 1.5 倍几何增长并对齐到 64 像素，
+// 需要的尺寸不到容量的四分之一时才收缩，避免窗口来回调整时反复分配
+inline int GrowBufferExtent(int capacity, int required)
+{
+    const int ALIGN = 64;
+    if (required <= 0)
+        return capacity;
+    if (required <= capacity && required * 4 >= capacity)
+        return capacity;
+
+    int grown = required;
+    if (required > capacity)
+        grown = std::max(required, capacity + capacity / 2);
+    return (grown + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+// 后备缓冲池：在帧之间保留离屏表面，只在客户区尺寸变化超出容量时重新分配
+// Factory 需要提供：
+//   typedef ... Surface;
+//   Surface Create(int width, int height);
+//   void Destroy(Surface& surface);
+// bufferCount 为 1 时是普通双缓冲；为 3 时是三缓冲环，
+// 上一帧等待呈现的同时可以在另一个缓冲中准备下一帧
+template <typename Factory>
+class BackBufferPool
+{
+public:
+    typedef typename Factory::Surface Surface;
+
+    explicit BackBufferPool(Factory factory = Factory(), int bufferCount = 1)
+        : m_factory(factory),
+          m_slots(std::max(bufferCount, 1)),
+          m_width(0),
+          m_height(0),
+          m_capacityWidth(0),
+          m_capacityHeight(0),
+          m_writeIndex(0),
+          m_presentIndex(-1),
+          m_allocations(0),
+          m_reuses(0)
+    {
+    }
+
+    ~BackBufferPool()
+    {
+        Release();
+    }
+
+    // 客户区尺寸变化时调用，返回是否重新分配了表面
+    bool Resize(int width, int height)
+    {
+        m_width = std::max(width, 0);
+        m_height = std::max(height, 0);
+
+        int capacityWidth = GrowBufferExtent(m_capacityWidth, m_width);
+        int capacityHeight = GrowBufferExtent(m_capacityHeight, m_height);
+        if (capacityWidth == m_capacityWidth && capacityHeight == m_capacityHeight)
+            return false;
+
+        DestroySurfaces();
+        m_capacityWidth = capacityWidth;
+        m_capacityHeight = capacityHeight;
+        return true;
+    }
+
+    // 取得本帧要绘制的表面
+    Surface& BeginFrame()
+    {
+        Slot& slot = m_slots[m_writeIndex];
+        if (!slot.allocated)
+        {
+            slot.surface = m_factory.Create(m_capacityWidth, m_capacityHeight);
+            slot.allocated = true;
+            ++m_allocations;
+        }
+        else
+        {
+            ++m_reuses;
+        }
+        return slot.surface;
+    }
+
+    // 本帧绘制完成，成为最新的可呈现帧，并轮换到下一个缓冲
+    void EndFrame()
+    {
+        m_presentIndex = m_writeIndex;
+        m_writeIndex = (m_writeIndex + 1) % (int)m_slots.size();
+    }
+
+    // 最近一次完成的帧，没有时返回 nullptr
+    Surface* PresentableSurface()
+    {
+        if (m_presentIndex < 0 || !m_slots[m_presentIndex].allocated)
+            return nullptr;
+        return &m_slots[m_presentIndex].surface;
+    }
+
+    // 释放所有表面
+    void Release()
+    {
+        DestroySurfaces();
+        m_capacityWidth = 0;
+        m_capacityHeight = 0;
+    }
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    int CapacityWidth() const { return m_capacityWidth; }
+    int CapacityHeight() const { return m_capacityHeight; }
+    int BufferCount() const { return (int)m_slots.size(); }
+    int Allocations() const { return m_allocations; }
+    int Reuses() const { return m_reuses; }
+
+private:
+    struct Slot
+    {
+        Slot() : surface(), allocated(false) {}
+
+        Surface surface;
+        bool allocated;
+    };
+
+    void DestroySurfaces()
+    {
+        for (size_t i = 0; i < m_slots.size(); ++i)
+        {
+            if (m_slots[i].allocated)
+            {
+                m_factory.Destroy(m_slots[i].surface);
+                m_slots[i].allocated = false;
+            }
+        }
+        m_writeIndex = 0;
+        m_presentIndex = -1;
+    }
+
+    Factory m_factory;
+    std::vector<Slot> m_slots;
+    int m_width;
+    int m_height;
+    int m_capacityWidth;
+    int m_capacityHeight;
+    int m_writeIndex;
+    int m_presentIndex;
+    int m_allocations;
+    int m_reuses;
+};
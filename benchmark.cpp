@@ -0,0 +1,1636 @@
+// 基准测试：移动、夹紧、边界检查、重置判断、软件绘制以及各个缓存和批处理组件
+// 用法：movable_window_bench [--filter 子串] [--samples N] [--min-time-ms 毫秒] [--out 文件] [--label 文本] [--list]
+// 结果以 JSON 写到 --out 指定的文件（默认标准输出），可读的表格写到标准错误。
+// 以 -DMOVABLE_WINDOW_COUNT_ALLOCATIONS=ON 构建时同时统计每次迭代的堆分配次数，
+// 标记为不分配内存的用例（稳定状态的帧）分配了内存时以状态 1 退出。
+// 每个用例报告处理一个单位（一步、一帧、一个窗口……）的纳秒数，不同提交之间按 name 对比。
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "alloc_counter.h"
+#include "bitmap_font.h"
+#include "command_channel.h"
+#include "control_panel.h"
+#include "display_layout.h"
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "input_journal.h"
+#include "key_bindings.h"
+#include "latency_stats.h"
+#include "motion.h"
+#include "move_sink.h"
+#include "position_feed.h"
+#include "position_history.h"
+#include "render_thread.h"
+#include "replay.h"
+#include "scene.h"
+#include "scheduler.h"
+#include "shadow.h"
+#include "spsc_ring.h"
+#include "text_layout.h"
+#include "trajectory.h"
+#include "tween.h"
+#include "window_batch.h"
+#include "window_controller.h"
+
+#if !defined(MW_BUILD_TYPE)
+#define MW_BUILD_TYPE "unknown"
+#endif
+
+// 防止编译器把被测代码的结果优化掉
+template <typename T>
+inline void KeepAlive(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+// 执行 iterations 次被测操作
+typedef std::function<void(uint64_t iterations)> BenchBody;
+
+// 与耗时一起输出的附加指标（压缩率之类），由 setup 调用 ReportCounter 报告
+typedef std::vector<std::pair<std::string, double>> BenchCounters;
+
+// 一个用例：setup 只在用例被选中时执行，返回的 body 持有准备好的数据
+struct BenchCase
+{
+    std::string name;
+    double items;                        // 每次迭代处理的单位数
+    std::function<BenchBody()> setup;
+    bool allocationFree;                 // 预热之后本线程不应分配内存
+};
+
+struct BenchResult
+{
+    std::string name;
+    double items;
+    uint64_t iterations;                 // 每个样本的迭代次数
+    std::vector<double> samples;         // 每个单位的纳秒数
+    double medianNs;
+    double minNs;
+    double maxNs;
+    double allocations;                  // 每次迭代的堆分配次数（统计打开时）
+    BenchCounters counters;
+};
+
+struct BenchOptions
+{
+    std::string filter;
+    std::string outPath;
+    std::string label;
+    int samples;
+    double minTimeMs;                    // 每个用例所有样本的最短总时间
+    bool list;
+};
+
+static std::vector<BenchCase> g_cases;
+static BenchCounters g_counters;  // 正在准备的用例报告的指标
+
+const int REPLAY_EVENTS = 4096;    // 回放用例的按键事件数
+const int DISPLAY_QUERIES = 1024;  // 显示器布局用例每次迭代的查询数
+const size_t COMMAND_DECODE_COUNT = 4096;  // 命令解码用例每次迭代的命令数
+
+static void Register(const std::string& name, double items, std::function<BenchBody()> setup,
+                     bool allocationFree = false)
+{
+    g_cases.push_back(BenchCase{name, items, setup, allocationFree});
+}
+
+static void ReportCounter(const std::string& name, double value)
+{
+    g_counters.push_back(std::make_pair(name, value));
+}
+
+static double TimeBody(const BenchBody& body, uint64_t iterations)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    body(iterations);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static const uint64_t ALLOCATION_WARMUP_ITERATIONS = 1024;
+
+static BenchResult RunCase(const BenchCase& benchCase, const BenchOptions& options)
+{
+    g_counters.clear();
+    BenchBody body = benchCase.setup();
+
+    // 找到让一个样本达到目标时长的迭代次数，同时起到预热的作用
+    double sampleNs = options.minTimeMs * 1e6 / options.samples;
+    uint64_t iterations = 1;
+    for (;;)
+    {
+        double elapsed = TimeBody(body, iterations);
+        if (elapsed >= sampleNs || iterations >= (uint64_t(1) << 40))
+            break;
+        double scale = elapsed > 0.0 ? sampleNs / elapsed * 1.2 : 100.0;
+        iterations = (uint64_t)(iterations * std::min(std::max(scale, 2.0), 100.0));
+    }
+
+    // 统计分配时多跑一段：缓存要转满一轮、各项的容量长到够用之后才不再分配
+    if (benchCase.allocationFree && AllocationCountingEnabled())
+        TimeBody(body, ALLOCATION_WARMUP_ITERATIONS);
+
+    BenchResult result;
+    result.name = benchCase.name;
+    result.items = benchCase.items;
+    result.iterations = iterations;
+    result.counters = g_counters;
+    result.samples.reserve(options.samples);
+    ScopedAllocationCount allocations;
+    for (int i = 0; i < options.samples; ++i)
+        result.samples.push_back(TimeBody(body, iterations) / ((double)iterations * benchCase.items));
+    result.allocations = (double)allocations.Count() / ((double)iterations * options.samples);
+
+    std::vector<double> sorted = result.samples;
+    std::sort(sorted.begin(), sorted.end());
+    size_t middle = sorted.size() / 2;
+    result.medianNs = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2.0;
+    result.minNs = sorted.front();
+    result.maxNs = sorted.back();
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 用例使用的固定数据
+
+// 简单的线性同余随机数，保证每次运行的数据相同
+class BenchRandom
+{
+public:
+    explicit BenchRandom(uint32_t seed) : m_state(seed) {}
+
+    uint32_t Next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return m_state >> 8;
+    }
+
+    int Range(int low, int high) { return low + (int)(Next() % (uint32_t)(high - low + 1)); }
+
+private:
+    uint32_t m_state;
+};
+
+// cols x rows 个 1920x1080 的显示器排成网格
+static std::vector<RectI> MonitorGrid(int cols, int rows)
+{
+    std::vector<RectI> monitors;
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col < cols; ++col)
+            monitors.push_back(MakeRect(col * 1920, row * 1080, 1920, 1080));
+    }
+    return monitors;
+}
+
+// 基准用的宿主：不移动任何真实窗口
+class BenchHost : public IWindowHost
+{
+public:
+    explicit BenchHost(const std::vector<RectI>& monitors) : m_displays(monitors), m_lastX(0) {}
+
+    const DisplayLayout& Displays() const override { return m_displays; }
+    void MoveWindows(const WindowMove* moves, size_t count) override { m_lastX = moves[count - 1].x + moves[count - 1].y; }
+    void InvalidatePanel() override {}
+
+    int LastX() const { return m_lastX; }
+
+private:
+    DisplayLayout m_displays;
+    int m_lastX;
+};
+
+// 虚拟时钟上的完整控制器
+struct ControllerFixture
+{
+    explicit ControllerFixture(const std::vector<RectI>& monitors)
+        : scheduler(clock),
+          host(monitors),
+          controller(host, scheduler)
+    {
+        const RectI& primary = host.Displays().Primary();
+        controller.Initialize(primary.left + (RectWidth(primary) - 600) / 2,
+                              primary.top + (RectHeight(primary) - 450) / 2, 600, 450);
+    }
+
+    VirtualClock clock;
+    EventScheduler scheduler;
+    BenchHost host;
+    WindowController controller;
+};
+
+// 软件绘制所需的帧缓冲、字形图集和排版缓存
+struct RenderFixture
+{
+    RenderFixture(int width, int height)
+        : target(width, height),
+          atlas(font),
+          text(atlas),
+          backend(target, &text, &shadows)
+    {
+    }
+
+    Framebuffer target;
+    BitmapFontSource font;
+    GlyphAtlas atlas;
+    TextRunCache text;
+    ShadowCache shadows;
+    SoftwareBackend backend;
+};
+
+static PanelState BenchPanelState(int frame)
+{
+    PanelState state = {};
+    state.upPressed = (frame & 1) != 0;
+    state.rightPressed = (frame & 2) != 0;
+    state.posX = 660 + frame % 97;
+    state.posY = 315 + frame % 53;
+    state.idleSeconds = (frame / 60) % 5;
+    return state;
+}
+
+// ---------------------------------------------------------------------------
+// 运动积分
+
+static void RegisterMotionCases()
+{
+    Register("motion/step", 1, [] {
+        std::shared_ptr<MotionEngine> engine = std::make_shared<MotionEngine>();
+        engine->Reset(MotionEngine::Clock::time_point());
+        engine->SetDirection(1, 1);
+        return BenchBody([engine](uint64_t iterations) {
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                MotionDelta delta = engine->Step();
+                sum += delta.dx + delta.dy;
+            }
+            KeepAlive(sum);
+        });
+    });
+
+    // 16ms 节拍推进，每 64 个节拍换一次方向，覆盖加速和减速
+    Register("motion/advance_16ms", 1, [] {
+        struct State
+        {
+            MotionEngine engine;
+            MotionEngine::Clock::time_point now;
+            uint64_t tick;
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+        state->engine.Reset(state->now);
+        state->tick = 0;
+        return BenchBody([state](uint64_t iterations) {
+            static const int DIRECTIONS[4][2] = {{1, 0}, {1, 1}, {0, 0}, {-1, -1}};
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i, ++state->tick)
+            {
+                if ((state->tick & 63) == 0)
+                {
+                    const int* dir = DIRECTIONS[(state->tick >> 6) & 3];
+                    state->engine.SetDirection(dir[0], dir[1]);
+                }
+                state->now += std::chrono::milliseconds(16);
+                MotionDelta delta = state->engine.Advance(state->now);
+                sum += delta.dx + delta.dy;
+            }
+            KeepAlive(sum);
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 控制器：MoveWindowBy 的夹紧、CheckWindowBoundary 的移出屏幕检测、ShouldResetPosition
+
+static void RegisterControllerCases()
+{
+    Register("controller/move_window_by", 1, [] {
+        std::shared_ptr<ControllerFixture> fixture = std::make_shared<ControllerFixture>(MonitorGrid(1, 1));
+        return BenchBody([fixture](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                fixture->controller.MoveWindowBy((i & 1) ? 3 : -3, (i & 2) ? 2 : -2);
+            KeepAlive(fixture->host.LastX());
+        });
+    });
+
+    // 每次都越过虚拟桌面的边缘，四个方向的夹紧都会执行
+    Register("controller/move_window_by_clamped", 1, [] {
+        std::shared_ptr<ControllerFixture> fixture = std::make_shared<ControllerFixture>(MonitorGrid(1, 1));
+        return BenchBody([fixture](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                fixture->controller.MoveWindowBy((i & 1) ? 5000 : -5000, (i & 2) ? 5000 : -5000);
+            KeepAlive(fixture->host.LastX());
+        });
+    });
+
+    struct BoundaryCase
+    {
+        const char* name;
+        int cols;
+        int rows;
+        bool offScreen;
+    };
+    static const BoundaryCase BOUNDARY_CASES[] = {
+        {"controller/check_boundary/onscreen/1mon", 1, 1, false},
+        {"controller/check_boundary/offscreen/1mon", 1, 1, true},
+        {"controller/check_boundary/onscreen/6mon", 3, 2, false},
+        {"controller/check_boundary/offscreen/6mon", 3, 2, true},
+    };
+    for (const BoundaryCase& boundary : BOUNDARY_CASES)
+    {
+        Register(boundary.name, 1, [boundary] {
+            std::shared_ptr<ControllerFixture> fixture =
+                std::make_shared<ControllerFixture>(MonitorGrid(boundary.cols, boundary.rows));
+            if (boundary.offScreen)
+            {
+                // 夹紧后的窗口总会留在桌面内，直接放到右下角之外
+                const RectI& desktop = fixture->host.Displays().VirtualBounds();
+                fixture->controller.Initialize(desktop.right + 100, desktop.bottom + 100, 600, 450);
+            }
+            return BenchBody([fixture](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    fixture->controller.CheckWindowBoundary();
+                KeepAlive(fixture->controller.ResetTriggered());
+            });
+        });
+    }
+
+    Register("controller/should_reset_position", 1, [] {
+        std::shared_ptr<ControllerFixture> fixture = std::make_shared<ControllerFixture>(MonitorGrid(1, 1));
+        return BenchBody([fixture](uint64_t iterations) {
+            int64_t due = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                fixture->clock.Advance(std::chrono::milliseconds(1));
+                due += fixture->controller.ShouldResetPosition();
+            }
+            KeepAlive(due);
+        });
+    });
+
+    // 完整的按键回放：边沿、移动节拍、边界检查和自动重置，单位是一个事件
+    Register("replay/journal", REPLAY_EVENTS, [] {
+        static const uint8_t KEYS[] = {'W', 'A', 'S', 'D', KEY_LEFT, KEY_RIGHT, KEY_UP, KEY_DOWN, KEY_SPACE, KEY_ESCAPE};
+        BenchRandom random(7);
+        InputJournalWriter writer;
+        int64_t timeUs = 0;
+        for (int i = 0; i < REPLAY_EVENTS / 2; ++i)
+        {
+            uint8_t key = KEYS[random.Next() % sizeof(KEYS)];
+            timeUs += random.Range(1000, 200000);
+            writer.Append(InputEvent{timeUs, key, true});
+            timeUs += random.Range(5000, 600000);
+            writer.Append(InputEvent{timeUs, key, false});
+        }
+        std::shared_ptr<std::vector<uint8_t>> journal = std::make_shared<std::vector<uint8_t>>(writer.Data());
+        return BenchBody([journal](uint64_t iterations) {
+            ReplayOptions options = DefaultReplayOptions();
+            options.settleUs = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                ReplayResult result = ReplayJournal(journal->data(), journal->size(), options);
+                KeepAlive(result.finalPos.x);
+            }
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 软件绘制：整帧绘制和按场景脏区域的局部重绘
+
+// 模拟把帧中的 rect 复制到屏幕（BitBlt / SetDIBitsToDevice）
+static void BlitRect(const uint32_t* pixels, int width, const RectI& rect, uint32_t* screen)
+{
+    for (int y = rect.top; y < rect.bottom; ++y)
+    {
+        size_t offset = (size_t)y * width + rect.left;
+        std::memcpy(screen + offset, pixels + offset, (size_t)RectWidth(rect) * sizeof(uint32_t));
+    }
+}
+
+static void RegisterRenderCases()
+{
+    static const SizeI FRAME_SIZES[] = {{600, 450}, {3840, 2160}};
+    for (const SizeI& size : FRAME_SIZES)
+    {
+        std::string suffix = std::to_string(size.cx) + "x" + std::to_string(size.cy);
+
+        Register("render/full_frame/" + suffix, 1, [size] {
+            std::shared_ptr<RenderFixture> fixture = std::make_shared<RenderFixture>(size.cx, size.cy);
+            std::shared_ptr<int> frame = std::make_shared<int>(0);
+            return BenchBody([fixture, frame](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    DrawControlPanel(fixture->backend, BenchPanelState((*frame)++));
+                KeepAlive(fixture->target.PixelAt(0, 0));
+            });
+        }, true);
+
+        // 每帧只重绘状态变化的节点
+        Register("render/scene_update/" + suffix, 1, [size] {
+            struct State
+            {
+                State(int width, int height) : render(width, height), frame(0) {}
+
+                RenderFixture render;
+                PanelScene scene;
+                int frame;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>(size.cx, size.cy);
+            state->scene.Layout(size.cx, size.cy);
+            state->scene.Update(BenchPanelState(0));
+            state->scene.Paint(state->render.backend, RectI{0, 0, size.cx, size.cy});
+            return BenchBody([state](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const std::vector<RectI>& damage = state->scene.Update(BenchPanelState(++state->frame));
+                    RectI dirty = {0, 0, 0, 0};
+                    for (size_t k = 0; k < damage.size(); ++k)
+                        dirty = UnionRect(dirty, damage[k]);
+                    if (!IsRectEmpty(dirty))
+                        state->scene.Paint(state->render.backend, dirty);
+                }
+                KeepAlive(state->render.target.PixelAt(0, 0));
+            });
+        }, true);
+
+        // UI 线程每帧的耗时：在 WM_PAINT 中更新场景、绘制并复制（sync）
+        // 与只提交状态、取渲染线程完成的帧并复制（threaded）对照；渲染线程来不及时中间的帧被丢弃，只复制最新一帧的变化区域
+        Register("render/ui_thread/sync/" + suffix, 1, [size] {
+            struct State
+            {
+                State(int width, int height) : render(width, height), screen((size_t)width * height), frame(0) {}
+
+                RenderFixture render;
+                PanelScene scene;
+                std::vector<uint32_t> screen;
+                int frame;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>(size.cx, size.cy);
+            state->scene.Layout(size.cx, size.cy);
+            return BenchBody([state](uint64_t iterations) {
+                int width = state->render.target.Width();
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    const std::vector<RectI>& damage = state->scene.Update(BenchPanelState(++state->frame));
+                    RectI dirty = {0, 0, 0, 0};
+                    for (size_t k = 0; k < damage.size(); ++k)
+                        dirty = UnionRect(dirty, damage[k]);
+                    if (IsRectEmpty(dirty))
+                        continue;
+                    state->scene.Paint(state->render.backend, dirty);
+                    BlitRect(state->render.target.Pixels(), width, dirty, state->screen.data());
+                }
+                KeepAlive(state->screen[0]);
+            });
+        }, true);
+
+        Register("render/ui_thread/threaded/" + suffix, 1, [size] {
+            struct State
+            {
+                State(int width, int height) : renderer(font), screen((size_t)width * height), frame(0) {}
+
+                BitmapFontSource font;
+                PanelRenderThread renderer;
+                std::vector<uint32_t> screen;
+                int frame;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>(size.cx, size.cy);
+            state->renderer.Start(nullptr);
+            SizeI canvas = size;
+            return BenchBody([state, canvas](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    state->renderer.Submit(BenchPanelState(++state->frame), canvas.cx, canvas.cy);
+                    if (state->renderer.AcquireFrame())
+                    {
+                        const PanelFrame& frame = state->renderer.Frame();
+                        BlitRect(frame.pixels.data(), frame.width, frame.damage, state->screen.data());
+                    }
+                }
+                KeepAlive(state->screen[0]);
+            });
+        }, true);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 文字：图集和排版缓存对照每次重新光栅化
+
+static void RegisterTextCases()
+{
+    static const FontSpec LABEL_FONT = {L"Segoe UI", 12, false};
+    static const RectI LABEL_RECT = {10, 10, 590, 40};
+
+    Register("text/label_cached", 1, [] {
+        std::shared_ptr<RenderFixture> fixture = std::make_shared<RenderFixture>(600, 50);
+        return BenchBody([fixture](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                fixture->backend.DrawLabel(L"Position: (660, 315) | Reset in 3s", LABEL_RECT, LABEL_FONT, TEXT_COLOR, TEXT_ALIGN_LEFT);
+            KeepAlive(fixture->target.PixelAt(20, 20));
+        });
+    }, true);
+
+    Register("text/label_uncached", 1, [] {
+        std::shared_ptr<RenderFixture> fixture = std::make_shared<RenderFixture>(600, 50);
+        return BenchBody([fixture](uint64_t iterations) {
+            RectI clip = {0, 0, fixture->target.Width(), fixture->target.Height()};
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                DrawTextUncached(fixture->target, clip, fixture->font, L"Position: (660, 315) | Reset in 3s",
+                                 LABEL_RECT, LABEL_FONT, TEXT_COLOR, TEXT_ALIGN_LEFT);
+            }
+            KeepAlive(fixture->target.PixelAt(20, 20));
+        });
+    });
+
+    // 状态栏的坐标每帧都变：排版缓存未命中，只有变化之后的字符重新排版
+    Register("text/status_change", 1, [] {
+        std::shared_ptr<RenderFixture> fixture = std::make_shared<RenderFixture>(600, 50);
+        std::shared_ptr<int> frame = std::make_shared<int>(0);
+        return BenchBody([fixture, frame](uint64_t iterations) {
+            wchar_t text[64];
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                int value = (*frame)++;
+                swprintf(text, 64, L"Position: (%d, %d)", 600 + value % 1000, 300 + value % 7);
+                fixture->backend.DrawLabel(text, LABEL_RECT, LABEL_FONT, TEXT_COLOR, TEXT_ALIGN_LEFT);
+            }
+            KeepAlive(fixture->target.PixelAt(20, 20));
+        });
+    }, true);
+}
+
+// ---------------------------------------------------------------------------
+// 阴影：盒式模糊和混合的 SIMD 实现对照逐像素实现，缓存的遮罩对照每次重新模糊
+
+static const int SHADOW_BENCH_SIZE = 256;
+
+static void RegisterShadowCases()
+{
+    typedef void (*BlurPass)(uint8_t*, const uint8_t*, int, int, int, uint16_t*);
+    static const struct
+    {
+        const char* name;
+        BlurPass pass;
+    } BLUR_PASSES[] = {{"scalar", BoxBlurColumnsScalar}, {"simd", BoxBlurColumns}};
+    for (const auto& variant : BLUR_PASSES)
+    {
+        BlurPass pass = variant.pass;
+        Register(std::string("shadow/box_blur/") + variant.name, (double)SHADOW_BENCH_SIZE * SHADOW_BENCH_SIZE, [pass] {
+            struct State
+            {
+                std::vector<uint8_t> src, dst;
+                std::vector<uint16_t> sums;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            BenchRandom random(41);
+            state->src.resize((size_t)SHADOW_BENCH_SIZE * SHADOW_BENCH_SIZE);
+            for (uint8_t& value : state->src)
+                value = (uint8_t)random.Next();
+            state->dst.resize(state->src.size());
+            state->sums.resize(SHADOW_BENCH_SIZE);
+            return BenchBody([state, pass](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    pass(state->dst.data(), state->src.data(), SHADOW_BENCH_SIZE, SHADOW_BENCH_SIZE, SHADOW_BLUR, state->sums.data());
+                KeepAlive(state->dst[SHADOW_BENCH_SIZE]);
+            });
+        });
+    }
+
+    // 把一整块阴影遮罩混合到帧缓冲上
+    typedef void (*BlendSpan)(uint32_t*, const uint8_t*, int, uint32_t);
+    static const struct
+    {
+        const char* name;
+        BlendSpan blend;
+    } BLEND_SPANS[] = {{"scalar", BlendCoverageSpanScalar}, {"simd", BlendCoverageSpan}};
+    for (const auto& variant : BLEND_SPANS)
+    {
+        BlendSpan blend = variant.blend;
+        Register(std::string("shadow/composite/") + variant.name, (double)SHADOW_BENCH_SIZE * SHADOW_BENCH_SIZE, [blend] {
+            struct State
+            {
+                ShadowCache cache;
+                Framebuffer target;
+                const ShadowMask* mask;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            int shape = SHADOW_BENCH_SIZE - 6 * SHADOW_BLUR;
+            state->mask = &state->cache.Get(shape, shape, 8, SHADOW_BLUR, SHADOW_OPACITY);
+            state->target.Resize(state->mask->width, state->mask->height);
+            return BenchBody([state, blend](uint64_t iterations) {
+                const ShadowMask& mask = *state->mask;
+                uint32_t pixel = ColorToPixel(SHADOW_COLOR);
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    for (int y = 0; y < mask.height; ++y)
+                        blend(state->target.Row(y), &mask.alpha[(size_t)y * mask.width], mask.width, pixel);
+                }
+                KeepAlive(state->target.PixelAt(1, 1));
+            });
+        });
+    }
+
+    // 一个按钮的阴影：从缓存取遮罩混合，对照每次重新光栅化并模糊
+    static const bool CACHED[] = {true, false};
+    for (bool cached : CACHED)
+    {
+        Register(std::string("shadow/draw/") + (cached ? "cached" : "uncached"), 1, [cached] {
+            std::shared_ptr<RenderFixture> fixture = std::make_shared<RenderFixture>(600, 450);
+            return BenchBody([fixture, cached](uint64_t iterations) {
+                RectI rect = MakeRect(200 + SHADOW_OFFSET, 300 + SHADOW_OFFSET, 180, 40);
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    if (!cached)
+                        fixture->shadows.Clear();
+                    fixture->backend.DropShadow(rect, 4, SHADOW_BLUR, SHADOW_COLOR, SHADOW_OPACITY);
+                }
+                KeepAlive(fixture->target.PixelAt(300, 345));
+            });
+        }, cached);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 多窗口批处理，单位是一个窗口的一个节拍
+
+static void RegisterBatchCases()
+{
+    static const size_t WINDOW_COUNTS[] = {1, 16, 1024, 65536, 1048576};
+    for (size_t count : WINDOW_COUNTS)
+    {
+        Register("batch/tick/" + std::to_string(count), (double)count, [count] {
+            struct State
+            {
+                State() : batch(RectI{0, 0, 1920, 1080}), nowUs(0) {}
+
+                WindowBatch batch;
+                std::vector<int32_t> dx;
+                std::vector<int32_t> dy;
+                int64_t nowUs;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            BenchRandom random(11);
+            state->batch.Reserve(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                state->batch.Add(random.Range(-700, 2500), random.Range(-500, 1500), 600, 450, 0);
+                // 大约一半的窗口在动
+                bool moving = (random.Next() & 1) != 0;
+                state->dx.push_back(moving ? random.Range(-3, 3) : 0);
+                state->dy.push_back(moving ? random.Range(-3, 3) : 0);
+            }
+            return BenchBody([state](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    state->nowUs += 16000;
+                    state->batch.Tick(state->dx.data(), state->dy.data(), state->nowUs, 5000000);
+                }
+                KeepAlive(state->batch.Position(0).x);
+            });
+        });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 吸附和防重叠：窗口大致排成网格（密度与窗口数无关），单位是一个窗口的一次移动
+
+struct SnapFixture
+{
+    SnapFixture() : batch(RectI{0, 0, 1920, 1080}) {}
+
+    WindowBatch batch;
+    SnapGrid grid;   // 同样的窗口，单独移动用
+    std::vector<int32_t> dx;
+    std::vector<int32_t> dy;
+};
+
+static std::shared_ptr<SnapFixture> MakeSnapFixture(size_t count)
+{
+    std::shared_ptr<SnapFixture> fixture = std::make_shared<SnapFixture>();
+    BenchRandom random(12);
+    int cols = 1;
+    while ((size_t)cols * cols < count)
+        ++cols;
+    fixture->batch.SetDesktop(MakeRect(0, 0, cols * 260, (int)((count + cols - 1) / cols) * 200));
+    fixture->batch.Reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        int col = (int)(i % cols);
+        int row = (int)(i / cols);
+        RectI rect = MakeRect(col * 260 + random.Range(0, 20), row * 200 + random.Range(0, 20),
+                              random.Range(200, 240), random.Range(140, 180));
+        fixture->batch.Add(rect.left, rect.top, RectWidth(rect), RectHeight(rect), 0);
+        fixture->grid.Insert((uint32_t)i, rect);
+        bool moving = (random.Next() & 1) != 0;
+        fixture->dx.push_back(moving ? random.Range(-3, 3) : 0);
+        fixture->dy.push_back(moving ? random.Range(-3, 3) : 0);
+    }
+    fixture->batch.EnableSnapping(SnapOptions{DEFAULT_SNAP_DISTANCE, true, WINDOW_VISIBLE_MARGIN});
+    return fixture;
+}
+
+static void RegisterSnapCases()
+{
+    static const size_t WINDOW_COUNTS[] = {10000, 100000};
+    for (size_t count : WINDOW_COUNTS)
+    {
+        // 单个窗口的移动：查找吸附目标、扫过碰撞区域、更新网格
+        Register("snap/move_one/" + std::to_string(count), 1.0, [count] {
+            std::shared_ptr<SnapFixture> fixture = MakeSnapFixture(count);
+            std::shared_ptr<BenchRandom> random = std::make_shared<BenchRandom>(13);
+            return BenchBody([fixture, random, count](uint64_t iterations) {
+                SnapGrid& grid = fixture->grid;
+                RectI screen = fixture->batch.Desktop();
+                SnapOptions options = {DEFAULT_SNAP_DISTANCE, true, WINDOW_VISIBLE_MARGIN};
+                int sum = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    uint32_t id = random->Next() % (uint32_t)count;
+                    const RectI& rect = grid.Rect(id);
+                    PointI target = {rect.left + random->Range(-16, 16), rect.top + random->Range(-16, 16)};
+                    sum += grid.Move(id, target, screen, options).x;
+                }
+                KeepAlive(sum);
+            });
+        });
+
+        // 整个节拍：大约一半的窗口在动
+        Register("snap/tick/" + std::to_string(count), (double)count, [count] {
+            std::shared_ptr<SnapFixture> fixture = MakeSnapFixture(count);
+            return BenchBody([fixture](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    fixture->batch.MoveBy(fixture->dx.data(), fixture->dy.data());
+                    // 来回移动，窗口不会全部挤到一边
+                    for (int32_t& d : fixture->dx)
+                        d = -d;
+                }
+                KeepAlive(fixture->batch.Position(0).x);
+            });
+        });
+
+        // 一个窗口大小的区域查询
+        Register("snap/query/" + std::to_string(count), 1.0, [count] {
+            std::shared_ptr<SnapFixture> fixture = MakeSnapFixture(count);
+            std::shared_ptr<BenchRandom> random = std::make_shared<BenchRandom>(14);
+            std::shared_ptr<std::vector<uint32_t>> found = std::make_shared<std::vector<uint32_t>>();
+            return BenchBody([fixture, random, found](uint64_t iterations) {
+                const RectI& screen = fixture->batch.Desktop();
+                size_t total = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    found->clear();
+                    RectI area = MakeRect(random->Range(0, screen.right), random->Range(0, screen.bottom), 240, 180);
+                    total += fixture->batch.Grid().Query(area, UINT32_MAX, found.get());
+                }
+                KeepAlive(total);
+            });
+        });
+    }
+}
+
+// 每个节拍之后把位置交给 MoveSink：没动的窗口被丢弃，其余合并成一次原生调用
+static void RegisterMoveSinkCases()
+{
+    class CountingMover : public INativeMover
+    {
+    public:
+        CountingMover() : m_windows(0) {}
+        void MoveWindows(const WindowMove* moves, size_t count) override
+        {
+            (void)moves;
+            m_windows += count;
+        }
+        size_t Windows() const { return m_windows; }
+
+    private:
+        size_t m_windows;
+    };
+
+    static const size_t WINDOW_COUNTS[] = {1024, 65536};
+    for (size_t count : WINDOW_COUNTS)
+    {
+        Register("moves/submit_batch/" + std::to_string(count), (double)count, [count] {
+            struct State
+            {
+                State() : batch(RectI{0, 0, 1920, 1080}), sink(mover), nowUs(0) {}
+
+                WindowBatch batch;
+                CountingMover mover;
+                MoveSink sink;
+                std::vector<int32_t> dx;
+                std::vector<int32_t> dy;
+                int64_t nowUs;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            BenchRandom random(13);
+            for (size_t i = 0; i < count; ++i)
+            {
+                int x = random.Range(0, 1300);
+                int y = random.Range(0, 600);
+                state->batch.Add(x, y, 600, 450, 0);
+                state->sink.SetKnownPosition((uint32_t)i, x, y);
+                // 大约四分之一的窗口在动
+                bool moving = (random.Next() & 3) == 0;
+                state->dx.push_back(moving ? random.Range(-3, 3) : 0);
+                state->dy.push_back(moving ? random.Range(-3, 3) : 0);
+            }
+            return BenchBody([state](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    state->nowUs += 16000;
+                    state->batch.Tick(state->dx.data(), state->dy.data(), state->nowUs, 5000000);
+                    state->batch.SubmitPositions(state->sink);
+                }
+                KeepAlive(state->mover.Windows());
+            });
+        });
+    }
+}
+
+// 外部命令：解码一段字节流，以及一批命令的应用（窗口每批只移动一次）
+static void RegisterCommandCases()
+{
+    static const size_t BATCH_SIZES[] = {1, 64, 4096};
+    for (size_t count : BATCH_SIZES)
+    {
+        Register("commands/apply/" + std::to_string(count), (double)count, [count] {
+            std::shared_ptr<ControllerFixture> fixture = std::make_shared<ControllerFixture>(MonitorGrid(1, 1));
+            std::shared_ptr<std::vector<WindowCommand>> commands = std::make_shared<std::vector<WindowCommand>>(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                WindowCommand& command = (*commands)[i];
+                command.type = (i % 64 == 63) ? COMMAND_MOVE_TO : COMMAND_MOVE_BY;
+                command.x = (i % 64 == 63) ? 600 : ((i & 1) ? 3 : -2);
+                command.y = (i % 64 == 63) ? 300 : ((i & 2) ? 2 : -3);
+            }
+            return BenchBody([fixture, commands](uint64_t iterations) {
+                for (uint64_t i = 0; i < iterations; ++i)
+                    fixture->controller.ApplyCommands(commands->data(), commands->size());
+                KeepAlive(fixture->host.LastX());
+            });
+        });
+    }
+
+    Register("commands/decode", (double)COMMAND_DECODE_COUNT, [] {
+        std::shared_ptr<std::vector<uint8_t>> stream = std::make_shared<std::vector<uint8_t>>(COMMAND_DECODE_COUNT * sizeof(WindowCommand));
+        for (size_t i = 0; i < COMMAND_DECODE_COUNT; ++i)
+        {
+            WindowCommand command = {COMMAND_MOVE_BY, (int32_t)(i & 7), -(int32_t)(i & 3), 0, i};
+            memcpy(stream->data() + i * sizeof(WindowCommand), &command, sizeof(command));
+        }
+        return BenchBody([stream](uint64_t iterations) {
+            CommandDecoder decoder;
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                // 按套接字读取的典型大小切开，命令跨越读取边界
+                for (size_t offset = 0; offset < stream->size(); offset += 1000)
+                {
+                    size_t size = std::min<size_t>(1000, stream->size() - offset);
+                    decoder.Feed(stream->data() + offset, size, [&sum](const WindowCommand& command) { sum += command.x; });
+                }
+            }
+            KeepAlive(sum);
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 共享内存状态：进程内的一个段，单位是一次写入或一次读取（多进程的读取负载见 feed_load）
+
+static void RegisterFeedCases()
+{
+    Register("feed/publish", 1, [] {
+        std::shared_ptr<PositionFeedSegment> segment = std::make_shared<PositionFeedSegment>();
+        segment->sequence.store(0);
+        return BenchBody([segment](uint64_t iterations) {
+            PositionSnapshot snapshot = {};
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                snapshot.x = (int32_t)i;
+                snapshot.resetCount = i;
+                PublishSnapshot(segment.get(), snapshot);
+            }
+        });
+    }, true);
+
+    Register("feed/read", 1, [] {
+        std::shared_ptr<PositionFeedSegment> segment = std::make_shared<PositionFeedSegment>();
+        segment->sequence.store(0);
+        PublishSnapshot(segment.get(), PositionSnapshot{660, 315, 600, 450, 0, 0, 1, 0});
+        return BenchBody([segment](uint64_t iterations) {
+            PositionSnapshot snapshot;
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                if (TryReadSnapshot(segment.get(), &snapshot))
+                    sum += snapshot.x;
+            }
+            KeepAlive(sum);
+        });
+    }, true);
+
+    // 另一个线程一直在写，读到一半被改写时重读
+    Register("feed/read_contended", 1, [] {
+        std::shared_ptr<PositionFeedSegment> segment = std::make_shared<PositionFeedSegment>();
+        segment->sequence.store(0);
+        return BenchBody([segment](uint64_t iterations) {
+            std::atomic<bool> stop(false);
+            std::thread writer([segment, &stop] {
+                PositionSnapshot snapshot = {};
+                for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); ++i)
+                {
+                    snapshot.x = (int32_t)i;
+                    PublishSnapshot(segment.get(), snapshot);
+                }
+            });
+            PositionSnapshot snapshot;
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                while (!TryReadSnapshot(segment.get(), &snapshot))
+                {
+                }
+                sum += snapshot.x;
+            }
+            stop.store(true);
+            writer.join();
+            KeepAlive(sum);
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 位置动画：每帧采样所有补间，单位是一个补间的一帧
+
+static void RegisterTweenCases()
+{
+    static const size_t TWEEN_COUNTS[] = {1000, 10000};
+    for (size_t count : TWEEN_COUNTS)
+    {
+        Register("tween/sample/" + std::to_string(count), (double)count, [count] {
+            struct State
+            {
+                TweenEngine engine;
+                uint64_t frame;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            state->frame = 0;
+            BenchRandom random(5);
+            for (size_t i = 0; i < count; ++i)
+            {
+                PointI from = {random.Range(-2000, 4000), random.Range(-1000, 2000)};
+                PointI to = {random.Range(0, 1920), random.Range(0, 1080)};
+                // 帧时间在前 480ms 内循环，补间不会结束
+                state->engine.Start(from, to, std::chrono::milliseconds(random.Range(600, 1000)), (Easing)(i % EASING_COUNT),
+                                    TweenEngine::Clock::time_point());
+            }
+            return BenchBody([state](uint64_t iterations) {
+                size_t active = 0;
+                for (uint64_t i = 0; i < iterations; ++i, ++state->frame)
+                {
+                    TweenEngine::Clock::time_point frameTime(std::chrono::milliseconds(16 * (state->frame % 30 + 1)));
+                    active += state->engine.Sample(frameTime);
+                }
+                KeepAlive(active);
+            });
+        });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 轨迹：弧长参数化、匀速取样和流式播放
+
+static const size_t PATH_STREAM_POINTS = 1000000;
+
+// 经过 count + 1 个随机点的 Catmull-Rom 路径，换算成贝塞尔段
+static std::vector<CubicSegment> RandomSplinePath(size_t count, uint32_t seed)
+{
+    BenchRandom random(seed);
+    std::vector<float> px(count + 3), py(count + 3);
+    for (size_t i = 0; i < px.size(); ++i)
+    {
+        px[i] = (float)random.Range(0, 1920);
+        py[i] = (float)random.Range(0, 1080);
+    }
+
+    std::vector<CubicSegment> segments(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* x = &px[i];
+        const float* y = &py[i];
+        segments[i] = CubicSegment{{x[1], x[1] + (x[2] - x[0]) / 6.0f, x[2] - (x[3] - x[1]) / 6.0f, x[2]},
+                                   {y[1], y[1] + (y[2] - y[0]) / 6.0f, y[2] - (y[3] - y[1]) / 6.0f, y[2]}};
+    }
+    return segments;
+}
+
+static void RegisterTrajectoryCases()
+{
+    Register("trajectory/assign/4096", (double)PATH_CHUNK_SEGMENTS, [] {
+        std::shared_ptr<std::vector<CubicSegment>> segments =
+            std::make_shared<std::vector<CubicSegment>>(RandomSplinePath(PATH_CHUNK_SEGMENTS, 21));
+        std::shared_ptr<Trajectory> trajectory = std::make_shared<Trajectory>();
+        return BenchBody([segments, trajectory](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                trajectory->Assign(segments->data(), segments->size());
+                KeepAlive(trajectory->Length());
+            }
+        });
+    });
+
+    // 单点查找（二分段表 + 二分弧长表）
+    Register("trajectory/evaluate", 1.0, [] {
+        std::vector<CubicSegment> segments = RandomSplinePath(PATH_CHUNK_SEGMENTS, 22);
+        std::shared_ptr<Trajectory> trajectory = std::make_shared<Trajectory>();
+        trajectory->Assign(segments.data(), segments.size());
+        std::shared_ptr<uint32_t> step = std::make_shared<uint32_t>(0);
+        return BenchBody([trajectory, step](uint64_t iterations) {
+            float sum = 0.0f;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                float distance = trajectory->Length() * (float)((*step = *step * 1664525u + 1013904223u) >> 8) / 16777216.0f;
+                float x, y;
+                trajectory->Evaluate(distance, &x, &y);
+                sum += x + y;
+            }
+            KeepAlive(sum);
+        });
+    });
+
+    // 匀速连续帧：一帧一个点和一次取一大批
+    static const size_t SAMPLE_COUNTS[] = {64, 4096};
+    for (size_t count : SAMPLE_COUNTS)
+    {
+        Register("trajectory/sample_uniform/" + std::to_string(count), (double)count, [count] {
+            struct State
+            {
+                Trajectory trajectory;
+                std::vector<float> x, y;
+                float start;
+            };
+            std::shared_ptr<State> state = std::make_shared<State>();
+            std::vector<CubicSegment> segments = RandomSplinePath(PATH_CHUNK_SEGMENTS, 23);
+            state->trajectory.Assign(segments.data(), segments.size());
+            state->x.resize(count);
+            state->y.resize(count);
+            state->start = 0.0f;
+            return BenchBody([state, count](uint64_t iterations) {
+                const float step = DEFAULT_PATH_SPEED / 60.0f;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    state->trajectory.SampleUniform(state->start, step, count, state->x.data(), state->y.data());
+                    state->start += step * count;
+                    if (state->start > state->trajectory.Length())
+                        state->start = 0.0f;
+                }
+                KeepAlive(state->x[count - 1] + state->y[count - 1]);
+            });
+        });
+    }
+
+    // 从文件流式播放一百万个点：读取、换算、分块参数化和取样，内存只保留一块
+    Register("trajectory/stream/" + std::to_string(PATH_STREAM_POINTS), (double)PATH_STREAM_POINTS, [] {
+        std::shared_ptr<FILE> file(tmpfile(), [](FILE* f) {
+            if (f)
+                fclose(f);
+        });
+        if (file)
+        {
+            BenchRandom random(24);
+            fprintf(file.get(), "catmull-rom\n");
+            for (size_t i = 0; i < PATH_STREAM_POINTS; ++i)
+                fprintf(file.get(), "%d %d\n", random.Range(0, 1920), random.Range(0, 1080));
+            fflush(file.get());
+        }
+        return BenchBody([file](uint64_t iterations) {
+            if (!file)
+                return;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                rewind(file.get());
+                PathPlayer player;
+                player.Attach(file.get());
+                // 每帧 16ms 大约前进一段，取样次数与段数相当
+                PathPlayer::TimePoint start;
+                player.Start(start, 50000.0f);
+
+                PointI pos = {0, 0};
+                int frame = 0;
+                while (player.Sample(start + std::chrono::milliseconds(16 * ++frame), &pos))
+                {
+                }
+                KeepAlive(pos.x + pos.y + player.SegmentsLoaded());
+            }
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 位置历史：追加、压缩率和按时间查找
+
+static const size_t HISTORY_TRACE_SAMPLES = 1 << 20;
+static const size_t RAW_HISTORY_SAMPLE_BYTES = 16;  // 不压缩时每个样本：64 位时间和两个 32 位坐标
+
+// 模拟键盘移动的位置序列：16ms 左右一个节拍，每步 1-2 像素，偶尔停顿、跳跃（外部命令）和重置
+static std::vector<HistorySample> MovementTrace(size_t count, uint32_t seed)
+{
+    BenchRandom random(seed);
+    std::vector<HistorySample> trace(count);
+    int64_t time = 0;
+    PointI pos = {660, 315};
+    int dx = 1, dy = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        HistoryKind kind = HISTORY_MOVE;
+        time += random.Range(0, 399) == 0 ? random.Range(1000, 30000) : random.Range(15, 17);
+        if (random.Range(0, 59) == 0)
+        {
+            dx = random.Range(-1, 1);
+            dy = random.Range(-1, 1);
+        }
+
+        int roll = random.Range(0, 1999);
+        if (roll == 0)
+        {
+            pos = PointI{660, 315};
+            kind = HISTORY_RESET;
+        }
+        else if (roll < 3)
+        {
+            pos.x += random.Range(-500, 500);
+            pos.y += random.Range(-500, 500);
+        }
+        else
+        {
+            int speed = random.Range(1, 2);
+            pos.x += (dx ? dx : 1) * speed;
+            pos.y += dy * speed;
+        }
+        trace[i] = HistorySample{time, pos, kind, 0};
+    }
+    return trace;
+}
+
+static void FillHistory(PositionHistory& history, const std::vector<HistorySample>& trace)
+{
+    for (const HistorySample& sample : trace)
+        history.Append(sample.timeMs, sample.pos, sample.kind);
+}
+
+static void RegisterHistoryCases()
+{
+    // 每次移动追加一个样本；同时报告默认容量下的压缩率和能保留多久的连续移动
+    Register("history/append", 1, [] {
+        struct State
+        {
+            std::vector<HistorySample> trace;
+            PositionHistory history;
+            size_t next;
+            int64_t offset;  // 序列用完之后从头再来，时间接着往后
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+        state->trace = MovementTrace(HISTORY_TRACE_SAMPLES, 31);
+        state->next = 0;
+        state->offset = 0;
+
+        FillHistory(state->history, state->trace);
+        HistorySample oldest, latest;
+        state->history.Oldest(&oldest);
+        state->history.Latest(&latest);
+        double encoded = (double)state->history.EncodedBytes();
+        double samples = (double)state->history.SampleCount();
+        ReportCounter("bytes_per_sample", encoded / samples);
+        ReportCounter("compression_ratio", samples * RAW_HISTORY_SAMPLE_BYTES / encoded);
+        ReportCounter("memory_kb", state->history.MemoryBytes() / 1024.0);
+        ReportCounter("retained_minutes", (latest.timeMs - oldest.timeMs) / 60000.0);
+        state->offset = latest.timeMs;
+
+        return BenchBody([state](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                const HistorySample& sample = state->trace[state->next];
+                state->history.Append(state->offset + sample.timeMs, sample.pos, sample.kind);
+                if (++state->next == state->trace.size())
+                {
+                    state->next = 0;
+                    state->offset += state->trace.back().timeMs;
+                }
+            }
+            KeepAlive(state->history.AppendedCount());
+        });
+    }, true);
+
+    // 后退：在保留的时间范围内随机取时刻
+    Register("history/seek", 1, [] {
+        struct State
+        {
+            PositionHistory history;
+            int64_t start;
+            int64_t span;
+        };
+        std::shared_ptr<State> state = std::make_shared<State>();
+        FillHistory(state->history, MovementTrace(HISTORY_TRACE_SAMPLES, 32));
+        HistorySample oldest, latest;
+        state->history.Oldest(&oldest);
+        state->history.Latest(&latest);
+        state->start = oldest.timeMs;
+        state->span = latest.timeMs - oldest.timeMs + 1;
+        return BenchBody([state](uint64_t iterations) {
+            BenchRandom random(33);
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                HistorySample sample;
+                int64_t time = state->start + (int64_t)(((uint64_t)random.Next() << 24 | random.Next()) % (uint64_t)state->span);
+                if (state->history.At(time, &sample))
+                    sum += sample.pos.x + sample.pos.y;
+            }
+            KeepAlive(sum);
+        });
+    }, true);
+
+    // 撤销重置：从最新往前找重置，依次撤销直到找不到
+    Register("history/find_reset", 1, [] {
+        std::shared_ptr<PositionHistory> history = std::make_shared<PositionHistory>();
+        FillHistory(*history, MovementTrace(HISTORY_TRACE_SAMPLES, 34));
+        return BenchBody([history](uint64_t iterations) {
+            uint64_t before = UINT64_MAX;
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                HistorySample reset, previous;
+                if (history->FindReset(before, &reset, &previous))
+                {
+                    before = reset.index;
+                    sum += previous.pos.x;
+                }
+                else
+                {
+                    before = UINT64_MAX;
+                }
+            }
+            KeepAlive(sum);
+        });
+    }, true);
+}
+
+// ---------------------------------------------------------------------------
+// 显示器布局查询
+
+static void RegisterDisplayCases()
+{
+    struct LayoutCase
+    {
+        const char* suffix;
+        int cols;
+        int rows;
+    };
+    static const LayoutCase LAYOUTS[] = {{"1mon", 1, 1}, {"4mon", 2, 2}, {"64mon", 8, 8}};
+    for (const LayoutCase& layoutCase : LAYOUTS)
+    {
+        struct State
+        {
+            DisplayLayout displays;
+            std::vector<RectI> rects;
+        };
+        std::function<std::shared_ptr<State>()> makeState = [layoutCase] {
+            std::shared_ptr<State> state = std::make_shared<State>();
+            state->displays.SetMonitors(MonitorGrid(layoutCase.cols, layoutCase.rows));
+            const RectI& bounds = state->displays.VirtualBounds();
+            BenchRandom random(3);
+            for (int i = 0; i < DISPLAY_QUERIES; ++i)
+            {
+                // 一部分落在桌面之外
+                int x = random.Range(bounds.left - 1200, bounds.right + 600);
+                int y = random.Range(bounds.top - 900, bounds.bottom + 450);
+                state->rects.push_back(MakeRect(x, y, 600, 450));
+            }
+            return state;
+        };
+
+        Register(std::string("display/is_fully_offscreen/") + layoutCase.suffix, DISPLAY_QUERIES, [makeState] {
+            std::shared_ptr<State> state = makeState();
+            return BenchBody([state](uint64_t iterations) {
+                int64_t off = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    for (const RectI& rect : state->rects)
+                        off += state->displays.IsFullyOffScreen(rect);
+                }
+                KeepAlive(off);
+            });
+        });
+
+        Register(std::string("display/nearest_monitor/") + layoutCase.suffix, DISPLAY_QUERIES, [makeState] {
+            std::shared_ptr<State> state = makeState();
+            return BenchBody([state](uint64_t iterations) {
+                int64_t sum = 0;
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    for (const RectI& rect : state->rects)
+                        sum += state->displays.NearestMonitor(PointI{rect.left, rect.top}).left;
+                }
+                KeepAlive(sum);
+            });
+        });
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 按键队列和延迟统计
+
+static void RegisterInfrastructureCases()
+{
+    // 按下的键到移动方向：四次掩码求交加一次查表
+    Register("input/direction", 1, [] {
+        std::shared_ptr<KeyBindings> bindings = std::make_shared<KeyBindings>();
+        return BenchBody([bindings](uint64_t iterations) {
+            static const unsigned KEYS[] = {'W', 'D', KEY_DOWN, 'A', KEY_UP, KEY_SPACE, 'Q', KEY_RIGHT};
+            KeyMask held = EMPTY_KEY_MASK;
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                held.Set(KEYS[i & 7], (i & 8) == 0);
+                DirectionVector direction = bindings->Direction(held);
+                sum += direction.dx * 3 + direction.dy;
+            }
+            KeepAlive(sum);
+        });
+    });
+
+    Register("input/action_lookup", 1, [] {
+        std::shared_ptr<KeyBindings> bindings = std::make_shared<KeyBindings>();
+        return BenchBody([bindings](uint64_t iterations) {
+            int64_t sum = 0;
+            for (uint64_t i = 0; i < iterations; ++i)
+                sum += bindings->ActionOf((unsigned)(i & 0xFF));
+            KeepAlive(sum);
+        });
+    });
+
+    Register("spsc/push_pop", 1, [] {
+        std::shared_ptr<SpscRing<uint64_t, 1024>> ring = std::make_shared<SpscRing<uint64_t, 1024>>();
+        return BenchBody([ring](uint64_t iterations) {
+            uint64_t sum = 0;
+            uint64_t value;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                ring->TryPush(i);
+                if (ring->TryPop(value))
+                    sum += value;
+            }
+            KeepAlive(sum);
+        });
+    });
+
+    // 生产者和消费者在不同线程，队列满或空时让出处理器
+    Register("spsc/two_threads", 1, [] {
+        std::shared_ptr<SpscRing<uint64_t, 1024>> ring = std::make_shared<SpscRing<uint64_t, 1024>>();
+        return BenchBody([ring](uint64_t iterations) {
+            std::thread producer([ring, iterations] {
+                for (uint64_t i = 0; i < iterations; ++i)
+                {
+                    while (!ring->TryPush(i))
+                        std::this_thread::yield();
+                }
+            });
+            uint64_t sum = 0;
+            uint64_t value;
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                while (!ring->TryPop(value))
+                    std::this_thread::yield();
+                sum += value;
+            }
+            producer.join();
+            KeepAlive(sum);
+        });
+    });
+
+    Register("latency/record", 1, [] {
+        return BenchBody([](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+                RecordLatency(LATENCY_MOVEMENT, (i * 2654435761u) & 0xFFFFF);
+        });
+    });
+
+    // 包括两次读取时钟
+    Register("latency/scoped", 1, [] {
+        return BenchBody([](uint64_t iterations) {
+            for (uint64_t i = 0; i < iterations; ++i)
+            {
+                ScopedLatency latency(LATENCY_MOVEMENT);
+            }
+        });
+    });
+}
+
+// ---------------------------------------------------------------------------
+// 输出
+
+static const char* CompilerName()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+#define MW_STRINGIFY2(x) #x
+#define MW_STRINGIFY(x) MW_STRINGIFY2(x)
+    return "msvc " MW_STRINGIFY(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+static const char* SimdLevel()
+{
+#if defined(__AVX2__)
+    return "avx2";
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+static std::string JsonString(const std::string& text)
+{
+    std::string out = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned)c);
+            out += escaped;
+        }
+        else
+        {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+static void WriteJson(FILE* file, const BenchOptions& options, const std::vector<BenchResult>& results)
+{
+    fprintf(file, "{\n");
+    fprintf(file, "  \"schema\": 1,\n");
+    fprintf(file, "  \"label\": %s,\n", JsonString(options.label).c_str());
+    fprintf(file, "  \"context\": {\"compiler\": %s, \"build_type\": %s, \"simd\": %s, \"pointer_bits\": %d, \"threads\": %u, "
+                  "\"allocation_counting\": %s},\n",
+            JsonString(CompilerName()).c_str(), JsonString(MW_BUILD_TYPE).c_str(), JsonString(SimdLevel()).c_str(),
+            (int)(sizeof(void*) * 8), std::thread::hardware_concurrency(), AllocationCountingEnabled() ? "true" : "false");
+    fprintf(file, "  \"unit\": \"ns\",\n");
+    fprintf(file, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const BenchResult& result = results[i];
+        fprintf(file, "    {\"name\": %s, \"items_per_iteration\": %.0f, \"iterations\": %llu, "
+                      "\"median_ns\": %.4f, \"min_ns\": %.4f, \"max_ns\": %.4f, \"samples_ns\": [",
+                JsonString(result.name).c_str(), result.items, (unsigned long long)result.iterations,
+                result.medianNs, result.minNs, result.maxNs);
+        for (size_t k = 0; k < result.samples.size(); ++k)
+            fprintf(file, "%s%.4f", k ? ", " : "", result.samples[k]);
+        fprintf(file, "]");
+        if (AllocationCountingEnabled())
+            fprintf(file, ", \"allocations_per_iteration\": %.4f", result.allocations);
+        if (!result.counters.empty())
+        {
+            fprintf(file, ", \"counters\": {");
+            for (size_t k = 0; k < result.counters.size(); ++k)
+                fprintf(file, "%s%s: %.4f", k ? ", " : "", JsonString(result.counters[k].first).c_str(), result.counters[k].second);
+            fprintf(file, "}");
+        }
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n");
+    fprintf(file, "}\n");
+}
+
+static bool ParseOptions(int argc, char** argv, BenchOptions* options)
+{
+    options->samples = 5;
+    options->minTimeMs = 100.0;
+    options->list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--list")
+            options->list = true;
+        else if (arg == "--filter" && hasValue)
+            options->filter = argv[++i];
+        else if (arg == "--out" && hasValue)
+            options->outPath = argv[++i];
+        else if (arg == "--label" && hasValue)
+            options->label = argv[++i];
+        else if (arg == "--samples" && hasValue)
+            options->samples = std::max(1, atoi(argv[++i]));
+        else if (arg == "--min-time-ms" && hasValue)
+            options->minTimeMs = std::max(0.0, atof(argv[++i]));
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        fprintf(stderr, "usage: %s [--filter substring] [--samples n] [--min-time-ms ms] [--out file.json] [--label text] [--list]\n", argv[0]);
+        return 2;
+    }
+
+    RegisterMotionCases();
+    RegisterControllerCases();
+    RegisterRenderCases();
+    RegisterTextCases();
+    RegisterShadowCases();
+    RegisterBatchCases();
+    RegisterSnapCases();
+    RegisterMoveSinkCases();
+    RegisterCommandCases();
+    RegisterFeedCases();
+    RegisterTweenCases();
+    RegisterTrajectoryCases();
+    RegisterHistoryCases();
+    RegisterDisplayCases();
+    RegisterInfrastructureCases();
+
+    std::vector<BenchResult> results;
+    bool allocated = false;
+    for (const BenchCase& benchCase : g_cases)
+    {
+        if (!options.filter.empty() && benchCase.name.find(options.filter) == std::string::npos)
+            continue;
+        if (options.list)
+        {
+            printf("%s\n", benchCase.name.c_str());
+            continue;
+        }
+
+        results.push_back(RunCase(benchCase, options));
+        const BenchResult& result = results.back();
+        fprintf(stderr, "%-44s %14.3f ns  (min %.3f, max %.3f, %llu iterations)", result.name.c_str(),
+                result.medianNs, result.minNs, result.maxNs, (unsigned long long)result.iterations);
+        if (AllocationCountingEnabled())
+        {
+            fprintf(stderr, "  %.3f allocs", result.allocations);
+            if (benchCase.allocationFree && result.allocations > 0.0)
+            {
+                fprintf(stderr, "  <- expected no allocations");
+                allocated = true;
+            }
+        }
+        for (size_t k = 0; k < result.counters.size(); ++k)
+            fprintf(stderr, "  %s %.3f", result.counters[k].first.c_str(), result.counters[k].second);
+        fprintf(stderr, "\n");
+    }
+    if (options.list)
+        return 0;
+
+    FILE* file = options.outPath.empty() ? stdout : fopen(options.outPath.c_str(), "w");
+    if (!file)
+    {
+        fprintf(stderr, "cannot write %s\n", options.outPath.c_str());
+        return 1;
+    }
+    WriteJson(file, options, results);
+    if (file != stdout && fclose(file) != 0)
+    {
+        fprintf(stderr, "cannot write %s\n", options.outPath.c_str());
+        return 1;
+    }
+    return allocated ? 1 : 0;
+}
@@ -0,0 +1,237 @@
+#include "bitmap_font.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 点阵的设计单位：每个字 6 列（5 列笔画 + 1 列间距），
+// 笔画 7 行，基线以上再留 1 行、以下留 1 行
+static const int CELL_COLUMNS = 6;
+static const int INK_COLUMNS = 5;
+static const int INK_ROWS = 7;
+static const int SUBSAMPLES = 4;
+
+struct BitmapGlyph
+{
+    uint32_t codepoint;
+    uint8_t rows[INK_ROWS];
+};
+
+// 按码点排序，便于二分查找
+static const BitmapGlyph BITMAP_GLYPHS[] = {
+    {0x0020, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},  // space
+    {0x0021, {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}},  // !
+    {0x0022, {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00}},  // "
+    {0x0023, {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}},  // #
+    {0x0024, {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}},  // $
+    {0x0025, {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}},  // %
+    {0x0026, {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}},  // &
+    {0x0027, {0x04, 0x04, 0x04, 0x00, 0x00, 0x00, 0x00}},  // '
+    {0x0028, {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}},  // (
+    {0x0029, {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}},  // )
+    {0x002A, {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}},  // *
+    {0x002B, {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}},  // +
+    {0x002C, {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}},  // ,
+    {0x002D, {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}},  // -
+    {0x002E, {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}},  // .
+    {0x002F, {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}},  // /
+    {0x0030, {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}},  // 0
+    {0x0031, {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}},  // 1
+    {0x0032, {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}},  // 2
+    {0x0033, {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}},  // 3
+    {0x0034, {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}},  // 4
+    {0x0035, {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}},  // 5
+    {0x0036, {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}},  // 6
+    {0x0037, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}},  // 7
+    {0x0038, {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}},  // 8
+    {0x0039, {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}},  // 9
+    {0x003A, {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}},  // :
+    {0x003B, {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}},  // ;
+    {0x003C, {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}},  // <
+    {0x003D, {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}},  // =
+    {0x003E, {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}},  // >
+    {0x003F, {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}},  // ?
+    {0x0040, {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}},  // @
+    {0x0041, {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}},  // A
+    {0x0042, {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}},  // B
+    {0x0043, {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}},  // C
+    {0x0044, {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}},  // D
+    {0x0045, {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}},  // E
+    {0x0046, {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}},  // F
+    {0x0047, {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}},  // G
+    {0x0048, {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}},  // H
+    {0x0049, {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},  // I
+    {0x004A, {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}},  // J
+    {0x004B, {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}},  // K
+    {0x004C, {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}},  // L
+    {0x004D, {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}},  // M
+    {0x004E, {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}},  // N
+    {0x004F, {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},  // O
+    {0x0050, {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}},  // P
+    {0x0051, {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}},  // Q
+    {0x0052, {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}},  // R
+    {0x0053, {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}},  // S
+    {0x0054, {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},  // T
+    {0x0055, {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}},  // U
+    {0x0056, {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}},  // V
+    {0x0057, {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}},  // W
+    {0x0058, {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}},  // X
+    {0x0059, {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}},  // Y
+    {0x005A, {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}},  // Z
+    {0x005B, {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}},  // [
+    {0x005C, {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}},  // backslash
+    {0x005D, {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}},  // ]
+    {0x005E, {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}},  // ^
+    {0x005F, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}},  // _
+    {0x0060, {0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00}},  // `
+    {0x0061, {0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F}},  // a
+    {0x0062, {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E}},  // b
+    {0x0063, {0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E}},  // c
+    {0x0064, {0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F}},  // d
+    {0x0065, {0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E}},  // e
+    {0x0066, {0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08}},  // f
+    {0x0067, {0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E}},  // g
+    {0x0068, {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11}},  // h
+    {0x0069, {0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E}},  // i
+    {0x006A, {0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C}},  // j
+    {0x006B, {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12}},  // k
+    {0x006C, {0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}},  // l
+    {0x006D, {0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11}},  // m
+    {0x006E, {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11}},  // n
+    {0x006F, {0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E}},  // o
+    {0x0070, {0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10}},  // p
+    {0x0071, {0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01}},  // q
+    {0x0072, {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10}},  // r
+    {0x0073, {0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E}},  // s
+    {0x0074, {0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06}},  // t
+    {0x0075, {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D}},  // u
+    {0x0076, {0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04}},  // v
+    {0x0077, {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A}},  // w
+    {0x0078, {0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11}},  // x
+    {0x0079, {0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E}},  // y
+    {0x007A, {0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F}},  // z
+    {0x007B, {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02}},  // {
+    {0x007C, {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}},  // |
+    {0x007D, {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08}},  // }
+    {0x007E, {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00}},  // ~
+    {0x2190, {0x00, 0x04, 0x08, 0x1F, 0x08, 0x04, 0x00}},  // ←
+    {0x2191, {0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04}},  // ↑
+    {0x2192, {0x00, 0x04, 0x02, 0x1F, 0x02, 0x04, 0x00}},  // →
+    {0x2193, {0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04}},  // ↓
+    {0x25B2, {0x00, 0x04, 0x04, 0x0E, 0x0E, 0x1F, 0x00}},  // ▲
+    {0x25B6, {0x08, 0x0C, 0x0E, 0x0F, 0x0E, 0x0C, 0x08}},  // ▶
+    {0x25BC, {0x00, 0x1F, 0x0E, 0x0E, 0x04, 0x04, 0x00}},  // ▼
+    {0x25C0, {0x02, 0x06, 0x0E, 0x1E, 0x0E, 0x06, 0x02}},  // ◀
+};
+
+const uint8_t* FindBitmapGlyph(uint32_t codepoint)
+{
+    const BitmapGlyph* begin = BITMAP_GLYPHS;
+    const BitmapGlyph* end = BITMAP_GLYPHS + sizeof(BITMAP_GLYPHS) / sizeof(BITMAP_GLYPHS[0]);
+    const BitmapGlyph* it = std::lower_bound(begin, end, codepoint,
+                                             [](const BitmapGlyph& glyph, uint32_t value) { return glyph.codepoint < value; });
+    return (it != end && it->codepoint == codepoint) ? it->rows : nullptr;
+}
+
+// 零宽字符：变体选择符、零宽连接符等
+static bool IsZeroWidth(uint32_t codepoint)
+{
+    return (codepoint >= 0xFE00 && codepoint <= 0xFE0F) || codepoint == 0x200B || codepoint == 0x200D;
+}
+
+// 东亚宽字符和表情占两个字宽
+static bool IsWide(uint32_t codepoint)
+{
+    return (codepoint >= 0x1100 && codepoint <= 0x115F) ||
+           (codepoint >= 0x23E9 && codepoint <= 0x23FA) ||
+           (codepoint >= 0x2600 && codepoint <= 0x27BF) ||
+           (codepoint >= 0x2E80 && codepoint <= 0xA4CF) ||
+           (codepoint >= 0xAC00 && codepoint <= 0xD7A3) ||
+           (codepoint >= 0xF900 && codepoint <= 0xFAFF) ||
+           (codepoint >= 0xFF00 && codepoint <= 0xFF60) ||
+           (codepoint >= 0x1F300 && codepoint <= 0x1FAFF);
+}
+
+// 笔画的像素高度：字号的 7/9，至少保持 1:1
+static int InkHeight(const FontSpec& font)
+{
+    return std::max(INK_ROWS, (int)std::lround(font.size * 7.0 / 9.0));
+}
+
+FontMetrics BitmapFontSource::Metrics(const FontSpec& font)
+{
+    double scale = InkHeight(font) / (double)INK_ROWS;
+    FontMetrics metrics;
+    metrics.ascent = (int)std::lround((INK_ROWS + 1) * scale);
+    metrics.descent = std::max(1, (int)std::lround(scale));
+    return metrics;
+}
+
+void BitmapFontSource::Rasterize(const FontSpec& font, uint32_t codepoint, GlyphImage* image)
+{
+    int inkHeight = InkHeight(font);
+    double scale = inkHeight / (double)INK_ROWS;
+    int boldColumns = font.bold ? 1 : 0;
+
+    image->bearingX = 0;
+    image->bearingY = inkHeight;
+    image->coverage.clear();
+
+    if (IsZeroWidth(codepoint))
+    {
+        image->width = image->height = image->advance = 0;
+        return;
+    }
+
+    const uint8_t* rows = FindBitmapGlyph(codepoint);
+    if (!rows)
+    {
+        // 没有点阵的字符画成空心方框
+        int cells = IsWide(codepoint) ? 2 : 1;
+        image->advance = (int)std::lround((CELL_COLUMNS * cells + boldColumns) * scale);
+        image->width = std::max(2, image->advance - (int)std::lround(scale) - 1);
+        image->height = inkHeight;
+        image->bearingX = (image->advance - image->width) / 2;
+        image->coverage.assign((size_t)image->width * image->height, 0);
+
+        int thickness = std::max(1, (int)(scale * (font.bold ? 0.8 : 0.5)));
+        for (int y = 0; y < image->height; ++y)
+        {
+            for (int x = 0; x < image->width; ++x)
+            {
+                if (x < thickness || y < thickness || x >= image->width - thickness || y >= image->height - thickness)
+                    image->coverage[(size_t)y * image->width + x] = 255;
+            }
+        }
+        return;
+    }
+
+    // 粗体把每一列向右加宽一个设计单位
+    int inkColumns = INK_COLUMNS + boldColumns;
+    image->advance = (int)std::lround((CELL_COLUMNS + boldColumns) * scale);
+    image->width = (int)std::ceil(inkColumns * scale);
+    image->height = inkHeight;
+    image->coverage.assign((size_t)image->width * image->height, 0);
+
+    for (int py = 0; py < image->height; ++py)
+    {
+        for (int px = 0; px < image->width; ++px)
+        {
+            int hits = 0;
+            for (int sy = 0; sy < SUBSAMPLES; ++sy)
+            {
+                int row = (int)((py + (sy + 0.5) / SUBSAMPLES) / scale);
+                if (row >= INK_ROWS) continue;
+
+                for (int sx = 0; sx < SUBSAMPLES; ++sx)
+                {
+                    int column = (int)((px + (sx + 0.5) / SUBSAMPLES) / scale);
+                    bool ink = column < INK_COLUMNS && (rows[row] >> (INK_COLUMNS - 1 - column)) & 1;
+                    if (!ink && boldColumns && column >= 1 && column - 1 < INK_COLUMNS)
+                        ink = (rows[row] >> (INK_COLUMNS - column)) & 1;
+                    hits += ink ? 1 : 0;
+                }
+            }
+            image->coverage[(size_t)py * image->width + px] = (uint8_t)(hits * 255 / (SUBSAMPLES * SUBSAMPLES));
+        }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "glyph_atlas.h"
+
+// 内置的 5x7 点阵字体，不依赖系统字体，Linux 上也能绘制和测试文字
+// 覆盖 ASCII 和面板用到的箭头、三角符号；其他码点（汉字、表情）画成空心方框，
+// 东亚宽字符占两个字宽。字号决定点阵的放大倍数，按 4x4 超采样得到抗锯齿覆盖率。
+class BitmapFontSource : public IGlyphSource
+{
+public:
+    FontMetrics Metrics(const FontSpec& font) override;
+    void Rasterize(const FontSpec& font, uint32_t codepoint, GlyphImage* image) override;
+};
+
+// 查找码点的 7 行点阵（每行低 5 位，最高位在左），没有时返回 nullptr
+const uint8_t* FindBitmapGlyph(uint32_t codepoint);
@@ -0,0 +1,486 @@
+#include "command_channel.h"
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+static const size_t READ_BUFFER_SIZE = 64 * 1024;
+
+CommandServer::CommandServer()
+    : m_waitingForSpace(false),
+      m_notified(false),
+      m_stopping(false),
+      m_received(0),
+      m_connections(0)
+#if defined(_WIN32)
+      , m_stopEvent(nullptr)
+#else
+      , m_listenFd(-1)
+#endif
+{
+#if !defined(_WIN32)
+    m_wakeFds[0] = m_wakeFds[1] = -1;
+#endif
+}
+
+CommandServer::~CommandServer()
+{
+    Stop();
+}
+
+size_t CommandServer::Drain(std::vector<WindowCommand>* out)
+{
+    // 先清除通知标记再取：之后到达的命令会再通知一次，不会漏掉
+    m_notified.exchange(false);
+
+    size_t count = 0;
+    WindowCommand command;
+    while (m_ring.TryPop(command))
+    {
+        out->push_back(command);
+        ++count;
+    }
+
+    // 腾出了空间：唤醒等待的后台线程。取出在加锁之前完成，后台线程在锁内重试时一定能看到
+    if (count > 0)
+    {
+        std::lock_guard<std::mutex> lock(m_spaceMutex);
+        if (m_waitingForSpace)
+            m_space.notify_one();
+    }
+    return count;
+}
+
+// 后台线程：放入队列，队列满时睡眠到 UI 线程取走（不占用 CPU）
+void CommandServer::Push(const WindowCommand& command)
+{
+    if (!m_ring.TryPush(command))
+    {
+        std::unique_lock<std::mutex> lock(m_spaceMutex);
+        while (!m_ring.TryPush(command))
+        {
+            if (m_stopping.load(std::memory_order_relaxed))
+                return;
+            // 先让 UI 线程知道有命令可取，再等它取出
+            Notify();
+            m_waitingForSpace = true;
+            m_space.wait(lock);
+            m_waitingForSpace = false;
+        }
+    }
+    m_received.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 让等待空间的后台线程看到 m_stopping
+void CommandServer::WakePush()
+{
+    std::lock_guard<std::mutex> lock(m_spaceMutex);
+    m_space.notify_all();
+}
+
+// 每批命令只通知一次，直到 UI 线程取出
+void CommandServer::Notify()
+{
+    if (!m_notified.exchange(true) && m_notify)
+        m_notify();
+}
+
+#if defined(_WIN32)
+
+std::string DefaultCommandEndpoint()
+{
+    return "\\\\.\\pipe\\movable_window";
+}
+
+bool CommandServer::Start(const char* endpoint, std::function<void()> notify)
+{
+    Stop();
+
+    m_stopEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!m_stopEvent)
+        return false;
+
+    m_endpoint = endpoint;
+    m_notify = notify;
+    m_stopping = false;
+    m_thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void CommandServer::Stop()
+{
+    if (m_thread.joinable())
+    {
+        m_stopping = true;
+        WakePush();
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+    if (m_stopEvent)
+    {
+        CloseHandle(m_stopEvent);
+        m_stopEvent = nullptr;
+    }
+}
+
+// 等待重叠操作完成，Stop 时取消操作并返回 false
+static bool WaitPipeIo(HANDLE pipe, OVERLAPPED* overlapped, HANDLE stopEvent, DWORD* bytes)
+{
+    HANDLE handles[2] = {stopEvent, overlapped->hEvent};
+    if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1)
+    {
+        CancelIo(pipe);
+        GetOverlappedResult(pipe, overlapped, bytes, TRUE);
+        return false;
+    }
+    return GetOverlappedResult(pipe, overlapped, bytes, FALSE) != FALSE;
+}
+
+void CommandServer::Run()
+{
+    std::vector<uint8_t> buffer(READ_BUFFER_SIZE);
+    CommandDecoder decoder;
+    HANDLE ioEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+
+    while (ioEvent && !m_stopping)
+    {
+        HANDLE pipe = CreateNamedPipeA(m_endpoint.c_str(),
+                                       PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED,
+                                       PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+                                       PIPE_UNLIMITED_INSTANCES, 0, (DWORD)READ_BUFFER_SIZE, 0, nullptr);
+        if (pipe == INVALID_HANDLE_VALUE)
+        {
+            // 管道名被占用等错误：稍后重试，Stop 时立即退出
+            WaitForSingleObject(m_stopEvent, 100);
+            continue;
+        }
+
+        // 等待客户端连接
+        OVERLAPPED overlapped = {};
+        overlapped.hEvent = ioEvent;
+        ResetEvent(ioEvent);
+        DWORD bytes = 0;
+        bool connected = ConnectNamedPipe(pipe, &overlapped) != FALSE;
+        if (!connected)
+        {
+            DWORD error = GetLastError();
+            if (error == ERROR_PIPE_CONNECTED)
+                connected = true;
+            else if (error == ERROR_IO_PENDING)
+                connected = WaitPipeIo(pipe, &overlapped, m_stopEvent, &bytes);
+        }
+
+        if (connected)
+        {
+            m_connections.fetch_add(1, std::memory_order_relaxed);
+            decoder.Reset();
+            for (;;)
+            {
+                overlapped = OVERLAPPED();
+                overlapped.hEvent = ioEvent;
+                ResetEvent(ioEvent);
+                bytes = 0;
+                if (!ReadFile(pipe, buffer.data(), (DWORD)buffer.size(), &bytes, &overlapped))
+                {
+                    if (GetLastError() != ERROR_IO_PENDING || !WaitPipeIo(pipe, &overlapped, m_stopEvent, &bytes))
+                        break;
+                }
+                else if (!GetOverlappedResult(pipe, &overlapped, &bytes, FALSE))
+                {
+                    break;
+                }
+                if (bytes == 0)
+                    continue;
+
+                if (decoder.Feed(buffer.data(), bytes, [this](const WindowCommand& command) { Push(command); }) > 0)
+                    Notify();
+            }
+        }
+
+        DisconnectNamedPipe(pipe);
+        CloseHandle(pipe);
+    }
+
+    if (ioEvent)
+        CloseHandle(ioEvent);
+}
+
+CommandClient::CommandClient()
+    : m_pipe(INVALID_HANDLE_VALUE)
+{
+}
+
+CommandClient::~CommandClient()
+{
+    Close();
+}
+
+bool CommandClient::Connect(const char* endpoint)
+{
+    Close();
+    for (int attempt = 0; attempt < 10; ++attempt)
+    {
+        HANDLE pipe = CreateFileA(endpoint, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, 0, nullptr);
+        if (pipe != INVALID_HANDLE_VALUE)
+        {
+            m_pipe = pipe;
+            return true;
+        }
+
+        // 所有实例都忙时等待空闲的实例
+        if (GetLastError() != ERROR_PIPE_BUSY || !WaitNamedPipeA(endpoint, 1000))
+            return false;
+    }
+    return false;
+}
+
+void CommandClient::Close()
+{
+    if (m_pipe != INVALID_HANDLE_VALUE)
+        CloseHandle(m_pipe);
+    m_pipe = INVALID_HANDLE_VALUE;
+}
+
+bool CommandClient::Send(const WindowCommand* commands, size_t count)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(commands);
+    size_t size = count * sizeof(WindowCommand);
+    while (size > 0)
+    {
+        DWORD written = 0;
+        if (!WriteFile(m_pipe, data, (DWORD)size, &written, nullptr))
+            return false;
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+#else
+
+std::string DefaultCommandEndpoint()
+{
+    const char* runtimeDir = getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && runtimeDir[0] == '/')
+        return std::string(runtimeDir) + "/movable_window.sock";
+    return "/tmp/movable_window." + std::to_string((unsigned long long)getuid()) + ".sock";
+}
+
+// 端点上已有文件时，只删除本用户的、连不上的套接字（上次异常退出留下的）；端点可用时返回 true
+static bool RemoveStaleSocket(const sockaddr_un& address)
+{
+    struct stat info;
+    if (lstat(address.sun_path, &info) != 0)
+        return errno == ENOENT;
+    if (!S_ISSOCK(info.st_mode) || info.st_uid != getuid())
+        return false;
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0)
+        return false;
+    bool stale = connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 &&
+                 errno == ECONNREFUSED;
+    close(probe);
+    return stale && unlink(address.sun_path) == 0;
+}
+
+bool CommandServer::Start(const char* endpoint, std::function<void()> notify)
+{
+    Stop();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(endpoint) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, endpoint);
+
+    if (!RemoveStaleSocket(address))
+        return false;
+
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listenFd < 0)
+        return false;
+    if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        close(m_listenFd);
+        m_listenFd = -1;
+        return false;
+    }
+
+    // bind 按 umask 创建文件，listen 之前收紧权限，其他用户连不上
+    if (chmod(endpoint, 0600) != 0 ||
+        listen(m_listenFd, 16) != 0 ||
+        pipe2(m_wakeFds, O_CLOEXEC) != 0)
+    {
+        close(m_listenFd);
+        m_listenFd = -1;
+        unlink(endpoint);
+        return false;
+    }
+
+    m_endpoint = endpoint;
+    m_notify = notify;
+    m_stopping = false;
+    m_thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void CommandServer::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    m_stopping = true;
+    WakePush();
+    char wake = 0;
+    while (write(m_wakeFds[1], &wake, 1) < 0 && errno == EINTR)
+    {
+    }
+    m_thread.join();
+
+    close(m_listenFd);
+    close(m_wakeFds[0]);
+    close(m_wakeFds[1]);
+    m_listenFd = m_wakeFds[0] = m_wakeFds[1] = -1;
+    unlink(m_endpoint.c_str());
+}
+
+void CommandServer::Run()
+{
+    std::vector<uint8_t> buffer(READ_BUFFER_SIZE);
+    std::vector<pollfd> polled;
+    std::vector<int> clients;
+    std::vector<CommandDecoder> decoders;
+
+    while (!m_stopping)
+    {
+        polled.clear();
+        polled.push_back(pollfd{m_wakeFds[0], POLLIN, 0});
+        polled.push_back(pollfd{m_listenFd, POLLIN, 0});
+        for (int fd : clients)
+            polled.push_back(pollfd{fd, POLLIN, 0});
+
+        if (poll(polled.data(), polled.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        if (polled[0].revents)
+            break;
+
+        // 一轮 poll 读到的所有命令只通知一次
+        bool any = false;
+        for (size_t i = clients.size(); i-- > 0;)
+        {
+            if (!polled[i + 2].revents)
+                continue;
+
+            ssize_t size = read(clients[i], buffer.data(), buffer.size());
+            if (size > 0)
+            {
+                any |= decoders[i].Feed(buffer.data(), (size_t)size, [this](const WindowCommand& command) { Push(command); }) > 0;
+                continue;
+            }
+            if (size < 0 && (errno == EINTR || errno == EAGAIN))
+                continue;
+
+            // 对方关闭或出错
+            close(clients[i]);
+            clients.erase(clients.begin() + i);
+            decoders.erase(decoders.begin() + i);
+        }
+
+        if (any)
+            Notify();
+
+        if (polled[1].revents & POLLIN)
+        {
+            int client = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0)
+            {
+                clients.push_back(client);
+                decoders.push_back(CommandDecoder());
+                m_connections.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    for (int fd : clients)
+        close(fd);
+}
+
+CommandClient::CommandClient()
+    : m_fd(-1)
+{
+}
+
+CommandClient::~CommandClient()
+{
+    Close();
+}
+
+bool CommandClient::Connect(const char* endpoint)
+{
+    Close();
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(endpoint) >= sizeof(address.sun_path))
+        return false;
+    strcpy(address.sun_path, endpoint);
+
+    m_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_fd < 0)
+        return false;
+    if (connect(m_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void CommandClient::Close()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+    m_fd = -1;
+}
+
+bool CommandClient::Send(const WindowCommand* commands, size_t count)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(commands);
+    size_t size = count * sizeof(WindowCommand);
+    while (size > 0)
+    {
+        // 对方已关闭时返回错误而不是触发 SIGPIPE
+        ssize_t written = send(m_fd, data, size, MSG_NOSIGNAL);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+#endif
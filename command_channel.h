@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "spsc_ring.h"
+
+// 外部程序控制窗口的命令，语义与按键相同
+enum WindowCommandType
+{
+    COMMAND_MOVE_TO = 1,        // 移到 (x, y)，与 MoveWindowBy 一样夹紧在虚拟桌面内
+    COMMAND_MOVE_BY = 2,        // 相对移动 (x, y)
+    COMMAND_RESET = 3,          // 回到屏幕中央（空格键）
+    COMMAND_CANCEL_RESET = 4    // 取消自动重置标记（ESC 键）
+};
+
+// 线路上的一条命令，定长 24 字节，按本机字节序
+struct WindowCommand
+{
+    uint32_t type;
+    int32_t x;
+    int32_t y;
+    uint32_t reserved;
+    uint64_t sentNs;    // 发送时刻（steady_clock 纳秒，同一台机器上各进程可比），0 表示不统计延迟
+};
+
+static_assert(sizeof(WindowCommand) == 24, "WindowCommand is a wire format");
+
+// 默认的端点：Windows 上是命名管道 \\.\pipe\movable_window；
+// Linux 上是 $XDG_RUNTIME_DIR/movable_window.sock（只有本用户能访问的目录），没有设置时为 /tmp/movable_window.<uid>.sock
+std::string DefaultCommandEndpoint();
+
+// 从字节流切出完整的命令，读取边界上的半条命令留到下一次
+class CommandDecoder
+{
+public:
+    CommandDecoder() : m_partialSize(0) {}
+
+    // 把 data 中的完整命令依次交给 sink，返回命令数
+    template <typename Sink>
+    size_t Feed(const uint8_t* data, size_t size, Sink&& sink);
+
+    void Reset() { m_partialSize = 0; }
+
+private:
+    uint8_t m_partial[sizeof(WindowCommand)];
+    size_t m_partialSize;
+};
+
+// 接收命令的队列，后台线程写入，UI 线程取出
+typedef SpscRing<WindowCommand, 4096> CommandRing;
+
+// 命令服务器：后台线程接收所有连接的命令并放入队列
+// 队列从空变为非空后调用一次 notify（Win32 中投递一条消息），UI 线程在 Drain 时一次取出全部命令。
+// 队列满时后台线程睡眠到 UI 线程取出命令为止，暂停读取，发送方在系统缓冲区满后被阻塞，不丢弃命令。
+// Windows 上同一时间只服务一个管道连接。
+class CommandServer
+{
+public:
+    CommandServer();
+    ~CommandServer();
+
+    // Linux 上套接字文件权限为 0600；端点已存在时，只删除本用户留下的、已经没有服务器在监听的套接字，
+    // 其他情况（别的文件、别的用户的套接字、另一个服务器正在监听）返回 false
+    bool Start(const char* endpoint, std::function<void()> notify);
+    void Stop();
+
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // UI 线程：取出已到达的所有命令，追加到 out，返回数量
+    size_t Drain(std::vector<WindowCommand>* out);
+
+    uint64_t Received() const { return m_received.load(std::memory_order_relaxed); }
+    uint64_t Connections() const { return m_connections.load(std::memory_order_relaxed); }
+
+private:
+    CommandServer(const CommandServer&);
+    CommandServer& operator=(const CommandServer&);
+
+    void Run();
+    void Push(const WindowCommand& command);
+    void WakePush();
+    void Notify();
+
+    CommandRing m_ring;
+    std::function<void()> m_notify;
+
+    // 队列满时后台线程在这里等 Drain 腾出空间（或 Stop）
+    std::mutex m_spaceMutex;
+    std::condition_variable m_space;
+    bool m_waitingForSpace;
+
+    std::atomic<bool> m_notified;   // 已经通知过、UI 线程还没有取出
+    std::atomic<bool> m_stopping;
+    std::atomic<uint64_t> m_received;
+    std::atomic<uint64_t> m_connections;
+    std::thread m_thread;
+    std::string m_endpoint;
+#if defined(_WIN32)
+    void* m_stopEvent;  // Stop 时置位，打断等待中的管道操作
+#else
+    int m_listenFd;
+    int m_wakeFds[2];   // Stop 时写入，唤醒阻塞在 poll 上的线程
+#endif
+};
+
+// 命令客户端（自动化脚本、负载生成器）
+class CommandClient
+{
+public:
+    CommandClient();
+    ~CommandClient();
+
+    bool Connect(const char* endpoint);
+    void Close();
+
+    // 阻塞直到全部发出，连接断开时返回 false
+    bool Send(const WindowCommand* commands, size_t count);
+
+private:
+    CommandClient(const CommandClient&);
+    CommandClient& operator=(const CommandClient&);
+
+#if defined(_WIN32)
+    void* m_pipe;
+#else
+    int m_fd;
+#endif
+};
+
+template <typename Sink>
+size_t CommandDecoder::Feed(const uint8_t* data, size_t size, Sink&& sink)
+{
+    const size_t RECORD = sizeof(WindowCommand);
+    size_t count = 0;
+    WindowCommand command;
+
+    // 补全上一次剩下的半条
+    if (m_partialSize > 0)
+    {
+        size_t take = RECORD - m_partialSize < size ? RECORD - m_partialSize : size;
+        std::memcpy(m_partial + m_partialSize, data, take);
+        m_partialSize += take;
+        data += take;
+        size -= take;
+        if (m_partialSize < RECORD)
+            return 0;
+
+        std::memcpy(&command, m_partial, RECORD);
+        sink(command);
+        m_partialSize = 0;
+        ++count;
+    }
+
+    for (; size >= RECORD; data += RECORD, size -= RECORD)
+    {
+        std::memcpy(&command, data, RECORD);
+        sink(command);
+        ++count;
+    }
+
+    std::memcpy(m_partial, data, size);
+    m_partialSize = size;
+    return count;
+}
@@ -0,0 +1,299 @@
+// 命令通道负载生成器
+// 用法：command_load [--clients N] [--rate 每秒命令数] [--batch 每次发送的命令数] [--seconds 秒]
+//                    [--endpoint 路径] [--connect]
+// 默认在进程内启动与窗口程序相同的服务端（CommandServer + WindowController，无界面宿主），
+// 客户端经过真实的套接字发送，报告每秒应用的命令数、原生移动次数和应用延迟的百分位。
+// --connect 时向已经运行的窗口程序（movable_window --listen）发送，只报告发送速率。
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "command_channel.h"
+#include "display_layout.h"
+#include "latency_stats.h"
+#include "scheduler.h"
+#include "window_controller.h"
+
+struct LoadOptions
+{
+    int clients;
+    double rate;        // 所有客户端合计的每秒命令数，0 表示不限速
+    int batch;
+    double seconds;
+    std::string endpoint;
+    bool connectOnly;
+};
+
+// 无界面宿主：三个显示器横向排列
+class LoadHost : public IWindowHost
+{
+public:
+    LoadHost()
+        : m_displays(std::vector<RectI>{RectI{0, 0, 1920, 1080}, RectI{1920, 0, 3840, 1080}, RectI{-1920, 0, 0, 1080}})
+    {
+    }
+
+    const DisplayLayout& Displays() const override { return m_displays; }
+    void MoveWindows(const WindowMove* moves, size_t count) override
+    {
+        (void)moves;
+        (void)count;
+    }
+    void InvalidatePanel() override {}
+
+private:
+    DisplayLayout m_displays;
+};
+
+// 简单的线性同余随机数，各客户端的序列可重复
+class LoadRandom
+{
+public:
+    explicit LoadRandom(uint32_t seed) : m_state(seed * 2654435761u + 1) {}
+
+    uint32_t Next()
+    {
+        m_state = m_state * 1664525u + 1013904223u;
+        return m_state >> 8;
+    }
+
+    int Range(int low, int high) { return low + (int)(Next() % (uint32_t)(high - low + 1)); }
+
+private:
+    uint32_t m_state;
+};
+
+// 大部分是小步相对移动，夹杂绝对移动、重置和取消
+static WindowCommand MakeCommand(LoadRandom& random, uint64_t index)
+{
+    WindowCommand command = {};
+    if (index % 4096 == 4095)
+    {
+        command.type = COMMAND_RESET;
+    }
+    else if (index % 1024 == 511)
+    {
+        command.type = COMMAND_CANCEL_RESET;
+    }
+    else if (index % 64 == 63)
+    {
+        command.type = COMMAND_MOVE_TO;
+        command.x = random.Range(-1800, 3600);
+        command.y = random.Range(0, 900);
+    }
+    else
+    {
+        command.type = COMMAND_MOVE_BY;
+        command.x = random.Range(-4, 4);
+        command.y = random.Range(-4, 4);
+    }
+    return command;
+}
+
+struct ClientResult
+{
+    uint64_t sent;
+    bool ok;
+};
+
+static void RunClient(const LoadOptions& options, int index, ClientResult* result)
+{
+    result->sent = 0;
+    result->ok = false;
+
+    CommandClient client;
+    if (!client.Connect(options.endpoint.c_str()))
+        return;
+
+    LoadRandom random((uint32_t)index + 1);
+    std::vector<WindowCommand> batch((size_t)options.batch);
+
+    // 限速时每个客户端按固定间隔发送一批
+    double perClient = options.rate / options.clients;
+    auto interval = std::chrono::duration<double>(perClient > 0.0 ? options.batch / perClient : 0.0);
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.seconds));
+    auto next = start;
+
+    while (std::chrono::steady_clock::now() < end)
+    {
+        if (perClient > 0.0)
+        {
+            std::this_thread::sleep_until(next);
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+        }
+
+        uint64_t sentNs = LatencyNow();
+        for (int i = 0; i < options.batch; ++i)
+        {
+            batch[i] = MakeCommand(random, result->sent + i);
+            batch[i].sentNs = sentNs;
+        }
+        if (!client.Send(batch.data(), batch.size()))
+            return;
+        result->sent += batch.size();
+    }
+    result->ok = true;
+}
+
+static uint64_t TotalSent(const std::vector<ClientResult>& results)
+{
+    uint64_t sent = 0;
+    for (const ClientResult& result : results)
+        sent += result.sent;
+    return sent;
+}
+
+static bool ParseOptions(int argc, char** argv, LoadOptions* options)
+{
+    options->clients = 4;
+    options->rate = 0.0;
+    options->batch = 16;
+    options->seconds = 3.0;
+    options->endpoint = DefaultCommandEndpoint();
+    options->connectOnly = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--connect")
+            options->connectOnly = true;
+        else if (arg == "--clients" && hasValue)
+            options->clients = std::max(1, atoi(argv[++i]));
+        else if (arg == "--rate" && hasValue)
+            options->rate = std::max(0.0, atof(argv[++i]));
+        else if (arg == "--batch" && hasValue)
+            options->batch = std::max(1, atoi(argv[++i]));
+        else if (arg == "--seconds" && hasValue)
+            options->seconds = std::max(0.1, atof(argv[++i]));
+        else if (arg == "--endpoint" && hasValue)
+            options->endpoint = argv[++i];
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    LoadOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        fprintf(stderr, "usage: %s [--clients n] [--rate commands-per-second] [--batch n] [--seconds s] [--endpoint path] [--connect]\n", argv[0]);
+        return 2;
+    }
+
+    // 进程内的服务端：UI 线程的角色由主线程承担，收到通知后一次取出并应用全部命令
+    SteadyClock clock;
+    EventScheduler scheduler(clock);
+    LoadHost host;
+    WindowController controller(host, scheduler);
+    controller.Initialize(660, 315, 600, 450);
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool notified = false;
+
+    CommandServer server;
+    if (!options.connectOnly)
+    {
+        bool started = server.Start(options.endpoint.c_str(), [&] {
+            std::lock_guard<std::mutex> lock(mutex);
+            notified = true;
+            wake.notify_one();
+        });
+        if (!started)
+        {
+            fprintf(stderr, "cannot listen on %s\n", options.endpoint.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<ClientResult> results((size_t)options.clients);
+    std::vector<std::thread> clients;
+    std::atomic<int> running(options.clients);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.clients; ++i)
+    {
+        clients.emplace_back([&, i] {
+            RunClient(options, i, &results[(size_t)i]);
+            --running;
+            std::lock_guard<std::mutex> lock(mutex);
+            wake.notify_one();
+        });
+    }
+
+    uint64_t applied = 0;
+    uint64_t batches = 0;
+    std::vector<WindowCommand> pending;
+    if (!options.connectOnly)
+    {
+        // 客户端全部结束、队列也取空之后停止
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                IClock::TimePoint deadline = std::min(scheduler.NextDeadline(), clock.Now() + std::chrono::milliseconds(50));
+                wake.wait_until(lock, deadline, [&] { return notified || running == 0; });
+                notified = false;
+            }
+
+            pending.clear();
+            size_t count = server.Drain(&pending);
+            if (count > 0)
+            {
+                controller.ApplyCommands(pending.data(), count);
+                applied += count;
+                ++batches;
+            }
+            controller.RunDueEvents();
+
+            // 发送成功的命令都已在套接字缓冲区里，全部应用之后才结束
+            if (running == 0 && applied == TotalSent(results))
+                break;
+        }
+    }
+
+    for (std::thread& client : clients)
+        client.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.Stop();
+
+    uint64_t sent = TotalSent(results);
+    bool ok = true;
+    for (const ClientResult& result : results)
+        ok &= result.ok;
+    if (!ok)
+        fprintf(stderr, "some clients could not connect to %s or were disconnected\n", options.endpoint.c_str());
+
+    printf("endpoint:         %s%s\n", options.endpoint.c_str(), options.connectOnly ? " (external)" : "");
+    printf("clients:          %d, batch %d, target rate %s\n", options.clients, options.batch,
+           options.rate > 0.0 ? std::to_string((long long)options.rate).c_str() : "unlimited");
+    printf("sent:             %llu commands in %.3f s (%.0f/s)\n", (unsigned long long)sent, elapsed, sent / elapsed);
+    if (options.connectOnly)
+        return ok ? 0 : 1;
+
+    LatencySnapshot latency;
+    SnapshotLatency(LATENCY_COMMAND_APPLY, &latency);
+    printf("applied:          %llu commands (%.0f/s) in %llu batches (%.1f per batch)\n",
+           (unsigned long long)applied, applied / elapsed, (unsigned long long)batches,
+           batches ? (double)applied / batches : 0.0);
+    printf("native moves:     %llu calls, %llu dropped, %llu coalesced\n",
+           (unsigned long long)controller.Moves().NativeCalls(), (unsigned long long)controller.Moves().Dropped(),
+           (unsigned long long)controller.Moves().Coalesced());
+    printf("apply latency:    p50 %.1f us, p99 %.1f us, p99.9 %.1f us, max %.1f us\n",
+           latency.Percentile(50) / 1000.0, latency.Percentile(99) / 1000.0,
+           latency.Percentile(99.9) / 1000.0, latency.max / 1000.0);
+    printf("final position:   (%d, %d), resets %llu\n", controller.WindowPos().x, controller.WindowPos().y,
+           (unsigned long long)controller.ResetCount());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+#include "control_panel.h"
+
+#include <cwchar>
+
+// 字体
+static const FontSpec TITLE_FONT = {L"Segoe UI", 28, true};
+static const FontSpec SMALL_FONT = {L"Segoe UI", 12, false};
+static const FontSpec BUTTON_FONT = {L"Segoe UI", 14, true};
+
+// 状态栏的三种显示
+enum StatusKind
+{
+    STATUS_NORMAL,
+    STATUS_IDLE_WARNING,
+    STATUS_RESET_WARNING
+};
+
+static RectI InflateRect(const RectI& rect, int left, int top, int right, int bottom)
+{
+    return RectI{rect.left - left, rect.top - top, rect.right + right, rect.bottom + bottom};
+}
+
+// 元素连同阴影覆盖的范围（阴影比 1 像素的描边外扩更大）
+static RectI ShadowBounds(const RectI& rect)
+{
+    return InflateRect(rect, SHADOW_SPREAD - SHADOW_OFFSET, SHADOW_SPREAD - SHADOW_OFFSET,
+                       SHADOW_SPREAD + SHADOW_OFFSET, SHADOW_SPREAD + SHADOW_OFFSET);
+}
+
+PanelLayout ComputePanelLayout(int width, int height)
+{
+    PanelLayout layout;
+    layout.width = width;
+    layout.height = height;
+    layout.keySize = 60;
+    layout.controlRect = RectI{50, 100, width - 50, 280};
+    layout.statusRect = RectI{50, 360, width - 50, height - 20};
+
+    // 标题文字比标题栏低，范围延伸到 80
+    layout.items[PANEL_TITLE_BAR] = RectI{0, 0, width, 60};
+    layout.bounds[PANEL_TITLE_BAR] = RectI{0, 0, width, 80};
+
+    layout.items[PANEL_CONTROL_AREA] = layout.controlRect;
+    layout.bounds[PANEL_CONTROL_AREA] = InflateRect(layout.controlRect, 1, 1, 1, 1);
+
+    // 方向键围绕控制区域中心排列
+    int centerX = (layout.controlRect.left + layout.controlRect.right) / 2;
+    int centerY = (layout.controlRect.top + layout.controlRect.bottom) / 2;
+    int keySize = layout.keySize;
+    int offset = keySize + 20;
+    int keyCenters[4][2] = {
+        {centerX, centerY - offset},
+        {centerX, centerY + offset},
+        {centerX - offset, centerY},
+        {centerX + offset, centerY}
+    };
+    for (int i = 0; i < 4; ++i)
+    {
+        RectI key = MakeRect(keyCenters[i][0] - keySize / 2, keyCenters[i][1] - keySize / 2, keySize, keySize);
+        layout.items[PANEL_KEY_UP + i] = key;
+        layout.bounds[PANEL_KEY_UP + i] = ShadowBounds(key);
+    }
+
+    // 功能按钮
+    int buttonWidth = 180;
+    int buttonHeight = 40;
+    int buttonY = 300;
+    int buttonX = (width - buttonWidth * 2 - 20) / 2;
+    layout.items[PANEL_SPACE_BUTTON] = MakeRect(buttonX, buttonY, buttonWidth, buttonHeight);
+    layout.items[PANEL_ESC_BUTTON] = MakeRect(buttonX + buttonWidth + 20, buttonY, buttonWidth, buttonHeight);
+    layout.bounds[PANEL_SPACE_BUTTON] = ShadowBounds(layout.items[PANEL_SPACE_BUTTON]);
+    layout.bounds[PANEL_ESC_BUTTON] = ShadowBounds(layout.items[PANEL_ESC_BUTTON]);
+
+    layout.items[PANEL_STATUS] = layout.statusRect;
+    layout.bounds[PANEL_STATUS] = InflateRect(layout.statusRect, 1, 1, 1, 1);
+
+    layout.items[PANEL_HINT] = RectI{0, height - 25, width, height};
+    layout.bounds[PANEL_HINT] = layout.items[PANEL_HINT];
+
+    return layout;
+}
+
+PanelElementKey GetPanelElementKey(const PanelState& state, PanelElement element)
+{
+    PanelElementKey key = {0, 0, 0};
+    switch (element)
+    {
+    case PANEL_KEY_UP:       key.kind = state.upPressed; break;
+    case PANEL_KEY_DOWN:     key.kind = state.downPressed; break;
+    case PANEL_KEY_LEFT:     key.kind = state.leftPressed; break;
+    case PANEL_KEY_RIGHT:    key.kind = state.rightPressed; break;
+    case PANEL_SPACE_BUTTON: key.kind = state.spacePressed; break;
+    case PANEL_ESC_BUTTON:   key.kind = state.escPressed; break;
+
+    case PANEL_STATUS:
+        // 只有正在显示的内容才参与比较
+        if (state.resetTriggered)
+        {
+            key.kind = STATUS_RESET_WARNING;
+            key.a = 5 - state.idleSeconds;
+        }
+        else if (state.idleSeconds >= 4)
+        {
+            key.kind = STATUS_IDLE_WARNING;
+            key.a = 5 - state.idleSeconds;
+        }
+        else
+        {
+            key.kind = STATUS_NORMAL;
+            key.a = state.posX;
+            key.b = state.posY;
+        }
+        break;
+
+    case PANEL_HINT:
+        // 显示延迟统计时按文字内容的散列比较
+        if (state.showLatency)
+        {
+            key.kind = 1;
+            unsigned hash = 2166136261u;
+            for (const wchar_t* p = state.latencyText; *p; ++p)
+                hash = (hash ^ (unsigned)*p) * 16777619u;
+            key.a = (int)hash;
+        }
+        break;
+
+    default:
+        // 标题和控制区域的内容不随状态变化
+        break;
+    }
+    return key;
+}
+
+void DrawPanelBackground(IRenderBackend& backend, const PanelLayout& layout)
+{
+    backend.FillRect(RectI{0, 0, layout.width, layout.height}, BG_COLOR);
+}
+
+void DrawPanelElement(IRenderBackend& backend, const PanelLayout& layout, const PanelState& state, PanelElement element)
+{
+    const RectI& item = layout.items[element];
+
+    switch (element)
+    {
+    case PANEL_TITLE_BAR:
+        // 绘制标题栏效果和标题
+        backend.FillRect(item, MakeColor(30, 30, 32));
+        backend.DrawLabel(L"✨ 可移动窗口控制器 ✨", RectI{0, 20, layout.width, 80}, TITLE_FONT, TEXT_COLOR, TEXT_ALIGN_CENTER);
+        break;
+
+    case PANEL_CONTROL_AREA:
+        {
+            // 绘制控制区域背景和边框
+            backend.FillRect(item, BORDER_COLOR);
+            backend.FrameRect(item, 2, ACCENT_COLOR);
+
+            // 绘制中心区域提示
+            int centerX = (item.left + item.right) / 2;
+            int centerY = (item.top + item.bottom) / 2;
+            RectI centerTextRect = {centerX - 50, centerY - 20, centerX + 50, centerY + 20};
+            backend.DrawLabel(L"斜向移动", centerTextRect, SMALL_FONT, MakeColor(150, 150, 150), TEXT_ALIGN_CENTER);
+        }
+        break;
+
+    case PANEL_KEY_UP:
+    case PANEL_KEY_DOWN:
+    case PANEL_KEY_LEFT:
+    case PANEL_KEY_RIGHT:
+        {
+            static const wchar_t* const IDLE_TEXT[4] = {L"W/↑", L"S/↓", L"A/←", L"D/→"};
+            static const wchar_t* const PRESSED_TEXT[4] = {L"▲", L"▼", L"◀", L"▶"};
+            int index = element - PANEL_KEY_UP;
+            bool pressed = GetPanelElementKey(state, element).kind != 0;
+            DrawKeyButton(backend, (item.left + item.right) / 2, (item.top + item.bottom) / 2, layout.keySize,
+                          pressed ? PRESSED_TEXT[index] : IDLE_TEXT[index], pressed);
+        }
+        break;
+
+    case PANEL_SPACE_BUTTON:
+        DrawModernButton(backend, item.left, item.top, RectWidth(item), RectHeight(item),
+                         state.spacePressed ? L"🔄 重置中..." : L"空格键 - 重置位置", state.spacePressed);
+        break;
+
+    case PANEL_ESC_BUTTON:
+        DrawModernButton(backend, item.left, item.top, RectWidth(item), RectHeight(item),
+                         L"ESC - 取消重置", state.escPressed);
+        break;
+
+    case PANEL_STATUS:
+        {
+            // 绘制状态信息背景和边框
+            backend.FillRect(item, MakeColor(30, 30, 30));
+            backend.FrameRect(item, 1, ACCENT_COLOR);
+
+            wchar_t statusText[256];
+            Color statusColor = TEXT_COLOR;
+            PanelElementKey key = GetPanelElementKey(state, PANEL_STATUS);
+            if (key.kind == STATUS_RESET_WARNING)
+            {
+                swprintf(statusText, 256, L"⚠️  窗口已移动到边界外！%d秒后自动重置到中心...", key.a);
+                statusColor = WARNING_COLOR;
+            }
+            else if (key.kind == STATUS_IDLE_WARNING)
+            {
+                swprintf(statusText, 256, L"⏰  %d秒未操作，即将自动重置...", key.a);
+                statusColor = WARNING_COLOR;
+            }
+            else
+            {
+                swprintf(statusText, 256, L"✅  窗口控制正常 | 位置: (%d, %d)", key.a, key.b);
+            }
+
+            RectI textRect = {item.left + 10, item.top, item.right - 10, item.bottom};
+            backend.DrawLabel(statusText, textRect, SMALL_FONT, statusColor, TEXT_ALIGN_LEFT);
+        }
+        break;
+
+    case PANEL_HINT:
+        // 绘制底部提示，或者延迟统计
+        if (state.showLatency)
+            backend.DrawLabel(state.latencyText, item, SMALL_FONT, KEY_COLOR, TEXT_ALIGN_CENTER);
+        else
+            backend.DrawLabel(L"💡 提示：只有窗口移动到屏幕外才会自动重置，ESC键取消重置",
+                              item, SMALL_FONT, MakeColor(120, 120, 120), TEXT_ALIGN_CENTER);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void DrawControlPanel(IRenderBackend& backend, const PanelState& state)
+{
+    PanelLayout layout = ComputePanelLayout(backend.Width(), backend.Height());
+
+    DrawPanelBackground(backend, layout);
+    for (int i = 0; i < PANEL_ELEMENT_COUNT; ++i)
+        DrawPanelElement(backend, layout, state, (PanelElement)i);
+}
+
+void DrawKeyButton(IRenderBackend& backend, int centerX, int centerY, int size, const wchar_t* text, bool pressed)
+{
+    int x = centerX - size / 2;
+    int y = centerY - size / 2;
+
+    // 按键颜色
+    Color bgColor = pressed ? KEY_COLOR : MakeColor(60, 60, 60);
+    Color textColor = pressed ? MakeColor(255, 255, 255) : TEXT_COLOR;
+    Color borderColor = pressed ? MakeColor(255, 255, 255) : ACCENT_COLOR;
+
+    // 绘制按键阴影（按下状态）
+    if (pressed)
+        backend.DropShadow(MakeRect(x + SHADOW_OFFSET, y + SHADOW_OFFSET, size, size), 5, SHADOW_BLUR, SHADOW_COLOR, SHADOW_OPACITY);
+
+    // 绘制按键背景（圆角矩形）
+    backend.RoundRect(MakeRect(x, y, size, size), 5, bgColor, borderColor, 2);
+
+    // 绘制按键文字
+    FontSpec font = {L"Segoe UI", size / 2, true};
+    backend.DrawLabel(text, MakeRect(x, y, size, size), font, textColor, TEXT_ALIGN_CENTER);
+}
+
+void DrawModernButton(IRenderBackend& backend, int x, int y, int width, int height, const wchar_t* text, bool active)
+{
+    // 按钮颜色
+    Color bgColor = active ? ACCENT_COLOR : MakeColor(70, 70, 70);
+    Color textColor = active ? MakeColor(255, 255, 255) : TEXT_COLOR;
+    Color borderColor = active ? MakeColor(255, 255, 255) : ACCENT_COLOR;
+
+    // 绘制按钮阴影
+    backend.DropShadow(MakeRect(x + SHADOW_OFFSET, y + SHADOW_OFFSET, width, height), 4, SHADOW_BLUR, SHADOW_COLOR, SHADOW_OPACITY);
+
+    // 绘制按钮
+    backend.RoundRect(MakeRect(x, y, width, height), 4, bgColor, borderColor, 1);
+
+    // 绘制按钮文字
+    backend.DrawLabel(text, MakeRect(x, y, width, height), BUTTON_FONT, textColor, TEXT_ALIGN_CENTER);
+}
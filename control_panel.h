@@ -0,0 +1,102 @@
+#pragma once
+
+#include "render_backend.h"
+
+// 颜色定义
+const Color BG_COLOR = MakeColor(45, 45, 48);      // 深灰色背景
+const Color TEXT_COLOR = MakeColor(241, 241, 241);  // 浅灰色文字
+const Color ACCENT_COLOR = MakeColor(0, 122, 204);  // 蓝色强调色
+const Color KEY_COLOR = MakeColor(86, 156, 214);    // 按键颜色
+const Color WARNING_COLOR = MakeColor(255, 153, 0); // 警告橙色
+const Color BORDER_COLOR = MakeColor(62, 62, 66);   // 边框颜色
+const Color SHADOW_COLOR = MakeColor(10, 10, 12);   // 阴影颜色
+
+// 按键和按钮的阴影：向右下偏移，模糊后向外扩散 SHADOW_SPREAD 像素
+const int SHADOW_OFFSET = 2;
+const int SHADOW_BLUR = 3;
+const int SHADOW_SPREAD = 3 * SHADOW_BLUR;
+const int SHADOW_OPACITY = 170;
+
+// 绘制一帧控制面板所需的全部状态
+struct PanelState
+{
+    bool upPressed;
+    bool downPressed;
+    bool leftPressed;
+    bool rightPressed;
+    bool spacePressed;
+    bool escPressed;
+    bool resetTriggered;
+    int idleSeconds;   // 距离最后一次移动的秒数
+    int posX;
+    int posY;
+    bool showLatency;          // 用延迟统计替换底部提示（F3 切换）
+    wchar_t latencyText[128];  // 延迟统计摘要
+};
+
+// 控制面板中的元素，按绘制顺序排列
+enum PanelElement
+{
+    PANEL_TITLE_BAR,
+    PANEL_CONTROL_AREA,
+    PANEL_KEY_UP,
+    PANEL_KEY_DOWN,
+    PANEL_KEY_LEFT,
+    PANEL_KEY_RIGHT,
+    PANEL_SPACE_BUTTON,
+    PANEL_ESC_BUTTON,
+    PANEL_STATUS,
+    PANEL_HINT,
+    PANEL_ELEMENT_COUNT
+};
+
+// 元素的可见内容摘要，内容相同则绘制结果相同
+struct PanelElementKey
+{
+    int kind;
+    int a;
+    int b;
+};
+
+inline bool operator==(const PanelElementKey& lhs, const PanelElementKey& rhs)
+{
+    return lhs.kind == rhs.kind && lhs.a == rhs.a && lhs.b == rhs.b;
+}
+
+inline bool operator!=(const PanelElementKey& lhs, const PanelElementKey& rhs)
+{
+    return !(lhs == rhs);
+}
+
+// 控制面板布局
+struct PanelLayout
+{
+    int width;
+    int height;
+    int keySize;
+    RectI controlRect;
+    RectI statusRect;
+    RectI items[PANEL_ELEMENT_COUNT];    // 元素本身的矩形（按键、按钮不含阴影）
+    RectI bounds[PANEL_ELEMENT_COUNT];   // 元素绘制时可能覆盖的范围（含阴影和描边）
+};
+
+// 根据客户区大小计算布局
+PanelLayout ComputePanelLayout(int width, int height);
+
+// 计算元素的内容摘要
+PanelElementKey GetPanelElementKey(const PanelState& state, PanelElement element);
+
+// 绘制背景（元素之下的底色）
+void DrawPanelBackground(IRenderBackend& backend, const PanelLayout& layout);
+
+// 绘制单个元素
+void DrawPanelElement(IRenderBackend& backend, const PanelLayout& layout, const PanelState& state, PanelElement element);
+
+// 绘制整个控制面板
+void DrawControlPanel(IRenderBackend& backend, const PanelState& state);
+
+// 绘制按键按钮（以中心点定位）
+void DrawKeyButton(IRenderBackend& backend, int centerX, int centerY, int size, const wchar_t* text, bool pressed);
+
+// 绘制现代风格按钮
+void DrawModernButton(IRenderBackend& backend, int x, int y, int width, int height, const wchar_t* text, bool active);
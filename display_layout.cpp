@@ -0,0 +1,132 @@
+#include "display_layout.h"
+
+#include <algorithm>
+#include <climits>
+
+DisplayLayout::DisplayLayout()
+{
+    SetMonitors(std::vector<RectI>());
+}
+
+DisplayLayout::DisplayLayout(const std::vector<RectI>& monitors)
+{
+    SetMonitors(monitors);
+}
+
+void DisplayLayout::SetMonitors(const std::vector<RectI>& monitors)
+{
+    m_monitors.clear();
+    for (size_t i = 0; i < monitors.size(); ++i)
+    {
+        if (!IsRectEmpty(monitors[i]))
+            m_monitors.push_back(monitors[i]);
+    }
+
+    if (m_monitors.empty())
+        m_monitors.push_back(RectI{0, 0, 1920, 1080});
+
+    m_bounds = RectI{0, 0, 0, 0};
+    m_primary = 0;
+    for (size_t i = 0; i < m_monitors.size(); ++i)
+    {
+        const RectI& monitor = m_monitors[i];
+        m_bounds = UnionRect(m_bounds, monitor);
+        if (monitor.left <= 0 && monitor.top <= 0 && monitor.right > 0 && monitor.bottom > 0)
+            m_primary = i;
+    }
+
+    BuildIndex();
+}
+
+void DisplayLayout::BuildIndex()
+{
+    // 所有左右边界排序去重，相邻两个边界之间的区间内覆盖情况不变
+    m_edges.clear();
+    for (size_t i = 0; i < m_monitors.size(); ++i)
+    {
+        m_edges.push_back(m_monitors[i].left);
+        m_edges.push_back(m_monitors[i].right);
+    }
+    std::sort(m_edges.begin(), m_edges.end());
+    m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+
+    m_slabStart.clear();
+    m_slabItems.clear();
+    for (size_t k = 0; k + 1 < m_edges.size(); ++k)
+    {
+        m_slabStart.push_back(m_slabItems.size());
+        for (size_t i = 0; i < m_monitors.size(); ++i)
+        {
+            if (m_monitors[i].left <= m_edges[k] && m_monitors[i].right >= m_edges[k + 1])
+                m_slabItems.push_back(i);
+        }
+    }
+    m_slabStart.push_back(m_slabItems.size());
+}
+
+int DisplayLayout::SlabAt(int x) const
+{
+    // 第一个大于 x 的边界之前的那个区间
+    std::vector<int>::const_iterator it = std::upper_bound(m_edges.begin(), m_edges.end(), x);
+    if (it == m_edges.begin() || it == m_edges.end())
+        return -1;
+    return (int)(it - m_edges.begin()) - 1;
+}
+
+bool DisplayLayout::IsFullyOffScreen(const RectI& rect) const
+{
+    if (IsRectEmpty(IntersectRect(rect, m_bounds)))
+        return true;
+
+    // 从 rect.left 所在的区间开始，逐个检查与 rect 水平方向重叠的区间
+    size_t slabCount = m_slabStart.size() - 1;
+    int first = SlabAt(std::max(rect.left, m_bounds.left));
+    for (size_t k = first < 0 ? 0 : (size_t)first; k < slabCount && m_edges[k] < rect.right; ++k)
+    {
+        for (size_t n = m_slabStart[k]; n < m_slabStart[k + 1]; ++n)
+        {
+            const RectI& monitor = m_monitors[m_slabItems[n]];
+            if (monitor.top < rect.bottom && rect.top < monitor.bottom)
+                return false;
+        }
+    }
+    return true;
+}
+
+const RectI& DisplayLayout::NearestMonitor(const PointI& point) const
+{
+    // 常见情况：点就在某个显示器上，只需查一个区间
+    int slab = SlabAt(point.x);
+    if (slab >= 0)
+    {
+        for (size_t n = m_slabStart[slab]; n < m_slabStart[slab + 1]; ++n)
+        {
+            const RectI& monitor = m_monitors[m_slabItems[n]];
+            if (point.y >= monitor.top && point.y < monitor.bottom)
+                return monitor;
+        }
+    }
+
+    // 不在任何显示器上：取到矩形距离最近的
+    size_t best = m_primary;
+    long long bestDistance = LLONG_MAX;
+    for (size_t i = 0; i < m_monitors.size(); ++i)
+    {
+        const RectI& monitor = m_monitors[i];
+        long long dx = point.x < monitor.left ? monitor.left - point.x : (point.x >= monitor.right ? point.x - monitor.right + 1 : 0);
+        long long dy = point.y < monitor.top ? monitor.top - point.y : (point.y >= monitor.bottom ? point.y - monitor.bottom + 1 : 0);
+        long long distance = dx * dx + dy * dy;
+        if (distance < bestDistance)
+        {
+            bestDistance = distance;
+            best = i;
+        }
+    }
+    return m_monitors[best];
+}
+
+PointI DisplayLayout::NearestMonitorCenter(const PointI& point) const
+{
+    const RectI& monitor = NearestMonitor(point);
+    return PointI{monitor.left + RectWidth(monitor) / 2, monitor.top + RectHeight(monitor) / 2};
+}
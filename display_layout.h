@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "geometry.h"
+
+// 虚拟桌面的显示器布局缓存
+// 只在显示设置变化时重建；查询走按 x 轴切分的区间索引，显示器很多时也不需要逐个比较。
+// 布局可以直接注入，便于在没有 Win32 的环境下覆盖 L 形、混合分辨率等排列。
+class DisplayLayout
+{
+public:
+    // 默认是一个 1920x1080 的主显示器
+    DisplayLayout();
+    explicit DisplayLayout(const std::vector<RectI>& monitors);
+
+    // 替换显示器列表并重建索引，空列表等同于默认布局
+    void SetMonitors(const std::vector<RectI>& monitors);
+
+    const std::vector<RectI>& Monitors() const { return m_monitors; }
+    size_t MonitorCount() const { return m_monitors.size(); }
+
+    // 所有显示器的外接矩形
+    const RectI& VirtualBounds() const { return m_bounds; }
+
+    // 主显示器：包含原点的显示器（Win32 的约定），没有时取第一个
+    const RectI& Primary() const { return m_monitors[m_primary]; }
+
+    // 矩形与任何一个显示器都不相交
+    bool IsFullyOffScreen(const RectI& rect) const;
+
+    // 包含 point 的显示器；不在任何显示器上时取距离最近的一个
+    const RectI& NearestMonitor(const PointI& point) const;
+
+    // 最近显示器的中心
+    PointI NearestMonitorCenter(const PointI& point) const;
+
+private:
+    void BuildIndex();
+
+    // 包含 x 的区间下标，不在任何区间内时返回 -1
+    int SlabAt(int x) const;
+
+    std::vector<RectI> m_monitors;
+    RectI m_bounds;
+    size_t m_primary;
+
+    // x 轴区间索引：第 k 个区间是 [m_edges[k], m_edges[k + 1])，
+    // 覆盖它的显示器下标存放在 m_slabItems[m_slabStart[k] .. m_slabStart[k + 1])
+    std::vector<int> m_edges;
+    std::vector<size_t> m_slabStart;
+    std::vector<size_t> m_slabItems;
+};
@@ -0,0 +1,257 @@
+// 共享内存状态的多进程读取负载
+// 用法：feed_load [--readers N] [--rate 每秒写入次数] [--seconds 秒] [--name 段名]
+// 主进程创建共享段并按给定速率写入（0 表示不限速，写者一直在写，读者最容易读到一半），
+// fork 出 N 个读者进程各自用 PositionFeedReader 打开同一个段，尽可能快地轮询。
+// 每次写入的各字段都由同一个计数器算出，读者逐次校验，能发现漏过序号检查的撕裂读。
+// 报告每秒读取次数、重读次数、撕裂读（应为 0）和读者看到的更新数。仅 Linux。
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "position_feed.h"
+
+struct FeedLoadOptions
+{
+    int readers;
+    double rate;      // 每秒写入次数，0 表示不限速
+    double seconds;
+    std::string name;
+};
+
+// 每个读者的结果，放在 fork 之前映射的共享内存里，各占一条缓存行
+struct alignas(64) ReaderResult
+{
+    uint64_t reads;     // 读到一致状态的次数
+    uint64_t retries;   // 序号检查发现读到一半被改写而重读的次数
+    uint64_t failed;    // 重读到上限仍不一致
+    uint64_t torn;      // 序号检查通过但字段互相矛盾
+    uint64_t updates;   // 看到的不同写入数
+    double seconds;
+    bool ok;
+};
+
+// 主进程和读者之间的开始、结束信号
+struct FeedLoadControl
+{
+    std::atomic<int> ready;
+    std::atomic<int> start;
+    std::atomic<int> stop;
+};
+
+static uint64_t NowNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 第 n 次写入的状态：每个字段都能从 resetCount 算出来
+static PositionSnapshot MakeSnapshot(uint64_t n)
+{
+    PositionSnapshot snapshot = {};
+    snapshot.x = (int32_t)(n % 4000) - 1000;
+    snapshot.y = -snapshot.x;
+    snapshot.width = (int32_t)(n & 0xFFFF);
+    snapshot.height = (int32_t)(n >> 16 & 0xFFFF);
+    snapshot.flags = (uint32_t)(n % 7);
+    snapshot.reserved = (uint32_t)(n * 2654435761u);
+    snapshot.resetCount = n;
+    snapshot.updateNs = ~n;
+    return snapshot;
+}
+
+static bool IsConsistent(const PositionSnapshot& snapshot)
+{
+    PositionSnapshot expected = MakeSnapshot(snapshot.resetCount);
+    return snapshot.x == expected.x && snapshot.y == expected.y && snapshot.width == expected.width &&
+           snapshot.height == expected.height && snapshot.flags == expected.flags &&
+           snapshot.reserved == expected.reserved && snapshot.updateNs == expected.updateNs;
+}
+
+static void RunReader(const FeedLoadOptions& options, FeedLoadControl* control, ReaderResult* result)
+{
+    PositionFeedReader reader;
+    if (!reader.Open(options.name.c_str()))
+    {
+        control->ready.fetch_add(1);
+        return;
+    }
+    control->ready.fetch_add(1);
+    while (!control->start.load(std::memory_order_acquire))
+        std::this_thread::yield();
+
+    uint64_t reads = 0;
+    uint64_t retries = 0;
+    uint64_t failed = 0;
+    uint64_t torn = 0;
+    uint64_t updates = 0;
+    uint64_t last = UINT64_MAX;
+    PositionSnapshot snapshot;
+    uint64_t sequence;
+    uint64_t startNs = NowNs();
+    while (!control->stop.load(std::memory_order_relaxed))
+    {
+        if (!reader.Read(&snapshot, &retries, &sequence))
+        {
+            ++failed;
+            continue;
+        }
+        ++reads;
+        if (!IsConsistent(snapshot))
+            ++torn;
+        if (sequence != last)
+        {
+            ++updates;
+            last = sequence;
+        }
+    }
+
+    result->seconds = (NowNs() - startNs) / 1e9;
+    result->reads = reads;
+    result->retries = retries;
+    result->failed = failed;
+    result->torn = torn;
+    result->updates = updates;
+    result->ok = true;
+}
+
+static bool ParseOptions(int argc, char** argv, FeedLoadOptions* options)
+{
+    options->readers = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    options->rate = 0.0;
+    options->seconds = 3.0;
+    options->name = "/movable_window_feed_load." + std::to_string((long long)getpid());
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--readers" && hasValue)
+            options->readers = std::max(1, atoi(argv[++i]));
+        else if (arg == "--rate" && hasValue)
+            options->rate = std::max(0.0, atof(argv[++i]));
+        else if (arg == "--seconds" && hasValue)
+            options->seconds = std::max(0.1, atof(argv[++i]));
+        else if (arg == "--name" && hasValue)
+            options->name = argv[++i];
+        else
+            return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    FeedLoadOptions options;
+    if (!ParseOptions(argc, argv, &options))
+    {
+        fprintf(stderr, "usage: %s [--readers n] [--rate writes-per-second] [--seconds s] [--name segment]\n", argv[0]);
+        return 2;
+    }
+
+    PositionFeedWriter writer;
+    if (!writer.Open(options.name.c_str()))
+    {
+        fprintf(stderr, "cannot create shared memory segment %s\n", options.name.c_str());
+        return 1;
+    }
+    writer.Publish(MakeSnapshot(0));
+
+    size_t sharedBytes = sizeof(ReaderResult) * (size_t)options.readers + sizeof(FeedLoadControl);
+    void* shared = mmap(nullptr, sharedBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED)
+    {
+        fprintf(stderr, "cannot map result area\n");
+        return 1;
+    }
+    ReaderResult* results = static_cast<ReaderResult*>(shared);
+    for (int i = 0; i < options.readers; ++i)
+        new (&results[i]) ReaderResult();
+    FeedLoadControl* control = new (&results[options.readers]) FeedLoadControl();
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < options.readers; ++i)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            // 子进程不能析构写者（会删除共享段），直接退出
+            RunReader(options, control, &results[i]);
+            _exit(0);
+        }
+        if (pid < 0)
+        {
+            fprintf(stderr, "fork failed after %d readers\n", i);
+            break;
+        }
+        children.push_back(pid);
+    }
+
+    while (control->ready.load() < (int)children.size())
+        std::this_thread::yield();
+
+    // 写者：不限速时一直写，否则按固定间隔写
+    uint64_t written = 0;
+    auto interval = std::chrono::duration<double>(options.rate > 0.0 ? 1.0 / options.rate : 0.0);
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.seconds));
+    auto next = start;
+    control->start.store(1, std::memory_order_release);
+    while (std::chrono::steady_clock::now() < end)
+    {
+        if (options.rate > 0.0)
+        {
+            std::this_thread::sleep_until(next);
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+        }
+        writer.Publish(MakeSnapshot(++written));
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    control->stop.store(1, std::memory_order_relaxed);
+
+    for (pid_t pid : children)
+        waitpid(pid, nullptr, 0);
+
+    uint64_t reads = 0, retries = 0, failed = 0, torn = 0, updates = 0;
+    double minRate = 0.0, maxRate = 0.0;
+    int finished = 0;
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+        const ReaderResult& result = results[i];
+        if (!result.ok)
+            continue;
+        double rate = result.seconds > 0.0 ? result.reads / result.seconds : 0.0;
+        minRate = finished == 0 ? rate : std::min(minRate, rate);
+        maxRate = finished == 0 ? rate : std::max(maxRate, rate);
+        reads += result.reads;
+        retries += result.retries;
+        failed += result.failed;
+        torn += result.torn;
+        updates += result.updates;
+        ++finished;
+    }
+    if (finished < (int)children.size())
+        fprintf(stderr, "%d readers could not open %s\n", (int)children.size() - finished, options.name.c_str());
+
+    printf("segment:          %s (%zu bytes)\n", options.name.c_str(), sizeof(PositionFeedSegment));
+    printf("writer:           %llu writes in %.3f s (%.0f/s), target rate %s\n", (unsigned long long)written, elapsed,
+           written / elapsed, options.rate > 0.0 ? std::to_string((long long)options.rate).c_str() : "unlimited");
+    printf("readers:          %d processes\n", finished);
+    printf("reads:            %llu (%.2f M/s total, per reader %.2f - %.2f M/s)\n", (unsigned long long)reads,
+           reads / elapsed / 1e6, minRate / 1e6, maxRate / 1e6);
+    printf("retries:          %llu (%.4f per read), %llu reads gave up\n", (unsigned long long)retries,
+           reads ? (double)retries / reads : 0.0, (unsigned long long)failed);
+    printf("updates seen:     %.0f distinct writes per reader on average\n", finished ? (double)updates / finished : 0.0);
+    printf("torn reads:       %llu\n", (unsigned long long)torn);
+    return torn == 0 && finished == (int)children.size() ? 0 : 1;
+}
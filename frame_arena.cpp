@@ -0,0 +1,82 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+
+FrameArena::FrameArena(size_t blockSize)
+    : m_blockSize(std::max(blockSize, (size_t)256)),
+      m_current(0),
+      m_offset(0),
+      m_used(0),
+      m_highWater(0),
+      m_blockAllocations(0)
+{
+}
+
+FrameArena::~FrameArena()
+{
+    for (const Block& block : m_blocks)
+        ::operator delete(block.data);
+}
+
+size_t FrameArena::Capacity() const
+{
+    size_t capacity = 0;
+    for (const Block& block : m_blocks)
+        capacity += block.size;
+    return capacity;
+}
+
+void FrameArena::AddBlock(size_t minimum)
+{
+    size_t size = std::max(m_blockSize, minimum);
+    m_blocks.push_back(Block{static_cast<uint8_t*>(::operator new(size)), size});
+    ++m_blockAllocations;
+}
+
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+    for (;;)
+    {
+        if (m_current < m_blocks.size())
+        {
+            Block& block = m_blocks[m_current];
+            uintptr_t base = (uintptr_t)block.data;
+            size_t offset = (size_t)(((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+            if (offset + size <= block.size)
+            {
+                m_used += offset + size - m_offset;
+                m_offset = offset + size;
+                m_highWater = std::max(m_highWater, m_used);
+                return block.data + offset;
+            }
+
+            // 当前块放不下，换下一块（后面的块是之前的帧留下的）
+            if (m_current + 1 < m_blocks.size())
+            {
+                ++m_current;
+                m_offset = 0;
+                continue;
+            }
+        }
+
+        AddBlock(size + alignment);
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+}
+
+void FrameArena::Reset()
+{
+    // 多块时换成一整块，之后的帧不再跨块
+    if (m_blocks.size() > 1)
+    {
+        size_t total = std::max(Capacity(), m_highWater);
+        for (const Block& block : m_blocks)
+            ::operator delete(block.data);
+        m_blocks.clear();
+        AddBlock(total);
+    }
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+}
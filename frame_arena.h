@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// 每帧重置的线性分配器
+// 分配只移动指针，Reset 一次归还这一帧的全部内存；块在帧之间保留，
+// 预热之后一帧的临时数据（格式化缓冲、统计快照）不再经过全局堆。
+// 分配出去的对象不会被析构，只能放平凡类型。
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t blockSize = 64 * 1024);
+    ~FrameArena();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* AllocateArray(size_t count)
+    {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // 值初始化的单个对象
+    template <typename T>
+    T* New()
+    {
+        return new (Allocate(sizeof(T), alignof(T))) T();
+    }
+
+    // 归还这一帧分配的全部内存；这一帧用了不止一块时合并成一块，下一帧只用一块
+    void Reset();
+
+    size_t Used() const { return m_used; }
+    size_t HighWater() const { return m_highWater; }
+    size_t Capacity() const;
+    uint64_t BlockAllocations() const { return m_blockAllocations; }
+
+private:
+    FrameArena(const FrameArena&);
+    FrameArena& operator=(const FrameArena&);
+
+    struct Block
+    {
+        uint8_t* data;
+        size_t size;
+    };
+
+    void AddBlock(size_t minimum);
+
+    size_t m_blockSize;
+    std::vector<Block> m_blocks;
+    size_t m_current;      // 正在使用的块
+    size_t m_offset;       // 当前块中已用的字节
+    size_t m_used;         // 这一帧已分配的字节
+    size_t m_highWater;
+    uint64_t m_blockAllocations;
+};
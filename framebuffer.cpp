@@ -0,0 +1,403 @@
+#include "framebuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MW_HAVE_SSE2 1
+#endif
+
+Framebuffer::Framebuffer()
+    : m_width(0),
+      m_height(0)
+{
+}
+
+Framebuffer::Framebuffer(int width, int height)
+    : m_width(0),
+      m_height(0)
+{
+    Resize(width, height);
+}
+
+void Framebuffer::Resize(int width, int height)
+{
+    m_width = std::max(width, 0);
+    m_height = std::max(height, 0);
+    m_pixels.assign((size_t)m_width * m_height, 0xFF000000);
+}
+
+void FillSpan(uint32_t* dst, int count, uint32_t value)
+{
+#if defined(__AVX2__)
+    __m256i value8 = _mm256_set1_epi32((int)value);
+    while (count >= 8)
+    {
+        _mm256_storeu_si256((__m256i*)dst, value8);
+        dst += 8;
+        count -= 8;
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    __m128i value4 = _mm_set1_epi32((int)value);
+    while (count >= 4)
+    {
+        _mm_storeu_si128((__m128i*)dst, value4);
+        dst += 4;
+        count -= 4;
+    }
+#endif
+    while (count-- > 0)
+        *dst++ = value;
+}
+
+void SwapRedBlue(uint32_t* dst, const uint32_t* src, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    {
+        __m256i keep = _mm256_set1_epi32((int)0xFF00FF00);
+        __m256i low = _mm256_set1_epi32(0x000000FF);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i p = _mm256_loadu_si256((const __m256i*)(src + i));
+            __m256i r = _mm256_slli_epi32(_mm256_and_si256(p, low), 16);
+            __m256i b = _mm256_and_si256(_mm256_srli_epi32(p, 16), low);
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_or_si256(_mm256_and_si256(p, keep), _mm256_or_si256(r, b)));
+        }
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    {
+        __m128i keep = _mm_set1_epi32((int)0xFF00FF00);
+        __m128i low = _mm_set1_epi32(0x000000FF);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i p = _mm_loadu_si128((const __m128i*)(src + i));
+            __m128i r = _mm_slli_epi32(_mm_and_si128(p, low), 16);
+            __m128i b = _mm_and_si128(_mm_srli_epi32(p, 16), low);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(_mm_and_si128(p, keep), _mm_or_si128(r, b)));
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        uint32_t p = src[i];
+        dst[i] = (p & 0xFF00FF00) | ((p & 0xFF) << 16) | ((p >> 16) & 0xFF);
+    }
+}
+
+void BlendPixel(uint32_t* dst, uint32_t value, int coverage)
+{
+    if (coverage <= 0) return;
+    if (coverage >= 255)
+    {
+        *dst = value;
+        return;
+    }
+
+    uint32_t old = *dst;
+    int inverse = 255 - coverage;
+    uint32_t r = ((value & 0xFF) * coverage + (old & 0xFF) * inverse + 127) / 255;
+    uint32_t g = (((value >> 8) & 0xFF) * coverage + ((old >> 8) & 0xFF) * inverse + 127) / 255;
+    uint32_t b = (((value >> 16) & 0xFF) * coverage + ((old >> 16) & 0xFF) * inverse + 127) / 255;
+    *dst = r | (g << 8) | (b << 16) | 0xFF000000;
+}
+
+void BlendCoverageSpanScalar(uint32_t* dst, const uint8_t* coverage, int count, uint32_t value)
+{
+    for (int i = 0; i < count; ++i)
+        BlendPixel(dst + i, value, coverage[i]);
+}
+
+// 每个通道 n = value * c + dst * (255 - c) + 127，n / 255 用 ((n + 1) + ((n + 1) >> 8)) >> 8 计算（n < 65280 时精确）
+// 目标和 value 都不透明时与 BlendPixel 的结果完全相同
+void BlendCoverageSpan(uint32_t* dst, const uint8_t* coverage, int count, uint32_t value)
+{
+    int i = 0;
+#if defined(__AVX2__)
+    {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i full = _mm256_set1_epi16(255);
+        __m256i bias = _mm256_set1_epi16(128);
+        __m256i value8 = _mm256_set1_epi32((int)value);
+        __m256i value16 = _mm256_unpacklo_epi8(value8, zero);
+        for (; i + 8 <= count; i += 8)
+        {
+            uint64_t packed;
+            memcpy(&packed, coverage + i, sizeof(packed));
+            if (packed == 0)
+                continue;
+            if (packed == ~(uint64_t)0)
+            {
+                _mm256_storeu_si256((__m256i*)(dst + i), value8);
+                continue;
+            }
+
+            // 每个像素的覆盖率扩展到四个 16 位通道，与 unpacklo/hi 得到的像素顺序一致
+            __m256i c32 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(coverage + i)));
+            __m256i c16 = _mm256_or_si256(c32, _mm256_slli_epi32(c32, 16));
+            __m256i cLow = _mm256_unpacklo_epi32(c16, c16);
+            __m256i cHigh = _mm256_unpackhi_epi32(c16, c16);
+
+            __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+            __m256i dLow = _mm256_unpacklo_epi8(d, zero);
+            __m256i dHigh = _mm256_unpackhi_epi8(d, zero);
+
+            __m256i xLow = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(value16, cLow),
+                                                             _mm256_mullo_epi16(dLow, _mm256_sub_epi16(full, cLow))), bias);
+            __m256i xHigh = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(value16, cHigh),
+                                                              _mm256_mullo_epi16(dHigh, _mm256_sub_epi16(full, cHigh))), bias);
+            xLow = _mm256_srli_epi16(_mm256_add_epi16(xLow, _mm256_srli_epi16(xLow, 8)), 8);
+            xHigh = _mm256_srli_epi16(_mm256_add_epi16(xHigh, _mm256_srli_epi16(xHigh, 8)), 8);
+            _mm256_storeu_si256((__m256i*)(dst + i), _mm256_packus_epi16(xLow, xHigh));
+        }
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i full = _mm_set1_epi16(255);
+        __m128i bias = _mm_set1_epi16(128);
+        __m128i value4 = _mm_set1_epi32((int)value);
+        __m128i value16 = _mm_unpacklo_epi8(value4, zero);
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32_t packed;
+            memcpy(&packed, coverage + i, sizeof(packed));
+            if (packed == 0)
+                continue;
+            if (packed == 0xFFFFFFFFu)
+            {
+                _mm_storeu_si128((__m128i*)(dst + i), value4);
+                continue;
+            }
+
+            __m128i c8 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int)packed), zero);
+            __m128i c16 = _mm_unpacklo_epi16(c8, c8);
+            __m128i cLow = _mm_unpacklo_epi32(c16, c16);
+            __m128i cHigh = _mm_unpackhi_epi32(c16, c16);
+
+            __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+            __m128i dLow = _mm_unpacklo_epi8(d, zero);
+            __m128i dHigh = _mm_unpackhi_epi8(d, zero);
+
+            __m128i xLow = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(value16, cLow),
+                                                       _mm_mullo_epi16(dLow, _mm_sub_epi16(full, cLow))), bias);
+            __m128i xHigh = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(value16, cHigh),
+                                                        _mm_mullo_epi16(dHigh, _mm_sub_epi16(full, cHigh))), bias);
+            xLow = _mm_srli_epi16(_mm_add_epi16(xLow, _mm_srli_epi16(xLow, 8)), 8);
+            xHigh = _mm_srli_epi16(_mm_add_epi16(xHigh, _mm_srli_epi16(xHigh, 8)), 8);
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_packus_epi16(xLow, xHigh));
+        }
+    }
+#endif
+    BlendCoverageSpanScalar(dst + i, coverage + i, count - i, value);
+}
+
+void BlendCoverage(Framebuffer& target, const RectI& clip, int x, int y,
+                   const uint8_t* coverage, int stride, int width, int height, uint32_t value)
+{
+    RectI area = IntersectRect(MakeRect(x, y, width, height), clip);
+    if (IsRectEmpty(area)) return;
+
+    for (int row = area.top; row < area.bottom; ++row)
+    {
+        const uint8_t* src = coverage + (size_t)(row - y) * stride + (area.left - x);
+        BlendCoverageSpan(target.Row(row) + area.left, src, area.right - area.left, value);
+    }
+}
+
+// 单行文字在矩形内的起点和基线（垂直居中，与 DT_VCENTER 一致）
+static PointI LabelOrigin(const RectI& rect, int width, const FontMetrics& metrics, TextAlign align)
+{
+    int x = align == TEXT_ALIGN_CENTER ? rect.left + (RectWidth(rect) - width) / 2 : rect.left;
+    int baseline = rect.top + (RectHeight(rect) - (metrics.ascent + metrics.descent)) / 2 + metrics.ascent;
+    return PointI{x, baseline};
+}
+
+void DrawTextUncached(Framebuffer& target, const RectI& clip, IGlyphSource& source,
+                      const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align)
+{
+    // 第一遍排版量出宽度，第二遍重新光栅化并绘制
+    GlyphImage image;
+    int width = 0;
+    for (size_t i = 0; text[i] != 0;)
+    {
+        uint32_t codepoint;
+        i += DecodeCodepoint(text + i, &codepoint);
+        source.Rasterize(font, codepoint, &image);
+        width += image.advance;
+    }
+
+    PointI origin = LabelOrigin(rect, width, source.Metrics(font), align);
+    RectI area = IntersectRect(rect, clip);
+    uint32_t pixel = ColorToPixel(color);
+    int pen = origin.x;
+    for (size_t i = 0; text[i] != 0;)
+    {
+        uint32_t codepoint;
+        i += DecodeCodepoint(text + i, &codepoint);
+        source.Rasterize(font, codepoint, &image);
+        BlendCoverage(target, area, pen + image.bearingX, origin.y - image.bearingY,
+                      image.coverage.data(), image.width, image.width, image.height, pixel);
+        pen += image.advance;
+    }
+}
+
+SoftwareBackend::SoftwareBackend(Framebuffer& target, TextRunCache* text, ShadowCache* shadows)
+    : m_target(target),
+      m_clip(RectI{0, 0, target.Width(), target.Height()}),
+      m_text(text),
+      m_shadows(shadows)
+{
+}
+
+void SoftwareBackend::SetClip(const RectI& clip)
+{
+    m_clip = IntersectRect(clip, RectI{0, 0, m_target.Width(), m_target.Height()});
+}
+
+void SoftwareBackend::FillRect(const RectI& rect, Color color)
+{
+    RectI clip = IntersectRect(rect, m_clip);
+    if (IsRectEmpty(clip)) return;
+
+    uint32_t pixel = ColorToPixel(color);
+    for (int y = clip.top; y < clip.bottom; ++y)
+        FillSpan(m_target.Row(y) + clip.left, clip.right - clip.left, pixel);
+}
+
+void SoftwareBackend::FrameRect(const RectI& rect, int borderWidth, Color color)
+{
+    if (borderWidth <= 0) return;
+
+    FillRect(RectI{rect.left, rect.top, rect.right, rect.top + borderWidth}, color);
+    FillRect(RectI{rect.left, rect.bottom - borderWidth, rect.right, rect.bottom}, color);
+    FillRect(RectI{rect.left, rect.top + borderWidth, rect.left + borderWidth, rect.bottom - borderWidth}, color);
+    FillRect(RectI{rect.right - borderWidth, rect.top + borderWidth, rect.right, rect.bottom - borderWidth}, color);
+}
+
+void SoftwareBackend::RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth)
+{
+    if (borderWidth <= 0 || border == fill)
+    {
+        FillRoundRect(rect, (float)radius, ColorToPixel(fill));
+        return;
+    }
+
+    // 先画外圈的边框色，再在内侧叠加填充色
+    FillRoundRect(rect, (float)radius, ColorToPixel(border));
+    RectI inner = {rect.left + borderWidth, rect.top + borderWidth, rect.right - borderWidth, rect.bottom - borderWidth};
+    FillRoundRect(inner, (float)std::max(radius - borderWidth, 0), ColorToPixel(fill));
+}
+
+void SoftwareBackend::DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity)
+{
+    if (!m_shadows)
+    {
+        FillRoundRect(rect, (float)radius, ColorToPixel(color));
+        return;
+    }
+
+    const ShadowMask& mask = m_shadows->Get(RectWidth(rect), RectHeight(rect), radius, blur, opacity);
+    BlendCoverage(m_target, m_clip, rect.left - mask.margin, rect.top - mask.margin,
+                  mask.alpha.data(), mask.width, mask.width, mask.height, ColorToPixel(color));
+}
+
+void SoftwareBackend::DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align)
+{
+    if (!m_text || !text || !text[0]) return;
+
+    RectI area = IntersectRect(rect, m_clip);
+    if (IsRectEmpty(area)) return;
+
+    GlyphAtlas& atlas = m_text->Atlas();
+    FontId fontId = atlas.RegisterFont(font);
+
+    // 同一位置的标签共用一个 slot，文字变化时只重新排版变化的部分
+    uint64_t slot = ((uint64_t)(uint16_t)rect.left << 48) | ((uint64_t)(uint16_t)rect.top << 32) | fontId;
+    const TextRun& run = m_text->Layout(text, fontId, slot);
+
+    PointI origin = LabelOrigin(rect, run.width, atlas.Metrics(fontId), align);
+    uint32_t pixel = ColorToPixel(color);
+    for (size_t i = 0; i < run.glyphs.size(); ++i)
+    {
+        const AtlasGlyph& glyph = atlas.Glyph(run.glyphs[i].glyph);
+        int x = origin.x + run.glyphs[i].x + glyph.bearingX;
+        if (x >= area.right) break;
+        if (glyph.width == 0 || x + glyph.width <= area.left) continue;
+
+        BlendCoverage(m_target, area, x, origin.y - glyph.bearingY,
+                      atlas.Pixels() + (size_t)glyph.y * atlas.Width() + glyph.x, atlas.Width(),
+                      glyph.width, glyph.height, pixel);
+    }
+}
+
+void SoftwareBackend::FillRoundRect(const RectI& rect, float radius, uint32_t pixel)
+{
+    RectI clip = IntersectRect(rect, m_clip);
+    if (IsRectEmpty(clip)) return;
+
+    radius = std::min(radius, std::min(RectWidth(rect), RectHeight(rect)) * 0.5f);
+    if (radius <= 0.0f)
+    {
+        for (int y = clip.top; y < clip.bottom; ++y)
+            FillSpan(m_target.Row(y) + clip.left, clip.right - clip.left, pixel);
+        return;
+    }
+
+    // 圆角圆心所在的坐标
+    float leftCenter = rect.left + radius;
+    float rightCenter = rect.right - radius;
+    float topCenter = rect.top + radius;
+    float bottomCenter = rect.bottom - radius;
+
+    // 圆角所占的整列范围，中间部分总是完全覆盖
+    int corner = (int)std::ceil(radius);
+    int innerLeft = rect.left + corner;
+    int innerRight = std::max(rect.right - corner, innerLeft);
+
+    for (int y = clip.top; y < clip.bottom; ++y)
+    {
+        uint32_t* row = m_target.Row(y);
+        float cy = y + 0.5f;
+        float dy = 0.0f;
+        if (cy < topCenter)
+            dy = topCenter - cy;
+        else if (cy > bottomCenter)
+            dy = cy - bottomCenter;
+
+        if (dy == 0.0f)
+        {
+            FillSpan(row + clip.left, clip.right - clip.left, pixel);
+            continue;
+        }
+
+        int middleLeft = std::max(innerLeft, clip.left);
+        int middleRight = std::min(innerRight, clip.right);
+        if (middleRight > middleLeft)
+            FillSpan(row + middleLeft, middleRight - middleLeft, pixel);
+
+        // 圆角处按到圆心的距离计算覆盖率
+        int leftEnd = std::min(innerLeft, clip.right);
+        for (int x = clip.left; x < leftEnd; ++x)
+        {
+            float dx = std::max(leftCenter - (x + 0.5f), 0.0f);
+            float coverage = radius - std::sqrt(dx * dx + dy * dy) + 0.5f;
+            BlendPixel(row + x, pixel, (int)(std::min(std::max(coverage, 0.0f), 1.0f) * 255.0f + 0.5f));
+        }
+
+        for (int x = std::max(innerRight, clip.left); x < clip.right; ++x)
+        {
+            float dx = std::max((x + 0.5f) - rightCenter, 0.0f);
+            float coverage = radius - std::sqrt(dx * dx + dy * dy) + 0.5f;
+            BlendPixel(row + x, pixel, (int)(std::min(std::max(coverage, 0.0f), 1.0f) * 255.0f + 0.5f));
+        }
+    }
+}
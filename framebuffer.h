@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "render_backend.h"
+#include "shadow.h"
+#include "text_layout.h"
+
+// RGBA 帧缓冲，每个像素在内存中依次为 R、G、B、A
+class Framebuffer
+{
+public:
+    Framebuffer();
+    Framebuffer(int width, int height);
+
+    void Resize(int width, int height);
+
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+    uint32_t* Row(int y) { return &m_pixels[(size_t)y * m_width]; }
+    const uint32_t* Row(int y) const { return &m_pixels[(size_t)y * m_width]; }
+    uint32_t* Pixels() { return m_pixels.data(); }
+    const uint32_t* Pixels() const { return m_pixels.data(); }
+
+    uint32_t PixelAt(int x, int y) const { return m_pixels[(size_t)y * m_width + x]; }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<uint32_t> m_pixels;
+};
+
+// 后备缓冲池使用的内存表面工厂
+struct FramebufferSurfaceFactory
+{
+    typedef Framebuffer* Surface;
+
+    Surface Create(int width, int height) { return new Framebuffer(width, height); }
+    void Destroy(Surface& surface)
+    {
+        delete surface;
+        surface = nullptr;
+    }
+};
+
+// 把 Color 转换为不透明的 RGBA 像素
+inline uint32_t ColorToPixel(Color color)
+{
+    return (color & 0x00FFFFFF) | 0xFF000000;
+}
+
+// 以 value 填充 count 个像素（SSE2/AVX2 加速）
+void FillSpan(uint32_t* dst, int count, uint32_t value);
+
+// 交换每个像素的 R 和 B：RGBA 与 32 位 DIB 的 BGRA 互相转换，src 和 dst 可以相同
+void SwapRedBlue(uint32_t* dst, const uint32_t* src, size_t count);
+
+// 按 0-255 的覆盖率把 value 混合到一个像素上
+void BlendPixel(uint32_t* dst, uint32_t value, int coverage);
+
+// 按 0-255 的覆盖率把 value 混合到连续 count 个像素上（SSE2/AVX2 加速）
+// 目标不透明时结果与逐个调用 BlendPixel 相同；完全覆盖和完全不覆盖的一组像素直接写入或跳过
+void BlendCoverageSpan(uint32_t* dst, const uint8_t* coverage, int count, uint32_t value);
+
+// 对照用：逐个像素调用 BlendPixel
+void BlendCoverageSpanScalar(uint32_t* dst, const uint8_t* coverage, int count, uint32_t value);
+
+// 按 0-255 的覆盖率位图把 value 混合到 (x, y) 处，只写 clip 以内的部分
+void BlendCoverage(Framebuffer& target, const RectI& clip, int x, int y,
+                   const uint8_t* coverage, int stride, int width, int height, uint32_t value);
+
+// 对照用：每次都重新排版并光栅化每个字形，不经过图集和排版缓存
+void DrawTextUncached(Framebuffer& target, const RectI& clip, IGlyphSource& source,
+                      const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align);
+
+// 纯软件绘图后端，在 Linux 上也可以完整绘制控制面板
+// 文字通过字形图集和排版缓存绘制，不提供缓存时不绘制文字；
+// 阴影从阴影缓存取模糊好的遮罩混合上去，不提供缓存时画不模糊的实心阴影
+class SoftwareBackend : public IRenderBackend
+{
+public:
+    explicit SoftwareBackend(Framebuffer& target, TextRunCache* text = nullptr, ShadowCache* shadows = nullptr);
+
+    int Width() const override { return m_target.Width(); }
+    int Height() const override { return m_target.Height(); }
+
+    void SetClip(const RectI& clip) override;
+    void FillRect(const RectI& rect, Color color) override;
+    void FrameRect(const RectI& rect, int borderWidth, Color color) override;
+    void RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth) override;
+    void DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity) override;
+    void DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align) override;
+
+private:
+    // 抗锯齿填充圆角矩形
+    void FillRoundRect(const RectI& rect, float radius, uint32_t pixel);
+
+    Framebuffer& m_target;
+    RectI m_clip;
+    TextRunCache* m_text;
+    ShadowCache* m_shadows;
+};
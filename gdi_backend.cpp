@@ -0,0 +1,320 @@
+#include "gdi_backend.h"
+
+#include <algorithm>
+#include <vector>
+
+HFONT CreateModernFont(const wchar_t* fontName, int size, bool bold)
+{
+    return CreateFontW(
+        size, 0, 0, 0,
+        bold ? FW_BOLD : FW_NORMAL,
+        FALSE, FALSE, FALSE,
+        DEFAULT_CHARSET,
+        OUT_DEFAULT_PRECIS,
+        CLIP_DEFAULT_PRECIS,
+        CLEARTYPE_QUALITY,
+        DEFAULT_PITCH | FF_DONTCARE,
+        fontName
+    );
+}
+
+static RECT ToRECT(const RectI& rect)
+{
+    RECT result = {rect.left, rect.top, rect.right, rect.bottom};
+    return result;
+}
+
+ResourceHandle GdiResourceFactory::CreateFontResource(const wchar_t* face, int size, int weight)
+{
+    return (ResourceHandle)CreateModernFont(face, size, weight >= FW_BOLD);
+}
+
+ResourceHandle GdiResourceFactory::CreateBrushResource(Color color)
+{
+    return (ResourceHandle)CreateSolidBrush(color);
+}
+
+ResourceHandle GdiResourceFactory::CreatePenResource(Color color, int width, int style)
+{
+    return (ResourceHandle)CreatePen(style, width, color);
+}
+
+void GdiResourceFactory::DestroyResource(ResourceHandle handle)
+{
+    DeleteObject((HGDIOBJ)handle);
+}
+
+GdiSurface GdiSurfaceFactory::Create(int width, int height)
+{
+    HDC hdcScreen = GetDC(nullptr);
+
+    GdiSurface surface;
+    surface.hdc = CreateCompatibleDC(hdcScreen);
+    surface.bitmap = CreateCompatibleBitmap(hdcScreen, std::max(width, 1), std::max(height, 1));
+    surface.oldBitmap = SelectObject(surface.hdc, surface.bitmap);
+
+    ReleaseDC(nullptr, hdcScreen);
+    return surface;
+}
+
+void GdiSurfaceFactory::Destroy(GdiSurface& surface)
+{
+    SelectObject(surface.hdc, surface.oldBitmap);
+    DeleteObject(surface.bitmap);
+    DeleteDC(surface.hdc);
+    surface.hdc = nullptr;
+    surface.bitmap = nullptr;
+    surface.oldBitmap = nullptr;
+}
+
+GdiShadowCache::GdiShadowCache()
+{
+}
+
+GdiShadowCache::~GdiShadowCache()
+{
+    Clear();
+}
+
+void GdiShadowCache::Clear()
+{
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        SelectObject(m_entries[i].hdc, m_entries[i].oldBitmap);
+        DeleteObject(m_entries[i].bitmap);
+        DeleteDC(m_entries[i].hdc);
+    }
+    m_entries.clear();
+    m_masks.Clear();
+}
+
+HDC GdiShadowCache::Get(int width, int height, int radius, int blur, Color color, int opacity, const ShadowMask** mask)
+{
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const Entry& entry = m_entries[i];
+        if (entry.width == width && entry.height == height && entry.radius == radius &&
+            entry.blur == blur && entry.opacity == opacity && entry.color == color)
+        {
+            *mask = entry.mask;
+            return entry.hdc;
+        }
+    }
+
+    // 遮罩缓存满时会整体清空，位图缓存跟着一起释放，保存的遮罩指针不会失效
+    if (m_entries.size() >= SHADOW_CACHE_LIMIT)
+        Clear();
+
+    const ShadowMask& shadow = m_masks.Get(width, height, radius, blur, opacity);
+    if (shadow.width <= 0 || shadow.height <= 0)
+        return nullptr;
+
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = shadow.width;
+    info.bmiHeader.biHeight = -shadow.height;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+
+    void* bits = nullptr;
+    HBITMAP bitmap = CreateDIBSection(nullptr, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+    if (!bitmap)
+        return nullptr;
+
+    // AlphaBlend 的 AC_SRC_ALPHA 要求颜色按 alpha 预乘，像素为 BGRA
+    uint32_t* pixels = static_cast<uint32_t*>(bits);
+    uint32_t red = GetRValue(color);
+    uint32_t green = GetGValue(color);
+    uint32_t blue = GetBValue(color);
+    size_t count = (size_t)shadow.width * shadow.height;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t alpha = shadow.alpha[i];
+        pixels[i] = (alpha << 24) | ((red * alpha + 127) / 255 << 16) | ((green * alpha + 127) / 255 << 8) |
+                    ((blue * alpha + 127) / 255);
+    }
+
+    Entry entry;
+    entry.width = width;
+    entry.height = height;
+    entry.radius = radius;
+    entry.blur = blur;
+    entry.opacity = opacity;
+    entry.color = color;
+    entry.mask = &shadow;
+    entry.hdc = CreateCompatibleDC(nullptr);
+    entry.bitmap = bitmap;
+    entry.oldBitmap = SelectObject(entry.hdc, bitmap);
+    m_entries.push_back(entry);
+
+    *mask = &shadow;
+    return entry.hdc;
+}
+
+GdiBackend::GdiBackend(HDC hdc, int width, int height, ResourceCache& resources, GdiShadowCache* shadows)
+    : m_hdc(hdc),
+      m_width(width),
+      m_height(height),
+      m_resources(resources),
+      m_shadows(shadows),
+      m_oldFont(nullptr)
+{
+    SetBkMode(m_hdc, TRANSPARENT);
+}
+
+GdiBackend::~GdiBackend()
+{
+    // 恢复原来的字体，缓存中的字体不在这里删除
+    if (m_oldFont)
+        SelectObject(m_hdc, m_oldFont);
+
+    SelectClipRgn(m_hdc, nullptr);
+}
+
+void GdiBackend::SetClip(const RectI& clip)
+{
+    SelectClipRgn(m_hdc, nullptr);
+    IntersectClipRect(m_hdc, clip.left, clip.top, clip.right, clip.bottom);
+}
+
+void GdiBackend::FillRect(const RectI& rect, Color color)
+{
+    RECT gdiRect = ToRECT(rect);
+    ::FillRect(m_hdc, &gdiRect, (HBRUSH)m_resources.GetBrush(color));
+}
+
+void GdiBackend::FrameRect(const RectI& rect, int borderWidth, Color color)
+{
+    HGDIOBJ hOldPen = SelectObject(m_hdc, (HPEN)m_resources.GetPen(color, borderWidth, PS_SOLID));
+    HGDIOBJ hOldBrush = SelectObject(m_hdc, GetStockObject(NULL_BRUSH));
+
+    Rectangle(m_hdc, rect.left, rect.top, rect.right, rect.bottom);
+
+    SelectObject(m_hdc, hOldBrush);
+    SelectObject(m_hdc, hOldPen);
+}
+
+void GdiBackend::RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth)
+{
+    HGDIOBJ hOldBrush = SelectObject(m_hdc, (HBRUSH)m_resources.GetBrush(fill));
+    HGDIOBJ hOldPen = SelectObject(m_hdc, (HPEN)m_resources.GetPen(border, borderWidth, PS_SOLID));
+
+    // GDI 的 RoundRect 使用圆角椭圆的直径
+    ::RoundRect(m_hdc, rect.left, rect.top, rect.right, rect.bottom, radius * 2, radius * 2);
+
+    SelectObject(m_hdc, hOldBrush);
+    SelectObject(m_hdc, hOldPen);
+}
+
+// 缓存的遮罩经预乘的 32 位 DIB 用 AlphaBlend 逐像素混合，和软件后端的阴影一致；
+// 没有阴影缓存（或位图创建失败）时退回不模糊的实心阴影
+void GdiBackend::DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity)
+{
+    const ShadowMask* mask = nullptr;
+    HDC source = m_shadows ? m_shadows->Get(RectWidth(rect), RectHeight(rect), radius, blur, color, opacity, &mask) : nullptr;
+    if (!source)
+    {
+        RoundRect(rect, radius, color, color, 1);
+        return;
+    }
+
+    BLENDFUNCTION blend = {AC_SRC_OVER, 0, 255, AC_SRC_ALPHA};
+    AlphaBlend(m_hdc, rect.left - mask->margin, rect.top - mask->margin, mask->width, mask->height,
+               source, 0, 0, mask->width, mask->height, blend);
+}
+
+void GdiBackend::DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align)
+{
+    HFONT hFont = (HFONT)m_resources.GetFont(font.face, font.size, font.bold ? FONT_WEIGHT_BOLD : FONT_WEIGHT_NORMAL);
+    HGDIOBJ hOldFont = SelectObject(m_hdc, hFont);
+    if (!m_oldFont)
+        m_oldFont = hOldFont;
+
+    SetTextColor(m_hdc, color);
+
+    RECT textRect = ToRECT(rect);
+    UINT format = DT_VCENTER | DT_SINGLELINE | (align == TEXT_ALIGN_CENTER ? DT_CENTER : DT_LEFT);
+    DrawTextW(m_hdc, text, -1, &textRect, format);
+}
+
+GdiGlyphSource::GdiGlyphSource()
+    : m_fonts(m_factory),
+      m_hdc(nullptr),
+      m_oldFont(nullptr)
+{
+}
+
+GdiGlyphSource::~GdiGlyphSource()
+{
+    if (m_hdc)
+    {
+        SelectObject(m_hdc, m_oldFont);
+        DeleteDC(m_hdc);
+    }
+    m_fonts.Clear();
+}
+
+HDC GdiGlyphSource::SelectFont(const FontSpec& font)
+{
+    if (!m_hdc)
+        m_hdc = CreateCompatibleDC(nullptr);
+
+    HFONT hFont = (HFONT)m_fonts.GetFont(font.face, font.size, font.bold ? FONT_WEIGHT_BOLD : FONT_WEIGHT_NORMAL);
+    HGDIOBJ old = SelectObject(m_hdc, hFont);
+    if (!m_oldFont)
+        m_oldFont = old;
+    return m_hdc;
+}
+
+FontMetrics GdiGlyphSource::Metrics(const FontSpec& font)
+{
+    TEXTMETRICW metrics = {};
+    GetTextMetricsW(SelectFont(font), &metrics);
+    return FontMetrics{(int)metrics.tmAscent, (int)metrics.tmDescent};
+}
+
+void GdiGlyphSource::Rasterize(const FontSpec& font, uint32_t codepoint, GlyphImage* image)
+{
+    static const MAT2 IDENTITY = {{0, 1}, {0, 0}, {0, 0}, {0, 1}};
+
+    HDC hdc = SelectFont(font);
+    image->width = 0;
+    image->height = 0;
+    image->bearingX = 0;
+    image->bearingY = 0;
+    image->coverage.clear();
+
+    GLYPHMETRICS metrics = {};
+    DWORD size = GetGlyphOutlineW(hdc, codepoint, GGO_GRAY8_BITMAP, &metrics, 0, nullptr, &IDENTITY);
+    if (size == GDI_ERROR)
+    {
+        // 字体里没有的码点只占位置
+        TEXTMETRICW text = {};
+        GetTextMetricsW(hdc, &text);
+        image->advance = (int)text.tmAveCharWidth;
+        return;
+    }
+    image->advance = metrics.gmCellIncX;
+    if (size == 0)
+        return;   // 空白字符
+
+    std::vector<uint8_t> bitmap(size);
+    if (GetGlyphOutlineW(hdc, codepoint, GGO_GRAY8_BITMAP, &metrics, size, bitmap.data(), &IDENTITY) == GDI_ERROR)
+        return;
+
+    // 每行按 4 字节对齐，灰度是 0-64
+    int width = (int)metrics.gmBlackBoxX;
+    int height = (int)metrics.gmBlackBoxY;
+    int stride = (width + 3) & ~3;
+    image->width = width;
+    image->height = height;
+    image->bearingX = metrics.gmptGlyphOrigin.x;
+    image->bearingY = metrics.gmptGlyphOrigin.y;
+    image->coverage.resize((size_t)width * height);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+            image->coverage[(size_t)y * width + x] = (uint8_t)std::min(bitmap[(size_t)y * stride + x] * 255 / 64, 255);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <windows.h>
+
+#include <vector>
+
+#include "glyph_atlas.h"
+#include "render_backend.h"
+#include "resource_cache.h"
+#include "shadow.h"
+
+// 加载字体
+HFONT CreateModernFont(const wchar_t* fontName, int size, bool bold = false);
+
+// 创建真实 GDI 对象的资源工厂
+class GdiResourceFactory : public IResourceFactory
+{
+public:
+    ResourceHandle CreateFontResource(const wchar_t* face, int size, int weight) override;
+    ResourceHandle CreateBrushResource(Color color) override;
+    ResourceHandle CreatePenResource(Color color, int width, int style) override;
+    void DestroyResource(ResourceHandle handle) override;
+};
+
+// 离屏 GDI 表面：内存 DC 和选入其中的兼容位图
+struct GdiSurface
+{
+    HDC hdc;
+    HBITMAP bitmap;
+    HGDIOBJ oldBitmap;
+};
+
+// 后备缓冲池使用的 GDI 表面工厂
+struct GdiSurfaceFactory
+{
+    typedef GdiSurface Surface;
+
+    GdiSurface Create(int width, int height);
+    void Destroy(GdiSurface& surface);
+};
+
+// GDI 后端的阴影位图：ShadowCache 的遮罩按阴影颜色预乘成 32 位 DIB，选入各自的内存 DC
+// 位图只在第一次用到时创建，之后每次阴影只是一次 AlphaBlend；超过 SHADOW_CACHE_LIMIT 个时整体释放
+class GdiShadowCache
+{
+public:
+    GdiShadowCache();
+    ~GdiShadowCache();
+
+    // 返回选入了阴影位图的内存 DC，mask 为对应的遮罩（给出尺寸和外扩）；创建失败时返回 nullptr
+    HDC Get(int width, int height, int radius, int blur, Color color, int opacity, const ShadowMask** mask);
+
+    void Clear();
+    size_t Size() const { return m_entries.size(); }
+
+private:
+    GdiShadowCache(const GdiShadowCache&);
+    GdiShadowCache& operator=(const GdiShadowCache&);
+
+    struct Entry
+    {
+        int width;
+        int height;
+        int radius;
+        int blur;
+        int opacity;
+        Color color;
+        const ShadowMask* mask;
+        HDC hdc;
+        HBITMAP bitmap;
+        HGDIOBJ oldBitmap;
+    };
+
+    ShadowCache m_masks;
+    std::vector<Entry> m_entries;  // 面板上只有几种阴影，线性查找
+};
+
+// GDI 绘图后端：把控制面板的绘制命令转换为 GDI 调用
+// 字体、画刷和画笔都从资源缓存中获取，不在绘制过程中创建
+// 有阴影缓存时用 AlphaBlend 合成柔和阴影，没有时画不模糊的实心阴影
+class GdiBackend : public IRenderBackend
+{
+public:
+    GdiBackend(HDC hdc, int width, int height, ResourceCache& resources, GdiShadowCache* shadows = nullptr);
+    ~GdiBackend();
+
+    int Width() const override { return m_width; }
+    int Height() const override { return m_height; }
+
+    void SetClip(const RectI& clip) override;
+    void FillRect(const RectI& rect, Color color) override;
+    void FrameRect(const RectI& rect, int borderWidth, Color color) override;
+    void RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth) override;
+    void DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity) override;
+    void DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align) override;
+
+private:
+    HDC m_hdc;
+    int m_width;
+    int m_height;
+    ResourceCache& m_resources;
+    GdiShadowCache* m_shadows;
+    HGDIOBJ m_oldFont;
+};
+
+// 用 GDI 光栅化字形（8 位灰度轮廓），交给字形图集在软件后端中绘制
+// 持有自己的内存 DC 和字体缓存，只能在一个线程上使用（渲染线程）
+class GdiGlyphSource : public IGlyphSource
+{
+public:
+    GdiGlyphSource();
+    ~GdiGlyphSource();
+
+    FontMetrics Metrics(const FontSpec& font) override;
+    void Rasterize(const FontSpec& font, uint32_t codepoint, GlyphImage* image) override;
+
+private:
+    GdiGlyphSource(const GdiGlyphSource&);
+    GdiGlyphSource& operator=(const GdiGlyphSource&);
+
+    // 选入字体，第一次使用时创建内存 DC
+    HDC SelectFont(const FontSpec& font);
+
+    GdiResourceFactory m_factory;
+    ResourceCache m_fonts;
+    HDC m_hdc;
+    HGDIOBJ m_oldFont;
+};
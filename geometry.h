@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// 平台无关的点和尺寸，对应 Win32 的 POINT 和 SIZE
+struct PointI
+{
+    int x;
+    int y;
+};
+
+struct SizeI
+{
+    int cx;
+    int cy;
+};
+
+// 平台无关的矩形，与 Win32 RECT 一样使用左闭右开的边界
+struct RectI
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+};
+
+inline RectI MakeRect(int x, int y, int width, int height)
+{
+    return RectI{x, y, x + width, y + height};
+}
+
+inline int RectWidth(const RectI& rect) { return rect.right - rect.left; }
+inline int RectHeight(const RectI& rect) { return rect.bottom - rect.top; }
+
+inline bool IsRectEmpty(const RectI& rect)
+{
+    return rect.right <= rect.left || rect.bottom <= rect.top;
+}
+
+inline RectI IntersectRect(const RectI& a, const RectI& b)
+{
+    return RectI{std::max(a.left, b.left), std::max(a.top, b.top),
+                 std::min(a.right, b.right), std::min(a.bottom, b.bottom)};
+}
+
+inline RectI UnionRect(const RectI& a, const RectI& b)
+{
+    if (IsRectEmpty(a)) return b;
+    if (IsRectEmpty(b)) return a;
+    return RectI{std::min(a.left, b.left), std::min(a.top, b.top),
+                 std::max(a.right, b.right), std::max(a.bottom, b.bottom)};
+}
+
+inline bool operator==(const RectI& a, const RectI& b)
+{
+    return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+}
+
+inline bool operator!=(const RectI& a, const RectI& b)
+{
+    return !(a == b);
+}
+
+// 颜色：与 COLORREF 相同的 0x00BBGGRR 布局，可以直接传给 GDI
+typedef uint32_t Color;
+
+inline constexpr Color MakeColor(int r, int g, int b)
+{
+    return Color(r & 0xFF) | (Color(g & 0xFF) << 8) | (Color(b & 0xFF) << 16);
+}
+
+inline int ColorR(Color color) { return color & 0xFF; }
+inline int ColorG(Color color) { return (color >> 8) & 0xFF; }
+inline int ColorB(Color color) { return (color >> 16) & 0xFF; }
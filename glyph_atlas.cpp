@@ -0,0 +1,111 @@
+#include "glyph_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+
+// 字形之间留 1 像素空隙，避免采样时互相渗透
+static const int GLYPH_PADDING = 1;
+
+GlyphAtlas::GlyphAtlas(IGlyphSource& source, int width, int height)
+    : m_source(source),
+      m_width(width),
+      m_height(height),
+      m_pixels((size_t)width * height, 0),
+      m_shelfX(0),
+      m_shelfY(0),
+      m_shelfHeight(0),
+      m_generation(0),
+      m_rasterized(0)
+{
+}
+
+FontId GlyphAtlas::RegisterFont(const FontSpec& font)
+{
+    for (size_t i = 0; i < m_fonts.size(); ++i)
+    {
+        const FontEntry& entry = m_fonts[i];
+        if (entry.size == font.size && entry.bold == font.bold && wcscmp(entry.face.c_str(), font.face) == 0)
+            return (FontId)i;
+    }
+
+    m_fonts.push_back(FontEntry());
+    FontEntry& entry = m_fonts.back();
+    entry.face = font.face;
+    entry.size = font.size;
+    entry.bold = font.bold;
+    entry.metrics = m_source.Metrics(font);
+
+    // vector 扩容后 c_str() 会变，统一在这里重新指向
+    for (size_t i = 0; i < m_fonts.size(); ++i)
+        m_fonts[i].spec = FontSpec{m_fonts[i].face.c_str(), m_fonts[i].size, m_fonts[i].bold};
+
+    return (FontId)(m_fonts.size() - 1);
+}
+
+uint32_t GlyphAtlas::FindOrAdd(FontId font, uint32_t codepoint)
+{
+    uint64_t key = ((uint64_t)font << 32) | codepoint;
+    std::unordered_map<uint64_t, uint32_t>::const_iterator it = m_lookup.find(key);
+    if (it != m_lookup.end())
+        return it->second;
+
+    m_source.Rasterize(m_fonts[font].spec, codepoint, &m_scratch);
+    ++m_rasterized;
+
+    // 字形比整张图集还大时只保留度量
+    int width = std::min(m_scratch.width, m_width - GLYPH_PADDING);
+    int height = std::min(m_scratch.height, m_height - GLYPH_PADDING);
+
+    AtlasGlyph glyph = {0, 0, width, height, m_scratch.bearingX, m_scratch.bearingY, m_scratch.advance};
+    if (width > 0 && height > 0)
+    {
+        if (!Pack(width, height, &glyph.x, &glyph.y))
+        {
+            // 装满了：整体清空后重新开始
+            Reset();
+            Pack(width, height, &glyph.x, &glyph.y);
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            memcpy(&m_pixels[(size_t)(glyph.y + y) * m_width + glyph.x],
+                   &m_scratch.coverage[(size_t)y * m_scratch.width], width);
+        }
+    }
+
+    uint32_t index = (uint32_t)m_glyphs.size();
+    m_glyphs.push_back(glyph);
+    m_lookup[key] = index;
+    return index;
+}
+
+bool GlyphAtlas::Pack(int width, int height, int* x, int* y)
+{
+    // 当前行放不下就换到下一行
+    if (m_shelfX + width + GLYPH_PADDING > m_width)
+    {
+        m_shelfY += m_shelfHeight + GLYPH_PADDING;
+        m_shelfX = 0;
+        m_shelfHeight = 0;
+    }
+
+    if (m_shelfY + height + GLYPH_PADDING > m_height)
+        return false;
+
+    *x = m_shelfX;
+    *y = m_shelfY;
+    m_shelfX += width + GLYPH_PADDING;
+    m_shelfHeight = std::max(m_shelfHeight, height);
+    return true;
+}
+
+void GlyphAtlas::Reset()
+{
+    m_glyphs.clear();
+    m_lookup.clear();
+    m_shelfX = 0;
+    m_shelfY = 0;
+    m_shelfHeight = 0;
+    std::fill(m_pixels.begin(), m_pixels.end(), 0);
+    ++m_generation;
+}
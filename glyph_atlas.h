@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "render_backend.h"
+
+// 光栅化后的单个字形，8 位覆盖率
+struct GlyphImage
+{
+    int width;
+    int height;
+    int bearingX;                  // 相对笔位置的水平偏移
+    int bearingY;                  // 基线到字形顶部的距离
+    int advance;                   // 笔位置的前进量
+    std::vector<uint8_t> coverage; // width * height
+};
+
+// 字体的纵向度量（像素）
+struct FontMetrics
+{
+    int ascent;   // 基线以上
+    int descent;  // 基线以下
+};
+
+// 字形来源：把码点光栅化为覆盖率位图
+class IGlyphSource
+{
+public:
+    virtual ~IGlyphSource() {}
+
+    virtual FontMetrics Metrics(const FontSpec& font) = 0;
+    virtual void Rasterize(const FontSpec& font, uint32_t codepoint, GlyphImage* image) = 0;
+};
+
+typedef uint32_t FontId;
+
+// 图集中的字形位置和度量
+struct AtlasGlyph
+{
+    int x;
+    int y;
+    int width;
+    int height;
+    int bearingX;
+    int bearingY;
+    int advance;
+};
+
+// 字形图集：每个 (字体, 码点) 只光栅化一次，按行（shelf）装入一张 8 位覆盖率纹理
+// 装满时整体清空并递增 Generation()，持有旧下标的一方据此重新排版
+class GlyphAtlas
+{
+public:
+    explicit GlyphAtlas(IGlyphSource& source, int width = 512, int height = 512);
+
+    // 同样的字体描述总是得到同一个 FontId
+    FontId RegisterFont(const FontSpec& font);
+    const FontMetrics& Metrics(FontId font) const { return m_fonts[font].metrics; }
+
+    // 返回字形在表中的下标，未缓存时光栅化并装入图集
+    uint32_t FindOrAdd(FontId font, uint32_t codepoint);
+    const AtlasGlyph& Glyph(uint32_t index) const { return m_glyphs[index]; }
+
+    const uint8_t* Pixels() const { return m_pixels.data(); }
+    int Width() const { return m_width; }
+    int Height() const { return m_height; }
+
+    uint32_t Generation() const { return m_generation; }
+    size_t GlyphCount() const { return m_glyphs.size(); }
+    uint64_t Rasterized() const { return m_rasterized; }
+
+    // 清空所有字形（字体注册保留）
+    void Reset();
+
+private:
+    struct FontEntry
+    {
+        std::wstring face;
+        int size;
+        bool bold;
+        FontSpec spec;        // face 指向上面的 face
+        FontMetrics metrics;
+    };
+
+    bool Pack(int width, int height, int* x, int* y);
+
+    IGlyphSource& m_source;
+    int m_width;
+    int m_height;
+    std::vector<uint8_t> m_pixels;
+
+    std::vector<FontEntry> m_fonts;
+    std::vector<AtlasGlyph> m_glyphs;
+    std::unordered_map<uint64_t, uint32_t> m_lookup;  // (字体 << 32 | 码点) -> 下标
+
+    // 当前行的位置和高度
+    int m_shelfX;
+    int m_shelfY;
+    int m_shelfHeight;
+
+    uint32_t m_generation;
+    uint64_t m_rasterized;
+    GlyphImage m_scratch;
+};
@@ -0,0 +1,114 @@
+#include "input_journal.h"
+
+#include <cstdio>
+#include <cstring>
+
+void WriteVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+bool ReadVarint(const uint8_t** cursor, const uint8_t* end, uint64_t* value)
+{
+    const uint8_t* p = *cursor;
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+        if (p == end)
+            return false;
+
+        uint8_t byte = *p++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+        {
+            *cursor = p;
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+InputJournalWriter::InputJournalWriter()
+    : m_lastTimeUs(0),
+      m_eventCount(0)
+{
+    Clear();
+}
+
+void InputJournalWriter::Append(const InputEvent& event)
+{
+    // 时间不允许倒退
+    int64_t delta = event.timeUs - m_lastTimeUs;
+    if (delta < 0)
+        delta = 0;
+    m_lastTimeUs += delta;
+
+    WriteVarint(m_data, ((uint64_t)delta << 9) | ((uint64_t)event.key << 1) | (event.down ? 1 : 0));
+    ++m_eventCount;
+}
+
+void InputJournalWriter::Clear()
+{
+    m_data.assign(INPUT_JOURNAL_MAGIC, INPUT_JOURNAL_MAGIC + sizeof(INPUT_JOURNAL_MAGIC));
+    m_lastTimeUs = 0;
+    m_eventCount = 0;
+}
+
+InputJournalReader::InputJournalReader(const uint8_t* data, size_t size)
+    : m_cursor(data),
+      m_end(data + size),
+      m_timeUs(0),
+      m_valid(false)
+{
+    if (size >= sizeof(INPUT_JOURNAL_MAGIC) && memcmp(data, INPUT_JOURNAL_MAGIC, sizeof(INPUT_JOURNAL_MAGIC)) == 0)
+    {
+        m_cursor += sizeof(INPUT_JOURNAL_MAGIC);
+        m_valid = true;
+    }
+}
+
+bool InputJournalReader::Next(InputEvent* event)
+{
+    uint64_t value = 0;
+    if (!m_valid || !ReadVarint(&m_cursor, m_end, &value))
+        return false;
+
+    m_timeUs += (int64_t)(value >> 9);
+    event->timeUs = m_timeUs;
+    event->key = (uint8_t)((value >> 1) & 0xFF);
+    event->down = (value & 1) != 0;
+    return true;
+}
+
+bool SaveJournal(const char* path, const std::vector<uint8_t>& data)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    return fclose(file) == 0 && ok;
+}
+
+bool LoadJournal(const char* path, std::vector<uint8_t>* data)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return false;
+
+    data->clear();
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        data->insert(data->end(), buffer, buffer + read);
+
+    bool ok = ferror(file) == 0;
+    fclose(file);
+    return ok;
+}
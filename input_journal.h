@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一次按键事件，时间为相对于记录开始的微秒数（单调递增）
+struct InputEvent
+{
+    int64_t timeUs;
+    uint8_t key;
+    bool down;
+};
+
+// 按键日志格式：
+//   4 字节文件头 "MWJ1"
+//   每个事件一个变长整数：(与上一事件的时间差 << 9) | (键码 << 1) | 是否按下
+// 变长整数每字节 7 位有效数据，最高位表示后面还有字节
+const uint8_t INPUT_JOURNAL_MAGIC[4] = {'M', 'W', 'J', '1'};
+
+// 把 value 以变长整数追加到 out
+void WriteVarint(std::vector<uint8_t>& out, uint64_t value);
+
+// 从 [*cursor, end) 读取一个变长整数，成功时移动 cursor
+bool ReadVarint(const uint8_t** cursor, const uint8_t* end, uint64_t* value);
+
+// 按键日志写入器
+class InputJournalWriter
+{
+public:
+    InputJournalWriter();
+
+    void Append(const InputEvent& event);
+    void Clear();
+
+    const std::vector<uint8_t>& Data() const { return m_data; }
+    size_t EventCount() const { return m_eventCount; }
+
+private:
+    std::vector<uint8_t> m_data;
+    int64_t m_lastTimeUs;
+    size_t m_eventCount;
+};
+
+// 按键日志读取器
+class InputJournalReader
+{
+public:
+    InputJournalReader(const uint8_t* data, size_t size);
+
+    // 文件头是否正确
+    bool IsValid() const { return m_valid; }
+
+    // 读取下一个事件，到达末尾或数据损坏时返回 false
+    bool Next(InputEvent* event);
+
+private:
+    const uint8_t* m_cursor;
+    const uint8_t* m_end;
+    int64_t m_timeUs;
+    bool m_valid;
+};
+
+// 读写日志文件
+bool SaveJournal(const char* path, const std::vector<uint8_t>& data);
+bool LoadJournal(const char* path, std::vector<uint8_t>* data);
@@ -0,0 +1,275 @@
+#include "key_bindings.h"
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// 编译期检查：生成的掩码与声明的绑定一一对应
+constexpr bool MasksMatchBindings(const KeyBinding* bindings, size_t count)
+{
+    int total = 0;
+    for (int action = 0; action < ACTION_COUNT; ++action)
+    {
+        KeyMask mask = MakeActionMask(bindings, count, (KeyAction)action);
+        total += mask.Count();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (mask.Test(bindings[i].key) != (bindings[i].action == action))
+                return false;
+        }
+    }
+    // 掩码里没有多余的键（默认绑定中每个键只出现一次）
+    return total == (int)count;
+}
+
+static_assert(MasksMatchBindings(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT), "default key masks do not match the bindings");
+static_assert(MakeActionMask(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT, ACTION_UP).Test('W') &&
+              MakeActionMask(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT, ACTION_UP).Test(KEY_UP) &&
+              !MakeActionMask(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT, ACTION_UP).Test('w'),
+              "W and the up arrow move up");
+static_assert(MakeActionMask(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT, ACTION_RESET).Test(KEY_SPACE), "space resets");
+static_assert(MakeActionMask(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT, ACTION_CANCEL_RESET).Test(KEY_ESCAPE), "escape cancels the reset");
+
+// 方向查找表
+static_assert(DIRECTION_TABLE.entries[0].dx == 0 && DIRECTION_TABLE.entries[0].dy == 0, "no key, no motion");
+static_assert(DIRECTION_TABLE.entries[1 << ACTION_UP].dy == -1 && DIRECTION_TABLE.entries[1 << ACTION_UP].dx == 0, "up");
+static_assert(DIRECTION_TABLE.entries[1 << ACTION_DOWN].dy == 1, "down");
+static_assert(DIRECTION_TABLE.entries[1 << ACTION_LEFT].dx == -1, "left");
+static_assert(DIRECTION_TABLE.entries[1 << ACTION_RIGHT].dx == 1, "right");
+static_assert(DIRECTION_TABLE.entries[(1 << ACTION_UP) | (1 << ACTION_RIGHT)].dx == 1 &&
+              DIRECTION_TABLE.entries[(1 << ACTION_UP) | (1 << ACTION_RIGHT)].dy == -1, "diagonal");
+static_assert(DIRECTION_TABLE.entries[(1 << ACTION_UP) | (1 << ACTION_DOWN)].dy == 0 &&
+              DIRECTION_TABLE.entries[(1 << ACTION_LEFT) | (1 << ACTION_RIGHT)].dx == 0, "opposite keys cancel");
+static_assert(DIRECTION_TABLE.entries[15].dx == 0 && DIRECTION_TABLE.entries[15].dy == 0, "all four keys cancel");
+
+KeyActionMap::KeyActionMap()
+    : m_slots(1, Slot{EMPTY_SLOT, (uint8_t)ACTION_NONE}),
+      m_multiplier(0),
+      m_shift(31)
+{
+}
+
+bool KeyActionMap::TryBuild(const std::vector<KeyBinding>& unique, int bits, uint32_t multiplier)
+{
+    int shift = 32 - bits;
+    std::vector<Slot> slots((size_t)1 << bits, Slot{EMPTY_SLOT, (uint8_t)ACTION_NONE});
+    for (const KeyBinding& binding : unique)
+    {
+        Slot& slot = slots[(uint32_t)(binding.key * multiplier) >> shift];
+        if (slot.key != EMPTY_SLOT)
+            return false;
+        slot.key = (uint16_t)binding.key;
+        slot.action = (uint8_t)binding.action;
+    }
+
+    m_slots.swap(slots);
+    m_multiplier = multiplier;
+    m_shift = shift;
+    return true;
+}
+
+// 去掉无效的绑定和重复的键，后面的绑定覆盖前面的
+static std::vector<KeyBinding> UniqueBindings(const KeyBinding* bindings, size_t count)
+{
+    std::vector<KeyBinding> unique;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (bindings[i].key >= 256 || bindings[i].action >= ACTION_COUNT)
+            continue;
+
+        bool replaced = false;
+        for (KeyBinding& existing : unique)
+        {
+            if (existing.key == bindings[i].key)
+            {
+                existing.action = bindings[i].action;
+                replaced = true;
+            }
+        }
+        if (!replaced)
+            unique.push_back(bindings[i]);
+    }
+    return unique;
+}
+
+void KeyActionMap::Build(const KeyBinding* bindings, size_t count)
+{
+    std::vector<KeyBinding> unique = UniqueBindings(bindings, count);
+
+    // 表的大小至少是键数的两倍，找不到乘数时再加倍
+    int bits = 1;
+    while (((size_t)1 << bits) < unique.size() * 2)
+        ++bits;
+
+    for (; bits <= 16; ++bits)
+    {
+        uint32_t multiplier = 0x9E3779B1u;
+        for (int attempt = 0; attempt < 256; ++attempt)
+        {
+            if (TryBuild(unique, bits, multiplier | 1))
+                return;
+            multiplier = multiplier * 1664525u + 1013904223u;
+        }
+
+        // 表不小于 256 项时，取低位的乘数就是键码本身，一定没有冲突
+        if (bits >= 8 && TryBuild(unique, bits, 1u << (32 - bits)))
+            return;
+    }
+}
+
+KeyBindings::KeyBindings()
+{
+    Assign(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDING_COUNT);
+}
+
+KeyBindings::KeyBindings(const KeyBinding* bindings, size_t count)
+{
+    Assign(bindings, count);
+}
+
+void KeyBindings::Assign(const KeyBinding* bindings, size_t count)
+{
+    // 一个键只对应一个动作，掩码和查找表保持一致
+    m_bindings = UniqueBindings(bindings, count);
+    for (int action = 0; action < ACTION_COUNT; ++action)
+        m_masks[action] = MakeActionMask(m_bindings.data(), m_bindings.size(), (KeyAction)action);
+
+    m_directionMask = EMPTY_KEY_MASK;
+    for (int action = 0; action < DIRECTION_ACTION_COUNT; ++action)
+    {
+        for (int i = 0; i < 4; ++i)
+            m_directionMask.words[i] |= m_masks[action].words[i];
+    }
+
+    m_map.Build(m_bindings.data(), m_bindings.size());
+}
+
+static const char* const ACTION_NAMES[ACTION_COUNT] = {"up", "down", "left", "right", "reset", "cancel", "undo", "rewind"};
+
+const char* KeyActionName(KeyAction action)
+{
+    return action < ACTION_COUNT ? ACTION_NAMES[action] : "none";
+}
+
+// 不区分大小写比较
+static bool SameName(const char* a, const char* b)
+{
+    for (; *a && *b; ++a, ++b)
+    {
+        if (toupper((unsigned char)*a) != toupper((unsigned char)*b))
+            return false;
+    }
+    return *a == *b;
+}
+
+static bool ParseAction(const char* token, KeyAction* action)
+{
+    for (int i = 0; i < ACTION_COUNT; ++i)
+    {
+        if (SameName(token, ACTION_NAMES[i]))
+        {
+            *action = (KeyAction)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool ParseKey(const char* token, unsigned* key)
+{
+    static const struct
+    {
+        const char* name;
+        unsigned key;
+    } NAMED_KEYS[] = {
+        {"UP", KEY_UP}, {"DOWN", KEY_DOWN}, {"LEFT", KEY_LEFT}, {"RIGHT", KEY_RIGHT},
+        {"SPACE", KEY_SPACE}, {"ESCAPE", KEY_ESCAPE}, {"ESC", KEY_ESCAPE},
+        {"BACKSPACE", KEY_BACK}, {"BACK", KEY_BACK},
+    };
+
+    // 单个字母或数字：虚拟键码就是大写字符
+    if (token[0] && !token[1] && isalnum((unsigned char)token[0]))
+    {
+        *key = (unsigned)toupper((unsigned char)token[0]);
+        return true;
+    }
+
+    for (size_t i = 0; i < sizeof(NAMED_KEYS) / sizeof(NAMED_KEYS[0]); ++i)
+    {
+        if (SameName(token, NAMED_KEYS[i].name))
+        {
+            *key = NAMED_KEYS[i].key;
+            return true;
+        }
+    }
+
+    if (token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+    {
+        char* end = nullptr;
+        unsigned long value = strtoul(token + 2, &end, 16);
+        if (end != token + 2 && *end == 0 && value > 0 && value < 256)
+        {
+            *key = (unsigned)value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LoadKeyBindings(const char* path, KeyBindings* bindings)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    std::vector<KeyBinding> loaded;
+    bool mentioned[ACTION_COUNT] = {};
+    bool ok = true;
+
+    char line[256];
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        char* comment = strchr(line, '#');
+        if (comment)
+            *comment = 0;
+
+        KeyAction action = ACTION_NONE;
+        bool first = true;
+        for (char* token = strtok(line, " \t\r\n"); token; token = strtok(nullptr, " \t\r\n"))
+        {
+            if (first)
+            {
+                ok = ParseAction(token, &action);
+                first = false;
+            }
+            else
+            {
+                unsigned key;
+                ok = ParseKey(token, &key);
+                if (ok)
+                    loaded.push_back(KeyBinding{key, action});
+            }
+            if (!ok)
+                break;
+        }
+        if (ok && action != ACTION_NONE)
+            mentioned[action] = true;
+    }
+    ok = ok && ferror(file) == 0;
+    fclose(file);
+    if (!ok)
+        return false;
+
+    // 文件里没有出现的动作保留原来的绑定
+    std::vector<KeyBinding> merged;
+    for (const KeyBinding& binding : bindings->Bindings())
+    {
+        if (!mentioned[binding.action])
+            merged.push_back(binding);
+    }
+    merged.insert(merged.end(), loaded.begin(), loaded.end());
+
+    bindings->Assign(merged.data(), merged.size());
+    return true;
+}
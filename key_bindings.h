@@ -0,0 +1,217 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 虚拟键码（与 Win32 的 VK_* 取值一致）
+const unsigned KEY_BACK = 0x08;
+const unsigned KEY_ESCAPE = 0x1B;
+const unsigned KEY_SPACE = 0x20;
+const unsigned KEY_LEFT = 0x25;
+const unsigned KEY_UP = 0x26;
+const unsigned KEY_RIGHT = 0x27;
+const unsigned KEY_DOWN = 0x28;
+
+// 按键触发的动作，前四个是方向，顺序与方向查找表的位一致
+enum KeyAction
+{
+    ACTION_UP,
+    ACTION_DOWN,
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_RESET,          // 立即回到屏幕中央
+    ACTION_CANCEL_RESET,   // 取消自动重置标记
+    ACTION_UNDO_RESET,     // 回到上一次重置之前的位置
+    ACTION_REWIND,         // 沿移动历史后退一步
+    ACTION_COUNT,
+    ACTION_NONE = ACTION_COUNT
+};
+
+const int DIRECTION_ACTION_COUNT = 4;
+
+struct KeyBinding
+{
+    unsigned key;
+    KeyAction action;
+};
+
+// 默认绑定：WASD、方向键、空格、ESC，Z 撤销重置，退格键后退
+// 字母的虚拟键码就是大写字母，小写字母不会出现在 WM_KEYDOWN 里
+constexpr KeyBinding DEFAULT_KEY_BINDINGS[] = {
+    {'W', ACTION_UP},      {KEY_UP, ACTION_UP},
+    {'S', ACTION_DOWN},    {KEY_DOWN, ACTION_DOWN},
+    {'A', ACTION_LEFT},    {KEY_LEFT, ACTION_LEFT},
+    {'D', ACTION_RIGHT},   {KEY_RIGHT, ACTION_RIGHT},
+    {KEY_SPACE, ACTION_RESET},
+    {KEY_ESCAPE, ACTION_CANCEL_RESET},
+    {'Z', ACTION_UNDO_RESET},
+    {KEY_BACK, ACTION_REWIND},
+};
+
+const size_t DEFAULT_KEY_BINDING_COUNT = sizeof(DEFAULT_KEY_BINDINGS) / sizeof(DEFAULT_KEY_BINDINGS[0]);
+
+// 256 个虚拟键各占一位
+struct KeyMask
+{
+    uint64_t words[4];
+
+    constexpr bool Test(unsigned key) const
+    {
+        return key < 256 && ((words[key >> 6] >> (key & 63)) & 1) != 0;
+    }
+
+    constexpr bool Intersects(const KeyMask& other) const
+    {
+        return ((words[0] & other.words[0]) | (words[1] & other.words[1]) |
+                (words[2] & other.words[2]) | (words[3] & other.words[3])) != 0;
+    }
+
+    constexpr bool Any() const { return (words[0] | words[1] | words[2] | words[3]) != 0; }
+
+    constexpr int Count() const
+    {
+        int count = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            for (uint64_t word = words[i]; word; word &= word - 1)
+                ++count;
+        }
+        return count;
+    }
+
+    void Set(unsigned key, bool down)
+    {
+        if (key >= 256) return;
+        uint64_t bit = uint64_t(1) << (key & 63);
+        if (down)
+            words[key >> 6] |= bit;
+        else
+            words[key >> 6] &= ~bit;
+    }
+
+    void Clear() { words[0] = words[1] = words[2] = words[3] = 0; }
+};
+
+constexpr KeyMask EMPTY_KEY_MASK = {{0, 0, 0, 0}};
+
+// 绑定到 action 的所有键
+constexpr KeyMask MakeActionMask(const KeyBinding* bindings, size_t count, KeyAction action)
+{
+    KeyMask mask = EMPTY_KEY_MASK;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (bindings[i].action == action && bindings[i].key < 256)
+            mask.words[bindings[i].key >> 6] |= uint64_t(1) << (bindings[i].key & 63);
+    }
+    return mask;
+}
+
+// 按住的方向：四位（上、下、左、右）对应一个单位方向，相反的方向互相抵消
+struct DirectionVector
+{
+    int dx;
+    int dy;
+};
+
+struct DirectionTable
+{
+    DirectionVector entries[1 << DIRECTION_ACTION_COUNT];
+};
+
+constexpr DirectionTable MakeDirectionTable()
+{
+    DirectionTable table = {};
+    for (unsigned bits = 0; bits < (1u << DIRECTION_ACTION_COUNT); ++bits)
+    {
+        table.entries[bits].dx = (int)((bits >> ACTION_RIGHT) & 1) - (int)((bits >> ACTION_LEFT) & 1);
+        table.entries[bits].dy = (int)((bits >> ACTION_DOWN) & 1) - (int)((bits >> ACTION_UP) & 1);
+    }
+    return table;
+}
+
+constexpr DirectionTable DIRECTION_TABLE = MakeDirectionTable();
+
+// 键码到动作的完美哈希表：(key * multiplier) 的高位作为下标，绑定的键互不冲突
+// 表在加载绑定时构建一次，查找只需一次乘法和一次比较
+class KeyActionMap
+{
+public:
+    KeyActionMap();
+
+    // 为 bindings 中的键寻找没有冲突的乘数，同一个键绑定多次时以最后一次为准
+    void Build(const KeyBinding* bindings, size_t count);
+
+    KeyAction Find(unsigned key) const
+    {
+        const Slot& slot = m_slots[(uint32_t)(key * m_multiplier) >> m_shift];
+        return slot.key == key ? (KeyAction)slot.action : ACTION_NONE;
+    }
+
+    size_t TableSize() const { return m_slots.size(); }
+
+private:
+    struct Slot
+    {
+        uint16_t key;      // EMPTY_SLOT 表示空
+        uint8_t action;
+    };
+
+    static const uint16_t EMPTY_SLOT = 0xFFFF;
+
+    bool TryBuild(const std::vector<KeyBinding>& unique, int bits, uint32_t multiplier);
+
+    std::vector<Slot> m_slots;
+    uint32_t m_multiplier;
+    int m_shift;
+};
+
+// 一组按键绑定：每个动作的键掩码和键码到动作的查找表
+class KeyBindings
+{
+public:
+    // 默认绑定
+    KeyBindings();
+    KeyBindings(const KeyBinding* bindings, size_t count);
+
+    // 替换全部绑定，同一个键绑定多次时以最后一次为准
+    void Assign(const KeyBinding* bindings, size_t count);
+
+    KeyAction ActionOf(unsigned key) const { return m_map.Find(key); }
+    const KeyMask& Mask(KeyAction action) const { return m_masks[action]; }
+    const std::vector<KeyBinding>& Bindings() const { return m_bindings; }
+
+    // 绑定到 action 的键是否有任何一个按下
+    bool IsHeld(const KeyMask& held, KeyAction action) const { return held.Intersects(m_masks[action]); }
+
+    // 按下的方向键的组合，每个方向一位
+    unsigned DirectionBits(const KeyMask& held) const
+    {
+        return (unsigned)held.Intersects(m_masks[ACTION_UP]) << ACTION_UP |
+               (unsigned)held.Intersects(m_masks[ACTION_DOWN]) << ACTION_DOWN |
+               (unsigned)held.Intersects(m_masks[ACTION_LEFT]) << ACTION_LEFT |
+               (unsigned)held.Intersects(m_masks[ACTION_RIGHT]) << ACTION_RIGHT;
+    }
+
+    DirectionVector Direction(const KeyMask& held) const { return DIRECTION_TABLE.entries[DirectionBits(held)]; }
+
+    bool AnyDirectionHeld(const KeyMask& held) const { return held.Intersects(m_directionMask); }
+
+private:
+    std::vector<KeyBinding> m_bindings;
+    KeyMask m_masks[ACTION_COUNT];
+    KeyMask m_directionMask;   // 所有方向键
+    KeyActionMap m_map;
+};
+
+// 动作的名字（up、down、left、right、reset、cancel）
+const char* KeyActionName(KeyAction action);
+
+// 读取按键绑定文件，每行一个动作和若干个键：
+//   # 注释
+//   up W I UP
+//   reset SPACE 0x52
+// 键可以是字母或数字（大小写相同）、UP/DOWN/LEFT/RIGHT/SPACE/ESCAPE，或 0x 开头的十六进制虚拟键码。
+// 文件中出现的动作替换默认绑定，没出现的动作保留默认绑定。
+// 文件不存在或格式错误时返回 false，*bindings 不变。
+bool LoadKeyBindings(const char* path, KeyBindings* bindings);
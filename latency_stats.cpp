@@ -0,0 +1,208 @@
+#include "latency_stats.h"
+
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cwchar>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// 最高位的位置，value 不为 0
+static int HighestBit(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (int)index;
+#elif defined(__GNUC__)
+    return 63 - __builtin_clzll(value);
+#else
+    int index = 0;
+    while (value >>= 1)
+        ++index;
+    return index;
+#endif
+}
+
+const char* LatencyMetricName(LatencyMetric metric)
+{
+    switch (metric)
+    {
+    case LATENCY_PAINT:          return "paint";
+    case LATENCY_MOVEMENT:       return "movement";
+    case LATENCY_SET_WINDOW_POS: return "set_window_pos";
+    case LATENCY_TIMER_JITTER:   return "timer_jitter";
+    case LATENCY_KEY_TO_MOVE:    return "key_to_move";
+    case LATENCY_COMMAND_APPLY:  return "command_apply";
+    case LATENCY_RENDER:         return "render";
+    default:                     return "unknown";
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+    : m_count(0),
+      m_sum(0),
+      m_max(0)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+        m_counts[i].store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+    Bump(m_counts[BucketIndex(value)], 1);
+    Bump(m_count, 1);
+    Bump(m_sum, value);
+    if (value > m_max.load(std::memory_order_relaxed))
+        m_max.store(value, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::BucketIndex(uint64_t value)
+{
+    if (value < (uint64_t)SUB_BUCKETS)
+        return (int)value;
+
+    int msb = HighestBit(value);
+    int sub = (int)((value >> (msb - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    return (msb - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(int index)
+{
+    if (index < SUB_BUCKETS)
+        return (uint64_t)index;
+
+    int msb = index / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+    uint64_t sub = (uint64_t)(index % SUB_BUCKETS);
+    return (SUB_BUCKETS + sub) << (msb - SUB_BUCKET_BITS);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(int index)
+{
+    return index + 1 < BUCKET_COUNT ? BucketLowerBound(index + 1) - 1 : UINT64_MAX;
+}
+
+void LatencySnapshot::Clear()
+{
+    std::fill(counts, counts + LatencyHistogram::BUCKET_COUNT, 0);
+    count = sum = max = 0;
+}
+
+void LatencySnapshot::Merge(const LatencyHistogram& histogram)
+{
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+        counts[i] += histogram.BucketCount(i);
+    count += histogram.Count();
+    sum += histogram.Sum();
+    max = std::max(max, histogram.Max());
+}
+
+uint64_t LatencySnapshot::Percentile(double p) const
+{
+    // 并发写入时 count 可能与各桶之和略有出入，以桶的和为准
+    uint64_t total = 0;
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+        total += counts[i];
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(std::min(std::max(p, 0.0), 100.0) / 100.0 * total + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return std::min(LatencyHistogram::BucketUpperBound(i), max);
+    }
+    return max;
+}
+
+// 每个线程一组直方图，挂在只增不减的链表上
+struct ThreadLatency
+{
+    LatencyHistogram metrics[LATENCY_METRIC_COUNT];
+    ThreadLatency* next;
+};
+
+static std::atomic<ThreadLatency*> g_latencyThreads(nullptr);
+
+static ThreadLatency& CurrentThreadLatency()
+{
+    thread_local ThreadLatency* local = nullptr;
+    if (!local)
+    {
+        local = new ThreadLatency();
+        local->next = g_latencyThreads.load(std::memory_order_relaxed);
+        while (!g_latencyThreads.compare_exchange_weak(local->next, local, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+    }
+    return *local;
+}
+
+void RecordLatency(LatencyMetric metric, uint64_t nanoseconds)
+{
+    CurrentThreadLatency().metrics[metric].Record(nanoseconds);
+}
+
+void SnapshotLatency(LatencyMetric metric, LatencySnapshot* snapshot)
+{
+    snapshot->Clear();
+    for (ThreadLatency* thread = g_latencyThreads.load(std::memory_order_acquire); thread; thread = thread->next)
+        snapshot->Merge(thread->metrics[metric]);
+}
+
+bool DumpLatencyReport(const char* path)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+        return false;
+
+    LatencySnapshot* snapshot = new LatencySnapshot();
+    for (int metric = 0; metric < LATENCY_METRIC_COUNT; ++metric)
+    {
+        SnapshotLatency((LatencyMetric)metric, snapshot);
+        fprintf(file, "%s count=%llu mean_us=%.3f p50_us=%.3f p90_us=%.3f p99_us=%.3f p999_us=%.3f max_us=%.3f\n",
+                LatencyMetricName((LatencyMetric)metric), (unsigned long long)snapshot->count,
+                snapshot->Mean() / 1000.0, snapshot->Percentile(50) / 1000.0, snapshot->Percentile(90) / 1000.0,
+                snapshot->Percentile(99) / 1000.0, snapshot->Percentile(99.9) / 1000.0, snapshot->max / 1000.0);
+
+        // 非空的桶：下界 上界 计数（纳秒）
+        for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+        {
+            if (snapshot->counts[i])
+            {
+                fprintf(file, "  %llu %llu %llu\n", (unsigned long long)LatencyHistogram::BucketLowerBound(i),
+                        (unsigned long long)LatencyHistogram::BucketUpperBound(i), (unsigned long long)snapshot->counts[i]);
+            }
+        }
+    }
+    delete snapshot;
+
+    return fclose(file) == 0;
+}
+
+void FormatLatencyOverlay(wchar_t* text, size_t size, FrameArena& scratch)
+{
+    static const LatencyMetric SHOWN[] = {LATENCY_PAINT, LATENCY_TIMER_JITTER, LATENCY_KEY_TO_MOVE};
+    static const wchar_t* const LABELS[] = {L"paint", L"jitter", L"key>move"};
+
+    // 快照有几 KB，放在帧分配器里，不占栈也不经过堆
+    LatencySnapshot* snapshot = scratch.New<LatencySnapshot>();
+    int prefix = swprintf(text, size, L"p50/p99/max ms  ");
+    size_t used = prefix > 0 ? (size_t)prefix : 0;
+    for (size_t i = 0; i < sizeof(SHOWN) / sizeof(SHOWN[0]) && used < size; ++i)
+    {
+        SnapshotLatency(SHOWN[i], snapshot);
+        int written = swprintf(text + used, size - used, L"%ls%ls %.2f/%.2f/%.2f", i ? L" | " : L"", LABELS[i],
+                               snapshot->Percentile(50) / 1e6, snapshot->Percentile(99) / 1e6, snapshot->max / 1e6);
+        if (written < 0)
+            break;
+        used += (size_t)written;
+    }
+}
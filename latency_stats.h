@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+class FrameArena;
+
+// 统计的热路径
+enum LatencyMetric
+{
+    LATENCY_PAINT,            // WM_PAINT 处理耗时
+    LATENCY_MOVEMENT,         // UpdateWindowMovement 耗时
+    LATENCY_SET_WINDOW_POS,   // SetWindowPos 调用耗时
+    LATENCY_TIMER_JITTER,     // 定时器到达时刻与截止时间之差
+    LATENCY_KEY_TO_MOVE,      // 按键按下到窗口第一次移动
+    LATENCY_COMMAND_APPLY,    // 外部命令发出到应用（窗口已移动）
+    LATENCY_RENDER,           // 渲染线程绘制一帧的耗时
+    LATENCY_METRIC_COUNT
+};
+
+const char* LatencyMetricName(LatencyMetric metric);
+
+// 对数线性直方图（纳秒）：小于 16 的值各占一格，之后每个 2 的幂区间再线性分成 16 格，
+// 相对误差不超过 1/16。只由所属线程写入，其他线程可以随时并发读取。
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    LatencyHistogram();
+
+    void Record(uint64_t value);
+
+    static int BucketIndex(uint64_t value);
+    static uint64_t BucketLowerBound(int index);
+    static uint64_t BucketUpperBound(int index);
+
+    uint64_t BucketCount(int index) const { return m_counts[index].load(std::memory_order_relaxed); }
+    uint64_t Count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t Sum() const { return m_sum.load(std::memory_order_relaxed); }
+    uint64_t Max() const { return m_max.load(std::memory_order_relaxed); }
+
+private:
+    // 单写者，不需要读改写指令，用 relaxed 的读和写即可
+    static void Bump(std::atomic<uint64_t>& value, uint64_t delta)
+    {
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::atomic<uint64_t> m_counts[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
+
+// 合并后的普通快照，用来计算百分位
+struct LatencySnapshot
+{
+    uint64_t counts[LatencyHistogram::BUCKET_COUNT];
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+
+    void Clear();
+    void Merge(const LatencyHistogram& histogram);
+
+    // 第 p 百分位（0-100）所在桶的上界，不超过最大值
+    uint64_t Percentile(double p) const;
+    double Mean() const { return count ? (double)sum / count : 0.0; }
+};
+
+// 记录到当前线程的直方图（每个线程第一次记录时分配，线程退出后保留以便汇总）
+void RecordLatency(LatencyMetric metric, uint64_t nanoseconds);
+
+// 合并所有线程的直方图
+void SnapshotLatency(LatencyMetric metric, LatencySnapshot* snapshot);
+
+// 把所有指标的汇总和非空的桶写入文本文件
+bool DumpLatencyReport(const char* path);
+
+// 面板上显示的一行摘要（p50/p99/max，毫秒），临时数据从 scratch 分配
+void FormatLatencyOverlay(wchar_t* text, size_t size, FrameArena& scratch);
+
+inline uint64_t LatencyNow()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 统计作用域的耗时
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyMetric metric) : m_metric(metric), m_start(LatencyNow()) {}
+    ~ScopedLatency() { RecordLatency(m_metric, LatencyNow() - m_start); }
+
+private:
+    ScopedLatency(const ScopedLatency&);
+    ScopedLatency& operator=(const ScopedLatency&);
+
+    LatencyMetric m_metric;
+    uint64_t m_start;
+};
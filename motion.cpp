@@ -0,0 +1,162 @@
+#include "motion.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 1/√2 的 16.16 定点表示，用于斜向速度归一化
+static const Fixed FIXED_INV_SQRT2 = 46341;
+
+MotionEngine::MotionEngine(const MotionParams& params)
+    : m_params(params),
+      m_stepDuration(std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(1000000000LL / params.stepHz))),
+      m_maxSpeedPerAxis(ToFixed(params.maxSpeed)),
+      m_maxSpeedDiagonal((ToFixed(params.maxSpeed) * FIXED_INV_SQRT2) >> FIXED_SHIFT),
+      m_accelPerStep(ToFixed(params.acceleration) / params.stepHz),
+      m_frictionPerStep(ToFixed(params.friction) / params.stepHz),
+      m_lastTime(),
+      m_accumulator(0),
+      m_velX(0), m_velY(0),
+      m_subX(0), m_subY(0),
+      m_dirX(0), m_dirY(0),
+      m_inputX(0), m_inputY(0),
+      m_inputMark(0)
+{
+}
+
+void MotionEngine::Reset(Clock::time_point now)
+{
+    m_lastTime = now;
+    m_accumulator = Clock::duration(0);
+    Stop();
+}
+
+void MotionEngine::Stop()
+{
+    m_velX = m_velY = 0;
+    m_subX = m_subY = 0;
+    ClearInput();
+}
+
+void MotionEngine::ClearInput()
+{
+    m_inputX = m_inputY = 0;
+    m_inputMark = Clock::duration(0);
+}
+
+void MotionEngine::SetDirection(int dirX, int dirY)
+{
+    dirX = (dirX > 0) - (dirX < 0);
+    dirY = (dirY > 0) - (dirY < 0);
+    if (dirX == m_dirX && dirY == m_dirY)
+        return;
+
+    // 记下旧方向在当前步内已经持续的时间
+    int64_t held = std::chrono::duration_cast<std::chrono::nanoseconds>(m_accumulator - m_inputMark).count();
+    m_inputX += m_dirX * held;
+    m_inputY += m_dirY * held;
+    m_inputMark = m_accumulator;
+
+    m_dirX = dirX;
+    m_dirY = dirY;
+}
+
+bool MotionEngine::IsMoving() const
+{
+    return m_velX != 0 || m_velY != 0 || m_dirX != 0 || m_dirY != 0 || m_inputX != 0 || m_inputY != 0;
+}
+
+MotionDelta MotionEngine::Advance(Clock::time_point now)
+{
+    MotionDelta total = {0, 0};
+    if (now <= m_lastTime)
+        return total;
+
+    Clock::duration elapsed = now - m_lastTime;
+    m_lastTime = now;
+
+    // 静止时不累积时间，避免下次按键时补算一大段
+    if (!IsMoving())
+    {
+        m_accumulator = Clock::duration(0);
+        ClearInput();
+        return total;
+    }
+
+    m_accumulator += elapsed;
+    Clock::duration maxCatchUp = std::chrono::milliseconds(m_params.maxCatchUpMs);
+    if (m_accumulator > maxCatchUp)
+        m_accumulator = maxCatchUp;
+    if (m_inputMark > m_accumulator)
+        m_inputMark = m_accumulator;
+
+    while (m_accumulator >= m_stepDuration)
+    {
+        m_accumulator -= m_stepDuration;
+        MotionDelta delta = Step();
+        total.dx += delta.dx;
+        total.dy += delta.dy;
+    }
+
+    return total;
+}
+
+MotionDelta MotionEngine::Step()
+{
+    Fixed targetX, targetY;
+    bool activeX, activeY;
+
+    if (m_inputX == 0 && m_inputY == 0)
+    {
+        // 整步都是同一个方向：斜向时每个轴除以 √2，保证合速度一致
+        Fixed axisSpeed = (m_dirX != 0 && m_dirY != 0) ? m_maxSpeedDiagonal : m_maxSpeedPerAxis;
+        targetX = m_dirX * axisSpeed;
+        targetY = m_dirY * axisSpeed;
+        activeX = m_dirX != 0;
+        activeY = m_dirY != 0;
+    }
+    else
+    {
+        // 步内方向变化过：按每个方向实际持续的时间加权
+        int64_t stepNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_stepDuration).count();
+        int64_t restNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_stepDuration - m_inputMark).count();
+        double fx = double(m_inputX + m_dirX * restNs) / stepNs;
+        double fy = double(m_inputY + m_dirY * restNs) / stepNs;
+
+        // 合成的输入超过单位长度时归一化
+        double length = std::sqrt(fx * fx + fy * fy);
+        if (length > 1.0)
+        {
+            fx /= length;
+            fy /= length;
+        }
+
+        targetX = Fixed(fx * m_maxSpeedPerAxis);
+        targetY = Fixed(fy * m_maxSpeedPerAxis);
+        activeX = targetX != 0;
+        activeY = targetY != 0;
+    }
+    ClearInput();
+
+    m_velX = Approach(m_velX, targetX, activeX ? m_accelPerStep : m_frictionPerStep);
+    m_velY = Approach(m_velY, targetY, activeY ? m_accelPerStep : m_frictionPerStep);
+
+    // 累积亚像素位移，只输出整像素部分
+    m_subX += m_velX / m_params.stepHz;
+    m_subY += m_velY / m_params.stepHz;
+
+    MotionDelta delta;
+    delta.dx = (int)(m_subX / FIXED_ONE);
+    delta.dy = (int)(m_subY / FIXED_ONE);
+    m_subX -= Fixed(delta.dx) * FIXED_ONE;
+    m_subY -= Fixed(delta.dy) * FIXED_ONE;
+    return delta;
+}
+
+Fixed MotionEngine::Approach(Fixed current, Fixed target, Fixed maxDelta)
+{
+    if (current < target)
+        return std::min(current + maxDelta, target);
+    if (current > target)
+        return std::max(current - maxDelta, target);
+    return current;
+}
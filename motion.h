@@ -0,0 +1,88 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// 定点数：16.16 格式，用于亚像素累积
+typedef int64_t Fixed;
+const int FIXED_SHIFT = 16;
+const Fixed FIXED_ONE = Fixed(1) << FIXED_SHIFT;
+
+inline Fixed ToFixed(int value) { return Fixed(value) * FIXED_ONE; }
+
+// 运动参数（单位：像素/秒，像素/秒²）
+struct MotionParams
+{
+    int stepHz;           // 固定步长频率
+    int maxSpeed;         // 最大速度
+    int acceleration;     // 按键按下时的加速度
+    int friction;         // 按键松开后的减速度
+    int maxCatchUpMs;     // 单次最多补算的时间，防止卡顿后瞬移
+};
+
+// 默认参数：最大速度 100 像素/秒，与原来的 50ms 移动 5 像素一致
+inline MotionParams DefaultMotionParams()
+{
+    return MotionParams{120, 100, 2000, 2000, 250};
+}
+
+// 一次推进后得到的整像素位移
+struct MotionDelta
+{
+    int dx;
+    int dy;
+};
+
+// 固定步长运动积分器
+// 由墙钟时间驱动，与定时器的抖动无关；同样的时间序列总是得到同样的结果
+class MotionEngine
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit MotionEngine(const MotionParams& params = DefaultMotionParams());
+
+    // 以 now 作为时间起点，清空速度和亚像素余量
+    void Reset(Clock::time_point now);
+
+    // 清空速度和亚像素余量，保留时间基准
+    void Stop();
+
+    // 设置移动方向，每个分量取 -1、0、1
+    // 方向在上一次 Advance 的时刻生效，当前步内旧方向已持续的时间会被记入，
+    // 所以两个步长之间按下又松开的短按也能产生位移
+    void SetDirection(int dirX, int dirY);
+
+    // 推进到 now，返回这段时间内累积出的整像素位移
+    MotionDelta Advance(Clock::time_point now);
+
+    // 执行一个固定步长，返回整像素位移（供确定性测试和基准使用）
+    MotionDelta Step();
+
+    bool IsMoving() const;
+
+    Fixed VelocityX() const { return m_velX; }
+    Fixed VelocityY() const { return m_velY; }
+    const MotionParams& Params() const { return m_params; }
+
+private:
+    static Fixed Approach(Fixed current, Fixed target, Fixed maxDelta);
+    void ClearInput();
+
+    MotionParams m_params;
+    Clock::duration m_stepDuration;
+    Fixed m_maxSpeedPerAxis;     // 单轴移动的目标速度
+    Fixed m_maxSpeedDiagonal;    // 斜向移动时每个轴的目标速度（已除以 √2）
+    Fixed m_accelPerStep;
+    Fixed m_frictionPerStep;
+
+    Clock::time_point m_lastTime;
+    Clock::duration m_accumulator;
+    Fixed m_velX, m_velY;        // 当前速度（定点，像素/秒）
+    Fixed m_subX, m_subY;        // 亚像素余量（定点，像素）
+    int m_dirX, m_dirY;
+
+    // 当前步内方向变化之前的按键积分（方向 × 纳秒）
+    int64_t m_inputX, m_inputY;
+    Clock::duration m_inputMark;  // 当前步内最后一次方向变化的位置
+};
@@ -5,53 +5,116 @@
 #include <thread>
 #include <vector>
 #include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include "back_buffer.h"
+#include "command_channel.h"
+#include "control_panel.h"
+#include "display_layout.h"
+#include "frame_arena.h"
+#include "gdi_backend.h"
+#include "input_journal.h"
+#include "key_bindings.h"
+#include "latency_stats.h"
+#include "position_feed.h"
+#include "render_thread.h"
+#include "resource_cache.h"
+#include "scene.h"
+#include "scheduler.h"
+#include "state_file.h"
+#include "trajectory.h"
+#include "window_controller.h"
+
+// Win32 宿主：把控制器的请求转换为窗口操作
+class Win32WindowHost : public IWindowHost
+{
+public:
+    const DisplayLayout& Displays() const override;
+    void MoveWindows(const WindowMove* moves, size_t count) override;
+    void InvalidatePanel() override;
+};
 
 // 全局变量
 HWND g_hWnd = nullptr;
-POINT g_windowPos = {0, 0};  // 当前窗口位置
-SIZE g_windowSize = {0, 0};  // 窗口大小
-bool g_hasMoved = false;     // 标记是否移动过
-std::chrono::steady_clock::time_point g_lastMoveTime;  // 最后一次移动的时间
-bool g_resetTriggered = false;  // 标记是否触发重置
-
-// 按键状态跟踪
-bool g_keyStates[256] = {false};
-
-// 颜色定义
-const COLORREF BG_COLOR = RGB(45, 45, 48);      // 深灰色背景
-const COLORREF TEXT_COLOR = RGB(241, 241, 241);  // 浅灰色文字
-const COLORREF ACCENT_COLOR = RGB(0, 122, 204);  // 蓝色强调色
-const COLORREF KEY_COLOR = RGB(86, 156, 214);    // 按键颜色
-const COLORREF WARNING_COLOR = RGB(255, 153, 0); // 警告橙色
-const COLORREF BORDER_COLOR = RGB(62, 62, 66);   // 边框颜色
+
+// 截止时间调度器，所有定时事件共用一个按需设置的定时器
+const UINT_PTR SCHEDULER_TIMER_ID = 1;
+SteadyClock g_clock;
+EventScheduler g_scheduler(g_clock);
+
+// 显示器布局，只在 WM_DISPLAYCHANGE 时重新枚举
+DisplayLayout g_displays;
+
+// 窗口控制逻辑（移动、边界检查、自动重置）
+Win32WindowHost g_host;
+WindowController g_controller(g_host, g_scheduler);
+
+// 按键边沿带时间戳入队，由 WM_APP_INPUT 交给控制器处理
+const UINT WM_APP_INPUT = WM_APP + 1;
+bool g_inputPosted = false;
+
+// 外部命令通道（启动参数 --listen 时打开），后台线程接收，WM_APP_COMMAND 一次应用一批
+const UINT WM_APP_COMMAND = WM_APP + 2;
+CommandServer g_commandServer;
+std::vector<WindowCommand> g_commandBatch;
+
+// 共享内存中的窗口状态（启动参数 --feed 时发布），录制器、叠加层等外部进程用 PositionFeedReader 轮询
+PositionFeedWriter g_positionFeed;
+
+// 控制面板场景（只重绘内容变化的区域）
+PanelScene g_scene;
+
+// 绘制用的字体、画刷和画笔，在窗口整个生命周期内复用
+GdiResourceFactory g_gdiFactory;
+ResourceCache g_resources(g_gdiFactory);
+
+// 同步绘制路径的阴影位图，和字体、画刷一样只在第一次用到时创建
+GdiShadowCache g_gdiShadows;
+
+// 离屏后备缓冲，只在客户区尺寸变化时重新分配
+BackBufferPool<GdiSurfaceFactory> g_backBuffers;
+
+// 渲染线程：面板状态交给渲染线程绘制，WM_APP_FRAME 取最新完成的一帧，WM_PAINT 只复制像素
+// 启动参数 --sync-paint 时不启动，仍在 WM_PAINT 中用 GDI 绘制（上面的场景和后备缓冲只用于这种情况）
+const UINT WM_APP_FRAME = WM_APP + 3;
+GdiGlyphSource g_glyphs;
+PanelRenderThread g_renderer(g_glyphs);
+SizeI g_clientSize = {0, 0};
+
+// 按键日志（启动参数 --record <文件> 时记录，退出时保存）
+InputJournalWriter g_journal;
+std::string g_journalPath;
+IClock::TimePoint g_journalStart;
+
+// 生成一帧面板状态时的临时内存，每次 InvalidatePanel 开始时重置
+FrameArena g_frameArena;
+
+// 延迟统计：F3 在面板上显示摘要，F4 写出完整报告
+const char LATENCY_REPORT_PATH[] = "latency_report.txt";
+bool g_showLatency = false;
+
+// 按键绑定文件（可选），启动时读取一次
+const char KEY_BINDINGS_PATH[] = "key_bindings.txt";
+
+// 窗口状态文件：启动时恢复位置、大小、重置标记和按键绑定，状态变化后限速写回
+const char STATE_FILE_PATH[] = "window_state.bin";
+StateFile g_stateFile;
+StateSaveThrottle g_stateThrottle;
+TimerId g_stateSaveTimer = 0;
+PersistedState g_persisted = {};   // 最近一次交给状态文件的内容
 
 // 函数声明
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
-void MoveWindowBy(int dx, int dy);
-void ResetToCenter();
-void UpdateLastMoveTime();
-bool ShouldResetPosition();
-void UpdateWindowMovement();
-void CheckWindowBoundary();
-void DrawRoundedRect(HDC hdc, int x, int y, int width, int height, int radius);
-void DrawKeyButton(HDC hdc, int x, int y, int size, const wchar_t* text, bool pressed);
-void DrawModernButton(HDC hdc, int x, int y, int width, int height, const wchar_t* text, bool active);
-
-// 加载字体
-HFONT CreateModernFont(const wchar_t* fontName, int size, bool bold = false)
-{
-    return CreateFontW(
-        size, 0, 0, 0,
-        bold ? FW_BOLD : FW_NORMAL,
-        FALSE, FALSE, FALSE,
-        DEFAULT_CHARSET,
-        OUT_DEFAULT_PRECIS,
-        CLIP_DEFAULT_PRECIS,
-        CLEARTYPE_QUALITY,
-        DEFAULT_PITCH | FF_DONTCARE,
-        fontName
-    );
-}
+void InvalidatePanel(HWND hWnd);
+void BlitPanelFrame(HDC hdc, const RECT& area);
+void ArmSchedulerTimer();
+IClock::TimePoint RecordKeyEvent(WPARAM key, bool down, IClock::TimePoint now);
+void CaptureKeyEdge(HWND hWnd, WPARAM key, bool down, IClock::TimePoint time);
+void RefreshDisplays();
+uint64_t KeyBindingsStamp();
+void MarkStateDirty();
+void SaveWindowState();
 
 // 主函数 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
@@ -69,17 +132,60 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     
     RegisterClassW(&wc);
     
-    // 获取屏幕尺寸
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+    // 解析启动参数
+    std::string pathFile;
+    const char* pathArg = strstr(lpCmdLine, "--path ");
+    if (pathArg)
+    {
+        pathArg += strlen("--path ");
+        pathFile.assign(pathArg, strcspn(pathArg, " "));
+    }
+    
+    const char* recordArg = strstr(lpCmdLine, "--record ");
+    if (recordArg)
+    {
+        recordArg += strlen("--record ");
+        g_journalPath.assign(recordArg, strcspn(recordArg, " "));
+        g_journalStart = g_clock.Now();
+    }
+    
+    // 上次退出时保存的状态
+    PersistedState saved = {};
+    bool restored = g_stateFile.Open(STATE_FILE_PATH) && g_stateFile.Load(&saved);
+    
+    // 按键绑定：配置文件没有变化时直接用保存的绑定，不再解析
+    // 文件不存在或格式错误时使用默认绑定
+    uint64_t bindingsStamp = KeyBindingsStamp();
+    KeyBindings bindings;
+    if (restored && saved.bindingsStamp == bindingsStamp && RestoreBindings(saved, &bindings))
+        g_controller.SetKeyBindings(bindings);
+    else if (LoadKeyBindings(KEY_BINDINGS_PATH, &bindings))
+        g_controller.SetKeyBindings(bindings);
+    StoreBindings(g_controller.Bindings(), bindingsStamp, &g_persisted);
+    
+    // 枚举显示器
+    RefreshDisplays();
     
-    // 计算初始位置
+    // 恢复上次的位置和大小，没有保存的状态时放在主显示器中央
     int windowWidth = 600;
     int windowHeight = 450;
-    g_windowSize.cx = windowWidth;
-    g_windowSize.cy = windowHeight;
-    g_windowPos.x = (screenWidth - windowWidth) / 2;
-    g_windowPos.y = (screenHeight - windowHeight) / 2;
+    int windowX = 0;
+    int windowY = 0;
+    if (restored && saved.width > 0 && saved.height > 0)
+    {
+        windowX = saved.x;
+        windowY = saved.y;
+        windowWidth = saved.width;
+        windowHeight = saved.height;
+    }
+    else
+    {
+        const RectI& primary = g_displays.Primary();
+        windowX = primary.left + (RectWidth(primary) - windowWidth) / 2;
+        windowY = primary.top + (RectHeight(primary) - windowHeight) / 2;
+    }
+    g_controller.Initialize(windowX, windowY, windowWidth, windowHeight);
+    g_controller.SetResetTriggered(restored && (saved.flags & PERSISTED_RESET_TRIGGERED) != 0);
     
     // 创建窗口 
     g_hWnd = CreateWindowExW(
@@ -87,8 +193,8 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
         CLASS_NAME,
         L"✨ 可移动窗口控制器 ✨",
         WS_OVERLAPPEDWINDOW & ~WS_THICKFRAME & ~WS_MAXIMIZEBOX,
-        g_windowPos.x,
-        g_windowPos.y,
+        windowX,
+        windowY,
         windowWidth,
         windowHeight,
         nullptr,
@@ -106,12 +212,39 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
     ShowWindow(g_hWnd, nCmdShow);
     UpdateWindow(g_hWnd);
     
-    // 初始化时间
-    g_lastMoveTime = std::chrono::steady_clock::now();
+    // 渲染线程：每完成一帧只投递一条消息，UI 线程取走之前不再投递
+    if (!strstr(lpCmdLine, "--sync-paint"))
+    {
+        g_renderer.Start([] { PostMessage(g_hWnd, WM_APP_FRAME, 0, 0); });
+        RECT clientRect;
+        GetClientRect(g_hWnd, &clientRect);
+        g_clientSize = SizeI{clientRect.right, clientRect.bottom};
+        InvalidatePanel(g_hWnd);
+    }
+    
+    // 命令通道：每批命令到达时只投递一条消息
+    if (strstr(lpCmdLine, "--listen"))
+        g_commandServer.Start(DefaultCommandEndpoint().c_str(), [] { PostMessage(g_hWnd, WM_APP_COMMAND, 0, 0); });
+    
+    // 共享内存状态：之后每次移动和重置都写入
+    if (strstr(lpCmdLine, "--feed") && g_positionFeed.Open(DEFAULT_POSITION_FEED))
+        g_controller.SetPositionFeed(&g_positionFeed);
+    
+    // 启动参数 --path <文件>：沿文件中的路径移动，边播放边读取
+    if (!pathFile.empty())
+    {
+        std::unique_ptr<PathPlayer> path(new PathPlayer());
+        if (path->Open(pathFile.c_str()))
+            g_controller.FollowPath(std::move(path));
+    }
     
-    // 设置定时器
-    SetTimer(g_hWnd, 1, 50, nullptr);
-    SetTimer(g_hWnd, 2, 100, nullptr);
+    // 显示器可能在两次运行之间变化，恢复的位置不在任何显示器上时按移出屏幕处理
+    if (restored)
+        g_controller.CheckWindowBoundary();
+    
+    // 按当前状态安排定时事件
+    g_controller.SyncSchedule();
+    ArmSchedulerTimer();
     
     // 消息循环
     MSG msg = {};
@@ -127,266 +260,145 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 // 窗口过程函数
 LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 {
-    static HFONT hTitleFont = nullptr;
-    static HFONT hNormalFont = nullptr;
-    static HFONT hSmallFont = nullptr;
-    
     switch (uMsg)
     {
-    case WM_CREATE:
-        // 创建字体
-        hTitleFont = CreateModernFont(L"Segoe UI", 28, true);
-        hNormalFont = CreateModernFont(L"Segoe UI", 16);
-        hSmallFont = CreateModernFont(L"Segoe UI", 12);
-        break;
-        
     case WM_DESTROY:
-        KillTimer(hWnd, 1);
-        KillTimer(hWnd, 2);
+        KillTimer(hWnd, SCHEDULER_TIMER_ID);
+        g_commandServer.Stop();
+        g_controller.SetPositionFeed(nullptr);
+        g_positionFeed.Close();
+        g_renderer.Stop();
+        
+        // 退出前写入最终状态，不等限速间隔
+        g_scheduler.Cancel(g_stateSaveTimer);
+        SaveWindowState();
+        g_stateFile.Close();
         
-        if (hTitleFont) DeleteObject(hTitleFont);
-        if (hNormalFont) DeleteObject(hNormalFont);
-        if (hSmallFont) DeleteObject(hSmallFont);
+        // 释放缓存的GDI对象和后备缓冲
+        g_resources.Clear();
+        g_gdiShadows.Clear();
+        g_backBuffers.Release();
+        
+        // 保存按键日志
+        if (!g_journalPath.empty())
+            SaveJournal(g_journalPath.c_str(), g_journal.Data());
         
         PostQuitMessage(0);
         return 0;
         
     case WM_KEYDOWN:
-        if (wParam < 256)
+        if (wParam == VK_F3 || wParam == VK_F4)
         {
-            g_keyStates[wParam] = true;
-            UpdateLastMoveTime();
-            
-            // 空格键重置位置
-            if (wParam == VK_SPACE)
+            // 忽略自动重复
+            if (lParam & (1 << 30)) return 0;
+            if (wParam == VK_F3)
+            {
+                g_showLatency = !g_showLatency;
+                InvalidatePanel(hWnd);
+            }
+            else
             {
-                ResetToCenter();
-                g_resetTriggered = true;
+                DumpLatencyReport(LATENCY_REPORT_PATH);
             }
+            return 0;
         }
+        CaptureKeyEdge(hWnd, wParam, true, RecordKeyEvent(wParam, true, g_clock.Now()));
         return 0;
         
     case WM_KEYUP:
-        if (wParam < 256)
-        {
-            g_keyStates[wParam] = false;
-        }
+        if (wParam == VK_F3 || wParam == VK_F4) return 0;
+        CaptureKeyEdge(hWnd, wParam, false, RecordKeyEvent(wParam, false, g_clock.Now()));
+        return 0;
+        
+    case WM_APP_INPUT:
+        // 按边沿发生的时刻处理，短按也会按实际按住的时间移动
+        g_inputPosted = false;
+        g_controller.DrainInput();
+        ArmSchedulerTimer();
+        return 0;
+        
+    case WM_APP_COMMAND:
+        // 取出到目前为止到达的全部命令，窗口只移动一次
+        g_commandBatch.clear();
+        g_commandServer.Drain(&g_commandBatch);
+        g_controller.ApplyCommands(g_commandBatch.data(), g_commandBatch.size());
+        ArmSchedulerTimer();
+        return 0;
         
-        // ESC键不退出，只是取消重置标记
-        if (wParam == VK_ESCAPE)
+    case WM_APP_FRAME:
+        // 只让新帧中变化的区域无效，WM_PAINT 时复制
+        if (g_renderer.AcquireFrame())
         {
-            g_resetTriggered = false;
-            InvalidateRect(hWnd, nullptr, TRUE);
+            const RectI& damage = g_renderer.Frame().damage;
+            RECT rect = {damage.left, damage.top, damage.right, damage.bottom};
+            InvalidateRect(hWnd, &rect, FALSE);
         }
         return 0;
         
     case WM_TIMER:
-        if (wParam == 1)
+        if (wParam == SCHEDULER_TIMER_ID)
         {
-            // 更新窗口移动
-            UpdateWindowMovement();
-            
-            // 每5秒检查是否需要重置位置（只有移动到边界外才会触发）
-            static int timerCount = 0;
-            timerCount++;
-            if (timerCount >= 100)  // 50ms * 100 = 5秒
+            // 定时器到达时刻相对最早截止时间的延迟
+            if (g_scheduler.HasPending())
             {
-                if (ShouldResetPosition() && g_resetTriggered)
-                {
-                    ResetToCenter();
-                    g_resetTriggered = false;
-                }
-                timerCount = 0;
+                IClock::TimePoint now = g_clock.Now();
+                IClock::TimePoint deadline = g_scheduler.NextDeadline();
+                if (deadline <= now)
+                    RecordLatency(LATENCY_TIMER_JITTER, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline).count());
             }
-        }
-        else if (wParam == 2)
-        {
-            // 检查窗口边界
-            CheckWindowBoundary();
+            g_controller.RunDueEvents();
+            ArmSchedulerTimer();
         }
         return 0;
         
     case WM_PAINT:
         {
+            ScopedLatency latency(LATENCY_PAINT);
             PAINTSTRUCT ps;
             HDC hdc = BeginPaint(hWnd, &ps);
             
-            // 双缓冲绘图
-            HDC hdcMem = CreateCompatibleDC(hdc);
-            RECT clientRect;
-            GetClientRect(hWnd, &clientRect);
-            HBITMAP hBitmap = CreateCompatibleBitmap(hdc, clientRect.right, clientRect.bottom);
-            HBITMAP hOldBitmap = (HBITMAP)SelectObject(hdcMem, hBitmap);
-            
-            // 绘制渐变背景
-            RECT bgRect = clientRect;
-            HBRUSH hBgBrush = CreateSolidBrush(BG_COLOR);
-            FillRect(hdcMem, &bgRect, hBgBrush);
-            
-            // 绘制标题栏效果
-            RECT titleBarRect = {0, 0, clientRect.right, 60};
-            HBRUSH hTitleBarBrush = CreateSolidBrush(RGB(30, 30, 32));
-            FillRect(hdcMem, &titleBarRect, hTitleBarBrush);
-            
-            // 绘制标题
-            HFONT hOldFont = (HFONT)SelectObject(hdcMem, hTitleFont);
-            SetTextColor(hdcMem, TEXT_COLOR);
-            SetBkMode(hdcMem, TRANSPARENT);
-            
-            // 使用宽字符绘制
-            std::wstring titleText = L"✨ 可移动窗口控制器 ✨";
-            RECT titleRect = {0, 20, clientRect.right, 80};
-            DrawTextW(hdcMem, titleText.c_str(), -1, &titleRect, DT_CENTER | DT_SINGLELINE | DT_VCENTER);
-            
-            // 绘制控制说明
-            SelectObject(hdcMem, hNormalFont);
-            
-            // 绘制控制区域背景
-            RECT controlRect = {50, 100, clientRect.right - 50, 280};
-            HBRUSH hControlBrush = CreateSolidBrush(BORDER_COLOR);
-            FillRect(hdcMem, &controlRect, hControlBrush);
-            DeleteObject(hControlBrush);
-            
-            // 绘制控制区域边框
-            HPEN hBorderPen = CreatePen(PS_SOLID, 2, ACCENT_COLOR);
-            HPEN hOldPen = (HPEN)SelectObject(hdcMem, hBorderPen);
-            SelectObject(hdcMem, GetStockObject(NULL_BRUSH));
-            Rectangle(hdcMem, controlRect.left, controlRect.top, controlRect.right, controlRect.bottom);
-            
-            // 绘制方向控制
-            int centerX = (controlRect.left + controlRect.right) / 2;
-            int centerY = (controlRect.top + controlRect.bottom) / 2;
-            int keySize = 60;
-            
-            // 上方向键
-            bool upPressed = g_keyStates['W'] || g_keyStates['w'] || g_keyStates[VK_UP];
-            std::wstring upText = upPressed ? L"▲" : L"W/↑";
-            DrawKeyButton(hdcMem, centerX, centerY - keySize - 20, keySize, upText.c_str(), upPressed);
-            
-            // 下方向键
-            bool downPressed = g_keyStates['S'] || g_keyStates['s'] || g_keyStates[VK_DOWN];
-            std::wstring downText = downPressed ? L"▼" : L"S/↓";
-            DrawKeyButton(hdcMem, centerX, centerY + keySize + 20, keySize, downText.c_str(), downPressed);
-            
-            // 左方向键
-            bool leftPressed = g_keyStates['A'] || g_keyStates['a'] || g_keyStates[VK_LEFT];
-            std::wstring leftText = leftPressed ? L"◀" : L"A/←";
-            DrawKeyButton(hdcMem, centerX - keySize - 20, centerY, keySize, leftText.c_str(), leftPressed);
-            
-            // 右方向键
-            bool rightPressed = g_keyStates['D'] || g_keyStates['d'] || g_keyStates[VK_RIGHT];
-            std::wstring rightText = rightPressed ? L"▶" : L"D/→";
-            DrawKeyButton(hdcMem, centerX + keySize + 20, centerY, keySize, rightText.c_str(), rightPressed);
-            
-            // 绘制中心区域提示
-            SelectObject(hdcMem, hSmallFont);
-            RECT centerTextRect = {centerX - 50, centerY - 20, centerX + 50, centerY + 20};
-            SetTextColor(hdcMem, RGB(150, 150, 150));
-            DrawTextW(hdcMem, L"斜向移动", -1, &centerTextRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-            
-            SelectObject(hdcMem, hOldPen);
-            DeleteObject(hBorderPen);
-            
-            // 绘制功能按钮区域
-            int buttonWidth = 180;
-            int buttonHeight = 40;
-            int buttonY = 300;
-            
-            // 空格键重置按钮
-            bool spacePressed = g_keyStates[VK_SPACE];
-            std::wstring spaceText = spacePressed ? L"🔄 重置中..." : L"空格键 - 重置位置";
-            DrawModernButton(hdcMem, 
-                           (clientRect.right - buttonWidth * 2 - 20) / 2, 
-                           buttonY, 
-                           buttonWidth, 
-                           buttonHeight, 
-                           spaceText.c_str(), 
-                           spacePressed);
-            
-            // ESC键提示按钮
-            bool escPressed = g_keyStates[VK_ESCAPE];
-            DrawModernButton(hdcMem, 
-                           (clientRect.right - buttonWidth * 2 - 20) / 2 + buttonWidth + 20, 
-                           buttonY, 
-                           buttonWidth, 
-                           buttonHeight, 
-                           L"ESC - 取消重置", 
-                           escPressed);
-            
-            // 绘制状态信息
-            SelectObject(hdcMem, hNormalFont);
-            RECT statusRect = {50, 360, clientRect.right - 50, clientRect.bottom - 20};
-            
-            // 状态信息背景
-            HBRUSH hStatusBrush = CreateSolidBrush(RGB(30, 30, 30));
-            FillRect(hdcMem, &statusRect, hStatusBrush);
-            DeleteObject(hStatusBrush);
-            
-            // 状态信息边框
-            HPEN hStatusPen = CreatePen(PS_SOLID, 1, ACCENT_COLOR);
-            SelectObject(hdcMem, hStatusPen);
-            SelectObject(hdcMem, GetStockObject(NULL_BRUSH));
-            Rectangle(hdcMem, statusRect.left, statusRect.top, statusRect.right, statusRect.bottom);
-            
-            // 状态文本
-            SelectObject(hdcMem, hSmallFont);
-            
-            wchar_t statusText[256];
-            auto now = std::chrono::steady_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - g_lastMoveTime).count();
-            
-            if (g_resetTriggered)
+            if (g_renderer.IsRunning())
             {
-                swprintf(statusText, 256, L"⚠️  窗口已移动到边界外！%d秒后自动重置到中心...", 5 - (int)elapsed);
-                SetTextColor(hdcMem, WARNING_COLOR);
+                BlitPanelFrame(hdc, ps.rcPaint);
+                EndPaint(hWnd, &ps);
+                return 0;
             }
-            else if (elapsed >= 4)
-            {
-                swprintf(statusText, 256, L"⏰  %d秒未操作，即将自动重置...", 5 - (int)elapsed);
-                SetTextColor(hdcMem, WARNING_COLOR);
-            }
-            else
-            {
-                swprintf(statusText, 256, L"✅  窗口控制正常 | 位置: (%d, %d)", g_windowPos.x, g_windowPos.y);
-            }
-            
-            RECT textRect = statusRect;
-            textRect.left += 10;
-            textRect.right -= 10;
-            DrawTextW(hdcMem, statusText, -1, &textRect, DT_LEFT | DT_VCENTER | DT_SINGLELINE);
-            
-            DeleteObject(hStatusPen);
             
-            // 绘制底部提示
-            SetTextColor(hdcMem, RGB(120, 120, 120));
-            RECT hintRect = {0, clientRect.bottom - 25, clientRect.right, clientRect.bottom};
-            DrawTextW(hdcMem, L"💡 提示：只有窗口移动到屏幕外才会自动重置，ESC键取消重置", 
-                     -1, &hintRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+            // 双缓冲绘图，后备缓冲在帧之间保留，尺寸只在 WM_SIZE 中调整
+            HDC hdcMem = g_backBuffers.BeginFrame().hdc;
             
-            // 清理画刷
-            DeleteObject(hBgBrush);
-            DeleteObject(hTitleBarBrush);
-            
-            // 恢复并清理
-            SelectObject(hdcMem, hOldFont);
-            SelectObject(hdc, hOldBitmap);
-            
-            // 将内存DC内容复制到屏幕DC
-            BitBlt(hdc, 0, 0, clientRect.right, clientRect.bottom, hdcMem, 0, 0, SRCCOPY);
+            // 只重绘无效区域内的节点
+            RectI dirty = {ps.rcPaint.left, ps.rcPaint.top, ps.rcPaint.right, ps.rcPaint.bottom};
+            {
+                GdiBackend backend(hdcMem, g_backBuffers.Width(), g_backBuffers.Height(), g_resources, &g_gdiShadows);
+                g_scene.Paint(backend, dirty);
+            }
             
-            // 清理资源
-            SelectObject(hdcMem, hOldBitmap);
-            DeleteObject(hBitmap);
-            DeleteDC(hdcMem);
+            // 将内存DC中的无效区域复制到屏幕DC
+            BitBlt(hdc, dirty.left, dirty.top, RectWidth(dirty), RectHeight(dirty), hdcMem, dirty.left, dirty.top, SRCCOPY);
+            g_backBuffers.EndFrame();
             
             EndPaint(hWnd, &ps);
         }
         return 0;
         
     case WM_SIZE:
-        g_windowSize.cx = LOWORD(lParam);
-        g_windowSize.cy = HIWORD(lParam);
-        InvalidateRect(hWnd, nullptr, TRUE);
+        g_clientSize = SizeI{LOWORD(lParam), HIWORD(lParam)};
+        g_controller.SetWindowSize(LOWORD(lParam), HIWORD(lParam));
+        g_scene.Layout(LOWORD(lParam), HIWORD(lParam));
+        // 新分配的缓冲没有旧内容，整个客户区都要重绘
+        if (g_backBuffers.Resize(LOWORD(lParam), HIWORD(lParam)))
+            InvalidateRect(hWnd, nullptr, FALSE);
+        InvalidatePanel(hWnd);
+        MarkStateDirty();
+        return 0;
+        
+    case WM_DISPLAYCHANGE:
+        // 显示器增减或分辨率变化，重建布局后重新检查边界
+        RefreshDisplays();
+        g_controller.CheckWindowBoundary();
+        g_controller.SyncSchedule();
+        ArmSchedulerTimer();
         return 0;
         
     case WM_ERASEBKGND:
@@ -396,240 +408,226 @@ LRESULT CALLBACK WindowProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 	return DefWindowProcW(hWnd, uMsg, wParam, lParam);
 }
 
-// 绘制圆角矩形
-void DrawRoundedRect(HDC hdc, int x, int y, int width, int height, int radius)
+const DisplayLayout& Win32WindowHost::Displays() const
 {
-    HPEN hPen = (HPEN)GetCurrentObject(hdc, OBJ_PEN);
-    HBRUSH hBrush = (HBRUSH)GetCurrentObject(hdc, OBJ_BRUSH);
-    
-    RoundRect(hdc, x, y, x + width, y + height, radius, radius);
+    return g_displays;
 }
 
-// 绘制按键按钮
-void DrawKeyButton(HDC hdc, int centerX, int centerY, int size, const wchar_t* text, bool pressed)
+// EnumDisplayMonitors 的回调：收集每个显示器的矩形
+static BOOL CALLBACK CollectMonitor(HMONITOR monitor, HDC hdc, LPRECT rect, LPARAM data)
 {
-    int x = centerX - size / 2;
-    int y = centerY - size / 2;
-    
-    // 按键背景
-    COLORREF bgColor = pressed ? KEY_COLOR : RGB(60, 60, 60);
-    COLORREF textColor = pressed ? RGB(255, 255, 255) : TEXT_COLOR;
-    COLORREF borderColor = pressed ? RGB(255, 255, 255) : ACCENT_COLOR;
-    
-    // 绘制按键阴影（按下状态）
-    if (pressed)
+    (void)monitor;
+    (void)hdc;
+    std::vector<RectI>* monitors = reinterpret_cast<std::vector<RectI>*>(data);
+    monitors->push_back(RectI{rect->left, rect->top, rect->right, rect->bottom});
+    return TRUE;
+}
+
+// 重新枚举显示器，失败时退回主显示器的尺寸
+void RefreshDisplays()
+{
+    std::vector<RectI> monitors;
+    if (!EnumDisplayMonitors(nullptr, nullptr, CollectMonitor, reinterpret_cast<LPARAM>(&monitors)) || monitors.empty())
     {
-        HBRUSH hShadowBrush = CreateSolidBrush(RGB(40, 40, 40));
-        HPEN hShadowPen = CreatePen(PS_SOLID, 1, RGB(40, 40, 40));
-        HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hShadowBrush);
-        HPEN hOldPen = (HPEN)SelectObject(hdc, hShadowPen);
-        DrawRoundedRect(hdc, x + 2, y + 2, size, size, 10);
-        SelectObject(hdc, hOldBrush);
-        SelectObject(hdc, hOldPen);
-        DeleteObject(hShadowBrush);
-        DeleteObject(hShadowPen);
+        monitors.assign(1, RectI{0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN)});
     }
+    g_displays.SetMonitors(monitors);
+}
+
+// 控制器的窗口编号对应的窗口，目前只有主窗口
+static HWND WindowFromSlot(uint32_t window)
+{
+    return window == 0 ? g_hWnd : nullptr;
+}
+
+void Win32WindowHost::MoveWindows(const WindowMove* moves, size_t count)
+{
+    // 只做标记，写文件在限速间隔结束后进行
+    MarkStateDirty();
     
-    // 绘制按键背景（圆角矩形）
-    HBRUSH hBrush = CreateSolidBrush(bgColor);
-    HPEN hPen = CreatePen(PS_SOLID, 2, borderColor);
-    
-    HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hBrush);
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hPen);
-    
-    DrawRoundedRect(hdc, x, y, size, size, 10);
+    ScopedLatency latency(LATENCY_SET_WINDOW_POS);
     
-    // 绘制按键文字
-    SetTextColor(hdc, textColor);
-    SetBkMode(hdc, TRANSPARENT);
+    if (count == 1)
+    {
+        HWND hWnd = WindowFromSlot(moves[0].window);
+        if (hWnd)
+            SetWindowPos(hWnd, nullptr, moves[0].x, moves[0].y, 0, 0, SWP_NOZORDER | SWP_NOSIZE);
+        return;
+    }
     
-    RECT textRect = {x, y, x + size, y + size};
-    HFONT hFont = CreateModernFont(L"Segoe UI", size / 2, true);
-    HFONT hOldFont = (HFONT)SelectObject(hdc, hFont);
+    // 多个窗口合并成一次延迟更新，系统一次性重新排列
+    HDWP defer = BeginDeferWindowPos((int)count);
+    for (size_t i = 0; i < count && defer; ++i)
+    {
+        HWND hWnd = WindowFromSlot(moves[i].window);
+        if (hWnd)
+            defer = DeferWindowPos(defer, hWnd, nullptr, moves[i].x, moves[i].y, 0, 0, SWP_NOZORDER | SWP_NOSIZE | SWP_NOACTIVATE);
+    }
     
-    DrawTextW(hdc, text, -1, &textRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
+    if (defer)
+    {
+        EndDeferWindowPos(defer);
+        return;
+    }
     
-    // 恢复原来的对象
-    SelectObject(hdc, hOldFont);
-    SelectObject(hdc, hOldBrush);
-    SelectObject(hdc, hOldPen);
+    // 延迟更新失败时逐个移动
+    for (size_t i = 0; i < count; ++i)
+    {
+        HWND hWnd = WindowFromSlot(moves[i].window);
+        if (hWnd)
+            SetWindowPos(hWnd, nullptr, moves[i].x, moves[i].y, 0, 0, SWP_NOZORDER | SWP_NOSIZE | SWP_NOACTIVATE);
+    }
+}
+
+void Win32WindowHost::InvalidatePanel()
+{
+    ::InvalidatePanel(g_hWnd);
     
-    DeleteObject(hFont);
-    DeleteObject(hBrush);
-    DeleteObject(hPen);
+    // 重置标记等状态的变化都伴随着面板刷新
+    MarkStateDirty();
 }
 
-// 绘制现代风格按钮
-void DrawModernButton(HDC hdc, int x, int y, int width, int height, const wchar_t* text, bool active)
+// 按键绑定文件的修改时间，文件不存在时为 0
+uint64_t KeyBindingsStamp()
 {
-    // 按钮背景
-    COLORREF bgColor = active ? ACCENT_COLOR : RGB(70, 70, 70);
-    COLORREF textColor = active ? RGB(255, 255, 255) : TEXT_COLOR;
-    
-    // 绘制按钮阴影
-    HBRUSH hShadowBrush = CreateSolidBrush(RGB(30, 30, 30));
-    HPEN hShadowPen = CreatePen(PS_SOLID, 1, RGB(30, 30, 30));
-    HBRUSH hOldBrush = (HBRUSH)SelectObject(hdc, hShadowBrush);
-    HPEN hOldPen = (HPEN)SelectObject(hdc, hShadowPen);
-    DrawRoundedRect(hdc, x + 2, y + 2, width, height, 8);
-    
-    // 绘制按钮
-    HBRUSH hBrush = CreateSolidBrush(bgColor);
-    HPEN hPen = CreatePen(PS_SOLID, 1, active ? RGB(255, 255, 255) : ACCENT_COLOR);
-    
-    SelectObject(hdc, hBrush);
-    SelectObject(hdc, hPen);
-    
-    DrawRoundedRect(hdc, x, y, width, height, 8);
-    
-    // 绘制按钮文字
-    SetTextColor(hdc, textColor);
-    SetBkMode(hdc, TRANSPARENT);
-    
-    RECT textRect = {x, y, x + width, y + height};
-    HFONT hFont = CreateModernFont(L"Segoe UI", 14, true);
-    HFONT hOldFont = (HFONT)SelectObject(hdc, hFont);
-    
-    DrawTextW(hdc, text, -1, &textRect, DT_CENTER | DT_VCENTER | DT_SINGLELINE);
-    
-    // 恢复原来的对象
-    SelectObject(hdc, hOldFont);
-    SelectObject(hdc, hOldBrush);
-    SelectObject(hdc, hOldPen);
-    
-    DeleteObject(hFont);
-    DeleteObject(hBrush);
-    DeleteObject(hPen);
-    DeleteObject(hShadowBrush);
-    DeleteObject(hShadowPen);
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(KEY_BINDINGS_PATH, error);
+    return error ? 0 : (uint64_t)time.time_since_epoch().count();
 }
 
-// 更新窗口移动
-void UpdateWindowMovement()
+// 状态变化只做标记，由调度器在限速间隔结束时写入
+void MarkStateDirty()
 {
-    if (!g_hWnd) return;
+    g_stateThrottle.MarkDirty();
+    if (g_stateSaveTimer != 0 || !g_stateFile.IsOpen())
+        return;
     
-    int dx = 0;
-    int dy = 0;
-    
-    // 计算移动方向
-    if (g_keyStates['W'] || g_keyStates['w'] || g_keyStates[VK_UP])
-        dy -= 5;
-    if (g_keyStates['S'] || g_keyStates['s'] || g_keyStates[VK_DOWN])
-        dy += 5;
-    if (g_keyStates['A'] || g_keyStates['a'] || g_keyStates[VK_LEFT])
-        dx -= 5;
-    if (g_keyStates['D'] || g_keyStates['d'] || g_keyStates[VK_RIGHT])
-        dx += 5;
-    
-    // 如果按下了方向键，移动窗口
-    if (dx != 0 || dy != 0)
-    {
-        MoveWindowBy(dx, dy);
-        
-        // 更新窗口显示
-        InvalidateRect(g_hWnd, nullptr, TRUE);
-    }
+    g_stateSaveTimer = g_scheduler.Schedule(g_stateThrottle.DueTime(g_clock.Now()), [] { SaveWindowState(); });
+    ArmSchedulerTimer();
 }
 
-// 移动窗口
-void MoveWindowBy(int dx, int dy)
+// 把当前状态写入状态文件，内容没有变化时不写
+void SaveWindowState()
 {
-    if (!g_hWnd || (dx == 0 && dy == 0)) return;
-    
-    // 获取屏幕尺寸
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-    
-    // 计算新位置
-    g_windowPos.x += dx;
-    g_windowPos.y += dy;
-    
-    // 边界检查，确保窗口不会移出屏幕
-    if (g_windowPos.x < -g_windowSize.cx + 20) 
-        g_windowPos.x = -g_windowSize.cx + 20;
-    if (g_windowPos.y < -g_windowSize.cy + 20)
-        g_windowPos.y = -g_windowSize.cy + 20;
-    if (g_windowPos.x > screenWidth - 20)
-        g_windowPos.x = screenWidth - 20;
-    if (g_windowPos.y > screenHeight - 20)
-        g_windowPos.y = screenHeight - 20;
-    
-    // 移动窗口
-    SetWindowPos(g_hWnd, nullptr, 
-                 g_windowPos.x, g_windowPos.y, 
-                 0, 0, 
-                 SWP_NOZORDER | SWP_NOSIZE);
-    
-    g_hasMoved = true;
+    g_stateSaveTimer = 0;
+    if (!g_hWnd || !g_stateFile.IsOpen())
+        return;
+    
+    // 位置以控制器为准；大小取整个窗口（包括边框），与创建窗口时的参数一致
+    RECT rect;
+    GetWindowRect(g_hWnd, &rect);
+    const PointI& pos = g_controller.WindowPos();
+    g_persisted.x = pos.x;
+    g_persisted.y = pos.y;
+    g_persisted.width = rect.right - rect.left;
+    g_persisted.height = rect.bottom - rect.top;
+    g_persisted.flags = g_controller.ResetTriggered() ? PERSISTED_RESET_TRIGGERED : 0;
+    
+    g_stateFile.Store(g_persisted);
+    g_stateThrottle.Saved(g_clock.Now());
 }
 
-// 检查窗口边界
-void CheckWindowBoundary()
+// 把场景中内容变化的区域标记为无效
+void InvalidatePanel(HWND hWnd)
 {
-    if (!g_hWnd) return;
+    if (!hWnd) return;
     
-    // 获取屏幕尺寸
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+    g_frameArena.Reset();
+    PanelState state = g_controller.CapturePanelState();
+    state.showLatency = g_showLatency;
+    if (g_showLatency)
+        FormatLatencyOverlay(state.latencyText, sizeof(state.latencyText) / sizeof(state.latencyText[0]), g_frameArena);
     
-    // 检查是否移动到屏幕外（完全不可见）
-    bool outOfBounds = false;
-    
-    // 如果窗口完全在屏幕外
-    if (g_windowPos.x + g_windowSize.cx <= 0 ||  // 完全在左边
-        g_windowPos.x >= screenWidth ||          // 完全在右边
-        g_windowPos.y + g_windowSize.cy <= 0 ||  // 完全在上边
-        g_windowPos.y >= screenHeight)           // 完全在下边
+    // 渲染线程自己比较场景内容，新帧完成后再让变化的区域无效
+    if (g_renderer.IsRunning())
     {
-        outOfBounds = true;
+        g_renderer.Submit(state, g_clientSize.cx, g_clientSize.cy);
+        return;
     }
     
-    // 如果移出屏幕，标记需要重置
-    if (outOfBounds && !g_resetTriggered)
+    const std::vector<RectI>& damage = g_scene.Update(state);
+    for (size_t i = 0; i < damage.size(); ++i)
     {
-        g_resetTriggered = true;
-        UpdateLastMoveTime();  // 重置计时器
-        InvalidateRect(g_hWnd, nullptr, TRUE);
+        RECT rect = {damage[i].left, damage[i].top, damage[i].right, damage[i].bottom};
+        InvalidateRect(hWnd, &rect, FALSE);
     }
 }
 
-// 重置窗口到屏幕中央
-void ResetToCenter()
+// 把渲染线程最近完成的一帧中 area 以内的部分复制到屏幕
+// 帧还没有完成或尺寸还是旧的时，帧以外的部分先填上背景色，新帧完成后会再次绘制
+void BlitPanelFrame(HDC hdc, const RECT& area)
+{
+    const PanelFrame& frame = g_renderer.Frame();
+    RectI dirty = {area.left, area.top, area.right, area.bottom};
+    RectI covered = IntersectRect(dirty, RectI{0, 0, frame.width, frame.height});
+    if (frame.sequence == 0 || IsRectEmpty(covered) || covered != dirty)
+        FillRect(hdc, &area, (HBRUSH)g_resources.GetBrush(BG_COLOR));
+    if (frame.sequence == 0 || IsRectEmpty(covered))
+        return;
+    
+    // 只描述需要的几行，源矩形就是整个 DIB，避免自上而下 DIB 的纵坐标约定
+    int rows = RectHeight(covered);
+    BITMAPINFO info = {};
+    info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    info.bmiHeader.biWidth = frame.width;
+    info.bmiHeader.biHeight = -rows;
+    info.bmiHeader.biPlanes = 1;
+    info.bmiHeader.biBitCount = 32;
+    info.bmiHeader.biCompression = BI_RGB;
+    SetDIBitsToDevice(hdc, covered.left, covered.top, RectWidth(covered), rows, covered.left, 0, 0, rows,
+                      &frame.pixels[(size_t)covered.top * frame.width], &info, DIB_RGB_COLORS);
+}
+
+// 把唯一的系统定时器设置到最早的截止时间
+void ArmSchedulerTimer()
 {
     if (!g_hWnd) return;
     
-    // 获取屏幕尺寸
-    int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-    int screenHeight = GetSystemMetrics(SM_CYSCREEN);
-    
-    // 计算中心位置
-    g_windowPos.x = (screenWidth - g_windowSize.cx) / 2;
-    g_windowPos.y = (screenHeight - g_windowSize.cy) / 2;
-    
-    // 移动窗口
-    SetWindowPos(g_hWnd, nullptr, 
-                 g_windowPos.x, g_windowPos.y, 
-                 0, 0, 
-                 SWP_NOZORDER | SWP_NOSIZE);
-    
-    // 重绘窗口
-    InvalidateRect(g_hWnd, nullptr, TRUE);
+    // 没有事件时关闭系统定时器，空闲时不再唤醒
+    if (!g_scheduler.HasPending())
+    {
+        KillTimer(g_hWnd, SCHEDULER_TIMER_ID);
+        return;
+    }
     
-    g_hasMoved = false;
-    g_resetTriggered = false;
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        g_scheduler.NextDeadline() - g_clock.Now() + std::chrono::microseconds(999)).count();
+    SetTimer(g_hWnd, SCHEDULER_TIMER_ID, (UINT)std::max<long long>(delay, USER_TIMER_MINIMUM), nullptr);
 }
 
-// 更新最后一次移动的时间
-void UpdateLastMoveTime()
+// 采集按键边沿：只记录时间戳并入队，不在这里推进模拟
+void CaptureKeyEdge(HWND hWnd, WPARAM key, bool down, IClock::TimePoint time)
 {
-    g_lastMoveTime = std::chrono::steady_clock::now();
+    KeyEdge edge = {time, (unsigned)key, down};
+    if (!g_controller.PushKeyEdge(edge))
+    {
+        // 队列满时先处理积压的边沿，不丢弃按键
+        g_controller.DrainInput();
+        g_controller.PushKeyEdge(edge);
+    }
+    
+    // 投递的消息先于后续的输入消息被取出，每批边沿只投递一次
+    if (!g_inputPosted)
+    {
+        g_inputPosted = PostMessage(hWnd, WM_APP_INPUT, 0, 0) != FALSE;
+        if (!g_inputPosted)
+        {
+            g_controller.DrainInput();
+            ArmSchedulerTimer();
+        }
+    }
 }
 
-// 检查是否应该重置位置（超过5秒未操作且已触发重置）
-bool ShouldResetPosition()
+// 记录按键事件，返回交给控制器的边沿时刻
+// 记录时按日志的微秒精度取整，控制器用的时刻和回放时完全相同，短于一个节拍的按键也能原样重现
+IClock::TimePoint RecordKeyEvent(WPARAM key, bool down, IClock::TimePoint now)
 {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - g_lastMoveTime).count();
-    return elapsed >= 5;
-}
\ No newline at end of file
+    if (g_journalPath.empty() || key >= 256) return now;
+    
+    InputEvent event;
+    event.timeUs = std::chrono::duration_cast<std::chrono::microseconds>(now - g_journalStart).count();
+    event.key = (uint8_t)key;
+    event.down = down;
+    g_journal.Append(event);
+    return g_journalStart + std::chrono::microseconds(event.timeUs);
+}
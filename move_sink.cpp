@@ -0,0 +1,110 @@
+#include "move_sink.h"
+
+MoveSink::MoveSink(INativeMover& mover)
+    : m_mover(mover),
+      m_batchDepth(0),
+      m_requests(0),
+      m_coalesced(0),
+      m_dropped(0),
+      m_nativeCalls(0),
+      m_windowsMoved(0)
+{
+}
+
+void MoveSink::Reserve(uint32_t window)
+{
+    if (window >= m_known.size())
+    {
+        m_known.resize((size_t)window + 1, KnownPosition{0, 0, false});
+        m_pendingSlot.resize((size_t)window + 1, -1);
+    }
+}
+
+void MoveSink::SetKnownPosition(uint32_t window, int x, int y)
+{
+    Reserve(window);
+    m_known[window] = KnownPosition{x, y, true};
+}
+
+void MoveSink::Request(uint32_t window, int x, int y)
+{
+    Reserve(window);
+    ++m_requests;
+
+    // 不在批处理中：直接比较并提交，不经过挂起列表
+    if (m_batchDepth == 0 && m_pending.empty())
+    {
+        KnownPosition& known = m_known[window];
+        if (known.valid && known.x == x && known.y == y)
+        {
+            ++m_dropped;
+            return;
+        }
+        known = KnownPosition{x, y, true};
+
+        WindowMove move = {window, x, y};
+        ++m_nativeCalls;
+        ++m_windowsMoved;
+        ++m_batchDepth;
+        m_mover.MoveWindows(&move, 1);
+        EndBatch();
+        return;
+    }
+
+    int32_t slot = m_pendingSlot[window];
+    if (slot >= 0)
+    {
+        // 同一批中后来的位置覆盖前面的
+        m_pending[slot].x = x;
+        m_pending[slot].y = y;
+        ++m_coalesced;
+    }
+    else
+    {
+        m_pendingSlot[window] = (int32_t)m_pending.size();
+        m_pending.push_back(WindowMove{window, x, y});
+    }
+}
+
+void MoveSink::EndBatch()
+{
+    if (m_batchDepth > 0 && --m_batchDepth == 0)
+        Flush();
+}
+
+size_t MoveSink::Flush()
+{
+    if (m_pending.empty())
+        return 0;
+
+    m_submit.clear();
+    for (const WindowMove& move : m_pending)
+    {
+        m_pendingSlot[move.window] = -1;
+
+        const KnownPosition& known = m_known[move.window];
+        if (known.valid && known.x == move.x && known.y == move.y)
+        {
+            ++m_dropped;
+            continue;
+        }
+        m_submit.push_back(move);
+    }
+    m_pending.clear();
+
+    if (m_submit.empty())
+        return 0;
+
+    for (const WindowMove& move : m_submit)
+        m_known[move.window] = KnownPosition{move.x, move.y, true};
+
+    ++m_nativeCalls;
+    size_t count = m_submit.size();
+    m_windowsMoved += count;
+
+    // MoveWindows 可能同步引发新的移动请求（窗口消息），先挂起，调用返回后再提交
+    ++m_batchDepth;
+    m_mover.MoveWindows(m_submit.data(), count);
+    EndBatch();
+    return count;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 一次窗口移动：window 是宿主内的窗口编号（单窗口程序只有 0）
+struct WindowMove
+{
+    uint32_t window;
+    int x;
+    int y;
+};
+
+// 真正移动窗口的一方（Win32 的 SetWindowPos / DeferWindowPos，或回放、测试中的计数器）
+class INativeMover
+{
+public:
+    virtual ~INativeMover() {}
+
+    // 一次调用移动一批窗口，多个窗口应当合并成一次更新
+    virtual void MoveWindows(const WindowMove* moves, size_t count) = 0;
+};
+
+// 移动命令的汇集点：
+// - 目标位置与窗口已知位置相同的移动直接丢弃（例如按住方向键顶在屏幕边缘时）
+// - 批处理期间同一个窗口的多次移动只保留最后一次，结束时所有窗口一起提交给 INativeMover
+// 不在批处理中的请求立即提交。
+class MoveSink
+{
+public:
+    explicit MoveSink(INativeMover& mover);
+
+    // 窗口在原生一侧的当前位置（创建窗口时），不产生移动
+    void SetKnownPosition(uint32_t window, int x, int y);
+
+    // 请求把窗口移到 (x, y)
+    void Request(uint32_t window, int x, int y);
+
+    // 批处理可以嵌套，最外层结束时提交
+    void BeginBatch() { ++m_batchDepth; }
+    void EndBatch();
+
+    // 提交挂起的移动，返回实际移动的窗口数
+    size_t Flush();
+
+    // 作用域内的批处理
+    class Batch
+    {
+    public:
+        explicit Batch(MoveSink& sink) : m_sink(sink) { m_sink.BeginBatch(); }
+        ~Batch() { m_sink.EndBatch(); }
+
+    private:
+        Batch(const Batch&);
+        Batch& operator=(const Batch&);
+
+        MoveSink& m_sink;
+    };
+
+    uint64_t Requests() const { return m_requests; }
+    uint64_t Coalesced() const { return m_coalesced; }      // 被同一批中后来的请求覆盖的移动
+    uint64_t Dropped() const { return m_dropped; }          // 目标就是当前位置的移动
+    uint64_t NativeCalls() const { return m_nativeCalls; }  // INativeMover::MoveWindows 的调用次数
+    uint64_t WindowsMoved() const { return m_windowsMoved; }
+
+private:
+    struct KnownPosition
+    {
+        int x;
+        int y;
+        bool valid;
+    };
+
+    void Reserve(uint32_t window);
+
+    INativeMover& m_mover;
+    std::vector<KnownPosition> m_known;   // 按窗口编号
+    std::vector<int32_t> m_pendingSlot;   // 按窗口编号，在 m_pending 中的下标，-1 表示没有
+    std::vector<WindowMove> m_pending;
+    std::vector<WindowMove> m_submit;     // 提交用的缓冲，复用容量
+    int m_batchDepth;
+
+    uint64_t m_requests;
+    uint64_t m_coalesced;
+    uint64_t m_dropped;
+    uint64_t m_nativeCalls;
+    uint64_t m_windowsMoved;
+};
@@ -0,0 +1,365 @@
+#include "position_feed.h"
+
+#include <cstring>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MW_HAVE_SSE2 1
+#endif
+
+void PublishSnapshot(PositionFeedSegment* segment, const PositionSnapshot& snapshot)
+{
+    // 先把序号改成奇数，release 栅栏保证读者看到新数据时也看到奇数序号
+    uint64_t sequence = segment->sequence.load(std::memory_order_relaxed);
+    segment->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const uint8_t* source = reinterpret_cast<const uint8_t*>(&snapshot);
+    for (size_t i = 0; i < FEED_WORDS; ++i)
+    {
+        uint64_t word;
+        memcpy(&word, source + i * 8, 8);
+        segment->words[i].store(word, std::memory_order_relaxed);
+    }
+    segment->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool TryReadSnapshot(const PositionFeedSegment* segment, PositionSnapshot* snapshot, uint64_t* sequence)
+{
+    uint64_t before = segment->sequence.load(std::memory_order_acquire);
+    if (before & 1)
+        return false;
+
+    // 直接逐字写到 snapshot：先存到局部数组再整体复制，宽读会等不到窄写的转发
+    uint8_t* target = reinterpret_cast<uint8_t*>(snapshot);
+    for (size_t i = 0; i < FEED_WORDS; ++i)
+    {
+        uint64_t word = segment->words[i].load(std::memory_order_relaxed);
+        memcpy(target + i * 8, &word, 8);
+    }
+
+    // acquire 栅栏让上面的读不会排到第二次读序号之后
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (segment->sequence.load(std::memory_order_relaxed) != before)
+        return false;
+
+    if (sequence)
+        *sequence = before / 2;
+    return true;
+}
+
+// 初始化映射好的段，magic 最后写入，读者看到它时其余字段都已就绪
+static void InitializeSegment(void* memory, uint32_t pid)
+{
+    PositionFeedSegment* segment = new (memory) PositionFeedSegment;
+    segment->magic.store(0, std::memory_order_relaxed);
+    segment->version = POSITION_FEED_VERSION;
+    segment->writerPid = pid;
+    segment->reserved = 0;
+    segment->sequence.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < FEED_WORDS; ++i)
+        segment->words[i].store(0, std::memory_order_relaxed);
+    segment->magic.store(POSITION_FEED_MAGIC, std::memory_order_release);
+}
+
+static bool IsReady(const PositionFeedSegment* segment)
+{
+    return segment->magic.load(std::memory_order_acquire) == POSITION_FEED_MAGIC &&
+           segment->version == POSITION_FEED_VERSION;
+}
+
+PositionFeedWriter::PositionFeedWriter()
+    : m_segment(nullptr),
+      m_published(0)
+#if defined(_WIN32)
+      , m_mapping(nullptr)
+#else
+      , m_fd(-1)
+#endif
+{
+}
+
+PositionFeedWriter::~PositionFeedWriter()
+{
+    Close();
+}
+
+void PositionFeedWriter::Publish(const PositionSnapshot& snapshot)
+{
+    if (!m_segment)
+        return;
+    PublishSnapshot(m_segment, snapshot);
+    ++m_published;
+}
+
+PositionFeedReader::PositionFeedReader()
+    : m_segment(nullptr)
+#if defined(_WIN32)
+      , m_mapping(nullptr)
+#endif
+{
+}
+
+PositionFeedReader::~PositionFeedReader()
+{
+    Close();
+}
+
+bool PositionFeedReader::Read(PositionSnapshot* snapshot, uint64_t* retries, uint64_t* sequence) const
+{
+    if (!m_segment || m_segment->magic.load(std::memory_order_relaxed) != POSITION_FEED_MAGIC)
+        return false;
+
+    for (int attempt = 0; attempt < FEED_READ_ATTEMPTS; ++attempt)
+    {
+        if (TryReadSnapshot(m_segment, snapshot, sequence))
+            return true;
+        if (retries)
+            ++*retries;
+#if defined(MW_HAVE_SSE2)
+        _mm_pause();  // 写者正在写，让出流水线给同一核上的另一个线程
+#endif
+    }
+    return false;
+}
+
+uint64_t PositionFeedReader::Sequence() const
+{
+    return m_segment ? m_segment->sequence.load(std::memory_order_acquire) / 2 : 0;
+}
+
+#if defined(_WIN32)
+
+static bool IsProcessAlive(uint32_t pid)
+{
+    HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, pid);
+    if (!process)
+        return GetLastError() == ERROR_ACCESS_DENIED;
+    bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+    CloseHandle(process);
+    return alive;
+}
+
+bool PositionFeedWriter::Open(const char* name)
+{
+    Close();
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0,
+                                        (DWORD)sizeof(PositionFeedSegment), name);
+    if (!mapping)
+        return false;
+    bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(PositionFeedSegment));
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    // 映射还被别的进程打开着：写者仍在运行时不能接管，否则两个写者会交替改写同一个段
+    PositionFeedSegment* segment = static_cast<PositionFeedSegment*>(view);
+    if (existed && IsReady(segment) && IsProcessAlive(segment->writerPid))
+    {
+        UnmapViewOfFile(view);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    InitializeSegment(view, (uint32_t)GetCurrentProcessId());
+    m_mapping = mapping;
+    m_segment = segment;
+    m_published = 0;
+    return true;
+}
+
+void PositionFeedWriter::Close()
+{
+    if (m_segment)
+    {
+        m_segment->magic.store(0, std::memory_order_release);
+        UnmapViewOfFile(m_segment);
+        m_segment = nullptr;
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+}
+
+bool PositionFeedReader::Open(const char* name)
+{
+    Close();
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name);
+    if (!mapping)
+        return false;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(PositionFeedSegment));
+    if (!view)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    m_mapping = mapping;
+    m_segment = static_cast<const PositionFeedSegment*>(view);
+    if (!IsReady(m_segment))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void PositionFeedReader::Close()
+{
+    if (m_segment)
+    {
+        UnmapViewOfFile(m_segment);
+        m_segment = nullptr;
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+}
+
+#else
+
+// 段名现在指向的仍是 fd 打开的那个段（没有被删除后换成别人新建的）
+static bool NameRefersTo(const char* name, int fd)
+{
+    int current = shm_open(name, O_RDONLY, 0);
+    if (current < 0)
+        return false;
+    struct stat held;
+    struct stat named;
+    bool same = fstat(fd, &held) == 0 && fstat(current, &named) == 0 &&
+                held.st_dev == named.st_dev && held.st_ino == named.st_ino;
+    close(current);
+    return same;
+}
+
+// 同名的段已经存在时：写者仍在运行（或正在初始化）返回 true，否则是上次没有正常退出留下的，删除它
+// 写者在整个生命期内对段持有 flock，进程退出时由内核释放，不依赖可能被复用的 pid
+static bool RemoveStaleSegment(const char* name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+    {
+        close(fd);
+        return true;
+    }
+
+    // 持有锁期间别人不会删除这个段；只有名字仍指向它时才删除，不会误删另一个写者刚新建的段
+    if (NameRefersTo(name, fd))
+        shm_unlink(name);
+    close(fd);
+    return false;
+}
+
+bool PositionFeedWriter::Open(const char* name)
+{
+    Close();
+    if (RemoveStaleSegment(name))
+        return false;
+
+    // O_EXCL：只初始化自己新建的段，和同时启动的另一个写者竞争时失败而不是覆盖它
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+        return false;
+
+    // 新建和加锁之间，另一个进程可能把还没加锁的新段当作残留删掉；加锁后名字不再指向它就放弃
+    if (flock(fd, LOCK_EX | LOCK_NB) != 0 || !NameRefersTo(name, fd))
+    {
+        close(fd);
+        return false;
+    }
+
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, sizeof(PositionFeedSegment)) == 0)
+        memory = mmap(nullptr, sizeof(PositionFeedSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (memory == MAP_FAILED)
+    {
+        shm_unlink(name);
+        close(fd);
+        return false;
+    }
+
+    InitializeSegment(memory, (uint32_t)getpid());
+    m_segment = static_cast<PositionFeedSegment*>(memory);
+    m_fd = fd;
+    m_name = name;
+    m_published = 0;
+    return true;
+}
+
+void PositionFeedWriter::Close()
+{
+    if (!m_segment)
+        return;
+
+    // 已经映射着的读者看到 magic 清零后不再读；之后打开的读者找不到这个段
+    m_segment->magic.store(0, std::memory_order_release);
+    munmap(m_segment, sizeof(PositionFeedSegment));
+    shm_unlink(m_name.c_str());
+    // 删除之后才释放锁：等在锁上的进程发现名字已经不指向这个段，不会再删
+    close(m_fd);
+    m_fd = -1;
+    m_segment = nullptr;
+    m_name.clear();
+}
+
+bool PositionFeedReader::Open(const char* name)
+{
+    Close();
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* memory = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && (size_t)info.st_size >= sizeof(PositionFeedSegment))
+        memory = mmap(nullptr, sizeof(PositionFeedSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+
+    m_segment = static_cast<const PositionFeedSegment*>(memory);
+    if (!IsReady(m_segment))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void PositionFeedReader::Close()
+{
+    if (!m_segment)
+        return;
+    munmap(const_cast<PositionFeedSegment*>(m_segment), sizeof(PositionFeedSegment));
+    m_segment = nullptr;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 窗口状态的共享内存发布：窗口程序写，任意多个进程读（录制器、叠加层）
+// 一个写者，读者不加锁也不写共享内存：序号为奇数时正在写，读前后序号不同说明读到一半被改写，重读即可。
+// 写入只是几次存储，不会被读者阻塞；读者之间互不影响，可以以 MHz 的频率轮询。
+
+// 默认的段名：Linux 上是 POSIX 共享内存（/dev/shm/movable_window_feed），Windows 上是命名文件映射
+#if defined(_WIN32)
+const char DEFAULT_POSITION_FEED[] = "Local\\movable_window_feed";
+#else
+const char DEFAULT_POSITION_FEED[] = "/movable_window_feed";
+#endif
+
+const uint32_t POSITION_FEED_MAGIC = 0x44465750;  // "PWFD"
+const uint32_t POSITION_FEED_VERSION = 1;
+const int FEED_READ_ATTEMPTS = 1 << 16;           // Read 的重试上限，写者中途退出时不会一直等下去
+
+enum PositionFeedFlags
+{
+    FEED_RESET_TRIGGERED = 1,  // 移出屏幕，等待自动重置
+    FEED_ANIMATING = 2,        // 正在回到中央（或后退）的动画中
+    FEED_HAS_MOVED = 4,        // 上次重置之后移动过
+};
+
+// 一次发布的窗口状态
+struct PositionSnapshot
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint32_t flags;       // PositionFeedFlags
+    uint32_t reserved;
+    uint64_t resetCount;  // 回到中央的次数
+    uint64_t updateNs;    // 写入时刻（steady_clock 纳秒，同一台机器上各进程可比）
+};
+
+static_assert(sizeof(PositionSnapshot) % 8 == 0, "PositionSnapshot is copied as 64-bit words");
+
+const size_t FEED_WORDS = sizeof(PositionSnapshot) / 8;
+
+// 共享段的布局，按本机字节序；序号和数据在同一条缓存行里，一次读只碰一条缓存行
+struct PositionFeedSegment
+{
+    std::atomic<uint32_t> magic;    // 写者初始化完成后最后写入，关闭时清零
+    uint32_t version;
+    uint32_t writerPid;
+    uint32_t reserved;
+    alignas(64) std::atomic<uint64_t> sequence;  // 已完成的写入次数 * 2，写入中为奇数
+    std::atomic<uint64_t> words[FEED_WORDS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the feed needs address-free 64-bit atomics");
+static_assert(sizeof(PositionFeedSegment) == 128, "PositionFeedSegment is shared between processes");
+
+// 在 segment 上发布一次（调用方保证只有一个写者）
+void PublishSnapshot(PositionFeedSegment* segment, const PositionSnapshot& snapshot);
+
+// 读一次；正在写或读到一半被改写时返回 false（snapshot 的内容无效）。成功时 sequence 为这是第几次写入
+bool TryReadSnapshot(const PositionFeedSegment* segment, PositionSnapshot* snapshot, uint64_t* sequence = nullptr);
+
+// 创建共享段并发布（窗口程序）
+class PositionFeedWriter
+{
+public:
+    PositionFeedWriter();
+    ~PositionFeedWriter();
+
+    // 同名的段属于仍在运行的写者时返回 false；上次没有正常退出留下的段先删除，再新建一个
+    // Linux 上写者在打开期间对段持有 flock，别的进程据此判断段是否还有主人
+    bool Open(const char* name);
+    void Close();
+
+    bool IsOpen() const { return m_segment != nullptr; }
+    void Publish(const PositionSnapshot& snapshot);
+
+    uint64_t Published() const { return m_published; }
+
+private:
+    PositionFeedWriter(const PositionFeedWriter&);
+    PositionFeedWriter& operator=(const PositionFeedWriter&);
+
+    PositionFeedSegment* m_segment;
+    uint64_t m_published;
+#if defined(_WIN32)
+    void* m_mapping;
+#else
+    int m_fd;            // 保持打开，持有 flock
+    std::string m_name;  // 关闭时删除
+#endif
+};
+
+// 只读映射共享段（外部订阅者）
+class PositionFeedReader
+{
+public:
+    PositionFeedReader();
+    ~PositionFeedReader();
+
+    // 段不存在或写者还没有初始化完成时返回 false
+    bool Open(const char* name);
+    void Close();
+
+    bool IsOpen() const { return m_segment != nullptr; }
+
+    // 读到一致的状态为止，retries 累加重读的次数
+    // 写者已经关闭，或超过 FEED_READ_ATTEMPTS 次仍不一致（写者写到一半退出）时返回 false
+    bool Read(PositionSnapshot* snapshot, uint64_t* retries = nullptr, uint64_t* sequence = nullptr) const;
+
+    // 已完成的写入次数，轮询时先比较它，没有变化就不必读整个状态
+    uint64_t Sequence() const;
+
+    uint32_t WriterPid() const { return m_segment ? m_segment->writerPid : 0; }
+
+private:
+    PositionFeedReader(const PositionFeedReader&);
+    PositionFeedReader& operator=(const PositionFeedReader&);
+
+    const PositionFeedSegment* m_segment;
+#if defined(_WIN32)
+    void* m_mapping;
+#endif
+};
@@ -0,0 +1,271 @@
+#include "position_history.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "input_journal.h"
+
+const uint64_t TAG_SMALL_MOVE = 0;
+const uint64_t TAG_MOVE = 1;
+const uint64_t TAG_RESET = 2;
+const size_t MAX_RECORD_BYTES = 10 + 2 * 10;  // 三个 64 位变长整数
+
+static uint64_t ZigZag(int64_t value)
+{
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t UnZigZag(uint64_t value)
+{
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static size_t PutVarint(uint8_t* out, uint64_t value)
+{
+    size_t size = 0;
+    while (value >= 0x80)
+    {
+        out[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = (uint8_t)value;
+    return size;
+}
+
+// 在 sample 上应用下一条记录，数据结束或损坏时返回 false
+static bool DecodeNext(const uint8_t** cursor, const uint8_t* end, HistorySample* sample)
+{
+    uint64_t header;
+    if (!ReadVarint(cursor, end, &header))
+        return false;
+
+    int64_t dx, dy;
+    uint64_t tag = header & 3;
+    if (tag == TAG_SMALL_MOVE)
+    {
+        if (*cursor == end)
+            return false;
+        uint8_t packed = *(*cursor)++;
+        dx = UnZigZag(packed >> 4);
+        dy = UnZigZag(packed & 15);
+    }
+    else if (tag == TAG_MOVE || tag == TAG_RESET)
+    {
+        uint64_t zx, zy;
+        if (!ReadVarint(cursor, end, &zx) || !ReadVarint(cursor, end, &zy))
+            return false;
+        dx = UnZigZag(zx);
+        dy = UnZigZag(zy);
+    }
+    else
+    {
+        return false;
+    }
+
+    sample->timeMs += (int64_t)(header >> 2);
+    sample->pos.x = (int)(sample->pos.x + dx);
+    sample->pos.y = (int)(sample->pos.y + dy);
+    sample->kind = tag == TAG_RESET ? HISTORY_RESET : HISTORY_MOVE;
+    ++sample->index;
+    return true;
+}
+
+PositionHistory::PositionHistory(size_t capacityBytes, size_t blockBytes)
+    : m_blockBytes(std::max(blockBytes, MAX_RECORD_BYTES)),
+      m_head(0),
+      m_blockCount(0),
+      m_samples(0),
+      m_appended(0)
+{
+    // 块头也算在内存上限里；至少两块，丢弃最旧的一块时还留着一块
+    size_t blocks = std::max(capacityBytes / (m_blockBytes + sizeof(Block)), (size_t)2);
+    m_data.resize(blocks * m_blockBytes);
+    m_blocks.resize(blocks);
+    Clear();
+}
+
+void PositionHistory::Clear()
+{
+    m_head = 0;
+    m_blockCount = 0;
+    m_samples = 0;
+    m_appended = 0;
+    m_last = HistorySample{0, PointI{0, 0}, HISTORY_MOVE, 0};
+}
+
+size_t PositionHistory::EncodedBytes() const
+{
+    size_t bytes = 0;
+    for (size_t i = 0; i < m_blockCount; ++i)
+        bytes += sizeof(Block) + BlockAt(i).used;
+    return bytes;
+}
+
+void PositionHistory::StartBlock(const HistorySample& sample)
+{
+    // 满了丢弃最旧的一块
+    if (m_blockCount == m_blocks.size())
+    {
+        m_samples -= m_blocks[m_head].samples;
+        m_head = (m_head + 1) % m_blocks.size();
+        --m_blockCount;
+    }
+
+    Block& block = m_blocks[(m_head + m_blockCount) % m_blocks.size()];
+    block.startMs = sample.timeMs;
+    block.startPos = sample.pos;
+    block.startKind = sample.kind;
+    block.firstIndex = sample.index;
+    block.used = 0;
+    block.samples = 1;
+    block.resets = sample.kind == HISTORY_RESET ? 1 : 0;
+    ++m_blockCount;
+}
+
+void PositionHistory::Append(int64_t timeMs, const PointI& pos, HistoryKind kind)
+{
+    HistorySample sample = {timeMs, pos, kind, m_appended};
+    if (m_blockCount == 0)
+    {
+        StartBlock(sample);
+    }
+    else
+    {
+        if (kind == HISTORY_MOVE && pos.x == m_last.pos.x && pos.y == m_last.pos.y)
+            return;
+
+        int64_t dt = std::max(timeMs - m_last.timeMs, (int64_t)0);
+        int64_t dx = (int64_t)pos.x - m_last.pos.x;
+        int64_t dy = (int64_t)pos.y - m_last.pos.y;
+        sample.timeMs = m_last.timeMs + dt;
+
+        uint8_t record[MAX_RECORD_BYTES];
+        size_t size;
+        if (kind == HISTORY_MOVE && dx >= -8 && dx <= 7 && dy >= -8 && dy <= 7)
+        {
+            size = PutVarint(record, ((uint64_t)dt << 2) | TAG_SMALL_MOVE);
+            record[size++] = (uint8_t)((ZigZag(dx) << 4) | ZigZag(dy));
+        }
+        else
+        {
+            size = PutVarint(record, ((uint64_t)dt << 2) | (kind == HISTORY_RESET ? TAG_RESET : TAG_MOVE));
+            size += PutVarint(record + size, ZigZag(dx));
+            size += PutVarint(record + size, ZigZag(dy));
+        }
+
+        size_t slot = (m_head + m_blockCount - 1) % m_blocks.size();
+        Block& block = m_blocks[slot];
+        if (block.used + size > m_blockBytes)
+        {
+            StartBlock(sample);
+        }
+        else
+        {
+            memcpy(&m_data[slot * m_blockBytes + block.used], record, size);
+            block.used += (uint32_t)size;
+            ++block.samples;
+            if (kind == HISTORY_RESET)
+                ++block.resets;
+        }
+    }
+
+    m_last = sample;
+    ++m_samples;
+    ++m_appended;
+}
+
+bool PositionHistory::Oldest(HistorySample* sample) const
+{
+    if (m_blockCount == 0)
+        return false;
+
+    const Block& block = BlockAt(0);
+    *sample = HistorySample{block.startMs, block.startPos, block.startKind, block.firstIndex};
+    return true;
+}
+
+bool PositionHistory::Latest(HistorySample* sample) const
+{
+    if (m_blockCount == 0)
+        return false;
+
+    *sample = m_last;
+    return true;
+}
+
+bool PositionHistory::At(int64_t timeMs, HistorySample* sample) const
+{
+    if (m_blockCount == 0 || timeMs < BlockAt(0).startMs)
+        return false;
+
+    // 最后一个开始时间不晚于 timeMs 的块
+    size_t low = 0;
+    size_t high = m_blockCount - 1;
+    while (low < high)
+    {
+        size_t middle = (low + high + 1) / 2;
+        if (BlockAt(middle).startMs <= timeMs)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+
+    const Block& block = BlockAt(low);
+    const uint8_t* cursor = BlockData(low);
+    const uint8_t* end = cursor + block.used;
+    HistorySample current = {block.startMs, block.startPos, block.startKind, block.firstIndex};
+    HistorySample next = current;
+    while (DecodeNext(&cursor, end, &next) && next.timeMs <= timeMs)
+        current = next;
+
+    *sample = current;
+    return true;
+}
+
+bool PositionHistory::FindReset(uint64_t before, HistorySample* reset, HistorySample* previous) const
+{
+    for (size_t i = m_blockCount; i-- > 0;)
+    {
+        const Block& block = BlockAt(i);
+        if (block.resets == 0 || block.firstIndex >= before)
+            continue;
+
+        // 从头解码这一块，记下最后一次重置和它前一个样本
+        const uint8_t* cursor = BlockData(i);
+        const uint8_t* end = cursor + block.used;
+        HistorySample current = {block.startMs, block.startPos, block.startKind, block.firstIndex};
+        HistorySample prior = current;
+        bool found = false;
+        bool atStart = false;
+        for (;;)
+        {
+            if (current.kind == HISTORY_RESET && current.index < before)
+            {
+                *reset = current;
+                *previous = prior;
+                found = true;
+                atStart = current.index == block.firstIndex;
+            }
+            prior = current;
+            if (!DecodeNext(&cursor, end, &current))
+                break;
+        }
+        if (!found)
+            continue;
+        if (!atStart)
+            return true;
+
+        // 重置是这一块的第一个样本：之前的样本是上一块的最后一个
+        if (i == 0)
+            return false;
+        const Block& earlier = BlockAt(i - 1);
+        cursor = BlockData(i - 1);
+        end = cursor + earlier.used;
+        *previous = HistorySample{earlier.startMs, earlier.startPos, earlier.startKind, earlier.firstIndex};
+        while (DecodeNext(&cursor, end, previous))
+        {
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+const size_t DEFAULT_HISTORY_BYTES = 256 * 1024;  // 历史记录的内存上限
+const size_t HISTORY_BLOCK_BYTES = 1024;          // 每块的编码数据
+
+enum HistoryKind
+{
+    HISTORY_MOVE,   // 普通移动
+    HISTORY_RESET,  // 回到屏幕中央，位置是重置的目标
+};
+
+// 历史中的一个位置
+struct HistorySample
+{
+    int64_t timeMs;   // 毫秒，单调不减
+    PointI pos;
+    HistoryKind kind;
+    uint64_t index;   // 从 Clear 开始追加的序号
+};
+
+// 窗口位置历史：固定内存的环形缓冲，满了丢弃最旧的一块
+// 每块以一个完整的样本开头（存在块头里），之后每个样本只记与上一个的差：
+//   变长整数 (时间差毫秒 << 2) | 类型
+//   类型 0：一个字节，高 4 位和低 4 位是 zigzag 编码的 dx、dy（-8..7）
+//   类型 1：移动，dx、dy 各一个 zigzag 变长整数
+//   类型 2：重置，同类型 1
+// 16ms 节拍的键盘移动每个样本 2 字节。追加只写当前块，O(1) 且不分配内存；
+// 按时间查找先在块头中二分，再解码一块。
+class PositionHistory
+{
+public:
+    explicit PositionHistory(size_t capacityBytes = DEFAULT_HISTORY_BYTES, size_t blockBytes = HISTORY_BLOCK_BYTES);
+
+    // 位置和上一个样本相同的移动不记录；时间早于上一个样本时按上一个样本的时间记录
+    void Append(int64_t timeMs, const PointI& pos, HistoryKind kind = HISTORY_MOVE);
+    void Clear();
+
+    bool Empty() const { return m_blockCount == 0; }
+    size_t SampleCount() const { return m_samples; }      // 保留着的样本数
+    uint64_t AppendedCount() const { return m_appended; }  // 记录过的样本数（含已丢弃的）
+    size_t EncodedBytes() const;                           // 保留着的样本占用的字节（含块头）
+    size_t MemoryBytes() const { return m_data.size() + m_blocks.size() * sizeof(Block); }
+
+    bool Oldest(HistorySample* sample) const;
+    bool Latest(HistorySample* sample) const;
+
+    // timeMs 时刻窗口所在的位置（不晚于 timeMs 的最后一个样本）；早于最旧的样本时返回 false
+    bool At(int64_t timeMs, HistorySample* sample) const;
+
+    // 序号小于 before 的最后一次重置，以及重置之前的样本；之前的样本已被丢弃时返回 false
+    bool FindReset(uint64_t before, HistorySample* reset, HistorySample* previous) const;
+
+private:
+    PositionHistory(const PositionHistory&);
+    PositionHistory& operator=(const PositionHistory&);
+
+    struct Block
+    {
+        int64_t startMs;     // 第一个样本
+        PointI startPos;
+        HistoryKind startKind;
+        uint64_t firstIndex;
+        uint32_t used;       // 之后的样本编码后的字节数
+        uint32_t samples;    // 含第一个样本
+        uint32_t resets;
+    };
+
+    const Block& BlockAt(size_t i) const { return m_blocks[(m_head + i) % m_blocks.size()]; }
+    const uint8_t* BlockData(size_t i) const { return &m_data[(m_head + i) % m_blocks.size() * m_blockBytes]; }
+    void StartBlock(const HistorySample& sample);
+
+    size_t m_blockBytes;
+    std::vector<uint8_t> m_data;
+    std::vector<Block> m_blocks;  // 环形，m_head 是最旧的一块
+    size_t m_head;
+    size_t m_blockCount;
+    size_t m_samples;
+    uint64_t m_appended;
+    HistorySample m_last;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "geometry.h"
+
+// 字体描述
+struct FontSpec
+{
+    const wchar_t* face;
+    int size;
+    bool bold;
+};
+
+// 文字对齐方式（单行、垂直居中）
+enum TextAlign
+{
+    TEXT_ALIGN_LEFT,
+    TEXT_ALIGN_CENTER
+};
+
+// 绘图后端接口
+// 控制面板只通过这个接口绘制，GDI 和纯软件帧缓冲各自实现
+class IRenderBackend
+{
+public:
+    virtual ~IRenderBackend() {}
+
+    virtual int Width() const = 0;
+    virtual int Height() const = 0;
+
+    // 限制后续绘制的范围，传入整个画布即取消限制
+    virtual void SetClip(const RectI& clip) = 0;
+
+    // 填充实心矩形
+    virtual void FillRect(const RectI& rect, Color color) = 0;
+
+    // 沿矩形内侧描边
+    virtual void FrameRect(const RectI& rect, int borderWidth, Color color) = 0;
+
+    // 填充并描边圆角矩形，radius 为圆角半径
+    virtual void RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth) = 0;
+
+    // 圆角矩形 rect 投下的柔和阴影，向外模糊约 3 * blur 像素，opacity 为 0-255 的不透明度
+    virtual void DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity) = 0;
+
+    // 在矩形内绘制单行文字
+    virtual void DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align) = 0;
+};
@@ -0,0 +1,156 @@
+#include "render_thread.h"
+
+#include "alloc_counter.h"
+#include "latency_stats.h"
+
+PanelRenderThread::PanelRenderThread(IGlyphSource& glyphs)
+    : m_pending(PanelState()),
+      m_pendingWidth(0),
+      m_pendingHeight(0),
+      m_hasPending(false),
+      m_stopping(false),
+      m_atlas(glyphs),
+      m_text(m_atlas),
+      m_lastDamage(RectI{0, 0, 0, 0}),
+      m_sequence(0),
+      m_notified(false),
+      m_rendered(0),
+      m_dropped(0),
+      m_frameAllocations(0)
+{
+}
+
+PanelRenderThread::~PanelRenderThread()
+{
+    Stop();
+}
+
+bool PanelRenderThread::Start(std::function<void()> notify)
+{
+    Stop();
+
+    m_notify = notify;
+    m_stopping = false;
+    m_thread = std::thread([this] { Run(); });
+    return true;
+}
+
+void PanelRenderThread::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+}
+
+void PanelRenderThread::Submit(const PanelState& state, int width, int height)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending = state;
+        m_pendingWidth = width;
+        m_pendingHeight = height;
+        m_hasPending = true;
+    }
+    m_wake.notify_one();
+}
+
+bool PanelRenderThread::TakePending(PanelState* state, int* width, int* height)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_hasPending)
+        return false;
+    *state = m_pending;
+    *width = m_pendingWidth;
+    *height = m_pendingHeight;
+    m_hasPending = false;
+    return true;
+}
+
+bool PanelRenderThread::RenderPending()
+{
+    PanelState state;
+    int width, height;
+    return TakePending(&state, &width, &height) && Render(state, width, height);
+}
+
+bool PanelRenderThread::AcquireFrame()
+{
+    // 先清除通知标记再取：之后完成的帧会再通知一次，不会漏掉
+    m_notified.exchange(false);
+    return m_frames.Acquire();
+}
+
+void PanelRenderThread::Run()
+{
+    PanelState state;
+    for (;;)
+    {
+        int width, height;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this] { return m_hasPending || m_stopping; });
+            if (m_stopping)
+                break;
+            state = m_pending;
+            width = m_pendingWidth;
+            height = m_pendingHeight;
+            m_hasPending = false;
+        }
+
+        if (Render(state, width, height) && !m_notified.exchange(true) && m_notify)
+            m_notify();
+    }
+}
+
+bool PanelRenderThread::Render(const PanelState& state, int width, int height)
+{
+    if (width <= 0 || height <= 0)
+        return false;
+
+    ScopedLatency latency(LATENCY_RENDER);
+    ScopedAllocationCount allocations;
+
+    if (width != m_canvas.Width() || height != m_canvas.Height())
+    {
+        m_canvas.Resize(width, height);
+        m_scene.Layout(width, height);
+    }
+
+    // 只重绘内容变化的节点；什么都没变时不产生新帧
+    const std::vector<RectI>& damage = m_scene.Update(state);
+    RectI dirty = {0, 0, 0, 0};
+    for (size_t i = 0; i < damage.size(); ++i)
+        dirty = UnionRect(dirty, damage[i]);
+    if (IsRectEmpty(dirty))
+        return false;
+
+    {
+        SoftwareBackend backend(m_canvas, &m_text, &m_shadows);
+        m_scene.Paint(backend, dirty);
+    }
+
+    // 上一帧还没被取走时会被这一帧替换，它的变化区域也要算进来
+    RectI report = m_frames.HasUnread() ? UnionRect(dirty, m_lastDamage) : dirty;
+
+    // 三缓冲中空出来的一份可能是几帧之前的内容，整帧复制（同时转换为 BGRA）
+    PanelFrame& frame = m_frames.Back();
+    frame.width = width;
+    frame.height = height;
+    frame.pixels.resize((size_t)width * height);
+    SwapRedBlue(frame.pixels.data(), m_canvas.Pixels(), frame.pixels.size());
+    frame.sequence = ++m_sequence;
+    frame.damage = report;
+
+    if (m_frames.Publish())
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+    m_rendered.fetch_add(1, std::memory_order_relaxed);
+    m_lastDamage = report;
+    m_frameAllocations.store(allocations.Count(), std::memory_order_relaxed);
+    return true;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "scene.h"
+#include "text_layout.h"
+#include "triple_buffer.h"
+
+// 渲染线程交给 UI 线程的一帧
+// 像素是 BGRA（与自上而下的 32 位 DIB 相同），UI 线程可以直接 SetDIBitsToDevice
+struct PanelFrame
+{
+    PanelFrame() : width(0), height(0), sequence(0), damage(RectI{0, 0, 0, 0}) {}
+
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+    uint64_t sequence;   // 0 表示还没有内容
+    RectI damage;        // 与 UI 线程上一次取到的帧相比变化的区域
+};
+
+// 控制面板的渲染线程
+// UI 线程只提交状态（复制一个结构），场景更新、软件绘制和格式转换都在渲染线程上完成，
+// 完成的帧经过三缓冲交给 UI 线程：渲染线程从不等待 UI 线程，UI 线程总是取到最新完成的一帧。
+// 文字通过字形图集绘制，每个字形只向 glyphs 光栅化一次；glyphs 只在渲染线程上使用。
+class PanelRenderThread
+{
+public:
+    explicit PanelRenderThread(IGlyphSource& glyphs);
+    ~PanelRenderThread();
+
+    // 每完成一帧调用一次 notify（在渲染线程上；Win32 中投递一条消息），UI 线程取走之前不再重复调用
+    bool Start(std::function<void()> notify);
+    void Stop();
+    bool IsRunning() const { return m_thread.joinable(); }
+
+    // UI 线程：提交最新的状态和客户区大小，渲染线程来不及处理时只保留最后一份
+    void Submit(const PanelState& state, int width, int height);
+
+    // 不启动线程时在调用者的线程上渲染已提交的状态，返回是否产生了新的一帧
+    bool RenderPending();
+
+    // UI 线程：换到最新完成的帧，返回是否有新帧
+    bool AcquireFrame();
+
+    // UI 线程：最近一次 AcquireFrame 得到的帧
+    const PanelFrame& Frame() const { return m_frames.Front(); }
+
+    uint64_t FramesRendered() const { return m_rendered.load(std::memory_order_relaxed); }
+    uint64_t FramesDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    // 最近一帧渲染时的堆分配次数（需要打开分配统计），预热之后应为 0
+    uint64_t LastFrameAllocations() const { return m_frameAllocations.load(std::memory_order_relaxed); }
+
+private:
+    PanelRenderThread(const PanelRenderThread&);
+    PanelRenderThread& operator=(const PanelRenderThread&);
+
+    void Run();
+    bool TakePending(PanelState* state, int* width, int* height);
+    bool Render(const PanelState& state, int width, int height);
+
+    // UI 线程提交、渲染线程取走
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    PanelState m_pending;
+    int m_pendingWidth;
+    int m_pendingHeight;
+    bool m_hasPending;
+    bool m_stopping;
+
+    // 只在渲染线程上使用
+    GlyphAtlas m_atlas;
+    TextRunCache m_text;
+    ShadowCache m_shadows;
+    PanelScene m_scene;
+    Framebuffer m_canvas;      // 保留上一帧的内容，每帧只重绘变化的节点
+    RectI m_lastDamage;        // 上一次发布的帧报告的区域
+    uint64_t m_sequence;
+
+    TripleBuffer<PanelFrame> m_frames;
+    std::function<void()> m_notify;
+    std::atomic<bool> m_notified;   // 已经通知过、UI 线程还没有取走
+    std::atomic<uint64_t> m_rendered;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_frameAllocations;
+    std::thread m_thread;
+};
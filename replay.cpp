@@ -0,0 +1,99 @@
+#include "replay.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "input_journal.h"
+#include "scheduler.h"
+#include "window_controller.h"
+
+// 无界面宿主：只记录原生移动的调用次数
+class HeadlessHost : public IWindowHost
+{
+public:
+    explicit HeadlessHost(const DisplayLayout& displays) : m_displays(displays), m_moves(0) {}
+
+    const DisplayLayout& Displays() const override { return m_displays; }
+    void MoveWindows(const WindowMove* moves, size_t count) override
+    {
+        (void)moves;
+        (void)count;
+        ++m_moves;
+    }
+    void InvalidatePanel() override {}
+
+    uint64_t Moves() const { return m_moves; }
+
+private:
+    DisplayLayout m_displays;
+    uint64_t m_moves;
+};
+
+// 按截止时间依次执行定时事件，直到 target
+static void AdvanceTo(VirtualClock& clock, EventScheduler& scheduler, WindowController& controller, IClock::TimePoint target)
+{
+    while (scheduler.HasPending())
+    {
+        IClock::TimePoint deadline = scheduler.NextDeadline();
+        if (deadline > target)
+            break;
+
+        clock.Set(std::max(clock.Now(), deadline));
+        controller.RunDueEvents();
+    }
+    clock.Set(std::max(clock.Now(), target));
+}
+
+ReplayResult ReplayJournal(const uint8_t* data, size_t size, const ReplayOptions& options)
+{
+    ReplayResult result = {};
+
+    InputJournalReader reader(data, size);
+    if (!reader.IsValid())
+        return result;
+
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+
+    VirtualClock clock;
+    EventScheduler scheduler(clock);
+    DisplayLayout displays(options.monitors.empty()
+                               ? std::vector<RectI>(1, RectI{0, 0, options.screen.cx, options.screen.cy})
+                               : options.monitors);
+    HeadlessHost host(displays);
+    WindowController controller(host, scheduler);
+
+    // 从主显示器中央开始
+    IClock::TimePoint start = clock.Now();
+    const RectI& primary = displays.Primary();
+    controller.Initialize(primary.left + (RectWidth(primary) - options.window.cx) / 2,
+                          primary.top + (RectHeight(primary) - options.window.cy) / 2,
+                          options.window.cx, options.window.cy);
+    controller.SyncSchedule();
+
+    InputEvent event;
+    int64_t lastTimeUs = 0;
+    while (reader.Next(&event))
+    {
+        AdvanceTo(clock, scheduler, controller, start + std::chrono::microseconds(event.timeUs));
+        if (event.down)
+            controller.OnKeyDown(event.key);
+        else
+            controller.OnKeyUp(event.key);
+
+        lastTimeUs = event.timeUs;
+        ++result.keyEvents;
+    }
+
+    AdvanceTo(clock, scheduler, controller, start + std::chrono::microseconds(lastTimeUs + options.settleUs));
+
+    result.valid = true;
+    result.finalPos = controller.WindowPos();
+    result.resetTriggered = controller.ResetTriggered();
+    result.resetCount = controller.ResetCount();
+    result.timerEvents = scheduler.EventsRun();
+    result.windowMoves = host.Moves();
+    result.movesDropped = controller.Moves().Dropped();
+    result.movesCoalesced = controller.Moves().Coalesced();
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return result;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+// 回放参数
+struct ReplayOptions
+{
+    SizeI screen;          // 屏幕尺寸（monitors 为空时使用的单显示器布局）
+    std::vector<RectI> monitors;  // 多显示器布局，第一个包含原点的是主显示器
+    SizeI window;          // 窗口尺寸
+    int64_t settleUs;      // 最后一个事件之后继续运行的时间，让挂起的自动重置有机会执行
+};
+
+inline ReplayOptions DefaultReplayOptions()
+{
+    return ReplayOptions{SizeI{1920, 1080}, std::vector<RectI>(), SizeI{600, 450}, 10 * 1000 * 1000};
+}
+
+// 回放结果
+struct ReplayResult
+{
+    bool valid;               // 日志格式是否正确
+    PointI finalPos;          // 最终窗口位置
+    bool resetTriggered;      // 结束时是否仍有挂起的重置
+    uint64_t resetCount;      // 重置到中心的次数
+    uint64_t keyEvents;       // 处理的按键事件数
+    uint64_t timerEvents;     // 执行的定时事件数
+    uint64_t windowMoves;     // 原生移动窗口的次数
+    uint64_t movesDropped;    // 位置没有变化而丢弃的移动
+    uint64_t movesCoalesced;  // 同一批中被合并掉的移动
+    double wallSeconds;       // 回放实际耗时
+
+    double EventsPerSecond() const
+    {
+        return wallSeconds > 0.0 ? (keyEvents + timerEvents) / wallSeconds : 0.0;
+    }
+};
+
+// 在虚拟时钟上以最快速度回放按键日志
+// 使用与窗口相同的 WindowController 逻辑，同一份日志总是得到同样的结果
+ReplayResult ReplayJournal(const uint8_t* data, size_t size, const ReplayOptions& options);
@@ -0,0 +1,50 @@
+// 按键日志回放工具
+// 用法：replay_tool <日志文件> [屏幕宽 屏幕高]
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "input_journal.h"
+#include "replay.h"
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: %s <journal> [screen-width screen-height]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint8_t> data;
+    if (!LoadJournal(argv[1], &data))
+    {
+        fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    ReplayOptions options = DefaultReplayOptions();
+    if (argc >= 4)
+    {
+        options.screen.cx = atoi(argv[2]);
+        options.screen.cy = atoi(argv[3]);
+    }
+
+    ReplayResult result = ReplayJournal(data.data(), data.size(), options);
+    if (!result.valid)
+    {
+        fprintf(stderr, "%s is not an input journal\n", argv[1]);
+        return 1;
+    }
+
+    printf("final position:   (%d, %d)\n", result.finalPos.x, result.finalPos.y);
+    printf("reset pending:    %s\n", result.resetTriggered ? "yes" : "no");
+    printf("reset count:      %llu\n", (unsigned long long)result.resetCount);
+    printf("key events:       %llu\n", (unsigned long long)result.keyEvents);
+    printf("timer events:     %llu\n", (unsigned long long)result.timerEvents);
+    printf("window moves:     %llu\n", (unsigned long long)result.windowMoves);
+    printf("moves dropped:    %llu\n", (unsigned long long)result.movesDropped);
+    printf("moves coalesced:  %llu\n", (unsigned long long)result.movesCoalesced);
+    printf("wall time:        %.3f ms\n", result.wallSeconds * 1000.0);
+    printf("events/second:    %.0f\n", result.EventsPerSecond());
+    return 0;
+}
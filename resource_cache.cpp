@@ -0,0 +1,109 @@
+#include "resource_cache.h"
+
+#include <cwchar>
+
+CountingResourceFactory::CountingResourceFactory()
+    : m_nextHandle(1),
+      m_fontsCreated(0),
+      m_brushesCreated(0),
+      m_pensCreated(0),
+      m_destroyed(0)
+{
+}
+
+ResourceHandle CountingResourceFactory::CreateFontResource(const wchar_t* face, int size, int weight)
+{
+    (void)face;
+    (void)size;
+    (void)weight;
+    ++m_fontsCreated;
+    return m_nextHandle++;
+}
+
+ResourceHandle CountingResourceFactory::CreateBrushResource(Color color)
+{
+    (void)color;
+    ++m_brushesCreated;
+    return m_nextHandle++;
+}
+
+ResourceHandle CountingResourceFactory::CreatePenResource(Color color, int width, int style)
+{
+    (void)color;
+    (void)width;
+    (void)style;
+    ++m_pensCreated;
+    return m_nextHandle++;
+}
+
+void CountingResourceFactory::DestroyResource(ResourceHandle handle)
+{
+    (void)handle;
+    ++m_destroyed;
+}
+
+ResourceCache::ResourceCache(IResourceFactory& factory)
+    : m_factory(factory)
+{
+}
+
+ResourceCache::~ResourceCache()
+{
+    Clear();
+}
+
+ResourceHandle ResourceCache::GetFont(const wchar_t* face, int size, int weight)
+{
+    // 字体种类很少，线性查找即可，查找过程不分配内存
+    for (size_t i = 0; i < m_fonts.size(); ++i)
+    {
+        const FontEntry& entry = m_fonts[i];
+        if (entry.size == size && entry.weight == weight && wcscmp(entry.face.c_str(), face) == 0)
+            return entry.handle;
+    }
+
+    FontEntry entry;
+    entry.face = face;
+    entry.size = size;
+    entry.weight = weight;
+    entry.handle = m_factory.CreateFontResource(face, size, weight);
+    m_fonts.push_back(entry);
+    return entry.handle;
+}
+
+ResourceHandle ResourceCache::GetBrush(Color color)
+{
+    std::unordered_map<Color, ResourceHandle>::iterator it = m_brushes.find(color);
+    if (it != m_brushes.end())
+        return it->second;
+
+    ResourceHandle handle = m_factory.CreateBrushResource(color);
+    m_brushes[color] = handle;
+    return handle;
+}
+
+ResourceHandle ResourceCache::GetPen(Color color, int width, int style)
+{
+    uint64_t key = (uint64_t)color | ((uint64_t)(uint16_t)width << 32) | ((uint64_t)(uint16_t)style << 48);
+    std::unordered_map<uint64_t, ResourceHandle>::iterator it = m_pens.find(key);
+    if (it != m_pens.end())
+        return it->second;
+
+    ResourceHandle handle = m_factory.CreatePenResource(color, width, style);
+    m_pens[key] = handle;
+    return handle;
+}
+
+void ResourceCache::Clear()
+{
+    for (size_t i = 0; i < m_fonts.size(); ++i)
+        m_factory.DestroyResource(m_fonts[i].handle);
+    for (std::unordered_map<Color, ResourceHandle>::iterator it = m_brushes.begin(); it != m_brushes.end(); ++it)
+        m_factory.DestroyResource(it->second);
+    for (std::unordered_map<uint64_t, ResourceHandle>::iterator it = m_pens.begin(); it != m_pens.end(); ++it)
+        m_factory.DestroyResource(it->second);
+
+    m_fonts.clear();
+    m_brushes.clear();
+    m_pens.clear();
+}
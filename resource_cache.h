@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry.h"
+
+// 不透明的资源句柄（GDI 中为 HFONT/HBRUSH/HPEN）
+typedef uintptr_t ResourceHandle;
+
+// 字体粗细，与 GDI 的 FW_NORMAL/FW_BOLD 取值一致
+const int FONT_WEIGHT_NORMAL = 400;
+const int FONT_WEIGHT_BOLD = 700;
+
+// 画笔样式，与 GDI 的 PS_SOLID 取值一致
+const int PEN_STYLE_SOLID = 0;
+
+// 资源工厂接口，负责真正创建和销毁底层对象
+class IResourceFactory
+{
+public:
+    virtual ~IResourceFactory() {}
+
+    virtual ResourceHandle CreateFontResource(const wchar_t* face, int size, int weight) = 0;
+    virtual ResourceHandle CreateBrushResource(Color color) = 0;
+    virtual ResourceHandle CreatePenResource(Color color, int width, int style) = 0;
+    virtual void DestroyResource(ResourceHandle handle) = 0;
+};
+
+// 计数用的资源工厂，不创建真实对象，用于无界面运行和统计
+class CountingResourceFactory : public IResourceFactory
+{
+public:
+    CountingResourceFactory();
+
+    ResourceHandle CreateFontResource(const wchar_t* face, int size, int weight) override;
+    ResourceHandle CreateBrushResource(Color color) override;
+    ResourceHandle CreatePenResource(Color color, int width, int style) override;
+    void DestroyResource(ResourceHandle handle) override;
+
+    int FontsCreated() const { return m_fontsCreated; }
+    int BrushesCreated() const { return m_brushesCreated; }
+    int PensCreated() const { return m_pensCreated; }
+    int TotalCreated() const { return m_fontsCreated + m_brushesCreated + m_pensCreated; }
+    int Destroyed() const { return m_destroyed; }
+
+private:
+    ResourceHandle m_nextHandle;
+    int m_fontsCreated;
+    int m_brushesCreated;
+    int m_pensCreated;
+    int m_destroyed;
+};
+
+// 资源缓存：按 (字体名, 字号, 粗细) 和 (颜色, 宽度, 样式) 复用对象，
+// 在窗口整个生命周期内保留，稳定状态下绘制不再创建任何对象
+class ResourceCache
+{
+public:
+    explicit ResourceCache(IResourceFactory& factory);
+    ~ResourceCache();
+
+    ResourceHandle GetFont(const wchar_t* face, int size, int weight);
+    ResourceHandle GetBrush(Color color);
+    ResourceHandle GetPen(Color color, int width, int style);
+
+    // 销毁所有缓存的对象
+    void Clear();
+
+    size_t Size() const { return m_fonts.size() + m_brushes.size() + m_pens.size(); }
+
+private:
+    ResourceCache(const ResourceCache&);
+    ResourceCache& operator=(const ResourceCache&);
+
+    struct FontEntry
+    {
+        std::wstring face;
+        int size;
+        int weight;
+        ResourceHandle handle;
+    };
+
+    IResourceFactory& m_factory;
+    std::vector<FontEntry> m_fonts;
+    std::unordered_map<Color, ResourceHandle> m_brushes;
+    std::unordered_map<uint64_t, ResourceHandle> m_pens;
+};
@@ -0,0 +1,62 @@
+#include "scene.h"
+
+PanelScene::PanelScene()
+    : m_layout(ComputePanelLayout(0, 0)),
+      m_state(),
+      m_needsFullRepaint(true)
+{
+    for (int i = 0; i < PANEL_ELEMENT_COUNT; ++i)
+        m_keys[i] = GetPanelElementKey(m_state, (PanelElement)i);
+}
+
+void PanelScene::Layout(int width, int height)
+{
+    if (width == m_layout.width && height == m_layout.height)
+        return;
+
+    m_layout = ComputePanelLayout(width, height);
+    m_needsFullRepaint = true;
+}
+
+const std::vector<RectI>& PanelScene::Update(const PanelState& state)
+{
+    m_damage.clear();
+    m_state = state;
+
+    if (m_needsFullRepaint)
+    {
+        for (int i = 0; i < PANEL_ELEMENT_COUNT; ++i)
+            m_keys[i] = GetPanelElementKey(state, (PanelElement)i);
+        m_damage.push_back(RectI{0, 0, m_layout.width, m_layout.height});
+        m_needsFullRepaint = false;
+        return m_damage;
+    }
+
+    for (int i = 0; i < PANEL_ELEMENT_COUNT; ++i)
+    {
+        PanelElementKey key = GetPanelElementKey(state, (PanelElement)i);
+        if (key != m_keys[i])
+        {
+            m_keys[i] = key;
+            m_damage.push_back(m_layout.bounds[i]);
+        }
+    }
+    return m_damage;
+}
+
+void PanelScene::Paint(IRenderBackend& backend, const RectI& clip) const
+{
+    RectI area = IntersectRect(clip, RectI{0, 0, m_layout.width, m_layout.height});
+    if (IsRectEmpty(area))
+        return;
+
+    // 节点之间可能重叠，按绘制顺序重绘所有与 clip 相交的节点
+    backend.SetClip(area);
+    DrawPanelBackground(backend, m_layout);
+    for (int i = 0; i < PANEL_ELEMENT_COUNT; ++i)
+    {
+        if (!IsRectEmpty(IntersectRect(m_layout.bounds[i], area)))
+            DrawPanelElement(backend, m_layout, m_state, (PanelElement)i);
+    }
+    backend.SetClip(RectI{0, 0, backend.Width(), backend.Height()});
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "control_panel.h"
+
+// 保留模式的控制面板场景
+// 每个节点记住上次绘制时的内容摘要，状态变化时只报告内容真正改变的节点范围
+class PanelScene
+{
+public:
+    PanelScene();
+
+    // 客户区大小变化时重新布局，整个画布都会被标记为脏区域
+    void Layout(int width, int height);
+
+    // 用新状态更新各节点，返回需要重绘的矩形（每个变化的节点一个）
+    const std::vector<RectI>& Update(const PanelState& state);
+
+    // 在 clip 范围内按当前状态重绘，只绘制与 clip 相交的节点
+    void Paint(IRenderBackend& backend, const RectI& clip) const;
+
+    const PanelLayout& GetLayout() const { return m_layout; }
+    const PanelState& GetState() const { return m_state; }
+
+private:
+    PanelLayout m_layout;
+    PanelState m_state;
+    PanelElementKey m_keys[PANEL_ELEMENT_COUNT];
+    bool m_needsFullRepaint;
+    std::vector<RectI> m_damage;
+};
@@ -0,0 +1,122 @@
+#include "scheduler.h"
+
+#include <algorithm>
+
+EventScheduler::EventScheduler(const IClock& clock)
+    : m_clock(clock),
+      m_pending(0),
+      m_nextSequence(0),
+      m_eventsRun(0)
+{
+}
+
+TimerId EventScheduler::Schedule(TimePoint deadline, Callback callback)
+{
+    uint32_t index;
+    if (!m_freeSlots.empty())
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        if (m_slots.size() >= MAX_SLOTS)
+            return 0;
+        index = (uint32_t)m_slots.size();
+        m_slots.push_back(Slot{0, 0, Callback()});
+    }
+
+    // 代数跳过 0，保证 id 不为 0，槽被复用后旧的 id 不再有效
+    Slot& slot = m_slots[index];
+    if (++slot.generation == 0)
+        slot.generation = 1;
+    slot.id = (TimerId)slot.generation << SLOT_BITS | index;
+    slot.callback = std::move(callback);
+    ++m_pending;
+
+    Entry entry = {deadline, m_nextSequence++, slot.id};
+    m_heap.push_back(entry);
+    std::push_heap(m_heap.begin(), m_heap.end(), Later());
+    return slot.id;
+}
+
+TimerId EventScheduler::ScheduleAfter(std::chrono::steady_clock::duration delay, Callback callback)
+{
+    return Schedule(m_clock.Now() + delay, callback);
+}
+
+bool EventScheduler::Cancel(TimerId id)
+{
+    // 堆中的条目在到达堆顶时再丢弃
+    Slot* slot = Find(id);
+    if (!slot)
+        return false;
+    Release(*slot);
+    return true;
+}
+
+EventScheduler::Slot* EventScheduler::Find(TimerId id)
+{
+    uint32_t index = id & (MAX_SLOTS - 1);
+    if (id == 0 || index >= m_slots.size() || m_slots[index].id != id)
+        return nullptr;
+    return &m_slots[index];
+}
+
+void EventScheduler::Release(Slot& slot)
+{
+    slot.id = 0;
+    slot.callback = nullptr;
+    m_freeSlots.push_back((uint32_t)(&slot - m_slots.data()));
+    --m_pending;
+}
+
+EventScheduler::TimePoint EventScheduler::NextDeadline()
+{
+    DropCancelled();
+    if (m_heap.empty())
+        return TimePoint::max();
+    return m_heap.front().deadline;
+}
+
+int EventScheduler::RunDue()
+{
+    TimePoint now = m_clock.Now();
+    uint64_t sequenceLimit = m_nextSequence;
+    int count = 0;
+
+    for (;;)
+    {
+        DropCancelled();
+        if (m_heap.empty())
+            break;
+
+        const Entry& top = m_heap.front();
+        if (top.deadline > now || top.sequence >= sequenceLimit)
+            break;
+
+        TimerId id = top.id;
+        std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+        m_heap.pop_back();
+
+        // 先取出回调并归还槽：回调里可能安排新的事件
+        Slot* slot = Find(id);
+        Callback callback = std::move(slot->callback);
+        Release(*slot);
+
+        callback();
+        ++count;
+        ++m_eventsRun;
+    }
+
+    return count;
+}
+
+void EventScheduler::DropCancelled()
+{
+    while (!m_heap.empty() && !Find(m_heap.front().id))
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), Later());
+        m_heap.pop_back();
+    }
+}
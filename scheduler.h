@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 时钟接口，便于在测试和回放中注入虚拟时钟
+class IClock
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    virtual ~IClock() {}
+    virtual TimePoint Now() const = 0;
+};
+
+// 真实的单调时钟
+class SteadyClock : public IClock
+{
+public:
+    TimePoint Now() const override { return std::chrono::steady_clock::now(); }
+};
+
+// 虚拟时钟，只在显式推进时前进
+class VirtualClock : public IClock
+{
+public:
+    VirtualClock() : m_now() {}
+    explicit VirtualClock(TimePoint start) : m_now(start) {}
+
+    TimePoint Now() const override { return m_now; }
+    void Set(TimePoint now) { m_now = now; }
+    void Advance(std::chrono::steady_clock::duration delta) { m_now += delta; }
+
+private:
+    TimePoint m_now;
+};
+
+typedef uint32_t TimerId;   // 0 表示无效
+
+// 基于最小堆的截止时间调度器
+// 只在有事件到期时才需要唤醒，空闲时没有任何周期性唤醒。
+// 回调存放在复用的槽里，TimerId 的低 16 位是槽号、高 16 位是槽的代数；
+// 预热之后安排和执行事件都不再分配内存（回调本身不超过 std::function 的内联容量时）
+class EventScheduler
+{
+public:
+    typedef IClock::TimePoint TimePoint;
+    typedef std::function<void()> Callback;
+
+    explicit EventScheduler(const IClock& clock);
+
+    // 在绝对时间 deadline 执行 callback
+    TimerId Schedule(TimePoint deadline, Callback callback);
+
+    // 在 delay 之后执行 callback
+    TimerId ScheduleAfter(std::chrono::steady_clock::duration delay, Callback callback);
+
+    // 取消尚未执行的事件，返回是否取消成功
+    bool Cancel(TimerId id);
+
+    bool HasPending() const { return m_pending != 0; }
+
+    // 最早的截止时间，没有事件时返回 TimePoint::max()
+    TimePoint NextDeadline();
+
+    // 执行所有已到期的事件，返回执行的数量
+    // 回调中新加入的事件即使已经到期，也留到下一次调用
+    int RunDue();
+
+    const IClock& Clock() const { return m_clock; }
+    uint64_t EventsRun() const { return m_eventsRun; }
+
+private:
+    struct Entry
+    {
+        TimePoint deadline;
+        uint64_t sequence;   // 截止时间相同时按加入顺序执行
+        TimerId id;
+    };
+
+    struct Later
+    {
+        bool operator()(const Entry& a, const Entry& b) const
+        {
+            if (a.deadline != b.deadline)
+                return a.deadline > b.deadline;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    // 一个回调槽，id 为 0 表示空闲
+    struct Slot
+    {
+        TimerId id;
+        uint16_t generation;
+        Callback callback;
+    };
+
+    static const uint32_t SLOT_BITS = 16;
+    static const uint32_t MAX_SLOTS = 1u << SLOT_BITS;
+
+    // id 仍在等待执行时返回它的槽，否则返回 nullptr
+    Slot* Find(TimerId id);
+    void Release(Slot& slot);
+
+    // 丢弃堆顶已取消的事件
+    void DropCancelled();
+
+    const IClock& m_clock;
+    std::vector<Entry> m_heap;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    size_t m_pending;
+    uint64_t m_nextSequence;
+    uint64_t m_eventsRun;
+};
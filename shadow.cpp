@@ -0,0 +1,206 @@
+#include "shadow.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MW_HAVE_SSE2 1
+#endif
+
+// 窗口内的和乘以 BoxScale 取高 16 位即为平均值
+// 65536 / (2r + 1) 向上取整：全是 255 的窗口仍得到 255，多遍模糊之后形状内部不会变暗
+static uint16_t BoxScale(int radius)
+{
+    int size = 2 * radius + 1;
+    return (uint16_t)((65536 + size - 1) / size);
+}
+
+// 前 radius 行的列和：第 0 行的窗口是 [-radius, radius]，范围外按 0 计，之后每行先加入 y + radius 行
+static void InitColumnSums(uint16_t* sums, const uint8_t* src, int width, int height, int radius)
+{
+    std::fill(sums, sums + width, (uint16_t)0);
+    for (int y = 0; y < std::min(radius, height); ++y)
+    {
+        const uint8_t* row = src + (size_t)y * width;
+        for (int x = 0; x < width; ++x)
+            sums[x] = (uint16_t)(sums[x] + row[x]);
+    }
+}
+
+// 从第 x 列开始逐列处理一行，SIMD 版本处理完整的组之后用它收尾
+static void BoxBlurRowScalar(uint8_t* out, const uint8_t* add, const uint8_t* remove, uint16_t* sums,
+                             int x, int width, uint16_t scale)
+{
+    for (; x < width; ++x)
+    {
+        uint16_t sum = (uint16_t)(sums[x] + (add ? add[x] : 0));
+        out[x] = (uint8_t)(((uint32_t)sum * scale) >> 16);
+        sums[x] = (uint16_t)(sum - (remove ? remove[x] : 0));
+    }
+}
+
+void BoxBlurColumnsScalar(uint8_t* dst, const uint8_t* src, int width, int height, int radius, uint16_t* sums)
+{
+    uint16_t scale = BoxScale(radius);
+    InitColumnSums(sums, src, width, height, radius);
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* add = y + radius < height ? src + (size_t)(y + radius) * width : nullptr;
+        const uint8_t* remove = y - radius >= 0 ? src + (size_t)(y - radius) * width : nullptr;
+        BoxBlurRowScalar(dst + (size_t)y * width, add, remove, sums, 0, width, scale);
+    }
+}
+
+void BoxBlurColumns(uint8_t* dst, const uint8_t* src, int width, int height, int radius, uint16_t* sums)
+{
+    uint16_t scale = BoxScale(radius);
+    InitColumnSums(sums, src, width, height, radius);
+
+    // 移出窗口的行不存在时用全 0 的一行代替，循环里不用分支
+    static const uint8_t ZERO_ROW[32] = {};
+    for (int y = 0; y < height; ++y)
+    {
+        const uint8_t* add = y + radius < height ? src + (size_t)(y + radius) * width : nullptr;
+        const uint8_t* remove = y - radius >= 0 ? src + (size_t)(y - radius) * width : nullptr;
+        uint8_t* out = dst + (size_t)y * width;
+        int x = 0;
+#if defined(__AVX2__)
+        {
+            __m256i scale16 = _mm256_set1_epi16((short)scale);
+            for (; x + 16 <= width; x += 16)
+            {
+                __m256i in = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(add ? add + x : ZERO_ROW)));
+                __m256i old = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(remove ? remove + x : ZERO_ROW)));
+                __m256i sum = _mm256_add_epi16(_mm256_loadu_si256((const __m256i*)(sums + x)), in);
+                __m256i average = _mm256_mulhi_epu16(sum, scale16);
+                __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(average), _mm256_extracti128_si256(average, 1));
+                _mm_storeu_si128((__m128i*)(out + x), packed);
+                _mm256_storeu_si256((__m256i*)(sums + x), _mm256_sub_epi16(sum, old));
+            }
+        }
+#endif
+#if defined(MW_HAVE_SSE2)
+        {
+            __m128i zero = _mm_setzero_si128();
+            __m128i scale8 = _mm_set1_epi16((short)scale);
+            for (; x + 8 <= width; x += 8)
+            {
+                __m128i in = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(add ? add + x : ZERO_ROW)), zero);
+                __m128i old = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(remove ? remove + x : ZERO_ROW)), zero);
+                __m128i sum = _mm_add_epi16(_mm_loadu_si128((const __m128i*)(sums + x)), in);
+                __m128i average = _mm_mulhi_epu16(sum, scale8);
+                _mm_storel_epi64((__m128i*)(out + x), _mm_packus_epi16(average, zero));
+                _mm_storeu_si128((__m128i*)(sums + x), _mm_sub_epi16(sum, old));
+            }
+        }
+#endif
+        BoxBlurRowScalar(out, add, remove, sums, x, width, scale);
+    }
+}
+
+void TransposeMask(uint8_t* dst, const uint8_t* src, int width, int height)
+{
+    // 8x8 分块，读写都留在缓存里
+    const int TILE = 8;
+    for (int y0 = 0; y0 < height; y0 += TILE)
+    {
+        int y1 = std::min(y0 + TILE, height);
+        for (int x0 = 0; x0 < width; x0 += TILE)
+        {
+            int x1 = std::min(x0 + TILE, width);
+            for (int y = y0; y < y1; ++y)
+            {
+                for (int x = x0; x < x1; ++x)
+                    dst[(size_t)x * height + y] = src[(size_t)y * width + x];
+            }
+        }
+    }
+}
+
+// 抗锯齿的圆角矩形覆盖率，与 SoftwareBackend 填充圆角矩形的规则相同
+static void RasterizeRoundRect(uint8_t* dst, int stride, int left, int top, int width, int height, float radius)
+{
+    radius = std::min(radius, std::min(width, height) * 0.5f);
+    float leftCenter = left + radius;
+    float rightCenter = left + width - radius;
+    float topCenter = top + radius;
+    float bottomCenter = top + height - radius;
+
+    for (int y = top; y < top + height; ++y)
+    {
+        uint8_t* row = dst + (size_t)y * stride;
+        float cy = y + 0.5f;
+        float dy = std::max(std::max(topCenter - cy, cy - bottomCenter), 0.0f);
+        for (int x = left; x < left + width; ++x)
+        {
+            float cx = x + 0.5f;
+            float dx = std::max(std::max(leftCenter - cx, cx - rightCenter), 0.0f);
+            float coverage = dx == 0.0f && dy == 0.0f ? 1.0f : radius - std::sqrt(dx * dx + dy * dy) + 0.5f;
+            row[x] = (uint8_t)(std::min(std::max(coverage, 0.0f), 1.0f) * 255.0f + 0.5f);
+        }
+    }
+}
+
+ShadowCache::ShadowCache()
+    : m_built(0)
+{
+}
+
+const ShadowMask& ShadowCache::Get(int width, int height, int radius, int blur, int opacity)
+{
+    width = std::min(std::max(width, 0), 0xFFFF);
+    height = std::min(std::max(height, 0), 0xFFFF);
+    radius = std::min(std::max(radius, 0), 0xFF);
+    blur = std::min(std::max(blur, 1), MAX_SHADOW_BLUR);
+    opacity = std::min(std::max(opacity, 0), 0xFF);
+
+    uint64_t key = ((uint64_t)width << 40) | ((uint64_t)height << 24) | ((uint64_t)radius << 16) |
+                   ((uint64_t)blur << 8) | (uint64_t)opacity;
+    std::unordered_map<uint64_t, ShadowMask>::iterator it = m_masks.find(key);
+    if (it != m_masks.end())
+        return it->second;
+
+    if (m_masks.size() >= SHADOW_CACHE_LIMIT)
+        m_masks.clear();
+
+    ShadowMask& mask = m_masks[key];
+    Build(mask, width, height, radius, blur, opacity);
+    return mask;
+}
+
+void ShadowCache::Build(ShadowMask& mask, int width, int height, int radius, int blur, int opacity)
+{
+    // 三遍盒式模糊让形状向外扩散 3 * blur 像素
+    mask.margin = 3 * blur;
+    mask.width = width + 2 * mask.margin;
+    mask.height = height + 2 * mask.margin;
+    size_t size = (size_t)mask.width * mask.height;
+    mask.alpha.assign(size, 0);
+    RasterizeRoundRect(mask.alpha.data(), mask.width, mask.margin, mask.margin, width, height, (float)radius);
+
+    m_scratch.resize(size);
+    m_sums.resize(std::max(mask.width, mask.height));
+    uint8_t* a = mask.alpha.data();
+    uint8_t* b = m_scratch.data();
+
+    // 竖直三遍，转置后再竖直三遍（即水平方向），最后转置回来
+    BoxBlurColumns(b, a, mask.width, mask.height, blur, m_sums.data());
+    BoxBlurColumns(a, b, mask.width, mask.height, blur, m_sums.data());
+    BoxBlurColumns(b, a, mask.width, mask.height, blur, m_sums.data());
+    TransposeMask(a, b, mask.width, mask.height);
+    BoxBlurColumns(b, a, mask.height, mask.width, blur, m_sums.data());
+    BoxBlurColumns(a, b, mask.height, mask.width, blur, m_sums.data());
+    BoxBlurColumns(b, a, mask.height, mask.width, blur, m_sums.data());
+    TransposeMask(a, b, mask.height, mask.width);
+
+    if (opacity < 255)
+    {
+        for (size_t i = 0; i < size; ++i)
+            a[i] = (uint8_t)((a[i] * opacity + 127) / 255);
+    }
+    ++m_built;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+const int MAX_SHADOW_BLUR = 32;        // 模糊半径上限
+const size_t SHADOW_CACHE_LIMIT = 64;  // 缓存的遮罩数，超过时整体清空
+
+// 圆角矩形的柔和阴影遮罩（0-255），四周各比形状大 margin 像素
+struct ShadowMask
+{
+    int width;
+    int height;
+    int margin;
+    std::vector<uint8_t> alpha;
+};
+
+// 竖直方向半径为 radius 的盒式模糊（范围外按 0 计），src 与 dst 不能相同
+// sums 为 width 个 16 位的列和；SSE2/AVX2 每次处理 8/16 列，结果与对照实现完全相同
+void BoxBlurColumns(uint8_t* dst, const uint8_t* src, int width, int height, int radius, uint16_t* sums);
+
+// 对照用的逐列实现
+void BoxBlurColumnsScalar(uint8_t* dst, const uint8_t* src, int width, int height, int radius, uint16_t* sums);
+
+// 把 width x height 的遮罩转置为 height x width
+void TransposeMask(uint8_t* dst, const uint8_t* src, int width, int height);
+
+// 按 (尺寸, 圆角, 模糊半径, 不透明度) 缓存阴影遮罩
+// 遮罩只在第一次用到时生成：光栅化圆角矩形，水平和竖直各做三遍盒式模糊（近似标准差为 blur 的高斯），
+// 再乘上不透明度；之后每帧的阴影只是一次混合。
+class ShadowCache
+{
+public:
+    ShadowCache();
+
+    const ShadowMask& Get(int width, int height, int radius, int blur, int opacity);
+
+    void Clear() { m_masks.clear(); }
+    size_t Size() const { return m_masks.size(); }
+    uint64_t Built() const { return m_built; }
+
+private:
+    ShadowCache(const ShadowCache&);
+    ShadowCache& operator=(const ShadowCache&);
+
+    void Build(ShadowMask& mask, int width, int height, int radius, int blur, int opacity);
+
+    std::unordered_map<uint64_t, ShadowMask> m_masks;
+    std::vector<uint8_t> m_scratch;  // 模糊的中间结果
+    std::vector<uint16_t> m_sums;
+    uint64_t m_built;
+};
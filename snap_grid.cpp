@@ -0,0 +1,308 @@
+#include "snap_grid.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+static const size_t MIN_BUCKETS = 64;
+
+static inline bool Intersects(const RectI& a, const RectI& b)
+{
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+static inline int ClampInt(int value, int low, int high)
+{
+    return std::min(std::max(value, low), high);
+}
+
+// 位移 delta 与移动方向相同、比当前最好的更近时采用；方向为 0 的轴不吸附
+static inline void ConsiderSnap(int delta, int direction, int distance, int* best)
+{
+    if (direction == 0 || std::abs(delta) > distance)
+        return;
+    if (delta != 0 && (delta > 0) != (direction > 0))
+        return;
+    if (std::abs(delta) < std::abs(*best))
+        *best = delta;
+}
+
+SnapGrid::SnapGrid(int cellShift)
+    : m_cellShift(cellShift),
+      m_count(0),
+      m_cellUpdates(0),
+      m_buckets(MIN_BUCKETS),
+      m_queryStamp(0)
+{
+}
+
+void SnapGrid::Clear()
+{
+    m_count = 0;
+    m_rects.clear();
+    m_present.clear();
+    m_visited.clear();
+    m_queryStamp = 0;
+    m_buckets.assign(MIN_BUCKETS, std::vector<uint32_t>());
+}
+
+void SnapGrid::Reserve(size_t count)
+{
+    m_rects.reserve(count);
+    m_present.reserve(count);
+    m_visited.reserve(count);
+    if (m_buckets.size() < count)
+    {
+        size_t buckets = MIN_BUCKETS;
+        while (buckets < count)
+            buckets *= 2;
+        Rehash(buckets);
+    }
+}
+
+// 右、下边界不包含在矩形内
+SnapGrid::CellRange SnapGrid::CellsOf(const RectI& rect) const
+{
+    return CellRange{rect.left >> m_cellShift, rect.top >> m_cellShift,
+                     (rect.right - 1) >> m_cellShift, (rect.bottom - 1) >> m_cellShift};
+}
+
+size_t SnapGrid::BucketOf(int cx, int cy) const
+{
+    uint32_t hash = (uint32_t)cx * 0x9E3779B1u + (uint32_t)cy * 0x85EBCA77u;
+    hash ^= hash >> 15;
+    return hash & (m_buckets.size() - 1);
+}
+
+void SnapGrid::AddToCells(uint32_t id, const CellRange& cells)
+{
+    for (int cy = cells.y0; cy <= cells.y1; ++cy)
+    {
+        for (int cx = cells.x0; cx <= cells.x1; ++cx)
+            m_buckets[BucketOf(cx, cy)].push_back(id);
+    }
+}
+
+// 两个单元落在同一个桶里时窗口登记了两次，这里也按单元逐个删除一次
+void SnapGrid::RemoveFromCells(uint32_t id, const CellRange& cells)
+{
+    for (int cy = cells.y0; cy <= cells.y1; ++cy)
+    {
+        for (int cx = cells.x0; cx <= cells.x1; ++cx)
+        {
+            std::vector<uint32_t>& bucket = m_buckets[BucketOf(cx, cy)];
+            std::vector<uint32_t>::iterator it = std::find(bucket.begin(), bucket.end(), id);
+            if (it != bucket.end())
+            {
+                *it = bucket.back();
+                bucket.pop_back();
+            }
+        }
+    }
+}
+
+void SnapGrid::Rehash(size_t bucketCount)
+{
+    m_buckets.assign(bucketCount, std::vector<uint32_t>());
+    for (uint32_t id = 0; id < m_rects.size(); ++id)
+    {
+        if (m_present[id])
+            AddToCells(id, CellsOf(m_rects[id]));
+    }
+}
+
+void SnapGrid::Insert(uint32_t id, const RectI& rect)
+{
+    if (id >= m_rects.size())
+    {
+        m_rects.resize(id + 1, RectI{0, 0, 0, 0});
+        m_present.resize(id + 1, 0);
+        m_visited.resize(id + 1, 0);
+    }
+    if (m_present[id])
+    {
+        Update(id, rect);
+        return;
+    }
+
+    m_rects[id] = rect;
+    m_present[id] = 1;
+    ++m_count;
+
+    // 平均每个桶不超过一个窗口
+    if (m_count > m_buckets.size())
+        Rehash(m_buckets.size() * 2);
+    else
+        AddToCells(id, CellsOf(rect));
+}
+
+void SnapGrid::Update(uint32_t id, const RectI& rect)
+{
+    CellRange before = CellsOf(m_rects[id]);
+    CellRange after = CellsOf(rect);
+    m_rects[id] = rect;
+
+    // 大部分移动都留在原来的单元里
+    if (before.x0 == after.x0 && before.y0 == after.y0 && before.x1 == after.x1 && before.y1 == after.y1)
+        return;
+
+    RemoveFromCells(id, before);
+    AddToCells(id, after);
+    ++m_cellUpdates;
+}
+
+void SnapGrid::Remove(uint32_t id)
+{
+    if (!Contains(id))
+        return;
+    RemoveFromCells(id, CellsOf(m_rects[id]));
+    m_present[id] = 0;
+    --m_count;
+}
+
+size_t SnapGrid::Query(const RectI& area, uint32_t exclude, std::vector<uint32_t>* out) const
+{
+    if (IsRectEmpty(area) || m_count == 0)
+        return 0;
+
+    if (++m_queryStamp == 0)
+    {
+        std::fill(m_visited.begin(), m_visited.end(), 0);
+        m_queryStamp = 1;
+    }
+
+    size_t found = 0;
+    auto visit = [&](const std::vector<uint32_t>& bucket) {
+        for (uint32_t id : bucket)
+        {
+            if (m_visited[id] == m_queryStamp)
+                continue;
+            m_visited[id] = m_queryStamp;
+            if (id != exclude && Intersects(m_rects[id], area))
+            {
+                out->push_back(id);
+                ++found;
+            }
+        }
+    };
+
+    // 区域覆盖的单元比桶还多时直接扫所有的桶
+    CellRange cells = CellsOf(area);
+    int64_t cellCount = (int64_t)(cells.x1 - cells.x0 + 1) * (cells.y1 - cells.y0 + 1);
+    if (cellCount >= (int64_t)m_buckets.size())
+    {
+        for (const std::vector<uint32_t>& bucket : m_buckets)
+            visit(bucket);
+        return found;
+    }
+
+    for (int cy = cells.y0; cy <= cells.y1; ++cy)
+    {
+        for (int cx = cells.x0; cx <= cells.x1; ++cx)
+            visit(m_buckets[BucketOf(cx, cy)]);
+    }
+    return found;
+}
+
+PointI SnapGrid::ResolveMove(uint32_t id, PointI target, const RectI& screen, const SnapOptions& options) const
+{
+    const RectI& from = m_rects[id];
+    int width = RectWidth(from);
+    int height = RectHeight(from);
+    int minX = screen.left + options.visibleMargin - width;
+    int maxX = screen.right - options.visibleMargin;
+    int minY = screen.top + options.visibleMargin - height;
+    int maxY = screen.bottom - options.visibleMargin;
+
+    PointI pos = {ClampInt(target.x, minX, maxX), ClampInt(target.y, minY, maxY)};
+
+    // 吸附：屏幕边缘和附近窗口的边缘，贴边（右对左）和对齐（左对左）都算
+    int distance = options.distance;
+    if (distance > 0)
+    {
+        int dirX = pos.x - from.left;
+        int dirY = pos.y - from.top;
+        RectI moved = MakeRect(pos.x, pos.y, width, height);
+        int snapX = distance + 1;
+        int snapY = distance + 1;
+
+        ConsiderSnap(screen.left - moved.left, dirX, distance, &snapX);
+        ConsiderSnap(screen.right - moved.right, dirX, distance, &snapX);
+        ConsiderSnap(screen.top - moved.top, dirY, distance, &snapY);
+        ConsiderSnap(screen.bottom - moved.bottom, dirY, distance, &snapY);
+
+        m_scratch.clear();
+        Query(RectI{moved.left - distance, moved.top - distance, moved.right + distance, moved.bottom + distance},
+              id, &m_scratch);
+        for (uint32_t other : m_scratch)
+        {
+            const RectI& near = m_rects[other];
+            ConsiderSnap(near.right - moved.left, dirX, distance, &snapX);
+            ConsiderSnap(near.left - moved.right, dirX, distance, &snapX);
+            ConsiderSnap(near.left - moved.left, dirX, distance, &snapX);
+            ConsiderSnap(near.right - moved.right, dirX, distance, &snapX);
+            ConsiderSnap(near.bottom - moved.top, dirY, distance, &snapY);
+            ConsiderSnap(near.top - moved.bottom, dirY, distance, &snapY);
+            ConsiderSnap(near.top - moved.top, dirY, distance, &snapY);
+            ConsiderSnap(near.bottom - moved.bottom, dirY, distance, &snapY);
+        }
+
+        if (snapX <= distance)
+            pos.x = ClampInt(pos.x + snapX, minX, maxX);
+        if (snapY <= distance)
+            pos.y = ClampInt(pos.y + snapY, minY, maxY);
+    }
+
+    if (!options.preventOverlap)
+        return pos;
+
+    // 防止重叠：先沿 x 扫过移动经过的区域，停在最先碰到的窗口边上，再从那里沿 y 扫
+    // 起点已经与之重叠的窗口（比如重置到中央时）不阻挡移动
+    RectI current = from;
+    int dx = pos.x - current.left;
+    if (dx != 0)
+    {
+        RectI swept = dx > 0 ? RectI{current.right, current.top, current.right + dx, current.bottom}
+                             : RectI{current.left + dx, current.top, current.left, current.bottom};
+        m_scratch.clear();
+        Query(swept, id, &m_scratch);
+        for (uint32_t other : m_scratch)
+        {
+            const RectI& block = m_rects[other];
+            if (dx > 0 && block.left >= current.right)
+                dx = std::min(dx, block.left - current.right);
+            else if (dx < 0 && block.right <= current.left)
+                dx = std::max(dx, block.right - current.left);
+        }
+        current.left += dx;
+        current.right += dx;
+    }
+
+    int dy = pos.y - current.top;
+    if (dy != 0)
+    {
+        RectI swept = dy > 0 ? RectI{current.left, current.bottom, current.right, current.bottom + dy}
+                             : RectI{current.left, current.top + dy, current.right, current.top};
+        m_scratch.clear();
+        Query(swept, id, &m_scratch);
+        for (uint32_t other : m_scratch)
+        {
+            const RectI& block = m_rects[other];
+            if (dy > 0 && block.top >= current.bottom)
+                dy = std::min(dy, block.top - current.bottom);
+            else if (dy < 0 && block.bottom <= current.top)
+                dy = std::max(dy, block.bottom - current.top);
+        }
+        current.top += dy;
+    }
+
+    return PointI{current.left, current.top};
+}
+
+PointI SnapGrid::Move(uint32_t id, PointI target, const RectI& screen, const SnapOptions& options)
+{
+    PointI pos = ResolveMove(id, target, screen, options);
+    const RectI& from = m_rects[id];
+    if (pos.x != from.left || pos.y != from.top)
+        Update(id, MakeRect(pos.x, pos.y, RectWidth(from), RectHeight(from)));
+    return pos;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geometry.h"
+
+const int SNAP_CELL_SHIFT = 8;         // 网格单元 256x256 像素
+const int DEFAULT_SNAP_DISTANCE = 12;  // 吸附距离（像素）
+
+struct SnapOptions
+{
+    int distance;         // 边缘相距不超过这个距离时吸附，0 表示不吸附
+    bool preventOverlap;  // 移动在碰到其他窗口时停下
+    int visibleMargin;    // 与屏幕夹紧规则相同：至少保留在屏幕内的像素
+};
+
+// 窗口矩形的空间哈希
+// 每个窗口登记在它覆盖的所有网格单元里，单元按坐标哈希到固定数量的桶；
+// 查询只看与区域相交的单元，移动时只有跨过单元边界才重新登记。
+// 窗口编号是稠密的下标（与 WindowBatch 一致）。查询使用内部的临时数组，不能在多个线程中同时调用。
+class SnapGrid
+{
+public:
+    explicit SnapGrid(int cellShift = SNAP_CELL_SHIFT);
+
+    void Clear();
+    void Reserve(size_t count);
+
+    // id 必须是下一个编号或者已经删除的编号
+    void Insert(uint32_t id, const RectI& rect);
+    void Update(uint32_t id, const RectI& rect);
+    void Remove(uint32_t id);
+
+    bool Contains(uint32_t id) const { return id < m_rects.size() && m_present[id] != 0; }
+    const RectI& Rect(uint32_t id) const { return m_rects[id]; }
+    size_t Size() const { return m_count; }
+
+    // 与 area 相交的窗口（不含 exclude），每个只出现一次，追加到 out，返回数量
+    size_t Query(const RectI& area, uint32_t exclude, std::vector<uint32_t>* out) const;
+
+    // 把窗口 id 从当前位置移向 target（左上角），返回最终位置，不修改网格：
+    //   1. 夹紧到 screen 内
+    //   2. 沿移动方向吸附到 distance 以内的屏幕边缘或相邻窗口的边缘（贴边或对齐），反方向不吸附，离开边缘时不会被拉回
+    //   3. preventOverlap 时按 x、y 两轴依次扫过移动的区域，碰到其他窗口就停在它的边上
+    PointI ResolveMove(uint32_t id, PointI target, const RectI& screen, const SnapOptions& options) const;
+
+    // ResolveMove 之后更新网格
+    PointI Move(uint32_t id, PointI target, const RectI& screen, const SnapOptions& options);
+
+    // 因跨过单元边界而重新登记的次数
+    uint64_t CellUpdates() const { return m_cellUpdates; }
+
+private:
+    struct CellRange
+    {
+        int x0, y0, x1, y1;
+    };
+
+    CellRange CellsOf(const RectI& rect) const;
+    size_t BucketOf(int cx, int cy) const;
+    void AddToCells(uint32_t id, const CellRange& cells);
+    void RemoveFromCells(uint32_t id, const CellRange& cells);
+    void Rehash(size_t bucketCount);
+
+    int m_cellShift;
+    size_t m_count;
+    uint64_t m_cellUpdates;
+    std::vector<RectI> m_rects;
+    std::vector<uint8_t> m_present;
+    std::vector<std::vector<uint32_t>> m_buckets;   // 桶数是 2 的幂
+
+    // 查询去重：窗口覆盖多个单元时只报告一次
+    mutable std::vector<uint32_t> m_visited;
+    mutable uint32_t m_queryStamp;
+    mutable std::vector<uint32_t> m_scratch;
+};
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// 单生产者/单消费者无锁环形队列
+// 生产者只写 m_head，消费者只写 m_tail，各自缓存对方的索引以减少跨核读取。
+// Capacity 必须是 2 的幂，实际可存放 Capacity 个元素。
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing()
+        : m_head(0),
+          m_cachedTail(0),
+          m_tail(0),
+          m_cachedHead(0)
+    {
+    }
+
+    // 生产者调用：队列已满时返回 false
+    bool TryPush(const T& value)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail >= Capacity)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail >= Capacity)
+                return false;
+        }
+
+        m_items[head & (Capacity - 1)] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者调用：队列为空时返回 false
+    bool TryPop(T& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead)
+                return false;
+        }
+
+        value = m_items[tail & (Capacity - 1)];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 近似的元素个数（另一端可能同时在修改）
+    size_t SizeApprox() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    bool EmptyApprox() const { return SizeApprox() == 0; }
+
+    static size_t CapacityValue() { return Capacity; }
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    // 生产者的数据
+    alignas(CACHE_LINE) std::atomic<size_t> m_head;
+    size_t m_cachedTail;
+
+    // 消费者的数据
+    alignas(CACHE_LINE) std::atomic<size_t> m_tail;
+    size_t m_cachedHead;
+
+    alignas(CACHE_LINE) T m_items[Capacity];
+};
@@ -0,0 +1,333 @@
+#include "state_file.h"
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct StateFileHeader
+{
+    uint8_t magic[4];
+    uint32_t version;
+    uint32_t slotSize;
+    uint32_t slotCount;
+};
+
+struct StateSlot
+{
+    uint64_t sequence;   // 0 表示空槽或正在写入
+    uint32_t checksum;   // 序号、长度和状态的 CRC-32
+    uint32_t size;       // sizeof(PersistedState)
+    PersistedState state;
+};
+
+static const size_t STATE_FILE_SIZE = sizeof(StateFileHeader) + STATE_FILE_SLOTS * sizeof(StateSlot);
+
+// 文件布局在各平台上必须一致
+static_assert(sizeof(PersistedBinding) == 4, "PersistedBinding layout");
+static_assert(sizeof(PersistedState) == 32 + 4 * MAX_PERSISTED_BINDINGS, "PersistedState layout");
+static_assert(sizeof(StateFileHeader) == 16, "StateFileHeader layout");
+
+// CRC-32（IEEE 802.3），查找表在静态初始化时建好
+struct Crc32Table
+{
+    uint32_t values[256];
+
+    Crc32Table()
+    {
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            values[i] = crc;
+        }
+    }
+};
+
+static const Crc32Table g_crc32Table;
+
+static uint32_t UpdateCrc32(uint32_t crc, const void* data, size_t size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i)
+        crc = g_crc32Table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static uint32_t SlotChecksum(uint64_t sequence, uint32_t size, const PersistedState& state)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+    crc = UpdateCrc32(crc, &sequence, sizeof(sequence));
+    crc = UpdateCrc32(crc, &size, sizeof(size));
+    crc = UpdateCrc32(crc, &state, sizeof(state));
+    return ~crc;
+}
+
+bool StoreBindings(const KeyBindings& bindings, uint64_t stamp, PersistedState* state)
+{
+    const std::vector<KeyBinding>& list = bindings.Bindings();
+    state->bindingCount = 0;
+    state->bindingsStamp = stamp;
+    memset(state->bindings, 0, sizeof(state->bindings));
+    if (list.size() > MAX_PERSISTED_BINDINGS)
+        return false;
+
+    for (size_t i = 0; i < list.size(); ++i)
+    {
+        state->bindings[i].key = (uint16_t)list[i].key;
+        state->bindings[i].action = (uint8_t)list[i].action;
+    }
+    state->bindingCount = (uint32_t)list.size();
+    return true;
+}
+
+bool RestoreBindings(const PersistedState& state, KeyBindings* bindings)
+{
+    if (state.bindingCount == 0 || state.bindingCount > MAX_PERSISTED_BINDINGS)
+        return false;
+
+    KeyBinding list[MAX_PERSISTED_BINDINGS];
+    for (uint32_t i = 0; i < state.bindingCount; ++i)
+    {
+        if (state.bindings[i].key >= 256 || state.bindings[i].action >= ACTION_COUNT)
+            return false;
+        list[i].key = state.bindings[i].key;
+        list[i].action = (KeyAction)state.bindings[i].action;
+    }
+    bindings->Assign(list, state.bindingCount);
+    return true;
+}
+
+StateFile::StateFile()
+    : m_view(nullptr),
+      m_size(0),
+      m_writes(0),
+#if defined(_WIN32)
+      m_file(INVALID_HANDLE_VALUE),
+      m_mapping(nullptr)
+#else
+      m_fd(-1)
+#endif
+{
+}
+
+StateFile::~StateFile()
+{
+    Close();
+}
+
+bool StateFile::Open(const char* path)
+{
+    Close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    m_file = file;
+
+    // 映射会把较短的文件补零扩展到 STATE_FILE_SIZE
+    m_mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, (DWORD)STATE_FILE_SIZE, nullptr);
+    if (!m_mapping)
+    {
+        Close();
+        return false;
+    }
+
+    m_view = static_cast<uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, STATE_FILE_SIZE));
+    if (!m_view)
+    {
+        Close();
+        return false;
+    }
+#else
+    m_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    // 较短的文件补零扩展到 STATE_FILE_SIZE
+    if ((uint64_t)info.st_size != STATE_FILE_SIZE && ftruncate(m_fd, (off_t)STATE_FILE_SIZE) != 0)
+    {
+        Close();
+        return false;
+    }
+
+    void* view = mmap(nullptr, STATE_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (view == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+    m_view = static_cast<uint8_t*>(view);
+#endif
+    m_size = STATE_FILE_SIZE;
+
+    // 文件头不对时整个文件作废；文件头完好而后面被截断时，补上的零让截掉的槽通不过校验，
+    // 完整的另一个槽仍然可以读取
+    const StateFileHeader* header = reinterpret_cast<const StateFileHeader*>(m_view);
+    if (memcmp(header->magic, STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC)) != 0 ||
+        header->version != STATE_FILE_VERSION ||
+        header->slotSize != sizeof(StateSlot) ||
+        header->slotCount != STATE_FILE_SLOTS)
+    {
+        Initialize();
+    }
+    return true;
+}
+
+void StateFile::Close()
+{
+#if defined(_WIN32)
+    if (m_view)
+    {
+        FlushViewOfFile(m_view, 0);
+        UnmapViewOfFile(m_view);
+    }
+    if (m_mapping)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+    m_mapping = nullptr;
+    m_file = INVALID_HANDLE_VALUE;
+#else
+    if (m_view)
+        munmap(m_view, m_size);
+    if (m_fd >= 0)
+        close(m_fd);
+    m_fd = -1;
+#endif
+    m_view = nullptr;
+    m_size = 0;
+}
+
+void StateFile::Initialize()
+{
+    memset(m_view, 0, m_size);
+
+    StateFileHeader header;
+    memcpy(header.magic, STATE_FILE_MAGIC, sizeof(STATE_FILE_MAGIC));
+    header.version = STATE_FILE_VERSION;
+    header.slotSize = sizeof(StateSlot);
+    header.slotCount = STATE_FILE_SLOTS;
+    memcpy(m_view, &header, sizeof(header));
+}
+
+StateSlot* StateFile::SlotAt(uint32_t index) const
+{
+    return reinterpret_cast<StateSlot*>(m_view + sizeof(StateFileHeader) + index * sizeof(StateSlot));
+}
+
+const StateSlot* StateFile::Latest() const
+{
+    if (!m_view)
+        return nullptr;
+
+    const StateSlot* latest = nullptr;
+    for (uint32_t i = 0; i < STATE_FILE_SLOTS; ++i)
+    {
+        const StateSlot* slot = SlotAt(i);
+        if (slot->sequence == 0 || slot->size != sizeof(PersistedState))
+            continue;
+        if (slot->checksum != SlotChecksum(slot->sequence, slot->size, slot->state))
+            continue;
+        if (!latest || slot->sequence > latest->sequence)
+            latest = slot;
+    }
+    return latest;
+}
+
+bool StateFile::Load(PersistedState* state) const
+{
+    const StateSlot* latest = Latest();
+    if (!latest)
+        return false;
+
+    memcpy(state, &latest->state, sizeof(PersistedState));
+    return true;
+}
+
+uint64_t StateFile::Sequence() const
+{
+    const StateSlot* latest = Latest();
+    return latest ? latest->sequence : 0;
+}
+
+bool StateFile::Store(const PersistedState& state)
+{
+    if (!m_view)
+        return false;
+
+    const StateSlot* latest = Latest();
+    if (latest && memcmp(&latest->state, &state, sizeof(PersistedState)) == 0)
+        return true;
+
+    // 覆盖另一个槽，最新的完整状态在写入期间保持不动
+    StateSlot* target = SlotAt(0);
+    if (latest == target)
+        target = SlotAt(1);
+    uint64_t sequence = latest ? latest->sequence + 1 : 1;
+
+    // 按顺序写：先作废，再写内容和校验和，最后写序号；中途中断时这个槽不会通过校验
+    target->sequence = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    target->size = sizeof(PersistedState);
+    memcpy(&target->state, &state, sizeof(PersistedState));
+    target->checksum = SlotChecksum(sequence, target->size, state);
+    std::atomic_thread_fence(std::memory_order_release);
+    target->sequence = sequence;
+
+    // 交给系统异步写回磁盘
+#if defined(_WIN32)
+    FlushViewOfFile(m_view, 0);
+#else
+    msync(m_view, m_size, MS_ASYNC);
+#endif
+    ++m_writes;
+    return true;
+}
+
+StateSaveThrottle::StateSaveThrottle(std::chrono::steady_clock::duration interval)
+    : m_interval(interval),
+      m_lastSave(),
+      m_saved(false),
+      m_dirty(false)
+{
+}
+
+IClock::TimePoint StateSaveThrottle::DueTime(IClock::TimePoint now) const
+{
+    if (!m_saved)
+        return now;
+
+    IClock::TimePoint due = m_lastSave + m_interval;
+    return due > now ? due : now;
+}
+
+void StateSaveThrottle::Saved(IClock::TimePoint now)
+{
+    m_lastSave = now;
+    m_saved = true;
+    m_dirty = false;
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "key_bindings.h"
+#include "scheduler.h"
+
+// 窗口状态文件：固定布局的二进制文件，映射到内存后原地更新
+//   16 字节文件头：魔数 "MWS1"、版本、槽大小、槽数量
+//   两个槽，每个槽：序号、校验和、状态
+// 写入总是覆盖较旧的槽：先把序号清零，写状态，再写校验和，最后写新序号。
+// 读取时取校验通过且序号最大的槽，写到一半中断（进程崩溃、断电）的槽被忽略，退回上一次完整的状态。
+const uint8_t STATE_FILE_MAGIC[4] = {'M', 'W', 'S', '1'};
+const uint32_t STATE_FILE_VERSION = 1;
+const uint32_t STATE_FILE_SLOTS = 2;
+
+const size_t MAX_PERSISTED_BINDINGS = 64;
+
+const auto STATE_SAVE_INTERVAL = std::chrono::milliseconds(500);   // 两次写入的最小间隔
+
+// 状态中的标志位
+const uint32_t PERSISTED_RESET_TRIGGERED = 1u << 0;   // 退出时已触发自动重置
+
+struct PersistedBinding
+{
+    uint16_t key;
+    uint8_t action;
+    uint8_t reserved;
+};
+
+// 保存的窗口状态，按原样写入文件，所有字段都是定长整数
+struct PersistedState
+{
+    int32_t x;
+    int32_t y;
+    int32_t width;
+    int32_t height;
+    uint32_t flags;
+    uint32_t bindingCount;          // 0 表示没有保存绑定
+    uint64_t bindingsStamp;         // 绑定来源（配置文件）的修改时间，文件变化后重新读取
+    PersistedBinding bindings[MAX_PERSISTED_BINDINGS];
+};
+
+// 把绑定存进状态，超过 MAX_PERSISTED_BINDINGS 时返回 false 且不保存绑定
+bool StoreBindings(const KeyBindings& bindings, uint64_t stamp, PersistedState* state);
+
+// 从状态取出绑定，没有保存或内容无效时返回 false
+bool RestoreBindings(const PersistedState& state, KeyBindings* bindings);
+
+struct StateSlot;
+
+// 内存映射的状态文件
+class StateFile
+{
+public:
+    StateFile();
+    ~StateFile();
+
+    // 打开或创建文件；文件头不对（不存在、版本不同）时重新初始化为空，
+    // 文件被截断时补齐长度，保留仍然完整的槽
+    bool Open(const char* path);
+    void Close();
+
+    bool IsOpen() const { return m_view != nullptr; }
+
+    // 最新的完整状态，没有时返回 false
+    bool Load(PersistedState* state) const;
+
+    // 写入较旧的槽，内容与最新状态相同时不写
+    bool Store(const PersistedState& state);
+
+    // 最新状态的序号，没有时为 0
+    uint64_t Sequence() const;
+
+    uint64_t Writes() const { return m_writes; }
+
+private:
+    StateFile(const StateFile&);
+    StateFile& operator=(const StateFile&);
+
+    StateSlot* SlotAt(uint32_t index) const;
+    const StateSlot* Latest() const;
+    void Initialize();
+
+    uint8_t* m_view;
+    size_t m_size;
+    uint64_t m_writes;
+#if defined(_WIN32)
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_fd;
+#endif
+};
+
+// 写入限速：状态变化只做标记，距上次写入不足 interval 时推迟到间隔结束
+// 写入本身放在调度器的事件里执行，不在移动路径上
+class StateSaveThrottle
+{
+public:
+    explicit StateSaveThrottle(std::chrono::steady_clock::duration interval = STATE_SAVE_INTERVAL);
+
+    // 状态变化了
+    void MarkDirty() { m_dirty = true; }
+    bool IsDirty() const { return m_dirty; }
+
+    // 下一次可以写入的时刻（now 之后，或就是 now）
+    IClock::TimePoint DueTime(IClock::TimePoint now) const;
+
+    // 已经写入（或确认不需要写入）
+    void Saved(IClock::TimePoint now);
+
+private:
+    std::chrono::steady_clock::duration m_interval;
+    IClock::TimePoint m_lastSave;
+    bool m_saved;
+    bool m_dirty;
+};
@@ -0,0 +1,149 @@
+#include <cwchar>
+
+#include "alloc_counter.h"
+#include "bitmap_font.h"
+#include "frame_arena.h"
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "latency_stats.h"
+#include "render_thread.h"
+#include "scene.h"
+#include "shadow.h"
+#include "test_framework.h"
+#include "test_host.h"
+#include "text_layout.h"
+
+// 这些用例只编进打开了分配统计的 allocation_tests
+const int WARMUP_FRAMES = 600;
+const int MEASURED_FRAMES = 600;
+
+// 第 frame 帧的面板状态：按键交替、坐标和倒计时不断变化，延迟叠加层打开
+static PanelState SteadyPanelState(int frame)
+{
+    PanelState state = {};
+    state.upPressed = (frame & 1) != 0;
+    state.rightPressed = (frame & 2) != 0;
+    state.posX = 660 + frame % 97;
+    state.posY = 315 + frame % 53;
+    state.idleSeconds = (frame / 60) % 5;
+    state.showLatency = true;
+    return state;
+}
+
+TEST(AllocationCounterSeesHeapAllocations)
+{
+    CHECK(AllocationCountingEnabled());
+    ScopedAllocationCount count;
+    // 直接调用 operator new，编译器不能省掉
+    void* block = ::operator new(64);
+    ::operator delete(block);
+    CHECK_EQ(count.Count(), (uint64_t)1);
+}
+
+// UI 线程的一帧：重置帧分配器、格式化延迟统计、更新场景、按脏区域重绘
+TEST(SteadyStateSceneFramesDoNotAllocate)
+{
+    Framebuffer target(600, 450);
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas);
+    ShadowCache shadows;
+    SoftwareBackend backend(target, &text, &shadows);
+    FrameArena arena;
+    PanelScene scene;
+    scene.Layout(600, 450);
+
+    uint64_t allocations = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; ++frame)
+    {
+        ScopedAllocationCount count;
+        arena.Reset();
+        RecordLatency(LATENCY_PAINT, 1000 + frame);
+        PanelState state = SteadyPanelState(frame);
+        FormatLatencyOverlay(state.latencyText, sizeof(state.latencyText) / sizeof(state.latencyText[0]), arena);
+        const std::vector<RectI>& damage = scene.Update(state);
+        RectI dirty = {0, 0, 0, 0};
+        for (size_t k = 0; k < damage.size(); ++k)
+            dirty = UnionRect(dirty, damage[k]);
+        scene.Paint(backend, dirty);
+        if (frame >= WARMUP_FRAMES)
+            allocations += count.Count();
+    }
+    CHECK_EQ(allocations, (uint64_t)0);
+}
+
+// 渲染线程的一帧（在调用者线程上执行同一份代码）
+TEST(SteadyStateRenderThreadFramesDoNotAllocate)
+{
+    BitmapFontSource font;
+    PanelRenderThread renderer(font);
+
+    uint64_t allocations = 0;
+    uint64_t renderAllocations = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; ++frame)
+    {
+        ScopedAllocationCount count;
+        PanelState state = SteadyPanelState(frame);
+        swprintf(state.latencyText, sizeof(state.latencyText) / sizeof(state.latencyText[0]), L"p50 %d us", frame % 40);
+        renderer.Submit(state, 600, 450);
+        bool rendered = renderer.RenderPending();
+        bool acquired = renderer.AcquireFrame();
+        if (frame >= WARMUP_FRAMES)
+        {
+            CHECK(rendered);
+            CHECK(acquired);
+            allocations += count.Count();
+            renderAllocations += renderer.LastFrameAllocations();
+        }
+    }
+    CHECK_EQ(allocations, (uint64_t)0);
+    CHECK_EQ(renderAllocations, (uint64_t)0);
+}
+
+// 缓存满后每次未命中都淘汰最久没用的一项：链表节点和索引节点改挂到新字符串上，不分配内存
+TEST(EvictingTextRunsDoesNotAllocate)
+{
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas, 2);
+    FontId id = atlas.RegisterFont(FontSpec{L"Test", 14, false});
+    const wchar_t* labels[] = {L"X: 100", L"X: 101", L"X: 102"};
+
+    uint64_t allocations = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; ++frame)
+    {
+        ScopedAllocationCount count;
+        text.Layout(labels[frame % 3], id, 1);
+        if (frame >= WARMUP_FRAMES)
+            allocations += count.Count();
+    }
+    CHECK_EQ(allocations, (uint64_t)0);
+    CHECK_EQ(text.Hits(), (uint64_t)0);
+    CHECK_EQ(text.Size(), (size_t)2);
+}
+
+// 按住方向键的移动节拍：积分、夹紧、历史记录、合并后的原生移动
+TEST(SteadyStateMovementTicksDoNotAllocate)
+{
+    ControllerFixture fixture;
+
+    uint64_t allocations = 0;
+    for (int frame = 0; frame < WARMUP_FRAMES + MEASURED_FRAMES; ++frame)
+    {
+        ScopedAllocationCount count;
+        // 左右来回移动，不会移出屏幕
+        switch (frame % 120)
+        {
+        case 0:   fixture.controller.OnKeyDown(KEY_RIGHT); break;
+        case 50:  fixture.controller.OnKeyUp(KEY_RIGHT); break;
+        case 60:  fixture.controller.OnKeyDown(KEY_LEFT); break;
+        case 110: fixture.controller.OnKeyUp(KEY_LEFT); break;
+        default:  break;
+        }
+        fixture.RunFor(MOVE_TICK_INTERVAL);
+        if (frame >= WARMUP_FRAMES)
+            allocations += count.Count();
+    }
+    CHECK_EQ(allocations, (uint64_t)0);
+    CHECK(fixture.host.Calls() > 0);
+}
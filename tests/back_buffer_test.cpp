@@ -0,0 +1,145 @@
+#include "back_buffer.h"
+#include "framebuffer.h"
+#include "test_framework.h"
+
+// 内存表面工厂，额外统计仍然存在的表面
+struct TrackingSurfaceFactory
+{
+    typedef Framebuffer* Surface;
+
+    explicit TrackingSurfaceFactory(int* live) : live(live) {}
+
+    Surface Create(int width, int height)
+    {
+        ++*live;
+        return inner.Create(width, height);
+    }
+
+    void Destroy(Surface& surface)
+    {
+        --*live;
+        inner.Destroy(surface);
+    }
+
+    FramebufferSurfaceFactory inner;
+    int* live;
+};
+
+TEST(GrowBufferExtentPolicy)
+{
+    // 第一次按需要的尺寸对齐到 64
+    CHECK_EQ(GrowBufferExtent(0, 600), 640);
+    CHECK_EQ(GrowBufferExtent(0, 64), 64);
+    // 容量够用时不变
+    CHECK_EQ(GrowBufferExtent(640, 600), 640);
+    CHECK_EQ(GrowBufferExtent(640, 640), 640);
+    // 不够时至少增长到 1.5 倍
+    CHECK_EQ(GrowBufferExtent(640, 641), 960);
+    CHECK_EQ(GrowBufferExtent(640, 2000), 2048);
+    // 缩小到容量的四分之一以下才收缩
+    CHECK_EQ(GrowBufferExtent(960, 240), 960);
+    CHECK_EQ(GrowBufferExtent(960, 239), 256);
+    // 尺寸为 0（最小化）时保留
+    CHECK_EQ(GrowBufferExtent(960, 0), 960);
+}
+
+TEST(BackBufferPoolReusesSurfaceWithinCapacity)
+{
+    int live = 0;
+    {
+        TrackingSurfaceFactory factory(&live);
+        BackBufferPool<TrackingSurfaceFactory> pool(factory);
+        CHECK(pool.Resize(600, 450));
+        Framebuffer* surface = pool.BeginFrame();
+        pool.EndFrame();
+        CHECK_EQ(surface->Width(), 640);
+        CHECK_EQ(surface->Height(), 512);
+        CHECK_EQ(pool.Allocations(), 1);
+
+        // 在容量以内调整大小不重新分配，同一个表面继续使用
+        CHECK(!pool.Resize(620, 500));
+        CHECK(!pool.Resize(500, 400));
+        CHECK(pool.BeginFrame() == surface);
+        pool.EndFrame();
+        CHECK(*pool.PresentableSurface() == surface);
+        CHECK_EQ(pool.Width(), 500);
+        CHECK_EQ(pool.Height(), 400);
+        CHECK_EQ(pool.Allocations(), 1);
+        CHECK_EQ(pool.Reuses(), 1);
+        CHECK_EQ(live, 1);
+
+        // 超出容量时释放旧表面，下一帧按新的容量分配
+        CHECK(pool.Resize(700, 450));
+        CHECK_EQ(live, 0);
+        CHECK(pool.PresentableSurface() == nullptr);
+        CHECK_EQ(pool.BeginFrame()->Width(), 960);
+        pool.EndFrame();
+        CHECK_EQ(pool.Allocations(), 2);
+        CHECK_EQ(live, 1);
+    }
+    CHECK_EQ(live, 0);
+}
+
+TEST(BackBufferPoolDragResizeAllocatesLogarithmically)
+{
+    int live = 0;
+    TrackingSurfaceFactory factory(&live);
+    BackBufferPool<TrackingSurfaceFactory> pool(factory);
+
+    // 把窗口从 600 像素宽逐像素拖到 1400：容量 640 -> 960 -> 1472（1440 对齐到 64）
+    int reallocations = 0;
+    for (int width = 600; width <= 1400; ++width)
+    {
+        if (pool.Resize(width, 450))
+            ++reallocations;
+        Framebuffer* surface = pool.BeginFrame();
+        CHECK(surface->Width() >= width);
+        pool.EndFrame();
+    }
+    CHECK_EQ(reallocations, 3);
+    CHECK_EQ(pool.Allocations(), 3);
+    CHECK_EQ(pool.Reuses(), 801 - 3);
+    CHECK_EQ(pool.CapacityWidth(), 1472);
+
+    // 再拖回去也不收缩，直到不到四分之一
+    bool shrunk = false;
+    for (int width = 1400; width >= 1472 / 4; --width)
+        shrunk = shrunk || pool.Resize(width, 450);
+    CHECK(!shrunk);
+    CHECK(pool.Resize(1472 / 4 - 1, 100));
+    CHECK_EQ(pool.CapacityWidth(), 384);
+    CHECK_EQ(pool.CapacityHeight(), 128);
+
+    pool.Release();
+    CHECK_EQ(live, 0);
+}
+
+TEST(BackBufferPoolRotatesTripleBuffers)
+{
+    int live = 0;
+    TrackingSurfaceFactory factory(&live);
+    BackBufferPool<TrackingSurfaceFactory> pool(factory, 3);
+    CHECK_EQ(pool.BufferCount(), 3);
+    pool.Resize(320, 240);
+
+    // 前三帧各分配一个表面，之后依次轮换复用
+    Framebuffer* surfaces[6];
+    for (int frame = 0; frame < 6; ++frame)
+    {
+        surfaces[frame] = pool.BeginFrame();
+        surfaces[frame]->Row(0)[0] = (uint32_t)frame;
+        pool.EndFrame();
+        CHECK(*pool.PresentableSurface() == surfaces[frame]);
+    }
+    CHECK(surfaces[0] != surfaces[1] && surfaces[1] != surfaces[2] && surfaces[0] != surfaces[2]);
+    CHECK(surfaces[3] == surfaces[0]);
+    CHECK(surfaces[4] == surfaces[1]);
+    CHECK(surfaces[5] == surfaces[2]);
+    CHECK_EQ(pool.Allocations(), 3);
+    CHECK_EQ(pool.Reuses(), 3);
+    CHECK_EQ(live, 3);
+
+    // 轮换不清除内容：呈现的是最后一帧写入的表面
+    CHECK_EQ((*pool.PresentableSurface())->PixelAt(0, 0), (uint32_t)5);
+    CHECK_EQ(surfaces[0]->PixelAt(0, 0), (uint32_t)3);
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
+
+#include "command_channel.h"
+#include "test_framework.h"
+
+static WindowCommand MakeCommand(uint32_t index)
+{
+    WindowCommand command = {};
+    command.type = COMMAND_MOVE_BY;
+    command.x = (int32_t)index;
+    command.y = -(int32_t)index;
+    command.sentNs = 1000 + index;
+    return command;
+}
+
+static bool SameCommand(const WindowCommand& a, const WindowCommand& b)
+{
+    return std::memcmp(&a, &b, sizeof(WindowCommand)) == 0;
+}
+
+// 按 sizes 依次切开字节流喂给解码器，返回解出的所有命令
+static std::vector<WindowCommand> FeedInPieces(const std::vector<WindowCommand>& commands, const std::vector<size_t>& sizes)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(commands.data());
+    size_t total = commands.size() * sizeof(WindowCommand);
+    std::vector<WindowCommand> decoded;
+    CommandDecoder decoder;
+    size_t offset = 0;
+    for (size_t i = 0; offset < total; ++i)
+    {
+        size_t size = std::min(sizes[i % sizes.size()], total - offset);
+        size_t before = decoded.size();
+        size_t count = decoder.Feed(data + offset, size, [&](const WindowCommand& command) { decoded.push_back(command); });
+        offset += size;
+        // 返回值就是这次交出的命令数，已经凑齐的命令立即交出
+        CHECK_EQ(count, decoded.size() - before);
+        CHECK_EQ(decoded.size(), offset / sizeof(WindowCommand));
+    }
+    return decoded;
+}
+
+TEST(CommandDecoderReassemblesPartialRecords)
+{
+    std::vector<WindowCommand> commands;
+    for (uint32_t i = 0; i < 5; ++i)
+        commands.push_back(MakeCommand(i));
+
+    // 每次一个字节；23 + 1 + 24（半条跨两次读取，之后正好一整条）；以及不规则的切法
+    const std::vector<size_t> splits[] = {{1}, {23, 1, 24}, {47, 2, 50, 1, 20}, {120}};
+    for (const std::vector<size_t>& sizes : splits)
+    {
+        std::vector<WindowCommand> decoded = FeedInPieces(commands, sizes);
+        CHECK_EQ(decoded.size(), commands.size());
+        for (size_t i = 0; i < decoded.size() && i < commands.size(); ++i)
+            CHECK(SameCommand(decoded[i], commands[i]));
+    }
+
+    // 23 字节之后补 1 字节：这一次正好交出 1 条
+    CommandDecoder decoder;
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(commands.data());
+    size_t delivered = 0;
+    auto sink = [&](const WindowCommand&) { ++delivered; };
+    CHECK_EQ(decoder.Feed(data, 23, sink), (size_t)0);
+    CHECK_EQ(decoder.Feed(data + 23, 1, sink), (size_t)1);
+    CHECK_EQ(decoder.Feed(data + 24, 24, sink), (size_t)1);
+    CHECK_EQ(delivered, (size_t)2);
+
+    // Reset 丢弃半条命令
+    CHECK_EQ(decoder.Feed(data, 10, sink), (size_t)0);
+    decoder.Reset();
+    CHECK_EQ(decoder.Feed(data + 24, 24, sink), (size_t)1);
+    CHECK_EQ(delivered, (size_t)3);
+}
+
+#if !defined(_WIN32)
+
+TEST(CommandSocketRoundTrip)
+{
+    std::string endpoint = "/tmp/movable_window_command_test." + std::to_string((long long)getpid()) + ".sock";
+    std::atomic<int> notified(0);
+    CommandServer server;
+    CHECK(server.Start(endpoint.c_str(), [&notified] { notified.fetch_add(1); }));
+
+    // 比队列长得多的一批：后台线程在队列满时等待取出，不丢弃、不乱序
+    const uint32_t count = 3 * 4096 + 17;
+    std::vector<WindowCommand> sent;
+    for (uint32_t i = 0; i < count; ++i)
+        sent.push_back(MakeCommand(i));
+
+    CommandClient client;
+    CHECK(client.Connect(endpoint.c_str()));
+    std::thread sender([&client, &sent] { client.Send(sent.data(), sent.size()); });
+
+    std::vector<WindowCommand> received;
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (received.size() < count && std::chrono::steady_clock::now() < deadline)
+    {
+        if (server.Drain(&received) == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    sender.join();
+
+    CHECK_EQ(received.size(), (size_t)count);
+    bool inOrder = received.size() == sent.size();
+    for (size_t i = 0; inOrder && i < received.size(); ++i)
+        inOrder = SameCommand(received[i], sent[i]);
+    CHECK(inOrder);
+    CHECK_EQ(server.Received(), (uint64_t)count);
+    CHECK_EQ(server.Connections(), (uint64_t)1);
+    CHECK(notified.load() > 0);
+
+    // 同一个端点上已有服务器在监听：第二个服务器启动失败，不删除它的套接字
+    CommandServer second;
+    CHECK(!second.Start(endpoint.c_str(), std::function<void()>()));
+
+    // 队列满时等待中的后台线程也能被 Stop 及时叫醒
+    CommandClient flood;
+    CHECK(flood.Connect(endpoint.c_str()));
+    flood.Send(sent.data(), 4096 + 100);
+    deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (server.Received() < count + 4000 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(server.Received() >= count + 4000);
+    server.Stop();
+    CHECK(!server.IsRunning());
+    CHECK(access(endpoint.c_str(), F_OK) != 0);
+}
+
+#endif
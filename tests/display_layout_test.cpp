@@ -0,0 +1,147 @@
+#include <climits>
+#include <vector>
+
+#include "display_layout.h"
+#include "test_framework.h"
+
+// 主显示器右上方是空的 L 形
+static std::vector<RectI> LShaped()
+{
+    std::vector<RectI> monitors;
+    monitors.push_back(MakeRect(0, 0, 1920, 1080));
+    monitors.push_back(MakeRect(1920, 1080, 1920, 1080));
+    return monitors;
+}
+
+// 混合分辨率：左边 1080p 底部对齐，中间 1440p 主显示器，右边竖放的 1080x1920；主显示器不在第一个
+static std::vector<RectI> MixedResolution()
+{
+    std::vector<RectI> monitors;
+    monitors.push_back(MakeRect(-1920, 360, 1920, 1080));
+    monitors.push_back(MakeRect(0, 0, 2560, 1440));
+    monitors.push_back(MakeRect(2560, -240, 1080, 1920));
+    return monitors;
+}
+
+// 逐个显示器比较的参考实现
+static bool NaiveFullyOffScreen(const std::vector<RectI>& monitors, const RectI& rect)
+{
+    for (const RectI& monitor : monitors)
+    {
+        if (!IsRectEmpty(IntersectRect(monitor, rect)))
+            return false;
+    }
+    return true;
+}
+
+static RectI NaiveNearest(const std::vector<RectI>& monitors, const PointI& point)
+{
+    RectI best = monitors[0];
+    long long bestDistance = LLONG_MAX;
+    for (const RectI& monitor : monitors)
+    {
+        long long dx = point.x < monitor.left ? monitor.left - point.x : (point.x >= monitor.right ? point.x - monitor.right + 1 : 0);
+        long long dy = point.y < monitor.top ? monitor.top - point.y : (point.y >= monitor.bottom ? point.y - monitor.bottom + 1 : 0);
+        if (dx * dx + dy * dy < bestDistance)
+        {
+            bestDistance = dx * dx + dy * dy;
+            best = monitor;
+        }
+    }
+    return best;
+}
+
+// 在虚拟桌面周围随机取矩形和点，与参考实现逐一比较
+static void CheckAgainstNaive(const std::vector<RectI>& monitors)
+{
+    DisplayLayout layout(monitors);
+    const RectI& bounds = layout.VirtualBounds();
+    uint32_t state = 777;
+    int mismatches = 0;
+    for (int i = 0; i < 20000; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        int x = bounds.left - 800 + (int)((state >> 8) % (uint32_t)(RectWidth(bounds) + 1600));
+        state = state * 1664525u + 1013904223u;
+        int y = bounds.top - 600 + (int)((state >> 8) % (uint32_t)(RectHeight(bounds) + 1200));
+        state = state * 1664525u + 1013904223u;
+        int width = 1 + (int)((state >> 8) % 900);
+        int height = 1 + (int)((state >> 20) % 700);
+
+        RectI rect = MakeRect(x, y, width, height);
+        if (layout.IsFullyOffScreen(rect) != NaiveFullyOffScreen(monitors, rect))
+            ++mismatches;
+        PointI point = {x, y};
+        if (layout.NearestMonitor(point) != NaiveNearest(monitors, point))
+            ++mismatches;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+TEST(DisplayLayoutLShaped)
+{
+    DisplayLayout layout(LShaped());
+    CHECK_EQ(layout.VirtualBounds(), (RectI{0, 0, 3840, 2160}));
+    CHECK_EQ(layout.Primary(), (RectI{0, 0, 1920, 1080}));
+
+    // 外接矩形里的两个空角落都算屏幕外
+    CHECK(layout.IsFullyOffScreen(MakeRect(2500, 100, 600, 450)));
+    CHECK(layout.IsFullyOffScreen(MakeRect(100, 1500, 600, 450)));
+    // 横跨两个显示器接缝、只露出一角都不算
+    CHECK(!layout.IsFullyOffScreen(MakeRect(1700, 900, 600, 450)));
+    CHECK(!layout.IsFullyOffScreen(MakeRect(1919, 100, 600, 450)));
+    CHECK(!layout.IsFullyOffScreen(MakeRect(2500, 1079, 600, 450)));
+    CHECK(layout.IsFullyOffScreen(MakeRect(2500, 1080 - 450, 600, 450)));
+
+    // 空角落里的点回到离它最近的显示器
+    CHECK_EQ(layout.NearestMonitor(PointI{3000, 900}), (RectI{1920, 1080, 3840, 2160}));
+    CHECK_EQ(layout.NearestMonitor(PointI{2000, 100}), (RectI{0, 0, 1920, 1080}));
+    CHECK_EQ(layout.NearestMonitorCenter(PointI{3000, 900}).x, 2880);
+    CHECK_EQ(layout.NearestMonitorCenter(PointI{3000, 900}).y, 1620);
+
+    CheckAgainstNaive(LShaped());
+}
+
+TEST(DisplayLayoutMixedResolution)
+{
+    DisplayLayout layout(MixedResolution());
+    CHECK_EQ(layout.MonitorCount(), (size_t)3);
+    CHECK_EQ(layout.VirtualBounds(), (RectI{-1920, -240, 3640, 1680}));
+    // 包含原点的才是主显示器
+    CHECK_EQ(layout.Primary(), (RectI{0, 0, 2560, 1440}));
+
+    // 左边显示器上方、右边竖屏下方的空隙
+    CHECK(layout.IsFullyOffScreen(MakeRect(-1500, 0, 600, 300)));
+    CHECK(!layout.IsFullyOffScreen(MakeRect(-1500, 0, 600, 361)));
+    CHECK(layout.IsFullyOffScreen(MakeRect(2700, 1680, 600, 450)));
+    CHECK(layout.IsFullyOffScreen(MakeRect(2600, -700, 600, 450)));
+    CHECK(!layout.IsFullyOffScreen(MakeRect(2600, -700, 600, 461)));
+
+    CHECK_EQ(layout.NearestMonitor(PointI{-1000, 100}), (RectI{-1920, 360, 0, 1440}));
+    CHECK_EQ(layout.NearestMonitor(PointI{3000, 1600}), (RectI{2560, -240, 3640, 1680}));
+    CHECK_EQ(layout.NearestMonitor(PointI{100, 1500}), (RectI{0, 0, 2560, 1440}));
+
+    CheckAgainstNaive(MixedResolution());
+}
+
+TEST(DisplayLayoutManyMonitorsMatchesNaive)
+{
+    // 大小不一、上下错开的一排显示器
+    std::vector<RectI> monitors;
+    int x = 0;
+    for (int i = 0; i < 12; ++i)
+    {
+        int width = 1280 + (i % 3) * 640;
+        int height = 720 + (i % 4) * 360;
+        monitors.push_back(MakeRect(x, (i % 5) * 200 - 400, width, height));
+        x += width + (i % 2) * 100;
+    }
+    CheckAgainstNaive(monitors);
+}
+
+TEST(DisplayLayoutEmptyListFallsBackToDefault)
+{
+    DisplayLayout layout(std::vector<RectI>(1, RectI{10, 10, 10, 20}));
+    CHECK_EQ(layout.MonitorCount(), (size_t)1);
+    CHECK_EQ(layout.Primary(), (RectI{0, 0, 1920, 1080}));
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "framebuffer.h"
+#include "test_framework.h"
+
+// 前后各留 16 个哨兵像素，检查向量路径不会越界写
+static const int GUARD = 16;
+static const uint32_t SENTINEL = 0xDEADBEEF;
+
+static std::vector<uint32_t> RandomOpaquePixels(std::mt19937& random, size_t count)
+{
+    std::vector<uint32_t> pixels(count);
+    for (uint32_t& pixel : pixels)
+        pixel = (uint32_t)random() | 0xFF000000;
+    return pixels;
+}
+
+TEST(FillSpanMatchesScalarAtUnalignedWidths)
+{
+    for (int offset = 0; offset < 8; ++offset)
+    {
+        for (int count = 0; count <= 41; ++count)
+        {
+            std::vector<uint32_t> buffer(GUARD + 8 + count + GUARD, SENTINEL);
+            FillSpan(buffer.data() + GUARD + offset, count, 0xFF123456);
+
+            bool exact = true;
+            for (int i = 0; i < (int)buffer.size(); ++i)
+            {
+                bool inside = i >= GUARD + offset && i < GUARD + offset + count;
+                exact = exact && buffer[i] == (inside ? 0xFF123456 : SENTINEL);
+            }
+            CHECK(exact);
+        }
+    }
+}
+
+TEST(BlendCoverageSpanMatchesScalarAtUnalignedWidths)
+{
+    std::mt19937 random(2);
+    for (int offset = 0; offset < 8; ++offset)
+    {
+        for (int count = 0; count <= 67; ++count)
+        {
+            // 成段的 0 和 255 走跳过和直接写入的快速路径，其余是任意覆盖率
+            std::vector<uint8_t> coverage(8 + count);
+            for (size_t i = 0; i < coverage.size(); ++i)
+            {
+                int kind = (int)((i / 8 + offset) % 3);
+                coverage[i] = kind == 0 ? 0 : kind == 1 ? 255 : (uint8_t)random();
+            }
+            if (count % 5 == 0)
+            {
+                for (uint8_t& c : coverage)
+                    c = (uint8_t)random();
+            }
+
+            std::vector<uint32_t> pixels = RandomOpaquePixels(random, GUARD + 8 + count + GUARD);
+            std::vector<uint32_t> vector = pixels;
+            std::vector<uint32_t> scalar = pixels;
+            uint32_t value = (uint32_t)random() | 0xFF000000;
+            BlendCoverageSpan(vector.data() + GUARD + offset, coverage.data() + offset, count, value);
+            BlendCoverageSpanScalar(scalar.data() + GUARD + offset, coverage.data() + offset, count, value);
+            CHECK(vector == scalar);
+        }
+    }
+}
+
+// 对照用的逐像素实现：到最近圆心的距离决定覆盖率，与 FillRoundRect 使用相同的浮点表达式
+static void ReferenceRoundRect(Framebuffer& target, const RectI& clip, const RectI& rect, int radius, uint32_t pixel)
+{
+    RectI area = IntersectRect(rect, clip);
+    float r = std::min((float)radius, std::min(RectWidth(rect), RectHeight(rect)) * 0.5f);
+    for (int y = area.top; y < area.bottom; ++y)
+    {
+        for (int x = area.left; x < area.right; ++x)
+        {
+            uint32_t* dst = target.Row(y) + x;
+            if (r <= 0.0f)
+            {
+                *dst = pixel;
+                continue;
+            }
+            float cx = x + 0.5f;
+            float cy = y + 0.5f;
+            float dx = std::max(std::max((rect.left + r) - cx, cx - (rect.right - r)), 0.0f);
+            float dy = std::max(std::max((rect.top + r) - cy, cy - (rect.bottom - r)), 0.0f);
+            float coverage = r - std::sqrt(dx * dx + dy * dy) + 0.5f;
+            BlendPixel(dst, pixel, (int)(std::min(std::max(coverage, 0.0f), 1.0f) * 255.0f + 0.5f));
+        }
+    }
+}
+
+TEST(FillRoundRectMatchesScalarReference)
+{
+    std::mt19937 random(3);
+    const int width = 64;
+    const int height = 40;
+    int cases = 0;
+    for (int left = 0; left < 6; ++left)
+    {
+        for (int rectWidth = 1; rectWidth <= 45; rectWidth += 4)
+        {
+            for (int radius = 0; radius <= 12; radius += 3)
+            {
+                RectI rect = MakeRect(left + 3, 2 + left, rectWidth, 5 + rectWidth % 31);
+                // 一半的情况裁掉左上角和右边的一部分
+                RectI clip = cases % 2 ? RectI{left + 5, 4, width - 7, height} : RectI{0, 0, width, height};
+
+                std::vector<uint32_t> background = RandomOpaquePixels(random, (size_t)width * height);
+                Framebuffer drawn(width, height);
+                Framebuffer expected(width, height);
+                std::copy(background.begin(), background.end(), drawn.Pixels());
+                std::copy(background.begin(), background.end(), expected.Pixels());
+
+                SoftwareBackend backend(drawn);
+                backend.SetClip(clip);
+                backend.RoundRect(rect, radius, 0x3060C0, 0x3060C0, 0);
+                ReferenceRoundRect(expected, clip, rect, radius, ColorToPixel(0x3060C0));
+
+                CHECK(std::equal(drawn.Pixels(), drawn.Pixels() + (size_t)width * height, expected.Pixels()));
+                ++cases;
+            }
+        }
+    }
+}
+
+TEST(RoundRectCornersAreAntialiasedAndClipped)
+{
+    const uint32_t black = 0xFF000000;
+    const uint32_t white = ColorToPixel(0xFFFFFF);
+    Framebuffer target(40, 30);
+    SoftwareBackend backend(target);
+    RectI rect = {5, 3, 35, 27};
+    backend.RoundRect(rect, 8, 0xFFFFFF, 0xFFFFFF, 0);
+
+    // 角外面不画，角上是部分覆盖，边的中间和内部完全覆盖
+    CHECK_EQ(target.PixelAt(5, 3), black);
+    uint32_t corner = target.PixelAt(8, 4);
+    CHECK(corner != black && corner != white);
+    CHECK_EQ(target.PixelAt(5, 15), white);
+    CHECK_EQ(target.PixelAt(20, 3), white);
+    CHECK_EQ(target.PixelAt(20, 15), white);
+    CHECK_EQ(target.PixelAt(4, 15), black);
+    CHECK_EQ(target.PixelAt(35, 15), black);
+
+    // 四个角对称
+    for (int y = 0; y < 8; ++y)
+    {
+        for (int x = 0; x < 8; ++x)
+        {
+            uint32_t topLeft = target.PixelAt(rect.left + x, rect.top + y);
+            CHECK_EQ(target.PixelAt(rect.right - 1 - x, rect.top + y), topLeft);
+            CHECK_EQ(target.PixelAt(rect.left + x, rect.bottom - 1 - y), topLeft);
+            CHECK_EQ(target.PixelAt(rect.right - 1 - x, rect.bottom - 1 - y), topLeft);
+        }
+    }
+
+    // 裁剪：只有与 clip 相交的部分变化，角上的覆盖率与不裁剪时相同
+    Framebuffer clipped(40, 30);
+    SoftwareBackend clippedBackend(clipped);
+    RectI clip = {7, 4, 20, 26};
+    clippedBackend.SetClip(clip);
+    clippedBackend.RoundRect(rect, 8, 0xFFFFFF, 0xFFFFFF, 0);
+    for (int y = 0; y < 30; ++y)
+    {
+        for (int x = 0; x < 40; ++x)
+        {
+            bool inside = x >= clip.left && x < clip.right && y >= clip.top && y < clip.bottom;
+            CHECK_EQ(clipped.PixelAt(x, y), inside ? target.PixelAt(x, y) : black);
+        }
+    }
+}
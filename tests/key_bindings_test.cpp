@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <vector>
+
+#include "key_bindings.h"
+#include "test_framework.h"
+
+const char BINDINGS_TEST_PATH[] = "movable_window_tests_keys.txt";
+
+// 声明的绑定直接线性查找：无效的跳过，同一个键以最后一次为准
+static KeyAction DeclaredAction(const std::vector<KeyBinding>& declared, unsigned key)
+{
+    KeyAction action = ACTION_NONE;
+    for (const KeyBinding& binding : declared)
+    {
+        if (binding.key == key && binding.key < 256 && binding.action < ACTION_COUNT)
+            action = binding.action;
+    }
+    return action;
+}
+
+// 完美哈希表和各动作的键掩码都要与声明的绑定一致
+static void CheckMatchesDeclared(const KeyBindings& bindings, const std::vector<KeyBinding>& declared)
+{
+    int mismatches = 0;
+    KeyMask expected[ACTION_COUNT] = {};
+    for (unsigned key = 0; key < 1024; ++key)
+    {
+        KeyAction action = DeclaredAction(declared, key);
+        if (bindings.ActionOf(key) != action)
+            ++mismatches;
+        if (action != ACTION_NONE)
+            expected[action].Set(key, true);
+    }
+
+    // 超出范围的键，包括与空槽标记相同的 0xFFFF 和低 16 位与已绑定键相同的键
+    static const unsigned FAR_KEYS[] = {0xFFFF, 0x10000 + 'W', 0x10000 + KEY_UP, 0xFFFFFFFFu};
+    for (unsigned key : FAR_KEYS)
+    {
+        if (bindings.ActionOf(key) != ACTION_NONE)
+            ++mismatches;
+    }
+    CHECK_EQ(mismatches, 0);
+
+    for (int action = 0; action < ACTION_COUNT; ++action)
+    {
+        const KeyMask& mask = bindings.Mask((KeyAction)action);
+        bool same = true;
+        for (int word = 0; word < 4; ++word)
+            same = same && mask.words[word] == expected[action].words[word];
+        CHECK(same);
+    }
+}
+
+TEST(KeyActionMapMatchesDefaultBindings)
+{
+    KeyBindings bindings;
+    std::vector<KeyBinding> declared(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDINGS + DEFAULT_KEY_BINDING_COUNT);
+    CheckMatchesDeclared(bindings, declared);
+    CHECK_EQ(bindings.ActionOf('W'), ACTION_UP);
+    CHECK_EQ(bindings.ActionOf(KEY_BACK), ACTION_REWIND);
+    CHECK_EQ(bindings.ActionOf('w'), ACTION_NONE);
+}
+
+TEST(KeyActionMapMatchesCustomBindings)
+{
+    // 固定种子生成的绑定集合：大小不一，有重复的键和无效的项
+    uint32_t state = 12345;
+    for (int round = 0; round < 200; ++round)
+    {
+        std::vector<KeyBinding> declared;
+        state = state * 1664525u + 1013904223u;
+        size_t count = 1 + (state >> 8) % 120;
+        for (size_t i = 0; i < count; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            unsigned key = (state >> 8) % 300;   // 偶尔超出 256
+            state = state * 1664525u + 1013904223u;
+            KeyAction action = (KeyAction)((state >> 8) % ACTION_COUNT);
+            declared.push_back(KeyBinding{key, action});
+        }
+
+        KeyBindings bindings(declared.data(), declared.size());
+        CheckMatchesDeclared(bindings, declared);
+    }
+
+    // 全部 256 个键都绑定
+    std::vector<KeyBinding> full;
+    for (unsigned key = 0; key < 256; ++key)
+        full.push_back(KeyBinding{key, (KeyAction)(key % ACTION_COUNT)});
+    KeyBindings bindings(full.data(), full.size());
+    CheckMatchesDeclared(bindings, full);
+}
+
+TEST(KeyActionMapMatchesLoadedBindings)
+{
+    if (FILE* file = fopen(BINDINGS_TEST_PATH, "w"))
+    {
+        fputs("# 方向改到 IJKL\n", file);
+        fputs("up I UP\n", file);
+        fputs("down k 0x28\n", file);
+        fputs("reset R SPACE   # 两个键\n", file);
+        fclose(file);
+    }
+
+    KeyBindings bindings;
+    CHECK(LoadKeyBindings(BINDINGS_TEST_PATH, &bindings));
+    std::remove(BINDINGS_TEST_PATH);
+
+    // 文件里出现的动作替换默认绑定，其余保留
+    std::vector<KeyBinding> declared;
+    for (size_t i = 0; i < DEFAULT_KEY_BINDING_COUNT; ++i)
+    {
+        KeyAction action = DEFAULT_KEY_BINDINGS[i].action;
+        if (action != ACTION_UP && action != ACTION_DOWN && action != ACTION_RESET)
+            declared.push_back(DEFAULT_KEY_BINDINGS[i]);
+    }
+    declared.push_back(KeyBinding{'I', ACTION_UP});
+    declared.push_back(KeyBinding{KEY_UP, ACTION_UP});
+    declared.push_back(KeyBinding{'K', ACTION_DOWN});
+    declared.push_back(KeyBinding{KEY_DOWN, ACTION_DOWN});
+    declared.push_back(KeyBinding{'R', ACTION_RESET});
+    declared.push_back(KeyBinding{KEY_SPACE, ACTION_RESET});
+    CheckMatchesDeclared(bindings, declared);
+    CHECK_EQ(bindings.ActionOf('W'), ACTION_NONE);
+    CHECK_EQ(bindings.ActionOf('A'), ACTION_LEFT);
+}
+
+TEST(LoadKeyBindingsRejectsMalformedFile)
+{
+    if (FILE* file = fopen(BINDINGS_TEST_PATH, "w"))
+    {
+        fputs("up I\n", file);
+        fputs("jump SPACE\n", file);
+        fclose(file);
+    }
+
+    KeyBindings bindings;
+    CHECK(!LoadKeyBindings(BINDINGS_TEST_PATH, &bindings));
+    std::remove(BINDINGS_TEST_PATH);
+
+    // 失败时绑定不变
+    std::vector<KeyBinding> declared(DEFAULT_KEY_BINDINGS, DEFAULT_KEY_BINDINGS + DEFAULT_KEY_BINDING_COUNT);
+    CheckMatchesDeclared(bindings, declared);
+}
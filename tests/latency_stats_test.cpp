@@ -0,0 +1,127 @@
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "latency_stats.h"
+#include "test_framework.h"
+
+TEST(HistogramSmallValuesHaveTheirOwnBuckets)
+{
+    for (uint64_t value = 0; value < (uint64_t)LatencyHistogram::SUB_BUCKETS * 2; ++value)
+    {
+        int index = LatencyHistogram::BucketIndex(value);
+        CHECK_EQ(index, (int)value);
+        CHECK_EQ(LatencyHistogram::BucketLowerBound(index), value);
+        CHECK_EQ(LatencyHistogram::BucketUpperBound(index), value);
+    }
+    CHECK_EQ(LatencyHistogram::BucketIndex(32), 32);
+    CHECK_EQ(LatencyHistogram::BucketIndex(33), 32);
+    CHECK_EQ(LatencyHistogram::BucketIndex(34), 33);
+}
+
+TEST(HistogramBucketsTileTheRangeWithBoundedError)
+{
+    // 相邻的桶首尾相接，两端的值都落回自己的桶，宽度不超过下界的 1/16
+    for (int index = 0; index < LatencyHistogram::BUCKET_COUNT; ++index)
+    {
+        uint64_t lower = LatencyHistogram::BucketLowerBound(index);
+        uint64_t upper = LatencyHistogram::BucketUpperBound(index);
+        CHECK(lower <= upper);
+        CHECK_EQ(LatencyHistogram::BucketIndex(lower), index);
+        CHECK_EQ(LatencyHistogram::BucketIndex(upper), index);
+        if (index + 1 < LatencyHistogram::BUCKET_COUNT)
+            CHECK_EQ(LatencyHistogram::BucketLowerBound(index + 1), upper + 1);
+        if (lower >= (uint64_t)LatencyHistogram::SUB_BUCKETS)
+            CHECK(upper - lower < lower / LatencyHistogram::SUB_BUCKETS);
+    }
+    CHECK_EQ(LatencyHistogram::BucketIndex(UINT64_MAX), LatencyHistogram::BUCKET_COUNT - 1);
+    CHECK_EQ(LatencyHistogram::BucketUpperBound(LatencyHistogram::BUCKET_COUNT - 1), UINT64_MAX);
+}
+
+TEST(HistogramPercentilesOfUniformDistribution)
+{
+    std::unique_ptr<LatencyHistogram> histogram(new LatencyHistogram());
+    for (uint64_t value = 1; value <= 10000; ++value)
+        histogram->Record(value);
+
+    std::unique_ptr<LatencySnapshot> snapshot(new LatencySnapshot());
+    snapshot->Clear();
+    snapshot->Merge(*histogram);
+    CHECK_EQ(snapshot->count, (uint64_t)10000);
+    CHECK_EQ(snapshot->max, (uint64_t)10000);
+    CHECK(snapshot->Mean() == 5000.5);
+
+    // 百分位是所在桶的上界：第 5000 个值在 [4864, 5119] 里
+    CHECK_EQ(snapshot->Percentile(50), (uint64_t)5119);
+    CHECK_EQ(snapshot->Percentile(90), LatencyHistogram::BucketUpperBound(LatencyHistogram::BucketIndex(9000)));
+    // 第 9900 个值所在的桶 [9728, 10239] 超过了最大值，取最大值
+    CHECK_EQ(snapshot->Percentile(99), (uint64_t)10000);
+    CHECK_EQ(snapshot->Percentile(100), (uint64_t)10000);
+    CHECK_EQ(snapshot->Percentile(0), (uint64_t)1);
+
+    std::unique_ptr<LatencySnapshot> empty(new LatencySnapshot());
+    empty->Clear();
+    CHECK_EQ(empty->Percentile(50), (uint64_t)0);
+    CHECK(empty->Mean() == 0.0);
+}
+
+TEST(HistogramMergeMatchesSingleHistogram)
+{
+    // 奇数和偶数分别记在两个直方图里，合并后与全部记在一个里完全相同
+    std::unique_ptr<LatencyHistogram> even(new LatencyHistogram());
+    std::unique_ptr<LatencyHistogram> odd(new LatencyHistogram());
+    std::unique_ptr<LatencyHistogram> all(new LatencyHistogram());
+    for (uint64_t value = 0; value < 200000; value += 7)
+    {
+        (value & 1 ? odd : even)->Record(value);
+        all->Record(value);
+    }
+
+    std::unique_ptr<LatencySnapshot> merged(new LatencySnapshot());
+    std::unique_ptr<LatencySnapshot> single(new LatencySnapshot());
+    merged->Clear();
+    merged->Merge(*even);
+    merged->Merge(*odd);
+    single->Clear();
+    single->Merge(*all);
+
+    CHECK_EQ(merged->count, single->count);
+    CHECK_EQ(merged->sum, single->sum);
+    CHECK_EQ(merged->max, single->max);
+    bool sameBuckets = true;
+    for (int i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+        sameBuckets = sameBuckets && merged->counts[i] == single->counts[i];
+    CHECK(sameBuckets);
+    CHECK_EQ(merged->Percentile(50), single->Percentile(50));
+    CHECK_EQ(merged->Percentile(99.9), single->Percentile(99.9));
+}
+
+TEST(LatencySnapshotMergesAllThreads)
+{
+    const int THREADS = 4;
+    const uint64_t PER_THREAD = 1000;
+    std::unique_ptr<LatencySnapshot> before(new LatencySnapshot());
+    SnapshotLatency(LATENCY_RENDER, before.get());
+
+    // 每个线程记在自己的直方图里，线程结束后仍然计入汇总
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.push_back(std::thread([t] {
+            for (uint64_t n = 0; n < PER_THREAD; ++n)
+                RecordLatency(LATENCY_RENDER, 1000000 * (uint64_t)(t + 1));
+        }));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    std::unique_ptr<LatencySnapshot> after(new LatencySnapshot());
+    SnapshotLatency(LATENCY_RENDER, after.get());
+    CHECK_EQ(after->count - before->count, THREADS * PER_THREAD);
+    CHECK(after->max >= 4000000);
+    for (int t = 0; t < THREADS; ++t)
+    {
+        int index = LatencyHistogram::BucketIndex(1000000 * (uint64_t)(t + 1));
+        CHECK_EQ(after->counts[index] - before->counts[index], PER_THREAD);
+    }
+}
@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cmath>
+
+#include "motion.h"
+#include "test_framework.h"
+
+typedef MotionEngine::Clock Clock;
+
+static const Clock::time_point T0 = Clock::time_point() + std::chrono::seconds(100);
+
+static double ToPixels(Fixed value)
+{
+    return (double)value / FIXED_ONE;
+}
+
+TEST(DiagonalSpeedEqualsAxisSpeed)
+{
+    MotionEngine axis;
+    MotionEngine diagonal;
+    axis.Reset(T0);
+    diagonal.Reset(T0);
+    axis.SetDirection(1, 0);
+    diagonal.SetDirection(-1, 1);
+
+    int axisX = 0;
+    int diagonalX = 0;
+    int diagonalY = 0;
+    for (int step = 0; step < 1200; ++step)
+    {
+        axisX += axis.Step().dx;
+        MotionDelta delta = diagonal.Step();
+        diagonalX += delta.dx;
+        diagonalY += delta.dy;
+    }
+
+    // 末速度：单轴为最大速度，斜向每个轴除以 √2，合速度相同
+    CHECK_EQ(axis.VelocityX(), ToFixed(100));
+    CHECK_EQ(diagonal.VelocityX(), -diagonal.VelocityY());
+    double speed = std::hypot(ToPixels(diagonal.VelocityX()), ToPixels(diagonal.VelocityY()));
+    CHECK(std::fabs(speed - 100.0) < 0.01);
+
+    // 10 秒走过的距离相同（亚像素余量各差不到 1 像素）
+    CHECK_EQ(diagonalX, -diagonalY);
+    double distance = std::hypot((double)diagonalX, (double)diagonalY);
+    CHECK(std::fabs(distance - axisX) <= 2.0);
+    CHECK(axisX > 990 && axisX <= 1000);
+}
+
+TEST(CatchUpIsCappedAfterStall)
+{
+    // 卡顿 5 秒：只补算 maxCatchUpMs（250ms，30 步），不会瞬移
+    MotionEngine stalled;
+    stalled.Reset(T0);
+    stalled.SetDirection(1, 0);
+    MotionDelta delta = stalled.Advance(T0 + std::chrono::seconds(5));
+
+    MotionEngine stepped;
+    stepped.SetDirection(1, 0);
+    int expected = 0;
+    for (int step = 0; step < 30; ++step)
+        expected += stepped.Step().dx;
+
+    CHECK_EQ(delta.dx, expected);
+    CHECK_EQ(delta.dy, 0);
+    CHECK_EQ(stalled.VelocityX(), stepped.VelocityX());
+
+    // 之后按正常节奏继续：一个步长正好一步
+    stalled.Advance(T0 + std::chrono::seconds(5) + std::chrono::nanoseconds(1000000000LL / 120));
+    stepped.Step();
+    CHECK_EQ(stalled.VelocityX(), stepped.VelocityX());
+}
+
+TEST(SubPixelRemainderCarriesAcrossAdvances)
+{
+    // 每秒 1 像素，每步只有 1/120 像素：逐步推进也不会丢掉余量
+    MotionParams params = DefaultMotionParams();
+    params.maxSpeed = 1;
+    MotionEngine slow(params);
+    slow.Reset(T0);
+    slow.SetDirection(0, 1);
+
+    Clock::time_point now = T0;
+    int moved = 0;
+    for (int tick = 1; tick <= 10 * 120; ++tick)
+    {
+        now = T0 + std::chrono::nanoseconds(1000000000LL * tick / 120);
+        MotionDelta delta = slow.Advance(now);
+        CHECK(delta.dy >= 0 && delta.dy <= 1);
+        moved += delta.dy;
+    }
+    CHECK(moved >= 9 && moved <= 10);
+
+    // 同样的时间，分成大小不一的几次推进，位移完全相同
+    MotionEngine coarse;
+    MotionEngine fine;
+    coarse.Reset(T0);
+    fine.Reset(T0);
+    coarse.SetDirection(1, 0);
+    fine.SetDirection(1, 0);
+    int coarseX = 0;
+    int fineX = 0;
+    for (int ms = 1; ms <= 3000; ++ms)
+    {
+        Clock::time_point time = T0 + std::chrono::milliseconds(ms);
+        fineX += fine.Advance(time).dx;
+        if (ms % 200 == 0 || ms % 37 == 0)
+            coarseX += coarse.Advance(time).dx;
+        if (ms % 200 == 0)
+            CHECK_EQ(coarseX, fineX);
+    }
+    CHECK(fineX > 290 && fineX <= 300);
+}
+
+TEST(SubTickTapIsWeightedByHeldTime)
+{
+    // 加速度足够大时速度一步到位，正好等于按住时间占一步的比例乘以最大速度
+    MotionParams params = DefaultMotionParams();
+    params.acceleration = 1000000;
+    const int64_t stepNs = 1000000000LL / params.stepHz;
+
+    const int64_t tapsNs[] = {1000000, 2000000, 5000000};
+    for (int64_t tapNs : tapsNs)
+    {
+        MotionEngine engine(params);
+        engine.Reset(T0);
+
+        // 两个步长之间按下又松开
+        Clock::time_point down = T0 + std::chrono::milliseconds(1);
+        engine.Advance(down);
+        engine.SetDirection(1, 0);
+        engine.Advance(down + std::chrono::nanoseconds(tapNs));
+        engine.SetDirection(0, 0);
+        CHECK(engine.IsMoving());
+
+        engine.Advance(down + std::chrono::nanoseconds(stepNs));
+        Fixed expected = Fixed((double)tapNs / stepNs * ToFixed(params.maxSpeed));
+        CHECK_EQ(engine.VelocityX(), expected);
+        CHECK_EQ(engine.VelocityY(), (Fixed)0);
+    }
+
+    // 步内先右后上：两个方向按各自的时间加权
+    MotionEngine engine(params);
+    engine.Reset(T0);
+    engine.Advance(T0 + std::chrono::milliseconds(1));
+    engine.SetDirection(1, 0);
+    engine.Advance(T0 + std::chrono::milliseconds(3));
+    engine.SetDirection(0, -1);
+    engine.Advance(T0 + std::chrono::milliseconds(1) + std::chrono::nanoseconds(stepNs));
+    double heldX = 2000000.0 / stepNs;
+    double heldY = (stepNs - 2000000.0) / stepNs;
+    CHECK_EQ(engine.VelocityX(), Fixed(heldX * ToFixed(100)));
+    CHECK_EQ(engine.VelocityY(), Fixed(-heldY * ToFixed(100)));
+}
@@ -0,0 +1,126 @@
+#include <vector>
+
+#include "move_sink.h"
+#include "test_framework.h"
+#include "test_host.h"
+
+using std::chrono::milliseconds;
+
+// 记录每次原生调用移动了哪些窗口
+class CountingMover : public INativeMover
+{
+public:
+    void MoveWindows(const WindowMove* moves, size_t count) override
+    {
+        calls.push_back(std::vector<WindowMove>(moves, moves + count));
+    }
+
+    std::vector<std::vector<WindowMove>> calls;
+};
+
+TEST(MoveSinkSubmitsImmediatelyOutsideBatch)
+{
+    CountingMover mover;
+    MoveSink sink(mover);
+    sink.SetKnownPosition(0, 100, 100);
+
+    sink.Request(0, 110, 100);
+    sink.Request(0, 120, 100);
+    CHECK_EQ(mover.calls.size(), (size_t)2);
+    CHECK_EQ(mover.calls[1][0].x, 120);
+
+    // 移到已知位置不产生调用
+    sink.Request(0, 120, 100);
+    CHECK_EQ(mover.calls.size(), (size_t)2);
+    CHECK_EQ(sink.Dropped(), (uint64_t)1);
+    CHECK_EQ(sink.NativeCalls(), (uint64_t)2);
+}
+
+TEST(MoveSinkCoalescesBatchIntoOneCall)
+{
+    CountingMover mover;
+    MoveSink sink(mover);
+    sink.SetKnownPosition(0, 0, 0);
+    sink.SetKnownPosition(1, 50, 50);
+    {
+        MoveSink::Batch outer(sink);
+        sink.Request(0, 10, 0);
+        {
+            MoveSink::Batch inner(sink);
+            sink.Request(1, 60, 50);
+            sink.Request(0, 20, 0);
+        }
+        CHECK(mover.calls.empty());
+        sink.Request(0, 30, 5);
+    }
+
+    // 最外层结束时两个窗口一起提交，每个窗口只保留最后一次
+    CHECK_EQ(mover.calls.size(), (size_t)1);
+    CHECK_EQ(mover.calls[0].size(), (size_t)2);
+    CHECK_EQ(mover.calls[0][0].window, (uint32_t)0);
+    CHECK_EQ(mover.calls[0][0].x, 30);
+    CHECK_EQ(mover.calls[0][0].y, 5);
+    CHECK_EQ(mover.calls[0][1].window, (uint32_t)1);
+    CHECK_EQ(mover.calls[0][1].x, 60);
+    CHECK_EQ(sink.Coalesced(), (uint64_t)2);
+    CHECK_EQ(sink.WindowsMoved(), (uint64_t)2);
+}
+
+TEST(MoveSinkBatchThatReturnsHomeMovesNothing)
+{
+    CountingMover mover;
+    MoveSink sink(mover);
+    sink.SetKnownPosition(0, 100, 100);
+    {
+        MoveSink::Batch batch(sink);
+        sink.Request(0, 140, 100);
+        sink.Request(0, 100, 100);
+    }
+    CHECK(mover.calls.empty());
+    CHECK_EQ(sink.NativeCalls(), (uint64_t)0);
+}
+
+// 按键脚本：按住右键 500ms，松开等它停下；再同时按住上和左 250ms
+static void RunKeyScript(ControllerFixture& fixture)
+{
+    fixture.controller.OnKeyDown(KEY_RIGHT);
+    fixture.RunFor(milliseconds(500));
+    fixture.controller.OnKeyUp(KEY_RIGHT);
+    fixture.RunFor(milliseconds(1000));
+    fixture.controller.OnKeyDown(KEY_UP);
+    fixture.controller.OnKeyDown('A');
+    fixture.RunFor(milliseconds(250));
+    fixture.controller.OnKeyUp(KEY_UP);
+    fixture.controller.OnKeyUp('A');
+    fixture.RunFor(milliseconds(1000));
+}
+
+TEST(ControllerKeyScriptMakesExactNativeCalls)
+{
+    ControllerFixture fixture;
+    RunKeyScript(fixture);
+
+    // 每个移动节拍最多一次原生调用，没有整像素位移的节拍不调用；
+    // 运动参数（motion.h 的默认值）或节拍间隔变化时这个数会变
+    CHECK_EQ(fixture.host.Calls(), (size_t)45);
+    CHECK_EQ(fixture.host.WindowsMoved(), fixture.host.Calls());
+    CHECK_EQ(fixture.controller.Moves().NativeCalls(), (uint64_t)fixture.host.Calls());
+    CHECK_EQ(fixture.host.LastMove().x, fixture.controller.WindowPos().x);
+    CHECK_EQ(fixture.host.LastMove().y, fixture.controller.WindowPos().y);
+}
+
+TEST(ControllerHoldingKeyAtEdgeStopsCallingNative)
+{
+    ControllerFixture fixture;
+    CHECK(fixture.controller.MoveWindowBy(1920, 0));
+    size_t calls = fixture.host.Calls();
+    CHECK_EQ(calls, (size_t)1);
+
+    // 已经顶在右边缘：按住右键一秒，节拍照常运行但没有原生调用
+    fixture.controller.OnKeyDown(KEY_RIGHT);
+    fixture.RunFor(milliseconds(1000));
+    fixture.controller.OnKeyUp(KEY_RIGHT);
+    fixture.RunFor(milliseconds(1000));
+    CHECK_EQ(fixture.host.Calls(), calls);
+    CHECK_EQ(fixture.controller.WindowPos().x, 1920 - 20);
+}
@@ -0,0 +1,91 @@
+#include <string>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "position_feed.h"
+#include "test_framework.h"
+
+// 每个用例用自己的段名，并行运行的其他测试进程不会互相干扰
+static std::string FeedName(const char* test)
+{
+    return std::string("/movable_window_feed_test.") + test + "." + std::to_string((long long)getpid());
+}
+
+TEST(PositionFeedRefusesSecondLiveWriter)
+{
+    std::string name = FeedName("second");
+    PositionFeedWriter first;
+    CHECK(first.Open(name.c_str()));
+
+    PositionSnapshot snapshot = {};
+    snapshot.x = 42;
+    first.Publish(snapshot);
+
+    PositionFeedWriter second;
+    CHECK(!second.Open(name.c_str()));
+
+    // 第一个写者发布的内容没有被第二个写者重新初始化
+    PositionFeedReader reader;
+    CHECK(reader.Open(name.c_str()));
+    PositionSnapshot read = {};
+    CHECK(reader.Read(&read));
+    CHECK_EQ(read.x, 42);
+    CHECK_EQ(reader.Sequence(), (uint64_t)1);
+
+    first.Close();
+    CHECK(second.Open(name.c_str()));
+}
+
+TEST(PositionFeedReplacesSegmentOfDeadWriter)
+{
+    std::string name = FeedName("stale");
+
+    // 子进程打开写者后直接退出，不关闭，留下 magic 有效的段
+    pid_t child = fork();
+    if (child == 0)
+    {
+        PositionFeedWriter writer;
+        _exit(writer.Open(name.c_str()) ? 0 : 1);
+    }
+    int status = 0;
+    CHECK(child > 0 && waitpid(child, &status, 0) == child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    PositionFeedReader stale;
+    CHECK(stale.Open(name.c_str()));
+    CHECK_EQ(stale.WriterPid(), (uint32_t)child);
+    stale.Close();
+
+    PositionFeedWriter writer;
+    CHECK(writer.Open(name.c_str()));
+    PositionFeedReader reader;
+    CHECK(reader.Open(name.c_str()));
+    CHECK_EQ(reader.WriterPid(), (uint32_t)getpid());
+    CHECK_EQ(reader.Sequence(), (uint64_t)0);
+}
+
+TEST(PositionFeedKeepsSegmentOfInitializingWriter)
+{
+    // 模拟另一个写者刚新建了段、加了锁，还没有写入 magic：不能把它当作残留删掉
+    std::string name = FeedName("initializing");
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    CHECK(fd >= 0);
+    CHECK(flock(fd, LOCK_EX | LOCK_NB) == 0);
+
+    PositionFeedWriter writer;
+    CHECK(!writer.Open(name.c_str()));
+    int still = shm_open(name.c_str(), O_RDONLY, 0);
+    CHECK(still >= 0);
+    close(still);
+
+    // 那个写者没有初始化完就退出（锁随之释放）：它留下的段被替换
+    close(fd);
+    CHECK(writer.Open(name.c_str()));
+    PositionFeedReader reader;
+    CHECK(reader.Open(name.c_str()));
+    CHECK_EQ(reader.WriterPid(), (uint32_t)getpid());
+}
@@ -0,0 +1,194 @@
+#include <vector>
+
+#include "position_history.h"
+#include "test_framework.h"
+#include "test_host.h"
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+// 固定种子的随机路径：大多是节拍移动的小位移，夹杂大跳和重置
+static std::vector<HistorySample> RandomWalk(size_t count)
+{
+    std::vector<HistorySample> samples;
+    uint32_t state = 4242;
+    HistorySample sample = {1000, PointI{100, 100}, HISTORY_MOVE, 0};
+    for (size_t i = 0; i < count; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        uint32_t roll = (state >> 8) % 100;
+        int dx, dy;
+        if (roll < 80)
+        {
+            dx = (int)((state >> 12) % 15) - 7;
+            dy = (int)((state >> 16) % 15) - 7;
+        }
+        else
+        {
+            dx = (int)((state >> 12) % 4001) - 2000;
+            dy = (int)((state >> 4) % 3001) - 1500;
+        }
+        if (dx == 0 && dy == 0)
+            dx = 1;
+
+        sample.timeMs += roll < 90 ? 16 : (int64_t)(state >> 20);
+        sample.pos.x += dx;
+        sample.pos.y += dy;
+        sample.kind = roll >= 97 ? HISTORY_RESET : HISTORY_MOVE;
+        samples.push_back(sample);
+    }
+    return samples;
+}
+
+static bool SameSample(const HistorySample& a, const HistorySample& b)
+{
+    return a.timeMs == b.timeMs && a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.kind == b.kind;
+}
+
+TEST(PositionHistoryRoundTripsEncodedSamples)
+{
+    std::vector<HistorySample> samples = RandomWalk(20000);
+    PositionHistory history(16 * 1024 * 1024);
+    for (const HistorySample& sample : samples)
+        history.Append(sample.timeMs, sample.pos, sample.kind);
+    CHECK_EQ(history.SampleCount(), samples.size());
+    CHECK_EQ(history.AppendedCount(), (uint64_t)samples.size());
+
+    // 每个样本的时刻、以及两个样本之间的时刻都解码回同一个样本
+    int mismatches = 0;
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+        HistorySample found;
+        if (!history.At(samples[i].timeMs, &found) || !SameSample(found, samples[i]) || found.index != i)
+            ++mismatches;
+        int64_t between = i + 1 < samples.size() ? samples[i + 1].timeMs - 1 : samples[i].timeMs + 100000;
+        if (!history.At(between, &found) || !SameSample(found, samples[i]))
+            ++mismatches;
+    }
+    CHECK_EQ(mismatches, 0);
+
+    HistorySample sample;
+    CHECK(!history.At(samples[0].timeMs - 1, &sample));
+    CHECK(history.Oldest(&sample) && SameSample(sample, samples.front()));
+    CHECK(history.Latest(&sample) && SameSample(sample, samples.back()));
+
+    // 节拍移动平均只占两个字节左右
+    CHECK(history.EncodedBytes() < samples.size() * 4);
+}
+
+TEST(PositionHistoryDropsOldestBlocksWhenFull)
+{
+    std::vector<HistorySample> samples = RandomWalk(5000);
+    PositionHistory history(4 * 256, 256);
+    size_t memory = history.MemoryBytes();
+    for (const HistorySample& sample : samples)
+        history.Append(sample.timeMs, sample.pos, sample.kind);
+
+    // 内存不变，只保留最近的样本，保留下来的仍然逐个正确
+    CHECK_EQ(history.MemoryBytes(), memory);
+    CHECK(history.SampleCount() < samples.size());
+    CHECK_EQ(history.AppendedCount(), (uint64_t)samples.size());
+
+    HistorySample oldest;
+    CHECK(history.Oldest(&oldest));
+    CHECK_EQ(oldest.index, (uint64_t)(samples.size() - history.SampleCount()));
+    CHECK(SameSample(oldest, samples[oldest.index]));
+    HistorySample found;
+    CHECK(!history.At(oldest.timeMs - 1, &found));
+    int mismatches = 0;
+    for (size_t i = (size_t)oldest.index; i < samples.size(); ++i)
+    {
+        if (!history.At(samples[i].timeMs, &found) || !SameSample(found, samples[i]))
+            ++mismatches;
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+TEST(PositionHistoryFindsResetsNewestFirst)
+{
+    PositionHistory history;
+    history.Append(0, PointI{10, 10});
+    history.Append(100, PointI{500, 10});
+    history.Append(100, PointI{660, 315}, HISTORY_RESET);
+    history.Append(200, PointI{700, 315});
+    history.Append(300, PointI{1800, 900});
+    history.Append(300, PointI{660, 315}, HISTORY_RESET);
+
+    HistorySample reset, previous;
+    CHECK(history.FindReset(UINT64_MAX, &reset, &previous));
+    CHECK_EQ(reset.index, (uint64_t)5);
+    CHECK_EQ(previous.pos.x, 1800);
+    CHECK(history.FindReset(reset.index, &reset, &previous));
+    CHECK_EQ(reset.index, (uint64_t)2);
+    CHECK_EQ(previous.pos.x, 500);
+    CHECK(!history.FindReset(reset.index, &reset, &previous));
+}
+
+TEST(ControllerUndoResetRoundTrips)
+{
+    ControllerFixture fixture;
+    WindowController& controller = fixture.controller;
+    controller.SetResetAnimation(std::chrono::steady_clock::duration::zero());
+
+    fixture.RunFor(seconds(1));
+    CHECK(controller.MoveWindowBy(300, 100));   // (960, 415)
+    fixture.RunFor(seconds(1));
+    controller.ResetToCenter();
+    fixture.RunFor(seconds(1));
+    CHECK(controller.MoveWindowBy(-500, -200));  // (160, 115)
+    fixture.RunFor(seconds(1));
+    controller.ResetToCenter();
+    CHECK_EQ(controller.WindowPos().x, 660);
+
+    // 依次撤销回到每次重置之前的位置，没有更早的重置时失败
+    CHECK(controller.UndoReset());
+    CHECK_EQ(controller.WindowPos().x, 160);
+    CHECK_EQ(controller.WindowPos().y, 115);
+    CHECK(controller.UndoReset());
+    CHECK_EQ(controller.WindowPos().x, 960);
+    CHECK_EQ(controller.WindowPos().y, 415);
+    CHECK(!controller.UndoReset());
+    CHECK_EQ(fixture.host.LastMove().x, 960);
+
+    // 新的重置之后又从最近一次开始撤销
+    controller.ResetToCenter();
+    CHECK(controller.UndoReset());
+    CHECK_EQ(controller.WindowPos().x, 960);
+}
+
+TEST(ControllerRewindRoundTrips)
+{
+    ControllerFixture fixture;
+    WindowController& controller = fixture.controller;
+    controller.SetResetAnimation(std::chrono::steady_clock::duration::zero());
+    IClock::TimePoint start = fixture.clock.Now();
+
+    // 每 5 秒移动一次，记下每个时刻的位置
+    std::vector<PointI> positions(1, controller.WindowPos());
+    for (int step = 1; step <= 6; ++step)
+    {
+        fixture.RunUntil(start + seconds(5 * step));
+        CHECK(controller.MoveWindowBy(40 * step, -10 * step));
+        positions.push_back(controller.WindowPos());
+    }
+
+    // 回到过去的任意时刻：取那时的位置（回去本身也记为现在的一次移动）
+    for (int step = 0; step < 6; ++step)
+    {
+        CHECK(controller.RewindTo(start + seconds(5 * step) + milliseconds(2500)));
+        CHECK_EQ(controller.WindowPos().x, positions[step].x);
+        CHECK_EQ(controller.WindowPos().y, positions[step].y);
+    }
+
+    // 连续后退每次再往前 5 秒，早于历史时停在最旧的位置
+    fixture.RunUntil(start + seconds(5 * 6) + milliseconds(500));
+    PointI latest = positions[6];
+    CHECK(controller.MoveWindowBy(latest.x - controller.WindowPos().x, latest.y - controller.WindowPos().y));
+    for (int step = 5; step >= 0; --step)
+    {
+        CHECK(controller.Rewind());
+        CHECK_EQ(controller.WindowPos().x, positions[step].x);
+    }
+    CHECK(controller.Rewind());
+    CHECK_EQ(controller.WindowPos().x, positions[0].x);
+}
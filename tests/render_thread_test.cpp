@@ -0,0 +1,134 @@
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bitmap_font.h"
+#include "render_thread.h"
+#include "test_framework.h"
+
+static const int WIDTH = 600;
+static const int HEIGHT = 450;
+
+static RectI UnionAll(const std::vector<RectI>& rects, RectI bounds)
+{
+    for (const RectI& rect : rects)
+        bounds = UnionRect(bounds, rect);
+    return bounds;
+}
+
+// 同一份状态在调用者线程上直接绘制整个画布，转换成 BGRA
+static std::vector<uint32_t> PaintDirectly(IGlyphSource& font, const PanelState& state)
+{
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas);
+    ShadowCache shadows;
+    PanelScene scene;
+    scene.Layout(WIDTH, HEIGHT);
+    scene.Update(state);
+
+    Framebuffer canvas(WIDTH, HEIGHT);
+    SoftwareBackend backend(canvas, &text, &shadows);
+    scene.Paint(backend, RectI{0, 0, WIDTH, HEIGHT});
+
+    std::vector<uint32_t> pixels((size_t)WIDTH * HEIGHT);
+    SwapRedBlue(pixels.data(), canvas.Pixels(), pixels.size());
+    return pixels;
+}
+
+// 初始状态，以及 UI 线程取帧之前连续提交的两份状态（改动不同的元素）
+static void MakeStates(PanelState* initial, PanelState* first, PanelState* second)
+{
+    *initial = PanelState();
+    initial->posX = 660;
+    initial->posY = 315;
+
+    *first = *initial;
+    first->leftPressed = true;
+    first->posX = 640;
+
+    *second = *first;
+    second->resetTriggered = true;
+    second->idleSeconds = 3;
+    second->escPressed = true;
+}
+
+TEST(RenderThreadMergesDamageOfUnreadFrames)
+{
+    BitmapFontSource font;
+    PanelState initial, first, second;
+    MakeStates(&initial, &first, &second);
+
+    // 期望的变化区域：同样的两次更新在单独的场景上各自报告的区域之和
+    PanelScene scene;
+    scene.Layout(WIDTH, HEIGHT);
+    scene.Update(initial);
+    RectI firstDamage = UnionAll(scene.Update(first), RectI{0, 0, 0, 0});
+    RectI secondDamage = UnionAll(scene.Update(second), RectI{0, 0, 0, 0});
+    CHECK(!IsRectEmpty(firstDamage));
+    CHECK(!IsRectEmpty(secondDamage));
+    CHECK(!(firstDamage == secondDamage));
+
+    // 不启动线程，在当前线程上逐帧渲染，时序是确定的
+    PanelRenderThread renderer(font);
+    renderer.Submit(initial, WIDTH, HEIGHT);
+    CHECK(renderer.RenderPending());
+    CHECK(renderer.AcquireFrame());
+    CHECK_EQ(renderer.Frame().damage, (RectI{0, 0, WIDTH, HEIGHT}));
+
+    // 两帧都完成之后 UI 线程才来取：取到的是第二帧，区域包括被跳过的第一帧
+    renderer.Submit(first, WIDTH, HEIGHT);
+    CHECK(renderer.RenderPending());
+    renderer.Submit(second, WIDTH, HEIGHT);
+    CHECK(renderer.RenderPending());
+    CHECK_EQ(renderer.FramesDropped(), (uint64_t)1);
+
+    CHECK(renderer.AcquireFrame());
+    const PanelFrame& frame = renderer.Frame();
+    CHECK_EQ(frame.sequence, (uint64_t)3);
+    CHECK_EQ(frame.damage, UnionRect(firstDamage, secondDamage));
+    CHECK(frame.pixels == PaintDirectly(font, second));
+    CHECK(!renderer.AcquireFrame());
+}
+
+TEST(RenderThreadFramesMatchDirectPaint)
+{
+    // 真正的渲染线程：两份状态在取帧之前提交，渲染线程可能合并也可能逐个渲染，
+    // 无论哪种，UI 线程取到的各帧区域之和都覆盖两次变化，最后一帧与直接绘制相同
+    BitmapFontSource font;
+    PanelState initial, first, second;
+    MakeStates(&initial, &first, &second);
+
+    PanelScene scene;
+    scene.Layout(WIDTH, HEIGHT);
+    scene.Update(initial);
+    RectI expected = UnionAll(scene.Update(first), RectI{0, 0, 0, 0});
+    expected = UnionAll(scene.Update(second), expected);
+    std::vector<uint32_t> final = PaintDirectly(font, second);
+
+    PanelRenderThread renderer(font);
+    CHECK(renderer.Start(std::function<void()>()));
+    renderer.Submit(initial, WIDTH, HEIGHT);
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!renderer.AcquireFrame() && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(renderer.Frame().pixels == PaintDirectly(font, initial));
+
+    renderer.Submit(first, WIDTH, HEIGHT);
+    renderer.Submit(second, WIDTH, HEIGHT);
+    RectI damage = {0, 0, 0, 0};
+    bool done = false;
+    while (!done && std::chrono::steady_clock::now() < deadline)
+    {
+        if (!renderer.AcquireFrame())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        damage = UnionRect(damage, renderer.Frame().damage);
+        done = renderer.Frame().pixels == final;
+    }
+    renderer.Stop();
+
+    CHECK(done);
+    CHECK_EQ(UnionRect(damage, expected), damage);
+}
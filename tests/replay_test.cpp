@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <vector>
+
+#include "input_journal.h"
+#include "key_bindings.h"
+#include "replay.h"
+#include "test_framework.h"
+
+TEST(VarintRoundTripsBoundaryValues)
+{
+    const uint64_t values[] = {0, 1, 127, 128, 16383, 16384, (uint64_t)1 << 35, UINT64_MAX};
+    const size_t lengths[] = {1, 1, 1, 2, 2, 3, 6, 10};
+
+    std::vector<uint8_t> data;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        size_t before = data.size();
+        WriteVarint(data, values[i]);
+        CHECK_EQ(data.size() - before, lengths[i]);
+    }
+
+    const uint8_t* cursor = data.data();
+    const uint8_t* end = data.data() + data.size();
+    for (uint64_t expected : values)
+    {
+        uint64_t value = 0;
+        CHECK(ReadVarint(&cursor, end, &value));
+        CHECK_EQ(value, expected);
+    }
+    CHECK(cursor == end);
+
+    // 截断在多字节整数中间：读取失败，游标不动
+    std::vector<uint8_t> truncated;
+    WriteVarint(truncated, 16384);
+    truncated.pop_back();
+    cursor = truncated.data();
+    uint64_t value = 0;
+    CHECK(!ReadVarint(&cursor, truncated.data() + truncated.size(), &value));
+    CHECK(cursor == truncated.data());
+}
+
+TEST(JournalRoundTripsLargeDeltasAndAllKeys)
+{
+    // 一小时和 2^40 微秒的间隔、键码 0 和 255，以及同一时刻的多个事件
+    const InputEvent events[] = {
+        {0, 0, true},
+        {5, 255, true},
+        {5, 255, false},
+        {3600LL * 1000 * 1000, (uint8_t)KEY_RIGHT, true},
+        {3600LL * 1000 * 1000 + ((int64_t)1 << 40), (uint8_t)KEY_RIGHT, false},
+        {3600LL * 1000 * 1000 + ((int64_t)1 << 40) + 1, 'A', true},
+    };
+    const size_t count = sizeof(events) / sizeof(events[0]);
+
+    InputJournalWriter writer;
+    for (const InputEvent& event : events)
+        writer.Append(event);
+    CHECK_EQ(writer.EventCount(), count);
+
+    InputJournalReader reader(writer.Data().data(), writer.Data().size());
+    CHECK(reader.IsValid());
+    InputEvent event;
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(reader.Next(&event));
+        CHECK_EQ(event.timeUs, events[i].timeUs);
+        CHECK_EQ((int)event.key, (int)events[i].key);
+        CHECK_EQ(event.down, events[i].down);
+    }
+    CHECK(!reader.Next(&event));
+}
+
+TEST(JournalClampsBackwardTime)
+{
+    InputJournalWriter writer;
+    writer.Append(InputEvent{1000, 'A', true});
+    writer.Append(InputEvent{400, 'A', false});
+
+    InputJournalReader reader(writer.Data().data(), writer.Data().size());
+    InputEvent event;
+    CHECK(reader.Next(&event));
+    CHECK(reader.Next(&event));
+    CHECK_EQ(event.timeUs, (int64_t)1000);
+}
+
+TEST(JournalRejectsBadHeader)
+{
+    const uint8_t data[] = {'M', 'W', 'J', '0', 0x00};
+    InputJournalReader reader(data, sizeof(data));
+    CHECK(!reader.IsValid());
+    CHECK(!ReplayJournal(data, sizeof(data), DefaultReplayOptions()).valid);
+}
+
+// 长按、短于一个移动节拍的轻点、对角移动、移出屏幕后等待自动重置，以及空格重置
+static std::vector<uint8_t> ScriptedJournal()
+{
+    InputJournalWriter writer;
+    int64_t now = 0;
+    auto key = [&](int64_t afterUs, unsigned code, bool down) {
+        now += afterUs;
+        writer.Append(InputEvent{now, (uint8_t)code, down});
+    };
+
+    key(100000, KEY_RIGHT, true);
+    key(750000, KEY_RIGHT, false);
+    for (int i = 0; i < 20; ++i)
+    {
+        key(37000, KEY_UP, true);
+        key(3000 + i * 211, KEY_UP, false);
+    }
+    key(50000, KEY_LEFT, true);
+    key(120000, KEY_DOWN, true);
+    key(900000, KEY_LEFT, false);
+    key(10, KEY_DOWN, false);
+    key(200000, KEY_RIGHT, true);
+    key(25000000, KEY_RIGHT, false);
+    key(7000000, KEY_SPACE, true);
+    key(80000, KEY_SPACE, false);
+    key(400000, 'A', true);
+    key(1234, 'A', false);
+    return writer.Data();
+}
+
+TEST(ReplayIsDeterministic)
+{
+    std::vector<uint8_t> journal = ScriptedJournal();
+    ReplayOptions options = DefaultReplayOptions();
+
+    ReplayResult first = ReplayJournal(journal.data(), journal.size(), options);
+    ReplayResult second = ReplayJournal(journal.data(), journal.size(), options);
+    CHECK(first.valid);
+    CHECK(second.valid);
+
+    CHECK_EQ(first.keyEvents, (uint64_t)52);
+    CHECK_EQ(second.finalPos.x, first.finalPos.x);
+    CHECK_EQ(second.finalPos.y, first.finalPos.y);
+    CHECK_EQ(second.resetTriggered, first.resetTriggered);
+    CHECK_EQ(second.resetCount, first.resetCount);
+    CHECK_EQ(second.keyEvents, first.keyEvents);
+    CHECK_EQ(second.timerEvents, first.timerEvents);
+    CHECK_EQ(second.windowMoves, first.windowMoves);
+    CHECK_EQ(second.movesDropped, first.movesDropped);
+    CHECK_EQ(second.movesCoalesced, first.movesCoalesced);
+
+    // 脚本确实走到了移出屏幕、自动重置和手动重置
+    CHECK(first.resetCount >= 2);
+    CHECK(first.windowMoves > 0);
+    CHECK(first.timerEvents > 0);
+}
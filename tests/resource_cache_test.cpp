@@ -0,0 +1,147 @@
+#include "control_panel.h"
+#include "resource_cache.h"
+#include "test_framework.h"
+
+// 与 GdiBackend 一样向资源缓存取画刷、画笔和字体，但不真正绘制
+class CachingBackend : public IRenderBackend
+{
+public:
+    CachingBackend(int width, int height, ResourceCache& resources)
+        : m_width(width), m_height(height), m_resources(resources)
+    {
+    }
+
+    int Width() const override { return m_width; }
+    int Height() const override { return m_height; }
+    void SetClip(const RectI& clip) override { (void)clip; }
+
+    void FillRect(const RectI& rect, Color color) override
+    {
+        (void)rect;
+        m_resources.GetBrush(color);
+    }
+
+    void FrameRect(const RectI& rect, int borderWidth, Color color) override
+    {
+        (void)rect;
+        m_resources.GetPen(color, borderWidth, PEN_STYLE_SOLID);
+    }
+
+    void RoundRect(const RectI& rect, int radius, Color fill, Color border, int borderWidth) override
+    {
+        (void)rect;
+        (void)radius;
+        m_resources.GetBrush(fill);
+        m_resources.GetPen(border, borderWidth, PEN_STYLE_SOLID);
+    }
+
+    // GDI 不画阴影
+    void DropShadow(const RectI& rect, int radius, int blur, Color color, int opacity) override
+    {
+        (void)rect;
+        (void)radius;
+        (void)blur;
+        (void)color;
+        (void)opacity;
+    }
+
+    void DrawLabel(const wchar_t* text, const RectI& rect, const FontSpec& font, Color color, TextAlign align) override
+    {
+        (void)text;
+        (void)rect;
+        (void)color;
+        (void)align;
+        m_resources.GetFont(font.face, font.size, font.bold ? FONT_WEIGHT_BOLD : FONT_WEIGHT_NORMAL);
+    }
+
+private:
+    int m_width;
+    int m_height;
+    ResourceCache& m_resources;
+};
+
+// 面板可能显示的各种状态：按键按下、空闲提示、重置倒计时
+static PanelState FrameState(int frame)
+{
+    PanelState state = {};
+    state.upPressed = (frame & 1) != 0;
+    state.downPressed = (frame & 2) != 0;
+    state.leftPressed = (frame & 4) != 0;
+    state.rightPressed = (frame & 8) != 0;
+    state.spacePressed = (frame & 16) != 0;
+    state.escPressed = (frame & 32) != 0;
+    state.resetTriggered = (frame & 64) != 0;
+    state.idleSeconds = frame % 6;
+    state.posX = 660 + frame;
+    state.posY = 315 - frame;
+    return state;
+}
+
+TEST(ResourceCacheReusesObjectsByKey)
+{
+    CountingResourceFactory factory;
+    {
+        ResourceCache cache(factory);
+        ResourceHandle brush = cache.GetBrush(MakeColor(1, 2, 3));
+        CHECK_EQ(cache.GetBrush(MakeColor(1, 2, 3)), brush);
+        CHECK(cache.GetBrush(MakeColor(1, 2, 4)) != brush);
+
+        ResourceHandle pen = cache.GetPen(MakeColor(1, 2, 3), 1, PEN_STYLE_SOLID);
+        CHECK_EQ(cache.GetPen(MakeColor(1, 2, 3), 1, PEN_STYLE_SOLID), pen);
+        CHECK(cache.GetPen(MakeColor(1, 2, 3), 2, PEN_STYLE_SOLID) != pen);
+
+        ResourceHandle font = cache.GetFont(L"Segoe UI", 14, FONT_WEIGHT_NORMAL);
+        CHECK_EQ(cache.GetFont(L"Segoe UI", 14, FONT_WEIGHT_NORMAL), font);
+        CHECK(cache.GetFont(L"Segoe UI", 14, FONT_WEIGHT_BOLD) != font);
+        CHECK(cache.GetFont(L"Segoe UI", 16, FONT_WEIGHT_NORMAL) != font);
+        CHECK(cache.GetFont(L"Consolas", 14, FONT_WEIGHT_NORMAL) != font);
+
+        CHECK_EQ(factory.BrushesCreated(), 2);
+        CHECK_EQ(factory.PensCreated(), 2);
+        CHECK_EQ(factory.FontsCreated(), 4);
+        CHECK_EQ(cache.Size(), (size_t)8);
+
+        // 清空后全部销毁，再次使用时重新创建
+        cache.Clear();
+        CHECK_EQ(factory.Destroyed(), 8);
+        CHECK_EQ(cache.Size(), (size_t)0);
+        cache.GetBrush(MakeColor(1, 2, 3));
+        CHECK_EQ(factory.BrushesCreated(), 3);
+    }
+    CHECK_EQ(factory.Destroyed(), factory.TotalCreated());
+}
+
+TEST(ResourceCacheStopsCreatingAfterFirstFrame)
+{
+    CountingResourceFactory factory;
+    {
+        ResourceCache cache(factory);
+        CachingBackend backend(600, 450, cache);
+
+        // 同一状态重绘：只有第一帧创建对象
+        PanelState idle = FrameState(0);
+        DrawControlPanel(backend, idle);
+        int firstFrame = factory.TotalCreated();
+        CHECK(firstFrame > 0);
+        CHECK_EQ((size_t)firstFrame, cache.Size());
+        for (int frame = 0; frame < 10; ++frame)
+            DrawControlPanel(backend, idle);
+        CHECK_EQ(factory.TotalCreated(), firstFrame);
+
+        // 每种状态第一次出现之后，之后的帧都不再创建
+        for (int frame = 0; frame < 128; ++frame)
+            DrawControlPanel(backend, FrameState(frame));
+        int allStates = factory.TotalCreated();
+        for (int pass = 0; pass < 3; ++pass)
+        {
+            for (int frame = 0; frame < 128; ++frame)
+                DrawControlPanel(backend, FrameState(frame));
+        }
+        CHECK_EQ(factory.TotalCreated(), allStates);
+        CHECK_EQ(factory.Destroyed(), 0);
+    }
+
+    // 析构时销毁每一个创建过的对象
+    CHECK(factory.TotalCreated() > 0);
+    CHECK_EQ(factory.Destroyed(), factory.TotalCreated());
+}
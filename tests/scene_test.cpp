@@ -0,0 +1,155 @@
+#include <cwchar>
+
+#include "scene.h"
+#include "test_framework.h"
+
+// 布局完成并已经做过第一次全量更新的场景
+static void PrepareScene(PanelScene& scene, const PanelState& state)
+{
+    scene.Layout(600, 450);
+    scene.Update(state);
+}
+
+static std::vector<RectI> Bounds(const PanelScene& scene, PanelElement element)
+{
+    return std::vector<RectI>(1, scene.GetLayout().bounds[element]);
+}
+
+TEST(SceneFirstUpdateRepaintsWholeCanvas)
+{
+    PanelScene scene;
+    scene.Layout(600, 450);
+    PanelState state = {};
+    CHECK_EQ(scene.Update(state), std::vector<RectI>(1, RectI{0, 0, 600, 450}));
+    CHECK(scene.Update(state).empty());
+}
+
+TEST(SceneRelayoutRepaintsWholeCanvasOnlyWhenSizeChanges)
+{
+    PanelScene scene;
+    PanelState state = {};
+    PrepareScene(scene, state);
+
+    scene.Layout(600, 450);
+    CHECK(scene.Update(state).empty());
+
+    scene.Layout(800, 500);
+    CHECK_EQ(scene.Update(state), std::vector<RectI>(1, RectI{0, 0, 800, 500}));
+    CHECK(scene.Update(state).empty());
+}
+
+TEST(SceneKeyDownAndUpDamageOnlyThatKey)
+{
+    static const PanelElement KEYS[] = {PANEL_KEY_UP, PANEL_KEY_DOWN, PANEL_KEY_LEFT, PANEL_KEY_RIGHT,
+                                        PANEL_SPACE_BUTTON, PANEL_ESC_BUTTON};
+    PanelScene scene;
+    PanelState state = {};
+    PrepareScene(scene, state);
+
+    for (PanelElement key : KEYS)
+    {
+        bool* pressed = nullptr;
+        switch (key)
+        {
+        case PANEL_KEY_UP:       pressed = &state.upPressed; break;
+        case PANEL_KEY_DOWN:     pressed = &state.downPressed; break;
+        case PANEL_KEY_LEFT:     pressed = &state.leftPressed; break;
+        case PANEL_KEY_RIGHT:    pressed = &state.rightPressed; break;
+        case PANEL_SPACE_BUTTON: pressed = &state.spacePressed; break;
+        default:                 pressed = &state.escPressed; break;
+        }
+
+        *pressed = true;
+        CHECK_EQ(scene.Update(state), Bounds(scene, key));
+        CHECK(scene.Update(state).empty());
+
+        *pressed = false;
+        CHECK_EQ(scene.Update(state), Bounds(scene, key));
+        CHECK(scene.Update(state).empty());
+    }
+}
+
+TEST(SceneSimultaneousChangesAreReportedInElementOrder)
+{
+    PanelScene scene;
+    PanelState state = {};
+    PrepareScene(scene, state);
+
+    state.rightPressed = true;
+    state.upPressed = true;
+    state.posX = 10;
+    std::vector<RectI> expected;
+    expected.push_back(scene.GetLayout().bounds[PANEL_KEY_UP]);
+    expected.push_back(scene.GetLayout().bounds[PANEL_KEY_RIGHT]);
+    expected.push_back(scene.GetLayout().bounds[PANEL_STATUS]);
+    CHECK_EQ(scene.Update(state), expected);
+}
+
+TEST(SceneStatusChangesDamageOnlyTheStatusArea)
+{
+    PanelScene scene;
+    PanelState state = {};
+    state.posX = 300;
+    state.posY = 200;
+    PrepareScene(scene, state);
+
+    // 正常状态下坐标参与比较
+    state.posX = 301;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+    state.posY = 199;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+
+    // 空闲不足 4 秒时不显示秒数，不必重绘
+    state.idleSeconds = 3;
+    CHECK(scene.Update(state).empty());
+
+    // 空闲提示出现，之后坐标不再显示
+    state.idleSeconds = 4;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+    state.posX = 500;
+    CHECK(scene.Update(state).empty());
+}
+
+TEST(SceneResetCountdownDamagesStatusEverySecond)
+{
+    PanelScene scene;
+    PanelState state = {};
+    PrepareScene(scene, state);
+
+    state.resetTriggered = true;
+    state.idleSeconds = 0;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+    for (int second = 1; second <= 5; ++second)
+    {
+        state.idleSeconds = second;
+        CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+        CHECK(scene.Update(state).empty());
+    }
+
+    // 回到中央后恢复正常状态
+    state.resetTriggered = false;
+    state.idleSeconds = 0;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_STATUS));
+}
+
+TEST(SceneLatencyOverlayToggleDamagesOnlyTheHint)
+{
+    PanelScene scene;
+    PanelState state = {};
+    PrepareScene(scene, state);
+
+    state.showLatency = true;
+    wcscpy(state.latencyText, L"p50 1.0 ms");
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_HINT));
+    CHECK(scene.Update(state).empty());
+
+    // 文字变化时重绘，关闭叠加层时也重绘
+    wcscpy(state.latencyText, L"p50 1.2 ms");
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_HINT));
+    state.showLatency = false;
+    CHECK_EQ(scene.Update(state), Bounds(scene, PANEL_HINT));
+
+    // 隐藏时文字变化不参与比较
+    wcscpy(state.latencyText, L"p50 9.9 ms");
+    CHECK(scene.Update(state).empty());
+}
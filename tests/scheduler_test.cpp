@@ -0,0 +1,71 @@
+#include <vector>
+
+#include "scheduler.h"
+#include "test_framework.h"
+
+using std::chrono::milliseconds;
+
+TEST(SchedulerRunsDueEventsInDeadlineOrder)
+{
+    VirtualClock clock;
+    EventScheduler scheduler(clock);
+    std::vector<int> order;
+    scheduler.ScheduleAfter(milliseconds(30), [&order] { order.push_back(3); });
+    scheduler.ScheduleAfter(milliseconds(10), [&order] { order.push_back(1); });
+    scheduler.ScheduleAfter(milliseconds(10), [&order] { order.push_back(2); });
+
+    CHECK(scheduler.NextDeadline() == clock.Now() + milliseconds(10));
+    clock.Advance(milliseconds(9));
+    CHECK_EQ(scheduler.RunDue(), 0);
+    clock.Advance(milliseconds(1));
+    CHECK_EQ(scheduler.RunDue(), 2);
+    clock.Advance(milliseconds(100));
+    CHECK_EQ(scheduler.RunDue(), 1);
+
+    // 截止时间相同时按加入顺序
+    CHECK_EQ(order.size(), (size_t)3);
+    CHECK(order == std::vector<int>({1, 2, 3}));
+    CHECK(!scheduler.HasPending());
+    CHECK(scheduler.NextDeadline() == IClock::TimePoint::max());
+}
+
+TEST(SchedulerCancelledIdsStayInvalidAfterSlotReuse)
+{
+    VirtualClock clock;
+    EventScheduler scheduler(clock);
+    int runs = 0;
+    TimerId first = scheduler.ScheduleAfter(milliseconds(5), [&runs] { ++runs; });
+    CHECK(first != 0);
+    CHECK(scheduler.Cancel(first));
+    CHECK(!scheduler.Cancel(first));
+    CHECK(!scheduler.HasPending());
+
+    // 新事件复用同一个槽，旧的 id 不能取消它
+    TimerId second = scheduler.ScheduleAfter(milliseconds(5), [&runs] { ++runs; });
+    CHECK(second != first);
+    CHECK(!scheduler.Cancel(first));
+    CHECK(scheduler.HasPending());
+
+    clock.Advance(milliseconds(5));
+    CHECK_EQ(scheduler.RunDue(), 1);
+    CHECK_EQ(runs, 1);
+    CHECK(!scheduler.Cancel(second));
+}
+
+TEST(SchedulerDefersEventsAddedWhileRunning)
+{
+    VirtualClock clock;
+    EventScheduler scheduler(clock);
+    int runs = 0;
+    scheduler.ScheduleAfter(milliseconds(0), [&] {
+        ++runs;
+        scheduler.ScheduleAfter(milliseconds(0), [&runs] { ++runs; });
+    });
+
+    // 回调里加入的已到期事件留到下一次 RunDue
+    CHECK_EQ(scheduler.RunDue(), 1);
+    CHECK_EQ(runs, 1);
+    CHECK_EQ(scheduler.RunDue(), 1);
+    CHECK_EQ(runs, 2);
+    CHECK_EQ(scheduler.EventsRun(), (uint64_t)2);
+}
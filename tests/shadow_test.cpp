@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "framebuffer.h"
+#include "shadow.h"
+#include "test_framework.h"
+
+// 奇数宽度让 SSE2/AVX2 的 8/16 列分组之后总有剩下的列走逐列路径
+const int BLUR_WIDTHS[] = {1, 7, 8, 15, 16, 17, 33, 100};
+const int BLUR_RADII[] = {1, 2, 5, 12, MAX_SHADOW_BLUR};
+
+// 随机遮罩里混入整片的 0 和 255，和真实的圆角矩形一样有平坦区域
+static std::vector<uint8_t> RandomMask(std::mt19937& random, int width, int height)
+{
+    std::vector<uint8_t> mask((size_t)width * height);
+    for (size_t i = 0; i < mask.size(); ++i)
+    {
+        uint32_t bits = random();
+        mask[i] = (bits & 3) == 0 ? 0 : (bits & 3) == 1 ? 255 : (uint8_t)(bits >> 8);
+    }
+    return mask;
+}
+
+TEST(BoxBlurColumnsMatchesScalarReference)
+{
+    std::mt19937 random(24);
+    for (int width : BLUR_WIDTHS)
+    {
+        for (int radius : BLUR_RADII)
+        {
+            int height = 3 * radius + 11;
+            std::vector<uint8_t> src = RandomMask(random, width, height);
+            std::vector<uint8_t> fast(src.size(), 0xCD);
+            std::vector<uint8_t> reference(src.size(), 0xCD);
+            std::vector<uint16_t> sums(width);
+
+            BoxBlurColumns(fast.data(), src.data(), width, height, radius, sums.data());
+            BoxBlurColumnsScalar(reference.data(), src.data(), width, height, radius, sums.data());
+            CHECK(fast == reference);
+        }
+    }
+}
+
+TEST(BoxBlurColumnsKeepsSolidMaskSolidAwayFromEdges)
+{
+    // 全 255 的遮罩：离上下边缘超过 radius 的行保持 255，边缘的行因范围外按 0 计而变暗
+    const int width = 19;
+    const int height = 40;
+    const int radius = 4;
+    std::vector<uint8_t> src((size_t)width * height, 255);
+    std::vector<uint8_t> dst(src.size());
+    std::vector<uint16_t> sums(width);
+
+    BoxBlurColumns(dst.data(), src.data(), width, height, radius, sums.data());
+    for (int x = 0; x < width; ++x)
+    {
+        CHECK_EQ((int)dst[(size_t)(height / 2) * width + x], 255);
+        CHECK(dst[x] < 255);
+        CHECK(dst[(size_t)(height - 1) * width + x] < 255);
+    }
+}
+
+TEST(TransposeMaskRoundTrips)
+{
+    std::mt19937 random(7);
+    const int sizes[][2] = {{1, 1}, {8, 8}, {13, 5}, {5, 13}, {64, 17}};
+    for (const int* size : sizes)
+    {
+        int width = size[0];
+        int height = size[1];
+        std::vector<uint8_t> src = RandomMask(random, width, height);
+        std::vector<uint8_t> transposed(src.size());
+        std::vector<uint8_t> back(src.size());
+
+        TransposeMask(transposed.data(), src.data(), width, height);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+                CHECK_EQ((int)transposed[(size_t)x * height + y], (int)src[(size_t)y * width + x]);
+        }
+        TransposeMask(back.data(), transposed.data(), height, width);
+        CHECK(back == src);
+    }
+}
+
+TEST(BlendCoverageSpanMatchesScalarReference)
+{
+    std::mt19937 random(99);
+    const int counts[] = {0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 31, 64, 250};
+    for (int count : counts)
+    {
+        std::vector<uint8_t> coverage = RandomMask(random, count, 1);
+        std::vector<uint32_t> background(count);
+        for (int i = 0; i < count; ++i)
+            background[i] = ColorToPixel(random());
+        uint32_t value = ColorToPixel(random());
+
+        std::vector<uint32_t> fast = background;
+        std::vector<uint32_t> reference = background;
+        BlendCoverageSpan(fast.data(), coverage.data(), count, value);
+        BlendCoverageSpanScalar(reference.data(), coverage.data(), count, value);
+        CHECK(fast == reference);
+    }
+}
+
+TEST(BlendCoverageSpanHandlesUniformGroups)
+{
+    // 整组全覆盖直接写入，整组全不覆盖直接跳过
+    const int count = 40;
+    std::vector<uint8_t> coverage(count, 0);
+    for (int i = 16; i < 32; ++i)
+        coverage[i] = 255;
+    std::vector<uint32_t> pixels(count, ColorToPixel(0x102030));
+    uint32_t value = ColorToPixel(0xA0B0C0);
+
+    BlendCoverageSpan(pixels.data(), coverage.data(), count, value);
+    for (int i = 0; i < count; ++i)
+        CHECK_EQ(pixels[i], coverage[i] ? value : ColorToPixel(0x102030));
+}
+
+TEST(ShadowCacheBuildsEachMaskOnce)
+{
+    ShadowCache cache;
+    const ShadowMask& mask = cache.Get(120, 80, 8, 6, 128);
+    CHECK_EQ(mask.margin, 18);
+    CHECK_EQ(mask.width, 120 + 2 * 18);
+    CHECK_EQ(mask.height, 80 + 2 * 18);
+    CHECK_EQ(mask.alpha.size(), (size_t)mask.width * mask.height);
+    CHECK_EQ(cache.Built(), (uint64_t)1);
+
+    // 形状中央的不透明度约为 opacity，遮罩的角落完全透明
+    CHECK_EQ((int)mask.alpha[(size_t)(mask.height / 2) * mask.width + mask.width / 2], 128);
+    CHECK_EQ((int)mask.alpha[0], 0);
+
+    cache.Get(120, 80, 8, 6, 128);
+    CHECK_EQ(cache.Built(), (uint64_t)1);
+    CHECK_EQ(cache.Size(), (size_t)1);
+
+    cache.Get(120, 80, 8, 6, 200);
+    CHECK_EQ(cache.Built(), (uint64_t)2);
+    CHECK_EQ(cache.Size(), (size_t)2);
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "snap_grid.h"
+#include "test_framework.h"
+
+static const RectI SCREEN = {0, 0, 1920, 1080};
+
+static bool Overlaps(const RectI& a, const RectI& b)
+{
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
+// 逐个比较所有窗口的结果，排好序
+static std::vector<uint32_t> BruteForce(const SnapGrid& grid, size_t count, const RectI& area, uint32_t exclude)
+{
+    std::vector<uint32_t> found;
+    for (uint32_t id = 0; id < count; ++id)
+    {
+        if (id != exclude && grid.Contains(id) && Overlaps(grid.Rect(id), area))
+            found.push_back(id);
+    }
+    return found;
+}
+
+static std::vector<uint32_t> Sorted(const SnapGrid& grid, const RectI& area, uint32_t exclude)
+{
+    std::vector<uint32_t> found;
+    grid.Query(area, exclude, &found);
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+TEST(SnapGridQueryMatchesBruteForceAfterUpdates)
+{
+    const size_t count = 300;
+    std::mt19937 random(20);
+    std::uniform_int_distribution<int> pos(-600, 3000);
+    std::uniform_int_distribution<int> size(1, 700);
+    std::uniform_int_distribution<int> step(-300, 300);
+
+    SnapGrid grid;
+    for (uint32_t id = 0; id < count; ++id)
+        grid.Insert(id, MakeRect(pos(random), pos(random), size(random), size(random)));
+
+    for (int round = 0; round < 50; ++round)
+    {
+        // 移动足够远，大部分窗口跨过单元边界；顺便删掉又加回一些窗口
+        for (uint32_t id = 0; id < count; ++id)
+        {
+            if (!grid.Contains(id))
+            {
+                grid.Insert(id, MakeRect(pos(random), pos(random), size(random), size(random)));
+                continue;
+            }
+            const RectI& rect = grid.Rect(id);
+            if (random() % 10 == 0)
+                grid.Remove(id);
+            else
+                grid.Update(id, MakeRect(rect.left + step(random), rect.top + step(random), size(random), size(random)));
+        }
+
+        for (int query = 0; query < 20; ++query)
+        {
+            RectI area = MakeRect(pos(random), pos(random), size(random) * 2, size(random) * 2);
+            uint32_t exclude = (uint32_t)(random() % count);
+            CHECK(Sorted(grid, area, exclude) == BruteForce(grid, count, area, exclude));
+        }
+    }
+    CHECK(grid.CellUpdates() > count * 10);
+
+    // 覆盖的单元比桶还多的查询走扫描所有桶的路径
+    RectI everything = {-2000, -2000, 6000, 6000};
+    CHECK(Sorted(grid, everything, UINT32_MAX) == BruteForce(grid, count, everything, UINT32_MAX));
+    CHECK_EQ(Sorted(grid, everything, UINT32_MAX).size(), grid.Size());
+}
+
+TEST(SnapGridRemoveCleansCellsSharingBucket)
+{
+    // 40x40 个单元的窗口远多于 64 个桶，必然有多个单元落在同一个桶里，窗口在那个桶里登记了多次
+    SnapGrid grid;
+    grid.Insert(0, MakeRect(0, 0, 40 << SNAP_CELL_SHIFT, 40 << SNAP_CELL_SHIFT));
+    grid.Insert(1, MakeRect(100, 100, 50, 50));
+    grid.Insert(2, MakeRect(5000, 5000, 50, 50));
+
+    // 移动后旧的单元里也不能留下任何登记
+    grid.Update(0, MakeRect(30, 30, 40 << SNAP_CELL_SHIFT, 40 << SNAP_CELL_SHIFT));
+    grid.Remove(0);
+    CHECK(!grid.Contains(0));
+    CHECK_EQ(grid.Size(), (size_t)2);
+
+    std::vector<uint32_t> found;
+    for (int cy = 0; cy < 40; ++cy)
+    {
+        for (int cx = 0; cx < 40; ++cx)
+        {
+            found.clear();
+            grid.Query(MakeRect(cx << SNAP_CELL_SHIFT, cy << SNAP_CELL_SHIFT, 1 << SNAP_CELL_SHIFT, 1 << SNAP_CELL_SHIFT),
+                       UINT32_MAX, &found);
+            CHECK(std::find(found.begin(), found.end(), 0u) == found.end());
+        }
+    }
+
+    // 重新使用这个编号：只在新位置出现，而且只出现一次
+    grid.Insert(0, MakeRect(5000, 5100, 50, 50));
+    CHECK(Sorted(grid, MakeRect(0, 0, 2000, 2000), UINT32_MAX) == std::vector<uint32_t>(1, 1u));
+    CHECK(Sorted(grid, MakeRect(4900, 4900, 300, 300), UINT32_MAX) == (std::vector<uint32_t>{0u, 2u}));
+}
+
+TEST(SnapGridPreventOverlapKeepsWindowsApart)
+{
+    // 窗口排成互不重叠的网格，随机移动很多次，任何时候都没有两个窗口重叠
+    const size_t count = 40;
+    SnapGrid grid;
+    for (uint32_t id = 0; id < count; ++id)
+        grid.Insert(id, MakeRect(20 + (int)(id % 8) * 230, 20 + (int)(id / 8) * 210, 150 + (int)(id % 3) * 20, 130));
+
+    SnapOptions options = {DEFAULT_SNAP_DISTANCE, true, 20};
+    std::mt19937 random(21);
+    std::uniform_int_distribution<int> step(-120, 120);
+    for (int move = 0; move < 4000; ++move)
+    {
+        uint32_t id = (uint32_t)(random() % count);
+        const RectI& rect = grid.Rect(id);
+        grid.Move(id, PointI{rect.left + step(random), rect.top + step(random)}, SCREEN, options);
+
+        const RectI& moved = grid.Rect(id);
+        for (uint32_t other = 0; other < count; ++other)
+            CHECK(other == id || !Overlaps(moved, grid.Rect(other)));
+    }
+}
+
+TEST(SnapGridSnapsOnlyInMovementDirection)
+{
+    SnapGrid grid;
+    grid.Insert(0, MakeRect(500, 300, 100, 100));
+    grid.Insert(1, MakeRect(700, 300, 100, 100));
+    SnapOptions options = {DEFAULT_SNAP_DISTANCE, false, 20};
+
+    // 向右靠近到相距 8 像素：贴上去
+    CHECK_EQ(grid.Move(0, PointI{592, 300}, SCREEN, options).x, 600);
+
+    // 从相距 3 像素处向左离开到 7 像素：不会被拉回去
+    grid.Update(0, MakeRect(597, 300, 100, 100));
+    CHECK_EQ(grid.Move(0, PointI{593, 300}, SCREEN, options).x, 593);
+
+    // 只沿 y 移动时 x 不吸附
+    PointI pos = grid.Move(0, PointI{593, 310}, SCREEN, options);
+    CHECK_EQ(pos.x, 593);
+    CHECK_EQ(pos.y, 310);
+
+    // 向下移动时与相邻窗口的上边对齐（相距 10 像素），向上离开时不对齐
+    grid.Update(0, MakeRect(650, 280, 100, 100));
+    CHECK_EQ(grid.Move(0, PointI{650, 290}, SCREEN, options).y, 300);
+    CHECK_EQ(grid.Move(0, PointI{650, 295}, SCREEN, options).y, 295);
+
+    // 屏幕边缘同理：向左靠近时贴边，向右离开时不拉回
+    grid.Update(0, MakeRect(30, 600, 100, 100));
+    CHECK_EQ(grid.Move(0, PointI{10, 600}, SCREEN, options).x, 0);
+    CHECK_EQ(grid.Move(0, PointI{5, 600}, SCREEN, options).x, 5);
+}
@@ -0,0 +1,149 @@
+#include <thread>
+
+#include "spsc_ring.h"
+#include "test_framework.h"
+#include "triple_buffer.h"
+
+const uint64_t STRESS_ITEMS = 500000;
+
+// 带校验字段的元素：各字段都由 sequence 算出，读到一半被改写时对不上
+struct StressItem
+{
+    uint64_t sequence;
+    uint64_t words[7];
+};
+
+static StressItem MakeItem(uint64_t sequence)
+{
+    StressItem item;
+    item.sequence = sequence;
+    for (int i = 0; i < 7; ++i)
+        item.words[i] = sequence * 0x9E3779B97F4A7C15ull + (uint64_t)i;
+    return item;
+}
+
+static bool IsConsistent(const StressItem& item)
+{
+    StressItem expected = MakeItem(item.sequence);
+    for (int i = 0; i < 7; ++i)
+    {
+        if (item.words[i] != expected.words[i])
+            return false;
+    }
+    return true;
+}
+
+TEST(SpscRingPreservesOrderAcrossThreads)
+{
+    // 容量很小，生产者频繁遇到队列满、下标频繁回绕
+    static SpscRing<StressItem, 64> ring;
+    uint64_t fullRetries = 0;
+    std::thread producer([&fullRetries] {
+        for (uint64_t n = 0; n < STRESS_ITEMS; ++n)
+        {
+            StressItem item = MakeItem(n);
+            while (!ring.TryPush(item))
+            {
+                ++fullRetries;
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint64_t expected = 0;
+    uint64_t outOfOrder = 0;
+    uint64_t torn = 0;
+    StressItem item;
+    while (expected < STRESS_ITEMS)
+    {
+        if (!ring.TryPop(item))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (item.sequence != expected)
+            ++outOfOrder;
+        if (!IsConsistent(item))
+            ++torn;
+        expected = item.sequence + 1;
+    }
+    producer.join();
+
+    // 每个元素恰好出现一次，按推入的顺序
+    CHECK_EQ(outOfOrder, (uint64_t)0);
+    CHECK_EQ(torn, (uint64_t)0);
+    CHECK_EQ(expected, STRESS_ITEMS);
+    CHECK(!ring.TryPop(item));
+    CHECK_EQ(ring.SizeApprox(), (size_t)0);
+}
+
+TEST(SpscRingRejectsPushWhenFull)
+{
+    SpscRing<int, 8> ring;
+    for (int i = 0; i < 8; ++i)
+        CHECK(ring.TryPush(i));
+    CHECK(!ring.TryPush(8));
+    CHECK_EQ(ring.SizeApprox(), (size_t)8);
+
+    int value = -1;
+    CHECK(ring.TryPop(value));
+    CHECK_EQ(value, 0);
+    CHECK(ring.TryPush(8));
+    for (int i = 1; i <= 8; ++i)
+    {
+        CHECK(ring.TryPop(value));
+        CHECK_EQ(value, i);
+    }
+    CHECK(!ring.TryPop(value));
+}
+
+TEST(TripleBufferDeliversNewestWithoutTearing)
+{
+    static TripleBuffer<StressItem> buffer;
+    std::atomic<bool> done(false);
+    uint64_t dropped = 0;
+    std::thread producer([&] {
+        for (uint64_t n = 1; n <= STRESS_ITEMS; ++n)
+        {
+            buffer.Back() = MakeItem(n);
+            if (buffer.Publish())
+                ++dropped;
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint64_t acquired = 0;
+    uint64_t last = 0;
+    uint64_t regressions = 0;
+    uint64_t torn = 0;
+    for (;;)
+    {
+        bool finished = done.load(std::memory_order_acquire);
+        if (buffer.Acquire())
+        {
+            const StressItem& item = buffer.Front();
+            ++acquired;
+            if (item.sequence <= last)
+                ++regressions;
+            if (!IsConsistent(item))
+                ++torn;
+            last = item.sequence;
+        }
+        else if (finished)
+        {
+            break;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    // 序号只增不减、没有撕裂，最后一次发布一定被读到；每次发布要么被读取要么被下一次替换
+    CHECK_EQ(regressions, (uint64_t)0);
+    CHECK_EQ(torn, (uint64_t)0);
+    CHECK_EQ(last, STRESS_ITEMS);
+    CHECK_EQ(acquired + dropped, STRESS_ITEMS);
+    CHECK(!buffer.HasUnread());
+}
@@ -0,0 +1,192 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "state_file.h"
+#include "test_framework.h"
+
+// 文件布局（state_file.cpp）：16 字节文件头，之后两个槽；
+// 每个槽依次是 8 字节序号、4 字节校验和、4 字节长度和状态
+const size_t HEADER_SIZE = 16;
+const size_t SLOT_SIZE = 16 + sizeof(PersistedState);
+const size_t SLOT_SEQUENCE = 0;
+const size_t SLOT_STATE = 16;
+
+const char STATE_TEST_PATH[] = "movable_window_tests_state.bin";
+
+static std::vector<uint8_t> ReadFileBytes(const char* path)
+{
+    std::vector<uint8_t> bytes;
+    if (FILE* file = fopen(path, "rb"))
+    {
+        uint8_t buffer[256];
+        size_t count;
+        while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+            bytes.insert(bytes.end(), buffer, buffer + count);
+        fclose(file);
+    }
+    return bytes;
+}
+
+static void WriteFileBytes(const char* path, const std::vector<uint8_t>& bytes)
+{
+    if (FILE* file = fopen(path, "wb"))
+    {
+        fwrite(bytes.data(), 1, bytes.size(), file);
+        fclose(file);
+    }
+}
+
+static size_t SlotOffset(int slot)
+{
+    return HEADER_SIZE + (size_t)slot * SLOT_SIZE;
+}
+
+static PersistedState MakeState(int x, int y)
+{
+    PersistedState state;
+    memset(&state, 0, sizeof(state));
+    state.x = x;
+    state.y = y;
+    state.width = 600;
+    state.height = 450;
+    // 绑定区也填上内容，截断后补的零不会恰好与原内容相同
+    state.bindingCount = (uint32_t)MAX_PERSISTED_BINDINGS;
+    for (size_t i = 0; i < MAX_PERSISTED_BINDINGS; ++i)
+    {
+        state.bindings[i].key = (uint16_t)((x + i) & 0xFF);
+        state.bindings[i].action = (uint8_t)(i % ACTION_COUNT);
+    }
+    return state;
+}
+
+// 依次写入 A、B：A 在槽 0（序号 1），B 在槽 1（序号 2）
+static void WriteTwoStates()
+{
+    std::remove(STATE_TEST_PATH);
+    StateFile file;
+    CHECK(file.Open(STATE_TEST_PATH));
+    CHECK(file.Store(MakeState(100, 200)));
+    CHECK(file.Store(MakeState(300, 400)));
+    CHECK_EQ(file.Sequence(), (uint64_t)2);
+}
+
+// 重新打开后读到的状态，没有时 x 为 -1
+static PersistedState Reopen(uint64_t* sequence)
+{
+    StateFile file;
+    PersistedState state = MakeState(-1, -1);
+    CHECK(file.Open(STATE_TEST_PATH));
+    file.Load(&state);
+    *sequence = file.Sequence();
+    return state;
+}
+
+TEST(StateFileRoundTripsLatestState)
+{
+    WriteTwoStates();
+    uint64_t sequence = 0;
+    PersistedState state = Reopen(&sequence);
+    CHECK_EQ(state.x, 300);
+    CHECK_EQ(state.y, 400);
+    CHECK_EQ(sequence, (uint64_t)2);
+
+    // 内容相同的写入被跳过
+    StateFile file;
+    CHECK(file.Open(STATE_TEST_PATH));
+    CHECK(file.Store(MakeState(300, 400)));
+    CHECK_EQ(file.Writes(), (uint64_t)0);
+    CHECK_EQ(file.Sequence(), (uint64_t)2);
+    file.Close();
+    std::remove(STATE_TEST_PATH);
+}
+
+TEST(StateFileIgnoresSlotInterruptedBeforeChecksum)
+{
+    WriteTwoStates();
+
+    // 第三次写入覆盖槽 0：序号已清零、状态写了一半，还没写校验和就中断
+    std::vector<uint8_t> bytes = ReadFileBytes(STATE_TEST_PATH);
+    CHECK_EQ(bytes.size(), HEADER_SIZE + 2 * SLOT_SIZE);
+    memset(&bytes[SlotOffset(0) + SLOT_SEQUENCE], 0, 8);
+    PersistedState partial = MakeState(500, 600);
+    memcpy(&bytes[SlotOffset(0) + SLOT_STATE], &partial, 8);
+    WriteFileBytes(STATE_TEST_PATH, bytes);
+
+    uint64_t sequence = 0;
+    PersistedState state = Reopen(&sequence);
+    CHECK_EQ(state.x, 300);
+    CHECK_EQ(sequence, (uint64_t)2);
+
+    // 下一次写入仍然覆盖被中断的槽，不碰最新的完整状态
+    {
+        StateFile file;
+        CHECK(file.Open(STATE_TEST_PATH));
+        CHECK(file.Store(MakeState(700, 800)));
+        CHECK_EQ(file.Sequence(), (uint64_t)3);
+    }
+    state = Reopen(&sequence);
+    CHECK_EQ(state.x, 700);
+    std::remove(STATE_TEST_PATH);
+}
+
+TEST(StateFileRejectsSlotWithBadChecksum)
+{
+    WriteTwoStates();
+
+    // 最新的槽序号完好但内容有一位出错：校验不通过，退回槽 0
+    std::vector<uint8_t> bytes = ReadFileBytes(STATE_TEST_PATH);
+    bytes[SlotOffset(1) + SLOT_STATE + 1] ^= 0x10;
+    WriteFileBytes(STATE_TEST_PATH, bytes);
+
+    uint64_t sequence = 0;
+    PersistedState state = Reopen(&sequence);
+    CHECK_EQ(state.x, 100);
+    CHECK_EQ(state.y, 200);
+    CHECK_EQ(sequence, (uint64_t)1);
+
+    // 两个槽都坏了时没有状态
+    bytes[SlotOffset(0) + SLOT_STATE + 2] ^= 0x01;
+    WriteFileBytes(STATE_TEST_PATH, bytes);
+    StateFile file;
+    CHECK(file.Open(STATE_TEST_PATH));
+    CHECK(!file.Load(&state));
+    CHECK_EQ(file.Sequence(), (uint64_t)0);
+    file.Close();
+    std::remove(STATE_TEST_PATH);
+}
+
+TEST(StateFileTruncatedInSecondSlotFallsBackToFirst)
+{
+    WriteTwoStates();
+
+    // 文件在槽 1 中间被截断：补齐之后槽 1 校验不通过，槽 0 的状态保留
+    std::vector<uint8_t> bytes = ReadFileBytes(STATE_TEST_PATH);
+    bytes.resize(SlotOffset(1) + 100);
+    WriteFileBytes(STATE_TEST_PATH, bytes);
+
+    uint64_t sequence = 0;
+    PersistedState state = Reopen(&sequence);
+    CHECK_EQ(state.x, 100);
+    CHECK_EQ(sequence, (uint64_t)1);
+    CHECK_EQ(ReadFileBytes(STATE_TEST_PATH).size(), HEADER_SIZE + 2 * SLOT_SIZE);
+    std::remove(STATE_TEST_PATH);
+}
+
+TEST(StateFileTruncatedHeaderStartsEmpty)
+{
+    WriteTwoStates();
+
+    std::vector<uint8_t> bytes = ReadFileBytes(STATE_TEST_PATH);
+    bytes.resize(HEADER_SIZE / 2);
+    WriteFileBytes(STATE_TEST_PATH, bytes);
+
+    StateFile file;
+    PersistedState state;
+    CHECK(file.Open(STATE_TEST_PATH));
+    CHECK(!file.Load(&state));
+    CHECK(file.Store(MakeState(1, 2)));
+    CHECK_EQ(file.Sequence(), (uint64_t)1);
+    file.Close();
+    std::remove(STATE_TEST_PATH);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "geometry.h"
+
+// 极简的测试框架：TEST 注册用例，CHECK 失败时记录文件和行号并继续执行
+// 所有用例编进同一个可执行文件，由 ctest 运行；有失败时返回非零
+
+typedef void (*TestFunction)();
+
+struct TestCase
+{
+    const char* name;
+    TestFunction run;
+};
+
+std::vector<TestCase>& TestRegistry();
+
+// 记录一次失败（当前用例仍然继续执行）
+void ReportFailure(const char* file, int line, const std::string& message);
+
+struct TestRegistrar
+{
+    TestRegistrar(const char* name, TestFunction run) { TestRegistry().push_back(TestCase{name, run}); }
+};
+
+#define TEST(name)                                              \
+    static void name();                                         \
+    static TestRegistrar name##_registrar(#name, name);         \
+    static void name()
+
+// 失败信息里打印的值
+template <typename T>
+std::string FormatValue(const T& value)
+{
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+inline std::string FormatValue(const RectI& rect)
+{
+    std::ostringstream out;
+    out << "{" << rect.left << ", " << rect.top << ", " << rect.right << ", " << rect.bottom << "}";
+    return out.str();
+}
+
+inline std::string FormatValue(const std::vector<RectI>& rects)
+{
+    std::string text = "[";
+    for (size_t i = 0; i < rects.size(); ++i)
+        text += (i ? ", " : "") + FormatValue(rects[i]);
+    return text + "]";
+}
+
+#define CHECK(expr)                                             \
+    do                                                          \
+    {                                                           \
+        if (!(expr))                                            \
+            ReportFailure(__FILE__, __LINE__, #expr);           \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                                     \
+    do                                                                                                 \
+    {                                                                                                  \
+        const auto& check_actual = (actual);                                                           \
+        const auto& check_expected = (expected);                                                       \
+        if (!(check_actual == check_expected))                                                         \
+            ReportFailure(__FILE__, __LINE__, std::string(#actual " == " #expected ": got ") +         \
+                                                  FormatValue(check_actual) + ", expected " +          \
+                                                  FormatValue(check_expected));                        \
+    } while (0)
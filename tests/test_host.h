@@ -0,0 +1,68 @@
+#pragma once
+
+#include <vector>
+
+#include "display_layout.h"
+#include "window_controller.h"
+
+// 测试用的宿主：不移动真实窗口，只记录原生移动调用
+class TestHost : public IWindowHost
+{
+public:
+    explicit TestHost(const std::vector<RectI>& monitors) : m_displays(monitors), m_calls(0), m_windows(0), m_invalidations(0), m_last() {}
+
+    const DisplayLayout& Displays() const override { return m_displays; }
+
+    void MoveWindows(const WindowMove* moves, size_t count) override
+    {
+        ++m_calls;
+        m_windows += count;
+        m_last = moves[count - 1];
+    }
+
+    void InvalidatePanel() override { ++m_invalidations; }
+
+    size_t Calls() const { return m_calls; }
+    size_t WindowsMoved() const { return m_windows; }
+    size_t Invalidations() const { return m_invalidations; }
+    const WindowMove& LastMove() const { return m_last; }
+
+private:
+    DisplayLayout m_displays;
+    size_t m_calls;
+    size_t m_windows;
+    size_t m_invalidations;
+    WindowMove m_last;
+};
+
+// 虚拟时钟上的完整控制器，窗口 600x450 放在主显示器中央（默认一个 1920x1080 的显示器）
+struct ControllerFixture
+{
+    explicit ControllerFixture(const std::vector<RectI>& monitors = std::vector<RectI>(1, MakeRect(0, 0, 1920, 1080)))
+        : scheduler(clock),
+          host(monitors),
+          controller(host, scheduler)
+    {
+        const RectI& primary = host.Displays().Primary();
+        controller.Initialize(primary.left + (RectWidth(primary) - 600) / 2,
+                              primary.top + (RectHeight(primary) - 450) / 2, 600, 450);
+    }
+
+    // 把时钟拨到 time，依次执行其间到期的事件
+    void RunUntil(IClock::TimePoint time)
+    {
+        while (scheduler.NextDeadline() <= time)
+        {
+            clock.Set(scheduler.NextDeadline());
+            controller.RunDueEvents();
+        }
+        clock.Set(time);
+    }
+
+    void RunFor(std::chrono::steady_clock::duration duration) { RunUntil(clock.Now() + duration); }
+
+    VirtualClock clock;
+    EventScheduler scheduler;
+    TestHost host;
+    WindowController controller;
+};
@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <cstring>
+
+#include "test_framework.h"
+
+static int g_failures = 0;
+
+std::vector<TestCase>& TestRegistry()
+{
+    static std::vector<TestCase> registry;
+    return registry;
+}
+
+void ReportFailure(const char* file, int line, const std::string& message)
+{
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, message.c_str());
+    ++g_failures;
+}
+
+// 用法：测试程序 [名字子串]，只运行名字包含该子串的用例
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+    int run = 0;
+    int failed = 0;
+    for (const TestCase& test : TestRegistry())
+    {
+        if (filter && !strstr(test.name, filter))
+            continue;
+        int before = g_failures;
+        test.run();
+        ++run;
+        if (g_failures != before)
+        {
+            ++failed;
+            fprintf(stderr, "FAILED  %s\n", test.name);
+        }
+        else
+        {
+            printf("ok      %s\n", test.name);
+        }
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed == 0 && run > 0 ? 0 : 1;
+}
@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <string>
+
+#include "bitmap_font.h"
+#include "framebuffer.h"
+#include "glyph_atlas.h"
+#include "test_framework.h"
+#include "text_layout.h"
+
+static const FontSpec TEST_FONT = {L"Test", 14, false};
+
+static bool SamePixels(const Framebuffer& a, const Framebuffer& b)
+{
+    return a.Width() == b.Width() && a.Height() == b.Height() &&
+           std::equal(a.Pixels(), a.Pixels() + (size_t)a.Width() * a.Height(), b.Pixels());
+}
+
+// 两次排版的字形下标、位置和来源完全相同
+static bool SameRun(const TextRun& a, const TextRun& b)
+{
+    if (a.width != b.width || a.glyphs.size() != b.glyphs.size())
+        return false;
+    for (size_t i = 0; i < a.glyphs.size(); ++i)
+    {
+        if (a.glyphs[i].glyph != b.glyphs[i].glyph || a.glyphs[i].x != b.glyphs[i].x ||
+            a.glyphs[i].source != b.glyphs[i].source)
+            return false;
+    }
+    return true;
+}
+
+TEST(CachedLabelsMatchUncachedDrawing)
+{
+    const wchar_t* labels[] = {L"Window: (660, 315)", L"Reset in 3s", L"← → ↑ ↓", L"窗口 A"};
+    const RectI rect = {7, 5, 190, 29};
+    const RectI clip = {20, 0, 150, 24};
+    const TextAlign aligns[] = {TEXT_ALIGN_LEFT, TEXT_ALIGN_CENTER};
+
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas);
+    for (const wchar_t* label : labels)
+    {
+        for (TextAlign align : aligns)
+        {
+            Framebuffer cached(200, 40);
+            Framebuffer uncached(200, 40);
+            SoftwareBackend backend(cached, &text);
+            backend.SetClip(clip);
+
+            // 第二次绘制走缓存命中的路径
+            backend.DrawLabel(label, rect, TEST_FONT, 0xE0C040, align);
+            CHECK(!SamePixels(cached, uncached));
+            DrawTextUncached(uncached, clip, font, label, rect, TEST_FONT, 0xE0C040, align);
+            CHECK(SamePixels(cached, uncached));
+
+            Framebuffer again(200, 40);
+            SoftwareBackend hit(again, &text);
+            hit.SetClip(clip);
+            uint64_t hits = text.Hits();
+            hit.DrawLabel(label, rect, TEST_FONT, 0xE0C040, align);
+            CHECK_EQ(text.Hits(), hits + 1);
+            CHECK(SamePixels(again, uncached));
+        }
+    }
+}
+
+TEST(StatusLineReusesUnchangedPrefix)
+{
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas);
+    FontId id = atlas.RegisterFont(TEST_FONT);
+
+    text.Layout(L"X: 100  Y: 200", id, 1);
+    CHECK_EQ(text.GlyphsLaidOut(), (uint64_t)14);
+    CHECK_EQ(text.GlyphsReused(), (uint64_t)0);
+
+    // 只有最后一位数字变化：前 13 个字形直接复用，只排版 1 个
+    const TextRun& run = text.Layout(L"X: 100  Y: 201", id, 1);
+    CHECK_EQ(text.GlyphsLaidOut(), (uint64_t)15);
+    CHECK_EQ(text.GlyphsReused(), (uint64_t)13);
+
+    TextRunCache fresh(atlas);
+    CHECK(SameRun(run, fresh.Layout(L"X: 100  Y: 201", id, 1)));
+
+    // 中间的数字变化，后面的字符都要重新排版
+    const TextRun& middle = text.Layout(L"X: 1000  Y: 201", id, 1);
+    CHECK_EQ(text.GlyphsReused(), (uint64_t)13 + 6);
+    CHECK_EQ(text.GlyphsLaidOut(), (uint64_t)15 + 9);
+    CHECK(SameRun(middle, fresh.Layout(L"X: 1000  Y: 201", id, 2)));
+
+    // 其他位置的结果不作为基础
+    text.Layout(L"X: 1000  Y: 202", id, 3);
+    CHECK_EQ(text.GlyphsReused(), (uint64_t)13 + 6);
+}
+
+TEST(PrefixReuseDoesNotSplitSurrogatePair)
+{
+    // 16 位 wchar_t 上两个表情的高位代理相同、低位不同，公共前缀停在代理对中间，必须退回到 A 之后；
+    // 32 位 wchar_t 上它们是不同的单个字符，复用的也只有 A
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas);
+    FontId id = atlas.RegisterFont(TEST_FONT);
+
+    text.Layout(L"A\U0001F600B", id, 1);
+    uint64_t reused = text.GlyphsReused();
+    const TextRun& run = text.Layout(L"A\U0001F601B", id, 1);
+    CHECK_EQ(text.GlyphsReused(), reused + 1);
+    CHECK_EQ(run.glyphs.size(), (size_t)3);
+
+    TextRunCache fresh(atlas);
+    CHECK(SameRun(run, fresh.Layout(L"A\U0001F601B", id, 1)));
+
+    uint32_t codepoint = 0;
+    CHECK_EQ(DecodeCodepoint(run.text.c_str() + run.glyphs[1].source, &codepoint), (int)(sizeof(wchar_t) == 2 ? 2 : 1));
+    CHECK_EQ(codepoint, (uint32_t)0x1F601);
+    CHECK_EQ(atlas.FindOrAdd(id, 0x1F601), run.glyphs[1].glyph);
+}
+
+TEST(AtlasResetDuringBuildRelaysOutLine)
+{
+    // 40x40 的图集只放得下 12 个 14 号字形：第二行排到一半时图集清空，整行从头再排
+    BitmapFontSource font;
+    GlyphAtlas atlas(font, 40, 40);
+    TextRunCache text(atlas);
+    FontId id = atlas.RegisterFont(TEST_FONT);
+
+    const TextRun& first = text.Layout(L"ABCDEFGH", id, 1);
+    CHECK_EQ(first.generation, (uint32_t)0);
+    CHECK_EQ(atlas.GlyphCount(), (size_t)8);
+
+    const TextRun& second = text.Layout(L"IJKLMNOP", id, 2);
+    CHECK_EQ(atlas.Generation(), (uint32_t)1);
+    CHECK_EQ(second.generation, (uint32_t)1);
+    CHECK_EQ(second.glyphs.size(), (size_t)8);
+    CHECK_EQ(atlas.GlyphCount(), (size_t)8);
+
+    // 字形下标都指向清空后的图集，再查一次不会重新光栅化
+    uint64_t rasterized = atlas.Rasterized();
+    int pen = 0;
+    for (size_t i = 0; i < second.glyphs.size(); ++i)
+    {
+        CHECK_EQ(second.glyphs[i].glyph, atlas.FindOrAdd(id, (uint32_t)(L'I' + i)));
+        CHECK_EQ(second.glyphs[i].x, pen);
+        pen += atlas.Glyph(second.glyphs[i].glyph).advance;
+    }
+    CHECK_EQ(second.width, pen);
+    CHECK_EQ(atlas.Rasterized(), rasterized);
+
+    // 清空前排好的一行下标已经失效，再次使用时重新排版而不算命中
+    uint64_t hits = text.Hits();
+    const TextRun& again = text.Layout(L"ABCDEFGH", id, 1);
+    CHECK_EQ(text.Hits(), hits);
+    CHECK_EQ(again.generation, atlas.Generation());
+    for (size_t i = 0; i < again.glyphs.size(); ++i)
+        CHECK_EQ(again.glyphs[i].glyph, atlas.FindOrAdd(id, (uint32_t)(L'A' + i)));
+}
+
+TEST(LeastRecentlyUsedRunIsEvicted)
+{
+    BitmapFontSource font;
+    GlyphAtlas atlas(font);
+    TextRunCache text(atlas, 2);
+    FontId id = atlas.RegisterFont(TEST_FONT);
+
+    text.Layout(L"one", id, 1);
+    text.Layout(L"two", id, 2);
+    text.Layout(L"one", id, 1);
+    CHECK_EQ(text.Hits(), (uint64_t)1);
+
+    // 缓存满：最久没用的 "two" 让位，它的索引节点改挂到新的字符串上
+    const TextRun& three = text.Layout(L"three", id, 3);
+    CHECK_EQ(text.Size(), (size_t)2);
+    CHECK(three.text == L"three");
+    CHECK_EQ(text.Misses(), (uint64_t)3);
+
+    const TextRun& hit = text.Layout(L"three", id, 3);
+    CHECK_EQ(text.Hits(), (uint64_t)2);
+    CHECK(&hit == &three);
+    text.Layout(L"one", id, 1);
+    CHECK_EQ(text.Hits(), (uint64_t)3);
+
+    // 被淘汰的项不再命中，重新排版的结果和原来一样
+    TextRunCache fresh(atlas);
+    const TextRun& two = text.Layout(L"two", id, 2);
+    CHECK_EQ(text.Misses(), (uint64_t)4);
+    CHECK(SameRun(two, fresh.Layout(L"two", id, 2)));
+    CHECK_EQ(text.Size(), (size_t)2);
+}
@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "test_framework.h"
+#include "trajectory.h"
+
+// 把路径文本写进临时文件，从头读取
+static FILE* PathFile(const std::string& text)
+{
+    FILE* file = tmpfile();
+    if (file)
+    {
+        fputs(text.c_str(), file);
+        rewind(file);
+    }
+    return file;
+}
+
+// 读完整个文件的全部段
+static std::vector<CubicSegment> ReadAll(const std::string& text, PathReader& reader)
+{
+    std::vector<CubicSegment> segments;
+    FILE* file = PathFile(text);
+    CHECK(file != nullptr);
+    if (!file)
+        return segments;
+    reader.Attach(file);
+    while (reader.Read(&segments, 16) > 0)
+    {
+    }
+    fclose(file);
+    return segments;
+}
+
+static bool SegmentIs(const CubicSegment& segment, float x0, float y0, float x3, float y3)
+{
+    return segment.x[0] == x0 && segment.y[0] == y0 && segment.x[3] == x3 && segment.y[3] == y3;
+}
+
+// 相邻两段首尾相接
+static bool IsContinuous(const std::vector<CubicSegment>& segments)
+{
+    for (size_t i = 1; i < segments.size(); ++i)
+    {
+        if (segments[i].x[0] != segments[i - 1].x[3] || segments[i].y[0] != segments[i - 1].y[3])
+            return false;
+    }
+    return true;
+}
+
+TEST(CatmullRomFlushesAtModeSwitchAndEnd)
+{
+    // 样条的输出落后一个点：换成折线时补上最后一段，再从它的终点接着画直线
+    PathReader reader;
+    std::vector<CubicSegment> segments = ReadAll("catmull-rom\n0 0\n100 0\n200 100\npolyline\n300 100\n", reader);
+    CHECK(!reader.Failed());
+    CHECK_EQ(segments.size(), (size_t)3);
+    if (segments.size() == 3)
+    {
+        CHECK(SegmentIs(segments[0], 0, 0, 100, 0));
+        CHECK(SegmentIs(segments[1], 100, 0, 200, 100));
+        CHECK(SegmentIs(segments[2], 200, 100, 300, 100));
+        // 补上的一段终点切线取端点本身，中间的点切线由前后两点决定
+        CHECK_EQ(segments[1].x[2], 200 - (200 - 100) / 6.0f);
+        CHECK_EQ(segments[0].x[2], 100 - (200 - 0) / 6.0f);
+    }
+    CHECK(IsContinuous(segments));
+
+    // 文件结束同样补上最后一段
+    segments = ReadAll("catmull-rom\n0 0\n100 0\n200 100\n", reader);
+    CHECK(reader.AtEnd());
+    CHECK_EQ(segments.size(), (size_t)2);
+    if (segments.size() == 2)
+        CHECK(SegmentIs(segments[1], 100, 0, 200, 100));
+    CHECK_EQ(reader.PointsRead(), (uint64_t)3);
+}
+
+TEST(BezierFlushesIncompleteSegmentAsLines)
+{
+    PathReader reader;
+    std::vector<CubicSegment> segments =
+        ReadAll("bezier\n0 0\n10 10\n20 10\n30 0\n40 0\n50 10\npolyline\n60 10\n", reader);
+    CHECK(!reader.Failed());
+    CHECK_EQ(segments.size(), (size_t)4);
+    if (segments.size() == 4)
+    {
+        CHECK(SegmentIs(segments[0], 0, 0, 30, 0));
+        CHECK_EQ(segments[0].x[1], 10.0f);
+        CHECK_EQ(segments[0].y[2], 10.0f);
+        // 换模式时剩下的两个点按折线连接
+        CHECK(SegmentIs(segments[1], 30, 0, 40, 0));
+        CHECK(SegmentIs(segments[2], 40, 0, 50, 10));
+        CHECK(SegmentIs(segments[3], 50, 10, 60, 10));
+    }
+    CHECK(IsContinuous(segments));
+
+    segments = ReadAll("bezier\n0 0\n1 1\n2 2\n3 3\n4 4\n", reader);
+    CHECK_EQ(segments.size(), (size_t)2);
+    if (segments.size() == 2)
+        CHECK(SegmentIs(segments[1], 3, 3, 4, 4));
+}
+
+TEST(PathReaderReportsMalformedLine)
+{
+    PathReader reader;
+    std::vector<CubicSegment> segments = ReadAll("speed 200\n0 0\n10 10\n# comment\n\nfoo\n20 20\n", reader);
+    CHECK(reader.Failed());
+    CHECK_EQ(reader.ErrorLine(), 6);
+    CHECK(reader.AtEnd());
+    CHECK_EQ(reader.Speed(), 200.0f);
+    // 停在最后一个正确的点上
+    CHECK_EQ(segments.size(), (size_t)1);
+
+    ReadAll("0 0\n10 abc\n", reader);
+    CHECK_EQ(reader.ErrorLine(), 2);
+
+    // speed 必须在第一个点之前
+    ReadAll("0 0\nspeed 100\n", reader);
+    CHECK_EQ(reader.ErrorLine(), 2);
+
+    ReadAll("# only\n0 0  # start\n5 5\n", reader);
+    CHECK(!reader.Failed());
+    CHECK_EQ(reader.ErrorLine(), 0);
+    CHECK_EQ(reader.Speed(), DEFAULT_PATH_SPEED);
+}
+
+TEST(EvaluateBatchMatchesEvaluate)
+{
+    PathReader reader;
+    std::vector<CubicSegment> segments = ReadAll(
+        "catmull-rom\n0 0\n120 40\n260 -30\n300 200\n410 260\n"
+        "bezier\n450 300\n520 240\n600 330\npolyline\n620 100\n100 100\n", reader);
+    Trajectory trajectory;
+    trajectory.Assign(segments.data(), segments.size());
+    CHECK(trajectory.Length() > 0.0f);
+
+    // 递增的弧长（逐段前进的快速路径）和乱序的弧长（每次查找），个数不是 4 和 8 的倍数，包括两端之外
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float> uniform(-10.0f, trajectory.Length() + 10.0f);
+    std::vector<float> distances(203);
+    for (size_t i = 0; i < distances.size(); ++i)
+        distances[i] = uniform(random);
+    std::vector<float> sorted = distances;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (const std::vector<float>* input : {&sorted, &distances})
+    {
+        std::vector<float> x(input->size());
+        std::vector<float> y(input->size());
+        trajectory.EvaluateBatch(input->data(), input->size(), x.data(), y.data());
+        for (size_t i = 0; i < input->size(); ++i)
+        {
+            float ex, ey;
+            trajectory.Evaluate((*input)[i], &ex, &ey);
+            CHECK(std::fabs(x[i] - ex) < 1e-3f);
+            CHECK(std::fabs(y[i] - ey) < 1e-3f);
+        }
+    }
+}
+
+TEST(PolylineIsSampledAtConstantSpeed)
+{
+    // 长短不一的直线段：同一段上相邻采样点的距离都是 step，跨过拐角时沿路径的距离也是 step
+    PathReader reader;
+    std::vector<CubicSegment> segments = ReadAll("0 0\n10 0\n250 0\n253 4\n553 404\n553 800\n", reader);
+    Trajectory trajectory;
+    trajectory.Assign(segments.data(), segments.size());
+    CHECK(std::fabs(trajectory.Length() - (10.0f + 240.0f + 5.0f + 500.0f + 396.0f)) < 1e-2f);
+
+    const float step = 7.0f;
+    const size_t count = (size_t)(trajectory.Length() / step);
+    std::vector<float> x(count);
+    std::vector<float> y(count);
+    trajectory.SampleUniform(0.0f, step, count, x.data(), y.data());
+
+    // 第一段和第二段都在 x 轴上：坐标就是弧长
+    for (size_t i = 0; i < count && step * i <= 250.0f; ++i)
+    {
+        CHECK(std::fabs(x[i] - step * i) < 1e-2f);
+        CHECK_EQ(y[i], 0.0f);
+    }
+
+    size_t straight = 0;
+    for (size_t i = 1; i < count; ++i)
+    {
+        float length = std::hypot(x[i] - x[i - 1], y[i] - y[i - 1]);
+        CHECK(length <= step + 1e-2f);
+        if (std::fabs(length - step) < 1e-2f)
+            ++straight;
+    }
+    // 只有跨过 4 个拐角的几步弦长变短
+    CHECK(straight >= count - 1 - 4);
+}
+
+TEST(PathPlayerIsContinuousAcrossChunks)
+{
+    // 比两块还多的段，沿 x 轴每段 3 像素；以 3000 像素/秒播放，每毫秒走过一段
+    const size_t segmentCount = PATH_CHUNK_SEGMENTS * 2 + 100;
+    std::string text = "speed 3000\n";
+    for (size_t i = 0; i <= segmentCount; ++i)
+        text += std::to_string(i * 3) + " 7\n";
+    FILE* file = PathFile(text);
+    CHECK(file != nullptr);
+    if (!file)
+        return;
+
+    PathPlayer player;
+    player.Attach(file);
+    PathPlayer::TimePoint start = std::chrono::steady_clock::time_point();
+    player.Start(start);
+    CHECK_EQ(player.Speed(), 3000.0f);
+
+    PointI pos = {};
+    int last = 0;
+    int maxError = 0;
+    int64_t totalUs = (int64_t)segmentCount * 1000;
+    for (int64_t us = 0; us < totalUs; us += 250)
+    {
+        CHECK(player.Sample(start + std::chrono::microseconds(us), &pos));
+        int expected = (int)std::lround(us * 0.003);
+        maxError = std::max(maxError, std::abs(pos.x - expected));
+        CHECK(pos.x >= last);
+        CHECK(pos.x - last <= 1);
+        CHECK_EQ(pos.y, 7);
+        last = pos.x;
+    }
+    CHECK(maxError <= 1);
+    CHECK_EQ(player.SegmentsLoaded(), (uint64_t)segmentCount);
+
+    // 走完之后停在终点
+    CHECK(!player.Sample(start + std::chrono::microseconds(totalUs + 1000), &pos));
+    CHECK(player.IsFinished());
+    CHECK_EQ(pos.x, (int)(segmentCount * 3));
+    CHECK_EQ(pos.y, 7);
+    fclose(file);
+}
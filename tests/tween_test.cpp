@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "scheduler.h"
+#include "test_framework.h"
+#include "test_host.h"
+#include "tween.h"
+
+using std::chrono::milliseconds;
+
+TEST(EasingCurvesHitExactEndpoints)
+{
+    for (int easing = 0; easing < EASING_COUNT; ++easing)
+    {
+        CHECK(Ease((Easing)easing, 0.0f) == 0.0f);
+        CHECK(Ease((Easing)easing, 1.0f) == 1.0f);
+        // 超出范围的参数被夹紧
+        CHECK(Ease((Easing)easing, -1.0f) == 0.0f);
+        CHECK(Ease((Easing)easing, 2.0f) == 1.0f);
+    }
+    CHECK(std::fabs(Ease(EASING_LINEAR, 0.25f) - 0.25f) < 1e-4f);
+
+    // 缓出单调递增、前半程走完大半；弹簧会越过目标
+    bool monotonic = true;
+    bool overshoots = false;
+    for (int i = 1; i <= 1000; ++i)
+    {
+        monotonic = monotonic && Ease(EASING_CUBIC, i / 1000.0f) >= Ease(EASING_CUBIC, (i - 1) / 1000.0f);
+        overshoots = overshoots || Ease(EASING_SPRING, i / 1000.0f) > 1.0f;
+    }
+    CHECK(monotonic);
+    CHECK(Ease(EASING_CUBIC, 0.5f) > 0.8f);
+    CHECK(overshoots);
+}
+
+TEST(TweenFollowsVirtualClock)
+{
+    VirtualClock clock;
+    clock.Advance(std::chrono::seconds(100));
+    TweenEngine tweens;
+    IClock::TimePoint start = clock.Now();
+    TweenId id = tweens.Start(PointI{0, 0}, PointI{1000, -500}, milliseconds(1000), EASING_LINEAR, start);
+
+    CHECK_EQ(tweens.Sample(clock.Now()), (size_t)1);
+    CHECK_EQ(tweens.Position(id).x, 0);
+    CHECK(!tweens.IsFinished(id));
+
+    // 每 16ms 一帧，线性补间的位置与经过的时间成正比（误差不超过 1 像素）
+    int worst = 0;
+    for (int ms = 16; ms < 1000; ms += 16)
+    {
+        clock.Set(start + milliseconds(ms));
+        tweens.Sample(clock.Now());
+        PointI pos = tweens.Position(id);
+        worst = std::max(worst, std::abs(pos.x - ms));
+        worst = std::max(worst, std::abs(pos.y + ms / 2));
+        CHECK(!tweens.IsFinished(id));
+    }
+    CHECK(worst <= 1);
+
+    // 正好到时长时停在目标上并结束，之后不再变化
+    CHECK_EQ(tweens.Sample(start + milliseconds(1000)), (size_t)0);
+    CHECK(tweens.IsFinished(id));
+    CHECK_EQ(tweens.Position(id).x, 1000);
+    CHECK_EQ(tweens.Position(id).y, -500);
+    tweens.Sample(start + milliseconds(5000));
+    CHECK_EQ(tweens.Position(id).x, 1000);
+}
+
+TEST(TweenSamplesEachFrameTimeOnce)
+{
+    VirtualClock clock;
+    TweenEngine tweens;
+    tweens.Start(PointI{0, 0}, PointI{100, 0}, milliseconds(100), EASING_CUBIC, clock.Now());
+    clock.Advance(milliseconds(16));
+    tweens.Sample(clock.Now());
+    tweens.Sample(clock.Now());
+    CHECK_EQ(tweens.FramesSampled(), (uint64_t)1);
+    clock.Advance(milliseconds(16));
+    tweens.Sample(clock.Now());
+    CHECK_EQ(tweens.FramesSampled(), (uint64_t)2);
+}
+
+TEST(TweenRetargetIsContinuous)
+{
+    VirtualClock clock;
+    TweenEngine tweens;
+    TweenId id = tweens.Start(PointI{0, 0}, PointI{1000, 0}, milliseconds(400), EASING_CUBIC, clock.Now());
+    clock.Advance(milliseconds(200));
+    PointI before = tweens.Evaluate(id, clock.Now());
+
+    CHECK(tweens.Retarget(id, PointI{0, 600}, milliseconds(300), clock.Now()));
+    PointI after = tweens.Evaluate(id, clock.Now());
+    CHECK(std::abs(after.x - before.x) <= 1);
+    CHECK(std::abs(after.y - before.y) <= 1);
+    CHECK_EQ(tweens.Target(id).y, 600);
+
+    // 从转向的时刻重新计时
+    tweens.Sample(clock.Now() + milliseconds(299));
+    CHECK(!tweens.IsFinished(id));
+    tweens.Sample(clock.Now() + milliseconds(300));
+    CHECK(tweens.IsFinished(id));
+    CHECK_EQ(tweens.Position(id).x, 0);
+    CHECK_EQ(tweens.Position(id).y, 600);
+
+    tweens.Cancel(id);
+    CHECK(!tweens.Contains(id));
+    CHECK(!tweens.Retarget(id, PointI{1, 1}, milliseconds(10), clock.Now()));
+    CHECK_EQ(tweens.Size(), (size_t)0);
+}
+
+TEST(TweenWithZeroDurationFinishesImmediately)
+{
+    VirtualClock clock;
+    TweenEngine tweens;
+    TweenId id = tweens.Start(PointI{5, 5}, PointI{50, 70}, std::chrono::steady_clock::duration::zero(), EASING_SPRING, clock.Now());
+    CHECK_EQ(tweens.Sample(clock.Now()), (size_t)0);
+    CHECK(tweens.IsFinished(id));
+    CHECK_EQ(tweens.Position(id).x, 50);
+    CHECK_EQ(tweens.Position(id).y, 70);
+}
+
+TEST(TweenBatchSampleMatchesEvaluate)
+{
+    VirtualClock clock;
+    TweenEngine tweens;
+    std::vector<TweenId> ids;
+    for (int i = 0; i < 1000; ++i)
+    {
+        clock.Advance(milliseconds(1));
+        ids.push_back(tweens.Start(PointI{i, -i}, PointI{i * 3 - 500, i * 2}, milliseconds(100 + i % 400),
+                                   (Easing)(i % EASING_COUNT), clock.Now()));
+    }
+
+    int mismatches = 0;
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        clock.Advance(milliseconds(16));
+        tweens.Sample(clock.Now());
+        for (TweenId id : ids)
+        {
+            PointI sampled = tweens.Position(id);
+            PointI evaluated = tweens.Evaluate(id, clock.Now());
+            if (sampled.x != evaluated.x || sampled.y != evaluated.y)
+                ++mismatches;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+TEST(ResetAnimationLandsAfterConfiguredDuration)
+{
+    ControllerFixture fixture;
+    fixture.controller.SetResetAnimation(RESET_ANIMATION_DURATION);
+    CHECK(fixture.controller.MoveWindowBy(800, 400));
+    fixture.controller.ResetToCenter(EASING_LINEAR);
+    fixture.controller.SyncSchedule();
+    IClock::TimePoint start = fixture.clock.Now();
+    CHECK(fixture.controller.IsAnimating());
+
+    // 动画帧每 16ms 一次，最后一帧之前还在路上
+    fixture.RunUntil(start + RESET_ANIMATION_DURATION - milliseconds(16));
+    CHECK(fixture.controller.IsAnimating());
+    CHECK(fixture.controller.WindowPos().x > 660);
+
+    fixture.RunUntil(start + RESET_ANIMATION_DURATION + ANIMATION_FRAME_INTERVAL);
+    CHECK(!fixture.controller.IsAnimating());
+    CHECK_EQ(fixture.controller.WindowPos().x, 660);
+    CHECK_EQ(fixture.controller.WindowPos().y, 315);
+    CHECK_EQ(fixture.host.LastMove().x, 660);
+}
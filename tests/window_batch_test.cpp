@@ -0,0 +1,128 @@
+#include <random>
+#include <vector>
+
+#include "test_framework.h"
+#include "test_host.h"
+#include "window_batch.h"
+
+// 原点不在左上角的桌面，覆盖夹紧和移出检测里的偏移
+static const RectI DESKTOP = {-1280, -200, 1920, 1080};
+
+static bool SameWindow(const WindowBatch& batch, size_t index, const WindowBatch& single)
+{
+    return batch.Position(index).x == single.Position(0).x && batch.Position(index).y == single.Position(0).y &&
+           batch.Flags(index) == single.Flags(0) && batch.LastMoveUs(index) == single.LastMoveUs(0);
+}
+
+TEST(WindowBatchVectorPathMatchesScalarTail)
+{
+    // 只有一个窗口的批处理全部走标量循环；N 个窗口时前面的走 SSE2/AVX2，余下的走标量
+    const size_t counts[] = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 23, 37};
+    std::mt19937 random(9);
+    std::uniform_int_distribution<int> posX(-2200, 2900);
+    std::uniform_int_distribution<int> posY(-900, 1800);
+    std::uniform_int_distribution<int> step(-40, 40);
+    std::uniform_int_distribution<int> jump(-3000, 3000);
+
+    for (size_t count : counts)
+    {
+        WindowBatch batch(DESKTOP);
+        std::vector<WindowBatch> singles(count, WindowBatch(DESKTOP));
+        for (size_t i = 0; i < count; ++i)
+        {
+            int x = posX(random);
+            int y = posY(random);
+            int width = 100 + (int)(i * 37) % 500;
+            int height = 80 + (int)(i * 53) % 400;
+            batch.Add(x, y, width, height, 0);
+            singles[i].Add(x, y, width, height, 0);
+        }
+
+        std::vector<int32_t> dx(count);
+        std::vector<int32_t> dy(count);
+        for (int tick = 1; tick <= 200; ++tick)
+        {
+            // 大约三分之一的窗口不动，偶尔有一次大跳把窗口推到边缘上
+            for (size_t i = 0; i < count; ++i)
+            {
+                bool still = random() % 3 == 0;
+                bool far = random() % 20 == 0;
+                dx[i] = still ? 0 : (far ? jump(random) : step(random));
+                dy[i] = still ? 0 : (far ? jump(random) : step(random));
+            }
+
+            int64_t nowUs = tick * 100000LL;
+            batch.Tick(dx.data(), dy.data(), nowUs, 1500000);
+            for (size_t i = 0; i < count; ++i)
+                singles[i].Tick(&dx[i], &dy[i], nowUs, 1500000);
+
+            for (size_t i = 0; i < count; ++i)
+                CHECK(SameWindow(batch, i, singles[i]));
+        }
+
+        // 夹紧整列也与逐个夹紧一致
+        batch.ClampPositions();
+        for (size_t i = 0; i < count; ++i)
+        {
+            singles[i].ClampPositions();
+            CHECK(SameWindow(batch, i, singles[i]));
+        }
+    }
+}
+
+TEST(WindowBatchPinnedWindowIsNotMarkedMoved)
+{
+    // 9 个窗口都已顶在左上角，继续向外推：位置不变，不算移动（向量部分和标量部分都一样）
+    WindowBatch batch(DESKTOP);
+    std::vector<int32_t> dx(9, -5);
+    std::vector<int32_t> dy(9, -5);
+    for (size_t i = 0; i < 9; ++i)
+        batch.Add(DESKTOP.left + WINDOW_VISIBLE_MARGIN - 300, DESKTOP.top + WINDOW_VISIBLE_MARGIN - 200, 300, 200, 0);
+
+    batch.MoveBy(dx.data(), dy.data());
+    for (size_t i = 0; i < 9; ++i)
+    {
+        CHECK_EQ(batch.Position(i).x, DESKTOP.left + WINDOW_VISIBLE_MARGIN - 300);
+        CHECK_EQ(batch.Flags(i), (uint32_t)0);
+    }
+
+    // 只沿一个轴顶住时另一个轴照常移动
+    dy.assign(9, 5);
+    batch.MoveBy(dx.data(), dy.data());
+    for (size_t i = 0; i < 9; ++i)
+    {
+        CHECK_EQ(batch.Position(i).y, DESKTOP.top + WINDOW_VISIBLE_MARGIN - 200 + 5);
+        CHECK_EQ(batch.Flags(i), WINDOW_FLAG_MOVED);
+    }
+}
+
+TEST(WindowBatchMatchesControllerOnOneMonitor)
+{
+    // 只有一个显示器时，批处理与 WindowController 的夹紧、是否移动和重置位置完全相同
+    ControllerFixture fixture(std::vector<RectI>(1, DESKTOP));
+    WindowController& controller = fixture.controller;
+    PointI start = controller.WindowPos();
+
+    WindowBatch batch(fixture.host.Displays().VirtualBounds());
+    batch.Add(start.x, start.y, 600, 450, 0);
+
+    const PointI moves[] = {{-5000, 0}, {-10, 0}, {0, -5000}, {-1, -1}, {7, 0}, {5000, 5000}, {3, 3}, {-40, 0}};
+    bool moved = false;
+    for (const PointI& move : moves)
+    {
+        moved = controller.MoveWindowBy(move.x, move.y) || moved;
+        batch.MoveBy(&move.x, &move.y);
+        CHECK_EQ(batch.Position(0).x, controller.WindowPos().x);
+        CHECK_EQ(batch.Position(0).y, controller.WindowPos().y);
+        CHECK_EQ((batch.Flags(0) & WINDOW_FLAG_MOVED) != 0, moved);
+    }
+
+    // 重置回到显示器中央
+    CHECK_EQ(batch.CheckBoundaries(0), (size_t)0);
+    WindowBatch off(DESKTOP);
+    off.Add(DESKTOP.right + 10, 0, 600, 450, 0);
+    CHECK_EQ(off.CheckBoundaries(1000), (size_t)1);
+    CHECK_EQ(off.ResetDue(5000, 4000), (size_t)1);
+    CHECK_EQ(off.Position(0).x, start.x);
+    CHECK_EQ(off.Position(0).y, start.y);
+}
@@ -0,0 +1,122 @@
+#include "test_framework.h"
+#include "test_host.h"
+
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+// L 形布局：主显示器右上方是空的，窗口移到那里就完全不可见
+static std::vector<RectI> LShapedMonitors()
+{
+    std::vector<RectI> monitors;
+    monitors.push_back(MakeRect(0, 0, 1920, 1080));
+    monitors.push_back(MakeRect(1920, 1080, 1920, 1080));
+    return monitors;
+}
+
+// 把窗口移到两个显示器之外，触发自动重置
+static void MoveOffScreen(ControllerFixture& fixture)
+{
+    WindowController& controller = fixture.controller;
+    CHECK(controller.MoveWindowBy(2500 - controller.WindowPos().x, 100 - controller.WindowPos().y));
+    controller.UpdateLastMoveTime();
+    controller.CheckWindowBoundary();
+    controller.SyncSchedule();
+    CHECK(controller.ResetTriggered());
+}
+
+TEST(IdleControllerSchedulesNothingAfterStatusRefresh)
+{
+    ControllerFixture fixture;
+    IClock::TimePoint start = fixture.clock.Now();
+    fixture.controller.SyncSchedule();
+
+    // 没有按键时只有第 4、5 秒的状态栏刷新
+    CHECK(fixture.scheduler.NextDeadline() == start + seconds(4));
+    fixture.RunUntil(start + seconds(4));
+    CHECK(fixture.scheduler.NextDeadline() == start + seconds(5));
+    fixture.RunUntil(start + seconds(5));
+
+    CHECK(!fixture.scheduler.HasPending());
+    CHECK(fixture.scheduler.NextDeadline() == IClock::TimePoint::max());
+    uint64_t eventsRun = fixture.scheduler.EventsRun();
+    CHECK_EQ(eventsRun, (uint64_t)2);
+
+    // 之后再空闲多久都没有事件到期
+    for (int minute = 1; minute <= 60; ++minute)
+    {
+        fixture.clock.Set(start + seconds(5) + std::chrono::minutes(minute));
+        fixture.controller.RunDueEvents();
+    }
+    CHECK_EQ(fixture.scheduler.EventsRun(), eventsRun);
+    CHECK(fixture.scheduler.NextDeadline() == IClock::TimePoint::max());
+    CHECK_EQ(fixture.host.Calls(), (size_t)0);
+}
+
+TEST(ControllerGoesIdleAfterKeyRelease)
+{
+    ControllerFixture fixture;
+    fixture.controller.OnKeyDown(KEY_RIGHT);
+    fixture.RunFor(milliseconds(200));
+    fixture.controller.OnKeyUp(KEY_RIGHT);
+
+    // 减速停下、倒计时刷新完之后不再有任何事件
+    fixture.RunFor(seconds(10));
+    CHECK(fixture.host.Calls() > 0);
+    CHECK(!fixture.scheduler.HasPending());
+    CHECK(fixture.scheduler.NextDeadline() == IClock::TimePoint::max());
+
+    size_t calls = fixture.host.Calls();
+    uint64_t eventsRun = fixture.scheduler.EventsRun();
+    fixture.RunFor(std::chrono::hours(1));
+    CHECK_EQ(fixture.host.Calls(), calls);
+    CHECK_EQ(fixture.scheduler.EventsRun(), eventsRun);
+}
+
+TEST(AutoResetFiresExactlyAtDelayAfterLastMove)
+{
+    ControllerFixture fixture(LShapedMonitors());
+    fixture.controller.SetResetAnimation(std::chrono::steady_clock::duration::zero());
+    fixture.clock.Advance(milliseconds(1234) + std::chrono::microseconds(567));
+    MoveOffScreen(fixture);
+    IClock::TimePoint moved = fixture.clock.Now();
+    CHECK(fixture.controller.LastMoveTime() == moved);
+
+    // 以 1 毫秒的步长推进：截止时间之前一直等待，正好到期时回到中央
+    for (int ms = 1; ms < 5000; ++ms)
+    {
+        fixture.RunUntil(moved + milliseconds(ms));
+        if (fixture.controller.ResetCount() != 0)
+        {
+            CHECK_EQ(ms, 5000);
+            break;
+        }
+    }
+    CHECK_EQ(fixture.controller.ResetCount(), (uint64_t)0);
+    CHECK(fixture.controller.ResetTriggered());
+
+    fixture.RunUntil(moved + AUTO_RESET_DELAY);
+    CHECK_EQ(fixture.controller.ResetCount(), (uint64_t)1);
+    CHECK(!fixture.controller.ResetTriggered());
+    // 回到离窗口中心最近的显示器（右下方那个）的中央
+    CHECK_EQ(fixture.controller.WindowPos().x, 1920 + (1920 - 600) / 2);
+    CHECK_EQ(fixture.controller.WindowPos().y, 1080 + (1080 - 450) / 2);
+}
+
+TEST(AutoResetDeadlineFollowsLatestMove)
+{
+    ControllerFixture fixture(LShapedMonitors());
+    fixture.controller.SetResetAnimation(std::chrono::steady_clock::duration::zero());
+    MoveOffScreen(fixture);
+
+    // 第 3 秒又移动了一次（仍在屏幕外），倒计时从这次移动重新开始
+    fixture.RunFor(seconds(3));
+    CHECK(fixture.controller.MoveWindowBy(10, 0));
+    fixture.controller.UpdateLastMoveTime();
+    fixture.controller.SyncSchedule();
+    IClock::TimePoint moved = fixture.clock.Now();
+
+    fixture.RunUntil(moved + AUTO_RESET_DELAY - milliseconds(1));
+    CHECK_EQ(fixture.controller.ResetCount(), (uint64_t)0);
+    fixture.RunUntil(moved + AUTO_RESET_DELAY);
+    CHECK_EQ(fixture.controller.ResetCount(), (uint64_t)1);
+}
@@ -0,0 +1,168 @@
+#include "text_layout.h"
+
+#include <algorithm>
+#include <iterator>
+
+int DecodeCodepoint(const wchar_t* text, uint32_t* codepoint)
+{
+    uint32_t value = (uint32_t)text[0];
+    if (sizeof(wchar_t) == 2 && value >= 0xD800 && value <= 0xDBFF)
+    {
+        uint32_t low = (uint32_t)text[1];
+        if (low >= 0xDC00 && low <= 0xDFFF)
+        {
+            *codepoint = 0x10000 + ((value - 0xD800) << 10) + (low - 0xDC00);
+            return 2;
+        }
+    }
+
+    *codepoint = value;
+    return 1;
+}
+
+TextRunCache::TextRunCache(GlyphAtlas& atlas, size_t capacity)
+    : m_atlas(atlas),
+      m_capacity(capacity > 0 ? capacity : 1),
+      m_hits(0),
+      m_misses(0),
+      m_glyphsLaidOut(0),
+      m_glyphsReused(0)
+{
+    m_probe.font = 0;
+    m_evicted.font = 0;
+}
+
+const TextRun& TextRunCache::Layout(const wchar_t* text, FontId font, uint64_t slot)
+{
+    m_probe.text.assign(text);
+    m_probe.font = font;
+
+    auto found = m_index.find(m_probe);
+    if (found != m_index.end())
+    {
+        RunList::iterator run = found->second;
+        m_runs.splice(m_runs.begin(), m_runs, run);
+
+        // 图集清空过，字形下标已经失效
+        if (run->generation != m_atlas.Generation())
+            Build(*run, nullptr);
+        else
+            ++m_hits;
+        return *run;
+    }
+
+    ++m_misses;
+
+    // 同一位置上一次的结果作为基础
+    const TextRun* base = nullptr;
+    auto previous = m_slots.find(slot);
+    if (previous != m_slots.end() && previous->second.font == font)
+        base = &previous->second;
+
+    // 缓存满时重用最久没用的一项：链表节点、字符串和字形数组的容量以及索引节点都留着，
+    // 稳定之后未命中也不分配内存
+    if (m_runs.size() >= m_capacity)
+    {
+        RunList::iterator oldest = std::prev(m_runs.end());
+        m_evicted.text.assign(oldest->text);
+        m_evicted.font = oldest->font;
+        auto node = m_index.extract(m_evicted);
+        m_runs.splice(m_runs.begin(), m_runs, oldest);
+        node.key().text.assign(m_probe.text);
+        node.key().font = font;
+        node.mapped() = m_runs.begin();
+        m_index.insert(std::move(node));
+    }
+    else
+    {
+        m_runs.push_front(TextRun());
+        m_index[m_probe] = m_runs.begin();
+    }
+
+    TextRun& run = m_runs.front();
+    run.text.assign(m_probe.text);
+    run.font = font;
+    Build(run, base);
+
+    m_slots[slot] = run;
+    return run;
+}
+
+void TextRunCache::Build(TextRun& run, const TextRun* base)
+{
+    const wchar_t* text = run.text.c_str();
+
+    // 与 base 相同的前缀长度，不拆开代理对
+    size_t prefix = 0;
+    if (base && base->generation == m_atlas.Generation())
+    {
+        size_t limit = std::min(base->text.size(), run.text.size());
+        while (prefix < limit && base->text[prefix] == run.text[prefix])
+            ++prefix;
+        if (sizeof(wchar_t) == 2 && prefix > 0 && text[prefix - 1] >= 0xD800 && text[prefix - 1] <= 0xDBFF)
+            --prefix;
+    }
+    else
+    {
+        base = nullptr;
+    }
+
+    // 排版过程中图集被清空时从头再来一次；清空后的图集一定放得下一行文字
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        uint32_t generation = m_atlas.Generation();
+        run.glyphs.clear();
+
+        size_t start = 0;
+        int pen = 0;
+        if (base)
+        {
+            // 每个码点都对应一个字形，前缀之后的第一个字形就是接着排的位置
+            size_t reused = 0;
+            while (reused < base->glyphs.size() && (size_t)base->glyphs[reused].source < prefix)
+                ++reused;
+            run.glyphs.assign(base->glyphs.begin(), base->glyphs.begin() + reused);
+            m_glyphsReused += reused;
+
+            start = prefix;
+            pen = reused < base->glyphs.size() ? base->glyphs[reused].x : base->width;
+        }
+
+        bool stale = false;
+        for (size_t i = start; text[i] != 0;)
+        {
+            uint32_t codepoint;
+            int length = DecodeCodepoint(text + i, &codepoint);
+            uint32_t index = m_atlas.FindOrAdd(run.font, codepoint);
+            if (m_atlas.Generation() != generation)
+            {
+                stale = true;
+                break;
+            }
+
+            PlacedGlyph placed = {index, pen, (int)i};
+            run.glyphs.push_back(placed);
+            pen += m_atlas.Glyph(index).advance;
+            i += length;
+            ++m_glyphsLaidOut;
+        }
+
+        run.width = pen;
+        run.generation = generation;
+        if (!stale)
+            return;
+
+        base = nullptr;
+    }
+
+    // 一行文字比整张图集还大，放弃绘制
+    run.glyphs.clear();
+    run.width = 0;
+}
+
+void TextRunCache::Clear()
+{
+    m_runs.clear();
+    m_index.clear();
+    m_slots.clear();
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "glyph_atlas.h"
+
+// 排好的一个字形
+struct PlacedGlyph
+{
+    uint32_t glyph;  // 图集中的下标
+    int x;           // 相对行首的笔位置
+    int source;      // 对应字符在字符串中的下标
+};
+
+// 一行排好的文字
+struct TextRun
+{
+    std::wstring text;
+    FontId font;
+    uint32_t generation;  // 排版时图集的 Generation()
+    int width;
+    std::vector<PlacedGlyph> glyphs;
+};
+
+// 读取下一个码点（wchar_t 为 16 位时解码代理对），返回消耗的 wchar_t 个数
+int DecodeCodepoint(const wchar_t* text, uint32_t* codepoint);
+
+// 排版结果缓存，按 (字符串, 字体) 查找，最近最少使用的先淘汰
+// slot 标识同一个位置上反复变化的标签（比如状态栏），未命中时从该位置上一次的结果
+// 复用相同的前缀，只排版变化之后的字符
+class TextRunCache
+{
+public:
+    explicit TextRunCache(GlyphAtlas& atlas, size_t capacity = 256);
+
+    const TextRun& Layout(const wchar_t* text, FontId font, uint64_t slot);
+
+    GlyphAtlas& Atlas() { return m_atlas; }
+    void Clear();
+
+    size_t Size() const { return m_runs.size(); }
+    uint64_t Hits() const { return m_hits; }
+    uint64_t Misses() const { return m_misses; }
+    uint64_t GlyphsLaidOut() const { return m_glyphsLaidOut; }
+    uint64_t GlyphsReused() const { return m_glyphsReused; }
+
+private:
+    struct RunKey
+    {
+        std::wstring text;
+        FontId font;
+
+        bool operator==(const RunKey& other) const { return font == other.font && text == other.text; }
+    };
+
+    struct RunKeyHash
+    {
+        size_t operator()(const RunKey& key) const
+        {
+            return std::hash<std::wstring>()(key.text) ^ ((size_t)key.font * 0x9E3779B9u);
+        }
+    };
+
+    typedef std::list<TextRun> RunList;
+
+    // 排版 run.text，base 中与之相同的前缀直接复用
+    void Build(TextRun& run, const TextRun* base);
+
+    GlyphAtlas& m_atlas;
+    size_t m_capacity;
+    RunList m_runs;  // 前面是最近使用的
+    std::unordered_map<RunKey, RunList::iterator, RunKeyHash> m_index;
+    std::unordered_map<uint64_t, TextRun> m_slots;  // 每个位置上一次的排版结果
+    RunKey m_probe;                                  // 查找用的键，复用字符串的容量
+    RunKey m_evicted;                                // 淘汰时查找旧项的键
+
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_glyphsLaidOut;
+    uint64_t m_glyphsReused;
+};
@@ -0,0 +1,517 @@
+#include "trajectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MW_HAVE_SSE2 1
+#endif
+
+PathReader::PathReader()
+    : m_file(nullptr),
+      m_ownsFile(false),
+      m_done(true),
+      m_line(0),
+      m_errorLine(0),
+      m_speed(DEFAULT_PATH_SPEED),
+      m_pointsRead(0),
+      m_mode(MODE_POLYLINE),
+      m_hasStart(false),
+      m_lastX(0.0f),
+      m_lastY(0.0f),
+      m_pendingCount(0),
+      m_beforeX(0.0f),
+      m_beforeY(0.0f)
+{
+}
+
+PathReader::~PathReader()
+{
+    Close();
+}
+
+bool PathReader::Open(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+        return false;
+
+    Attach(file);
+    m_ownsFile = true;
+    return true;
+}
+
+void PathReader::Attach(FILE* file)
+{
+    Close();
+    m_file = file;
+    m_ownsFile = false;
+    m_done = false;
+    m_line = 0;
+    m_errorLine = 0;
+    m_speed = DEFAULT_PATH_SPEED;
+    m_pointsRead = 0;
+    m_mode = MODE_POLYLINE;
+    m_hasStart = false;
+    m_pendingCount = 0;
+}
+
+void PathReader::Close()
+{
+    if (m_file && m_ownsFile)
+        fclose(m_file);
+    m_file = nullptr;
+    m_ownsFile = false;
+    m_done = true;
+}
+
+// 直线段：控制点取三等分点，参数与弧长成正比
+void PathReader::EmitLine(float x0, float y0, float x1, float y1, std::vector<CubicSegment>* out)
+{
+    float dx = (x1 - x0) / 3.0f;
+    float dy = (y1 - y0) / 3.0f;
+    out->push_back(CubicSegment{{x0, x0 + dx, x1 - dx, x1}, {y0, y0 + dy, y1 - dy, y1}});
+    m_beforeX = x0;
+    m_beforeY = y0;
+    m_lastX = x1;
+    m_lastY = y1;
+}
+
+void PathReader::AddPoint(float x, float y, std::vector<CubicSegment>* out)
+{
+    ++m_pointsRead;
+    if (!m_hasStart)
+    {
+        m_hasStart = true;
+        m_lastX = m_beforeX = x;
+        m_lastY = m_beforeY = y;
+        return;
+    }
+
+    switch (m_mode)
+    {
+    case MODE_POLYLINE:
+        EmitLine(m_lastX, m_lastY, x, y, out);
+        break;
+
+    case MODE_CATMULL_ROM:
+        // 需要下一个点才能确定当前段终点的切线，所以输出总是落后一个点
+        m_pending[m_pendingCount][0] = x;
+        m_pending[m_pendingCount][1] = y;
+        if (++m_pendingCount == 2)
+        {
+            // 段 last -> pending[0]，切线由 before 和 pending[1] 决定（均匀 Catmull-Rom 换算成贝塞尔）
+            float x1 = m_pending[0][0];
+            float y1 = m_pending[0][1];
+            out->push_back(CubicSegment{
+                {m_lastX, m_lastX + (x1 - m_beforeX) / 6.0f, x1 - (x - m_lastX) / 6.0f, x1},
+                {m_lastY, m_lastY + (y1 - m_beforeY) / 6.0f, y1 - (y - m_lastY) / 6.0f, y1}});
+            m_beforeX = m_lastX;
+            m_beforeY = m_lastY;
+            m_lastX = x1;
+            m_lastY = y1;
+            m_pending[0][0] = x;
+            m_pending[0][1] = y;
+            m_pendingCount = 1;
+        }
+        break;
+
+    case MODE_BEZIER:
+        m_pending[m_pendingCount][0] = x;
+        m_pending[m_pendingCount][1] = y;
+        if (++m_pendingCount == 3)
+        {
+            out->push_back(CubicSegment{{m_lastX, m_pending[0][0], m_pending[1][0], x},
+                                        {m_lastY, m_pending[0][1], m_pending[1][1], y}});
+            m_beforeX = m_pending[1][0];
+            m_beforeY = m_pending[1][1];
+            m_lastX = x;
+            m_lastY = y;
+            m_pendingCount = 0;
+        }
+        break;
+    }
+}
+
+// 结束当前模式：输出还缺少后续点的段
+void PathReader::FlushMode(std::vector<CubicSegment>* out)
+{
+    if (m_mode == MODE_CATMULL_ROM && m_pendingCount == 1)
+    {
+        // 最后一段的终点切线取终点本身（端点重复）
+        float x1 = m_pending[0][0];
+        float y1 = m_pending[0][1];
+        out->push_back(CubicSegment{
+            {m_lastX, m_lastX + (x1 - m_beforeX) / 6.0f, x1 - (x1 - m_lastX) / 6.0f, x1},
+            {m_lastY, m_lastY + (y1 - m_beforeY) / 6.0f, y1 - (y1 - m_lastY) / 6.0f, y1}});
+        m_beforeX = m_lastX;
+        m_beforeY = m_lastY;
+        m_lastX = x1;
+        m_lastY = y1;
+    }
+    else if (m_mode == MODE_BEZIER)
+    {
+        // 不足三个点的贝塞尔段按折线处理
+        for (int i = 0; i < m_pendingCount; ++i)
+            EmitLine(m_lastX, m_lastY, m_pending[i][0], m_pending[i][1], out);
+    }
+    m_pendingCount = 0;
+}
+
+size_t PathReader::Read(std::vector<CubicSegment>* out, size_t maxSegments)
+{
+    size_t before = out->size();
+    char line[256];
+    while (!m_done && out->size() - before < maxSegments)
+    {
+        if (!fgets(line, sizeof(line), m_file))
+        {
+            // 文件结束：输出最后一段
+            FlushMode(out);
+            m_done = true;
+            break;
+        }
+        ++m_line;
+
+        char* comment = strchr(line, '#');
+        if (comment)
+            *comment = 0;
+
+        char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t')
+            ++cursor;
+        if (*cursor == 0 || *cursor == '\r' || *cursor == '\n')
+            continue;
+
+        bool ok = true;
+        if ((*cursor >= 'a' && *cursor <= 'z') || (*cursor >= 'A' && *cursor <= 'Z'))
+        {
+            char* token = strtok(cursor, " \t\r\n");
+            char* value = strtok(nullptr, " \t\r\n");
+            if (strcmp(token, "speed") == 0)
+            {
+                float speed = value ? strtof(value, nullptr) : 0.0f;
+                ok = speed > 0.0f && !m_hasStart;
+                if (ok)
+                    m_speed = speed;
+            }
+            else
+            {
+                Mode mode = m_mode;
+                if (strcmp(token, "polyline") == 0)
+                    mode = MODE_POLYLINE;
+                else if (strcmp(token, "catmull-rom") == 0)
+                    mode = MODE_CATMULL_ROM;
+                else if (strcmp(token, "bezier") == 0)
+                    mode = MODE_BEZIER;
+                else
+                    ok = false;
+
+                if (ok)
+                {
+                    FlushMode(out);
+                    m_mode = mode;
+                }
+            }
+        }
+        else
+        {
+            char* end = nullptr;
+            float x = strtof(cursor, &end);
+            ok = end != cursor;
+            char* next = end;
+            float y = ok ? strtof(next, &end) : 0.0f;
+            ok = ok && end != next && std::isfinite(x) && std::isfinite(y);
+            if (ok)
+                AddPoint(x, y, out);
+        }
+
+        if (!ok)
+        {
+            // 格式错误：路径停在最后一个正确的点上
+            m_errorLine = m_line;
+            m_pendingCount = 0;
+            m_done = true;
+        }
+    }
+    return out->size() - before;
+}
+
+Trajectory::Trajectory()
+    : m_length(0.0f)
+{
+}
+
+void Trajectory::Clear()
+{
+    m_ax.clear(); m_bx.clear(); m_cx.clear(); m_dx.clear();
+    m_ay.clear(); m_by.clear(); m_cy.clear(); m_dy.clear();
+    m_start.clear();
+    m_table.clear();
+    m_length = 0.0f;
+}
+
+void Trajectory::Assign(const CubicSegment* segments, size_t count)
+{
+    Clear();
+    m_ax.resize(count); m_bx.resize(count); m_cx.resize(count); m_dx.resize(count);
+    m_ay.resize(count); m_by.resize(count); m_cy.resize(count); m_dy.resize(count);
+    m_start.resize(count);
+    m_table.resize(count * (ARC_LENGTH_SAMPLES + 1));
+
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const CubicSegment& s = segments[i];
+
+        // 贝塞尔控制点换算成幂基系数
+        m_ax[i] = -s.x[0] + 3.0f * s.x[1] - 3.0f * s.x[2] + s.x[3];
+        m_bx[i] = 3.0f * s.x[0] - 6.0f * s.x[1] + 3.0f * s.x[2];
+        m_cx[i] = 3.0f * (s.x[1] - s.x[0]);
+        m_dx[i] = s.x[0];
+        m_ay[i] = -s.y[0] + 3.0f * s.y[1] - 3.0f * s.y[2] + s.y[3];
+        m_by[i] = 3.0f * s.y[0] - 6.0f * s.y[1] + 3.0f * s.y[2];
+        m_cy[i] = 3.0f * (s.y[1] - s.y[0]);
+        m_dy[i] = s.y[0];
+
+        // 均匀参数上的累计弦长
+        float* table = &m_table[i * (ARC_LENGTH_SAMPLES + 1)];
+        double length = 0.0;
+        double px = s.x[0];
+        double py = s.y[0];
+        table[0] = 0.0f;
+        for (int j = 1; j <= ARC_LENGTH_SAMPLES; ++j)
+        {
+            double t = (double)j / ARC_LENGTH_SAMPLES;
+            double x = ((m_ax[i] * t + m_bx[i]) * t + m_cx[i]) * t + m_dx[i];
+            double y = ((m_ay[i] * t + m_by[i]) * t + m_cy[i]) * t + m_dy[i];
+            length += std::sqrt((x - px) * (x - px) + (y - py) * (y - py));
+            table[j] = (float)length;
+            px = x;
+            py = y;
+        }
+
+        m_start[i] = (float)total;
+        total += length;
+    }
+    m_length = (float)total;
+}
+
+size_t Trajectory::FindSegment(float distance, size_t hint) const
+{
+    size_t count = m_start.size();
+
+    // 递增的弧长通常落在同一段或下一段
+    if (hint < count && m_start[hint] <= distance)
+    {
+        if (hint + 1 == count || distance < m_start[hint + 1])
+            return hint;
+        if (hint + 2 == count || distance < m_start[hint + 2])
+            return hint + 1;
+    }
+
+    // 最后一个起始弧长不大于 distance 的段（跳过长度为 0 的段）
+    size_t index = std::upper_bound(m_start.begin(), m_start.end(), distance) - m_start.begin();
+    return index > 0 ? index - 1 : 0;
+}
+
+float Trajectory::ParameterAt(size_t segment, float distance) const
+{
+    const float* table = &m_table[segment * (ARC_LENGTH_SAMPLES + 1)];
+    float local = distance - m_start[segment];
+    if (local <= 0.0f)
+        return 0.0f;
+    if (local >= table[ARC_LENGTH_SAMPLES])
+        return 1.0f;
+
+    int low = 0;
+    int high = ARC_LENGTH_SAMPLES;
+    while (high - low > 1)
+    {
+        int middle = (low + high) / 2;
+        if (table[middle] <= local)
+            low = middle;
+        else
+            high = middle;
+    }
+    float fraction = (local - table[low]) / (table[high] - table[low]);
+    return ((float)low + fraction) * (1.0f / ARC_LENGTH_SAMPLES);
+}
+
+void Trajectory::Evaluate(float distance, float* x, float* y) const
+{
+    if (m_start.empty())
+    {
+        *x = *y = 0.0f;
+        return;
+    }
+
+    size_t segment = FindSegment(distance, 0);
+    float t = ParameterAt(segment, distance);
+    *x = ((m_ax[segment] * t + m_bx[segment]) * t + m_cx[segment]) * t + m_dx[segment];
+    *y = ((m_ay[segment] * t + m_by[segment]) * t + m_cy[segment]) * t + m_dy[segment];
+}
+
+// 对一块已经取出系数的点做 Horner 求值
+static void EvaluateCubics(const float* t, const float* a, const float* b, const float* c, const float* d, size_t count, float* out)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 vt = _mm256_loadu_ps(t + i);
+        __m256 v = _mm256_loadu_ps(a + i);
+        v = _mm256_add_ps(_mm256_mul_ps(v, vt), _mm256_loadu_ps(b + i));
+        v = _mm256_add_ps(_mm256_mul_ps(v, vt), _mm256_loadu_ps(c + i));
+        v = _mm256_add_ps(_mm256_mul_ps(v, vt), _mm256_loadu_ps(d + i));
+        _mm256_storeu_ps(out + i, v);
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 vt = _mm_loadu_ps(t + i);
+        __m128 v = _mm_loadu_ps(a + i);
+        v = _mm_add_ps(_mm_mul_ps(v, vt), _mm_loadu_ps(b + i));
+        v = _mm_add_ps(_mm_mul_ps(v, vt), _mm_loadu_ps(c + i));
+        v = _mm_add_ps(_mm_mul_ps(v, vt), _mm_loadu_ps(d + i));
+        _mm_storeu_ps(out + i, v);
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = ((a[i] * t[i] + b[i]) * t[i] + c[i]) * t[i] + d[i];
+}
+
+void Trajectory::EvaluateBatch(const float* distances, size_t count, float* x, float* y) const
+{
+    if (m_start.empty())
+    {
+        std::fill(x, x + count, 0.0f);
+        std::fill(y, y + count, 0.0f);
+        return;
+    }
+
+    // 先逐点定位段和参数，把系数整理成连续的数组，再成组求值
+    const size_t BLOCK = 64;
+    float t[BLOCK];
+    float ax[BLOCK], bx[BLOCK], cx[BLOCK], dx[BLOCK];
+    float ay[BLOCK], by[BLOCK], cy[BLOCK], dy[BLOCK];
+    size_t segment = 0;
+
+    for (size_t begin = 0; begin < count; begin += BLOCK)
+    {
+        size_t n = std::min(BLOCK, count - begin);
+        for (size_t k = 0; k < n; ++k)
+        {
+            float distance = distances[begin + k];
+            segment = FindSegment(distance, segment);
+            t[k] = ParameterAt(segment, distance);
+            ax[k] = m_ax[segment]; bx[k] = m_bx[segment]; cx[k] = m_cx[segment]; dx[k] = m_dx[segment];
+            ay[k] = m_ay[segment]; by[k] = m_by[segment]; cy[k] = m_cy[segment]; dy[k] = m_dy[segment];
+        }
+        EvaluateCubics(t, ax, bx, cx, dx, n, x + begin);
+        EvaluateCubics(t, ay, by, cy, dy, n, y + begin);
+    }
+}
+
+void Trajectory::SampleUniform(float start, float step, size_t count, float* x, float* y) const
+{
+    const size_t BLOCK = 256;
+    float distances[BLOCK];
+    for (size_t begin = 0; begin < count; begin += BLOCK)
+    {
+        size_t n = std::min(BLOCK, count - begin);
+        for (size_t k = 0; k < n; ++k)
+            distances[k] = start + step * (float)(begin + k);
+        EvaluateBatch(distances, n, x + begin, y + begin);
+    }
+}
+
+// 四舍五入（远离 0）
+static int RoundToPixel(float value)
+{
+    return (int)(value + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+PathPlayer::PathPlayer()
+    : m_chunkStart(0.0),
+      m_startTime(),
+      m_speed(DEFAULT_PATH_SPEED),
+      m_started(false),
+      m_finished(false),
+      m_segmentsLoaded(0)
+{
+}
+
+bool PathPlayer::Open(const char* path)
+{
+    m_started = false;
+    m_finished = false;
+    return m_reader.Open(path);
+}
+
+void PathPlayer::Attach(FILE* file)
+{
+    m_started = false;
+    m_finished = false;
+    m_reader.Attach(file);
+}
+
+void PathPlayer::Start(TimePoint now, float speed)
+{
+    m_chunk.Clear();
+    m_chunkStart = 0.0;
+    m_segmentsLoaded = 0;
+    m_startTime = now;
+    m_started = true;
+    m_finished = false;
+
+    // 读第一块之后文件头里的速度才确定
+    LoadChunk();
+    m_speed = speed > 0.0f ? speed : m_reader.Speed();
+}
+
+// 读取下一块并参数化；没有更多的段时保留当前块（终点仍然可以求值）
+bool PathPlayer::LoadChunk()
+{
+    m_buffer.clear();
+    if (m_reader.Read(&m_buffer, PATH_CHUNK_SEGMENTS) == 0)
+        return false;
+
+    m_chunkStart += m_chunk.Length();
+    m_chunk.Assign(m_buffer.data(), m_buffer.size());
+    m_segmentsLoaded += m_buffer.size();
+    return true;
+}
+
+bool PathPlayer::Sample(TimePoint time, PointI* pos)
+{
+    if (!m_started || m_chunk.SegmentCount() == 0)
+    {
+        m_finished = true;
+        return false;
+    }
+
+    double elapsed = std::max(0.0, std::chrono::duration<double>(time - m_startTime).count());
+    double distance = elapsed * m_speed;
+    while (distance >= m_chunkStart + m_chunk.Length() && LoadChunk())
+    {
+    }
+
+    double local = distance - m_chunkStart;
+    bool end = local >= m_chunk.Length();
+    float x, y;
+    m_chunk.Evaluate((float)std::min(local, (double)m_chunk.Length()), &x, &y);
+    pos->x = RoundToPixel(x);
+    pos->y = RoundToPixel(y);
+
+    if (end)
+        m_finished = true;
+    return !end;
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "geometry.h"
+
+// 三次贝塞尔曲线段：起点、两个控制点、终点
+// 折线和 Catmull-Rom 样条在读取时都换算成这种形式，求值只有一种公式
+struct CubicSegment
+{
+    float x[4];
+    float y[4];
+};
+
+const float DEFAULT_PATH_SPEED = 600.0f;   // 像素/秒
+const size_t PATH_CHUNK_SEGMENTS = 4096;   // 流式读取时每次参数化的段数
+const int ARC_LENGTH_SAMPLES = 32;         // 每段弧长表的分段数
+
+// 路径文件（文本，逐行读取，不整体载入内存）：
+//   # 注释
+//   speed 800        速度（像素/秒），必须在第一个点之前
+//   polyline         之后的点用直线连接
+//   catmull-rom      之后的点用 Catmull-Rom 样条连接，曲线经过每个点
+//   bezier           之后每三个点是一段三次贝塞尔曲线（两个控制点和终点）
+//   120 340          一个点（屏幕坐标）
+// 默认是 polyline。每种曲线都从上一段的终点继续，第一个点是路径的起点。
+class PathReader
+{
+public:
+    PathReader();
+    ~PathReader();
+
+    bool Open(const char* path);
+
+    // 读取已经打开的文件，不负责关闭（基准测试用 tmpfile）
+    void Attach(FILE* file);
+    void Close();
+
+    // 读取大约 maxSegments 段追加到 out（换曲线类型时可能多出一两段），返回读到的段数；到达末尾或出错后返回 0
+    size_t Read(std::vector<CubicSegment>* out, size_t maxSegments);
+
+    bool AtEnd() const { return m_done; }
+    bool Failed() const { return m_errorLine != 0; }
+    int ErrorLine() const { return m_errorLine; }     // 格式错误所在的行，0 表示没有错误
+
+    // 第一个点之前的 speed 行，没有时为默认速度；Read 至少调用一次后才确定
+    float Speed() const { return m_speed; }
+
+    uint64_t PointsRead() const { return m_pointsRead; }
+
+private:
+    enum Mode
+    {
+        MODE_POLYLINE,
+        MODE_CATMULL_ROM,
+        MODE_BEZIER
+    };
+
+    PathReader(const PathReader&);
+    PathReader& operator=(const PathReader&);
+
+    void AddPoint(float x, float y, std::vector<CubicSegment>* out);
+    void FlushMode(std::vector<CubicSegment>* out);
+    void EmitLine(float x0, float y0, float x1, float y1, std::vector<CubicSegment>* out);
+
+    FILE* m_file;
+    bool m_ownsFile;
+    bool m_done;
+    int m_line;
+    int m_errorLine;
+    float m_speed;
+    uint64_t m_pointsRead;
+
+    Mode m_mode;
+    bool m_hasStart;
+    float m_lastX;           // 已经输出的路径的终点
+    float m_lastY;
+    float m_pending[3][2];   // 当前模式下还没能输出的点
+    int m_pendingCount;
+    float m_beforeX;         // Catmull-Rom：已输出部分的倒数第二个点（切线用）
+    float m_beforeY;
+};
+
+// 按弧长参数化的一组曲线段
+// 每段按参数均匀取 ARC_LENGTH_SAMPLES + 1 个点，累计弦长作为弧长表，求值时反查参数。
+// 数据按结构数组保存：曲线系数（幂基）、每段的起始弧长和弧长表。
+class Trajectory
+{
+public:
+    Trajectory();
+
+    // 参数化 segments，弧长从 0 开始
+    void Assign(const CubicSegment* segments, size_t count);
+    void Clear();
+
+    size_t SegmentCount() const { return m_start.size(); }
+    float Length() const { return m_length; }
+
+    // 弧长 distance 处的位置，超出范围时取端点
+    void Evaluate(float distance, float* x, float* y) const;
+
+    // 一批弧长处的位置；按弧长递增排列时逐段前进，不需要查找
+    void EvaluateBatch(const float* distances, size_t count, float* x, float* y) const;
+
+    // 从 start 开始，每隔 step 取一个点，共 count 个（匀速播放的连续帧）
+    void SampleUniform(float start, float step, size_t count, float* x, float* y) const;
+
+private:
+    size_t FindSegment(float distance, size_t hint) const;
+    float ParameterAt(size_t segment, float distance) const;
+
+    // x(t) = ((ax t + bx) t + cx) t + dx，y 同理
+    std::vector<float> m_ax, m_bx, m_cx, m_dx;
+    std::vector<float> m_ay, m_by, m_cy, m_dy;
+    std::vector<float> m_start;    // 每段的起始弧长
+    std::vector<float> m_table;    // 每段 ARC_LENGTH_SAMPLES + 1 个累计弧长（段内）
+    float m_length;
+};
+
+// 匀速播放路径文件：边播放边读取，内存中只保留当前的一块段
+class PathPlayer
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+
+    PathPlayer();
+
+    bool Open(const char* path);
+    void Attach(FILE* file);
+
+    // 从 now 开始计时；speed 为 0 时使用文件里的速度
+    void Start(TimePoint now, float speed = 0.0f);
+
+    // time 时刻的位置（取整到像素）；路径走完后返回 false，*pos 是终点
+    bool Sample(TimePoint time, PointI* pos);
+
+    bool IsFinished() const { return m_finished; }
+    bool Failed() const { return m_reader.Failed(); }
+    int ErrorLine() const { return m_reader.ErrorLine(); }
+    float Speed() const { return m_speed; }
+    uint64_t SegmentsLoaded() const { return m_segmentsLoaded; }
+
+private:
+    bool LoadChunk();
+
+    PathReader m_reader;
+    Trajectory m_chunk;
+    std::vector<CubicSegment> m_buffer;
+    double m_chunkStart;      // 当前块在整条路径上的起始弧长
+    TimePoint m_startTime;
+    float m_speed;
+    bool m_started;
+    bool m_finished;
+    uint64_t m_segmentsLoaded;
+};
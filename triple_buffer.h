@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// 单生产者/单消费者的无锁三缓冲，只保留最新的一份
+// 生产者独占 back，消费者独占 front，middle 是交换位：发布时 back 与 middle 互换并置“新”标记，
+// 读取时有新标记才把 front 与 middle 互换。生产者不会等待消费者，来不及读的旧内容被新内容覆盖。
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_middle(1),
+          m_back(0),
+          m_front(2)
+    {
+    }
+
+    // 生产者：正在写的一份
+    T& Back() { return m_slots[m_back]; }
+
+    // 生产者：发布 Back()，之后 Back() 换成另一份（内容是两次发布之前的某一份）
+    // 返回被替换的一份是否还没被读取（被丢弃）
+    bool Publish()
+    {
+        uint32_t previous = m_middle.exchange(m_back | FRESH, std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+        return (previous & FRESH) != 0;
+    }
+
+    // 生产者：上一次发布的内容还没被读取
+    // 返回 false 时一定已经读取；返回 true 时消费者可能正在读取
+    bool HasUnread() const { return (m_middle.load(std::memory_order_acquire) & FRESH) != 0; }
+
+    // 消费者：有新发布的内容时换过来，返回是否换了
+    bool Acquire()
+    {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+        uint32_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    // 消费者：最近一次 Acquire 得到的内容
+    const T& Front() const { return m_slots[m_front]; }
+
+private:
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator=(const TripleBuffer&);
+
+    static const uint32_t INDEX_MASK = 3;
+    static const uint32_t FRESH = 4;
+
+    T m_slots[3];
+
+    // 三个索引各占一条缓存行，两个线程只在 m_middle 上交汇
+    alignas(64) std::atomic<uint32_t> m_middle;
+    alignas(64) uint32_t m_back;
+    alignas(64) uint32_t m_front;
+};
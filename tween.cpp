@@ -0,0 +1,268 @@
+#include "tween.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 弹簧参数：阻尼比和固有频率（以整个补间时长为单位时间），t = 1 时余振小于 0.1%
+static const double SPRING_DAMPING = 0.65;
+static const double SPRING_FREQUENCY = 12.0;
+
+static double EvaluateCurve(Easing easing, double t)
+{
+    switch (easing)
+    {
+    case EASING_CUBIC:
+        return 1.0 - (1.0 - t) * (1.0 - t) * (1.0 - t);
+
+    case EASING_SPRING:
+    {
+        // 从 0 出发、静止释放的欠阻尼弹簧的阶跃响应
+        double decay = SPRING_DAMPING * SPRING_FREQUENCY;
+        double damped = SPRING_FREQUENCY * std::sqrt(1.0 - SPRING_DAMPING * SPRING_DAMPING);
+        return 1.0 - std::exp(-decay * t) * (std::cos(damped * t) + decay / damped * std::sin(damped * t));
+    }
+
+    default:
+        return t;
+    }
+}
+
+// 所有曲线的查找表，首次使用前在静态初始化时建好
+struct EasingTables
+{
+    float values[EASING_COUNT][EASING_LUT_SIZE + 1];
+
+    EasingTables()
+    {
+        for (int easing = 0; easing < EASING_COUNT; ++easing)
+        {
+            for (int i = 0; i <= EASING_LUT_SIZE; ++i)
+                values[easing][i] = (float)EvaluateCurve((Easing)easing, (double)i / EASING_LUT_SIZE);
+
+            // 两端精确落在起点和终点上
+            values[easing][0] = 0.0f;
+            values[easing][EASING_LUT_SIZE] = 1.0f;
+        }
+    }
+};
+
+static const EasingTables g_easingTables;
+
+float Ease(Easing easing, float t)
+{
+    const float* table = g_easingTables.values[easing < EASING_COUNT ? easing : EASING_LINEAR];
+    float position = std::min(std::max(t, 0.0f), 1.0f) * EASING_LUT_SIZE;
+    int index = std::min((int)position, EASING_LUT_SIZE - 1);
+    float fraction = position - (float)index;
+    return table[index] + (table[index + 1] - table[index]) * fraction;
+}
+
+static int64_t ToNanoseconds(TweenEngine::Clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// 四舍五入（远离 0），与 lround 一致但不调用库函数
+static int32_t RoundToPixel(float value)
+{
+    return (int32_t)(value + (value < 0.0f ? -0.5f : 0.5f));
+}
+
+TweenEngine::TweenEngine()
+    : m_nextId(1),
+      m_lastFrameNs(0),
+      m_sampled(false),
+      m_active(0),
+      m_framesSampled(0)
+{
+}
+
+TweenId TweenEngine::Start(const PointI& from, const PointI& to, Clock::duration duration, Easing easing, Clock::time_point now)
+{
+    TweenId id = m_nextId++;
+    if (m_nextId == 0)
+        m_nextId = 1;
+
+    size_t index = m_ids.size();
+    m_ids.push_back(id);
+    m_fromX.push_back(0.0f);
+    m_fromY.push_back(0.0f);
+    m_deltaX.push_back(0.0f);
+    m_deltaY.push_back(0.0f);
+    m_startNs.push_back(0);
+    m_invDurationNs.push_back(0.0f);
+    m_easing.push_back((uint8_t)(easing < EASING_COUNT ? easing : EASING_LINEAR));
+    m_finished.push_back(0);
+    m_x.push_back(from.x);
+    m_y.push_back(from.y);
+    m_index[id] = index;
+
+    Assign(index, (float)from.x, (float)from.y, to, duration, now);
+    return id;
+}
+
+bool TweenEngine::Retarget(TweenId id, const PointI& to, Clock::duration duration, Clock::time_point now)
+{
+    size_t index = IndexOf(id);
+    if (index == m_ids.size())
+        return false;
+
+    // 从当前时刻的精确位置（不取整）继续，避免在帧之间跳一下
+    float t = Ease((Easing)m_easing[index], Progress(index, ToNanoseconds(now)));
+    float x = m_fromX[index] + m_deltaX[index] * t;
+    float y = m_fromY[index] + m_deltaY[index] * t;
+    Assign(index, x, y, to, duration, now);
+    return true;
+}
+
+void TweenEngine::Assign(size_t index, float fromX, float fromY, const PointI& to, Clock::duration duration, Clock::time_point now)
+{
+    int64_t durationNs = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+
+    m_fromX[index] = fromX;
+    m_fromY[index] = fromY;
+    m_deltaX[index] = (float)to.x - fromX;
+    m_deltaY[index] = (float)to.y - fromY;
+    m_startNs[index] = ToNanoseconds(now);
+    m_invDurationNs[index] = durationNs > 0 ? (float)(1.0 / (double)durationNs) : 0.0f;
+    m_finished[index] = 0;
+
+    // 新的补间要在下一帧参与采样，即使帧时间与上一次相同
+    m_sampled = false;
+}
+
+void TweenEngine::Cancel(TweenId id)
+{
+    size_t index = IndexOf(id);
+    if (index == m_ids.size())
+        return;
+
+    if (!m_finished[index] && m_active > 0)
+        --m_active;
+
+    // 与最后一个交换后删除
+    size_t last = m_ids.size() - 1;
+    if (index != last)
+    {
+        m_ids[index] = m_ids[last];
+        m_fromX[index] = m_fromX[last];
+        m_fromY[index] = m_fromY[last];
+        m_deltaX[index] = m_deltaX[last];
+        m_deltaY[index] = m_deltaY[last];
+        m_startNs[index] = m_startNs[last];
+        m_invDurationNs[index] = m_invDurationNs[last];
+        m_easing[index] = m_easing[last];
+        m_finished[index] = m_finished[last];
+        m_x[index] = m_x[last];
+        m_y[index] = m_y[last];
+        m_index[m_ids[index]] = index;
+    }
+
+    m_ids.pop_back();
+    m_fromX.pop_back();
+    m_fromY.pop_back();
+    m_deltaX.pop_back();
+    m_deltaY.pop_back();
+    m_startNs.pop_back();
+    m_invDurationNs.pop_back();
+    m_easing.pop_back();
+    m_finished.pop_back();
+    m_x.pop_back();
+    m_y.pop_back();
+    m_index.erase(id);
+}
+
+void TweenEngine::Clear()
+{
+    m_ids.clear();
+    m_fromX.clear();
+    m_fromY.clear();
+    m_deltaX.clear();
+    m_deltaY.clear();
+    m_startNs.clear();
+    m_invDurationNs.clear();
+    m_easing.clear();
+    m_finished.clear();
+    m_x.clear();
+    m_y.clear();
+    m_index.clear();
+    m_active = 0;
+    m_sampled = false;
+}
+
+float TweenEngine::Progress(size_t index, int64_t timeNs) const
+{
+    if (m_invDurationNs[index] == 0.0f)
+        return 1.0f;
+
+    float t = (float)(timeNs - m_startNs[index]) * m_invDurationNs[index];
+    return std::min(std::max(t, 0.0f), 1.0f);
+}
+
+size_t TweenEngine::Sample(Clock::time_point frameTime)
+{
+    int64_t frameNs = ToNanoseconds(frameTime);
+    if (m_sampled && frameNs == m_lastFrameNs)
+        return m_active;
+
+    size_t active = 0;
+    size_t count = m_ids.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (m_finished[i])
+            continue;
+
+        float t = Progress(i, frameNs);
+        float eased = Ease((Easing)m_easing[i], t);
+        m_x[i] = RoundToPixel(m_fromX[i] + m_deltaX[i] * eased);
+        m_y[i] = RoundToPixel(m_fromY[i] + m_deltaY[i] * eased);
+
+        if (t >= 1.0f)
+            m_finished[i] = 1;
+        else
+            ++active;
+    }
+
+    m_lastFrameNs = frameNs;
+    m_sampled = true;
+    m_active = active;
+    ++m_framesSampled;
+    return active;
+}
+
+PointI TweenEngine::Evaluate(TweenId id, Clock::time_point time) const
+{
+    size_t index = IndexOf(id);
+    if (index == m_ids.size())
+        return PointI{0, 0};
+
+    float eased = Ease((Easing)m_easing[index], Progress(index, ToNanoseconds(time)));
+    return PointI{RoundToPixel(m_fromX[index] + m_deltaX[index] * eased),
+                  RoundToPixel(m_fromY[index] + m_deltaY[index] * eased)};
+}
+
+size_t TweenEngine::IndexOf(TweenId id) const
+{
+    auto found = m_index.find(id);
+    return found != m_index.end() ? found->second : m_ids.size();
+}
+
+PointI TweenEngine::Position(TweenId id) const
+{
+    size_t index = IndexOf(id);
+    return index != m_ids.size() ? PointI{m_x[index], m_y[index]} : PointI{0, 0};
+}
+
+bool TweenEngine::IsFinished(TweenId id) const
+{
+    size_t index = IndexOf(id);
+    return index == m_ids.size() || m_finished[index] != 0;
+}
+
+PointI TweenEngine::Target(TweenId id) const
+{
+    size_t index = IndexOf(id);
+    if (index == m_ids.size())
+        return PointI{0, 0};
+    return PointI{RoundToPixel(m_fromX[index] + m_deltaX[index]), RoundToPixel(m_fromY[index] + m_deltaY[index])};
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "geometry.h"
+
+// 缓动曲线，取值在启动时预先算成查找表
+enum Easing
+{
+    EASING_LINEAR,
+    EASING_CUBIC,    // 三次缓出：开始快，结束慢
+    EASING_SPRING,   // 欠阻尼弹簧：略微越过目标再回弹
+    EASING_COUNT
+};
+
+const int EASING_LUT_SIZE = 256;  // 每条曲线的分段数，表中有 EASING_LUT_SIZE + 1 个采样
+
+// 查表并线性插值，t 取 [0, 1]，两端分别精确为 0 和 1
+float Ease(Easing easing, float t);
+
+typedef uint32_t TweenId;   // 0 表示无效
+
+// 以时间为参数的位置补间
+// 每个补间记录起点、位移、开始时间和时长；Sample 在每个呈现的帧调用一次，
+// 同一帧时间重复调用不会重新计算。数据按结构数组保存，几千个补间一起采样。
+class TweenEngine
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    TweenEngine();
+
+    // 从 from 到 to，在 now 开始
+    TweenId Start(const PointI& from, const PointI& to, Clock::duration duration, Easing easing, Clock::time_point now);
+
+    // 改变进行中的补间的目标：从它在 now 时刻的位置出发，重新计时，不会跳变
+    // 补间已经不存在时返回 false
+    bool Retarget(TweenId id, const PointI& to, Clock::duration duration, Clock::time_point now);
+
+    void Cancel(TweenId id);
+    void Clear();
+
+    // 按帧时间计算所有补间的位置，返回仍未结束的数量
+    size_t Sample(Clock::time_point frameTime);
+
+    // 补间在任意时刻的位置（不改变采样结果）
+    PointI Evaluate(TweenId id, Clock::time_point time) const;
+
+    bool Contains(TweenId id) const { return m_index.count(id) != 0; }
+
+    // 上一次采样的位置；已结束的补间停在目标上，直到被取消
+    PointI Position(TweenId id) const;
+    bool IsFinished(TweenId id) const;
+    PointI Target(TweenId id) const;
+
+    size_t Size() const { return m_ids.size(); }
+    uint64_t FramesSampled() const { return m_framesSampled; }
+
+private:
+    size_t IndexOf(TweenId id) const;
+    void Assign(size_t index, float fromX, float fromY, const PointI& to, Clock::duration duration, Clock::time_point now);
+    float Progress(size_t index, int64_t timeNs) const;
+
+    std::vector<TweenId> m_ids;
+    std::vector<float> m_fromX;
+    std::vector<float> m_fromY;
+    std::vector<float> m_deltaX;
+    std::vector<float> m_deltaY;
+    std::vector<int64_t> m_startNs;
+    std::vector<float> m_invDurationNs;   // 1 / 时长（纳秒），时长为 0 时为 0，立即结束
+    std::vector<uint8_t> m_easing;
+    std::vector<uint8_t> m_finished;
+    std::vector<int32_t> m_x;             // 上一次采样的位置
+    std::vector<int32_t> m_y;
+
+    std::unordered_map<TweenId, size_t> m_index;
+    TweenId m_nextId;
+    int64_t m_lastFrameNs;
+    bool m_sampled;
+    size_t m_active;
+    uint64_t m_framesSampled;
+};
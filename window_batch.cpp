@@ -0,0 +1,431 @@
+#include "window_batch.h"
+
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MW_HAVE_SSE2 1
+#endif
+
+#if defined(MW_HAVE_SSE2)
+// SSE2 没有 32 位的 min/max 和 blend，用比较结果拼出来
+static inline __m128i Select128(__m128i mask, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+static inline __m128i Max128(__m128i a, __m128i b)
+{
+    return Select128(_mm_cmpgt_epi32(a, b), a, b);
+}
+
+static inline __m128i Min128(__m128i a, __m128i b)
+{
+    return Select128(_mm_cmpgt_epi32(a, b), b, a);
+}
+#endif
+
+// 与 WindowController::MoveWindowBy 相同的夹紧规则
+static inline int32_t ClampAxis(int32_t value, int32_t size, int32_t low, int32_t high)
+{
+    return std::min(std::max(value, low + WINDOW_VISIBLE_MARGIN - size), high - WINDOW_VISIBLE_MARGIN);
+}
+
+WindowBatch::WindowBatch(const RectI& desktop)
+    : m_desktop(desktop),
+      m_snapping(false),
+      m_snap(SnapOptions{0, false, WINDOW_VISIBLE_MARGIN})
+{
+}
+
+size_t WindowBatch::Add(int x, int y, int width, int height, int64_t nowUs)
+{
+    m_x.push_back(x);
+    m_y.push_back(y);
+    m_width.push_back(width);
+    m_height.push_back(height);
+    m_flags.push_back(0);
+    m_lastMoveUs.push_back(nowUs);
+    if (m_snapping)
+        m_grid.Insert((uint32_t)(m_x.size() - 1), MakeRect(x, y, width, height));
+    return m_x.size() - 1;
+}
+
+void WindowBatch::Clear()
+{
+    m_x.clear();
+    m_y.clear();
+    m_width.clear();
+    m_height.clear();
+    m_flags.clear();
+    m_lastMoveUs.clear();
+    m_grid.Clear();
+}
+
+void WindowBatch::Reserve(size_t count)
+{
+    m_x.reserve(count);
+    m_y.reserve(count);
+    m_width.reserve(count);
+    m_height.reserve(count);
+    m_flags.reserve(count);
+    m_lastMoveUs.reserve(count);
+    if (m_snapping)
+        m_grid.Reserve(count);
+}
+
+void WindowBatch::EnableSnapping(const SnapOptions& options)
+{
+    m_snap = options;
+    m_snapping = true;
+    m_grid.Clear();
+    m_grid.Reserve(Size());
+    for (size_t i = 0; i < Size(); ++i)
+        m_grid.Insert((uint32_t)i, MakeRect(m_x[i], m_y[i], m_width[i], m_height[i]));
+}
+
+void WindowBatch::DisableSnapping()
+{
+    m_snapping = false;
+    m_grid.Clear();
+}
+
+// 位置被批处理直接改写之后同步到网格
+void WindowBatch::SyncGrid(size_t index)
+{
+    if (m_snapping)
+        m_grid.Update((uint32_t)index, MakeRect(m_x[index], m_y[index], m_width[index], m_height[index]));
+}
+
+// 按下标顺序逐个移动，后面的窗口看到的是前面的窗口移动之后的位置
+void WindowBatch::MoveSnapped(const int32_t* dx, const int32_t* dy)
+{
+    size_t count = Size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (dx[i] == 0 && dy[i] == 0)
+            continue;
+
+        PointI pos = m_grid.Move((uint32_t)i, PointI{m_x[i] + dx[i], m_y[i] + dy[i]}, m_desktop, m_snap);
+        if (pos.x == m_x[i] && pos.y == m_y[i])
+            continue;
+        m_x[i] = pos.x;
+        m_y[i] = pos.y;
+        m_flags[i] |= WINDOW_FLAG_MOVED;
+    }
+}
+
+void WindowBatch::MoveBy(const int32_t* dx, const int32_t* dy)
+{
+    if (m_snapping)
+    {
+        MoveSnapped(dx, dy);
+        return;
+    }
+
+    size_t count = Size();
+    size_t i = 0;
+    int32_t* x = m_x.data();
+    int32_t* y = m_y.data();
+    const int32_t* w = m_width.data();
+    const int32_t* h = m_height.data();
+    uint32_t* flags = m_flags.data();
+
+#if defined(__AVX2__)
+    {
+        __m256i marginX = _mm256_set1_epi32(m_desktop.left + WINDOW_VISIBLE_MARGIN);
+        __m256i marginY = _mm256_set1_epi32(m_desktop.top + WINDOW_VISIBLE_MARGIN);
+        __m256i maxX = _mm256_set1_epi32(m_desktop.right - WINDOW_VISIBLE_MARGIN);
+        __m256i maxY = _mm256_set1_epi32(m_desktop.bottom - WINDOW_VISIBLE_MARGIN);
+        __m256i movedFlag = _mm256_set1_epi32((int)WINDOW_FLAG_MOVED);
+        __m256i zero = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i ddx = _mm256_loadu_si256((const __m256i*)(dx + i));
+            __m256i ddy = _mm256_loadu_si256((const __m256i*)(dy + i));
+            __m256i moved = _mm256_xor_si256(_mm256_cmpeq_epi32(_mm256_or_si256(ddx, ddy), zero), _mm256_set1_epi32(-1));
+
+            __m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+            __m256i vy = _mm256_loadu_si256((const __m256i*)(y + i));
+            __m256i nx = _mm256_add_epi32(vx, ddx);
+            __m256i ny = _mm256_add_epi32(vy, ddy);
+            nx = _mm256_min_epi32(_mm256_max_epi32(nx, _mm256_sub_epi32(marginX, _mm256_loadu_si256((const __m256i*)(w + i)))), maxX);
+            ny = _mm256_min_epi32(_mm256_max_epi32(ny, _mm256_sub_epi32(marginY, _mm256_loadu_si256((const __m256i*)(h + i)))), maxY);
+
+            // 没有位移的窗口不夹紧；夹紧后位置不变的窗口不标记为移动过
+            nx = _mm256_blendv_epi8(vx, nx, moved);
+            ny = _mm256_blendv_epi8(vy, ny, moved);
+            __m256i same = _mm256_and_si256(_mm256_cmpeq_epi32(nx, vx), _mm256_cmpeq_epi32(ny, vy));
+            _mm256_storeu_si256((__m256i*)(x + i), nx);
+            _mm256_storeu_si256((__m256i*)(y + i), ny);
+            __m256i f = _mm256_loadu_si256((const __m256i*)(flags + i));
+            _mm256_storeu_si256((__m256i*)(flags + i), _mm256_or_si256(f, _mm256_andnot_si256(same, movedFlag)));
+        }
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    {
+        __m128i marginX = _mm_set1_epi32(m_desktop.left + WINDOW_VISIBLE_MARGIN);
+        __m128i marginY = _mm_set1_epi32(m_desktop.top + WINDOW_VISIBLE_MARGIN);
+        __m128i maxX = _mm_set1_epi32(m_desktop.right - WINDOW_VISIBLE_MARGIN);
+        __m128i maxY = _mm_set1_epi32(m_desktop.bottom - WINDOW_VISIBLE_MARGIN);
+        __m128i movedFlag = _mm_set1_epi32((int)WINDOW_FLAG_MOVED);
+        __m128i zero = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i ddx = _mm_loadu_si128((const __m128i*)(dx + i));
+            __m128i ddy = _mm_loadu_si128((const __m128i*)(dy + i));
+            __m128i moved = _mm_xor_si128(_mm_cmpeq_epi32(_mm_or_si128(ddx, ddy), zero), _mm_set1_epi32(-1));
+
+            __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+            __m128i vy = _mm_loadu_si128((const __m128i*)(y + i));
+            __m128i nx = _mm_add_epi32(vx, ddx);
+            __m128i ny = _mm_add_epi32(vy, ddy);
+            nx = Min128(Max128(nx, _mm_sub_epi32(marginX, _mm_loadu_si128((const __m128i*)(w + i)))), maxX);
+            ny = Min128(Max128(ny, _mm_sub_epi32(marginY, _mm_loadu_si128((const __m128i*)(h + i)))), maxY);
+
+            nx = Select128(moved, nx, vx);
+            ny = Select128(moved, ny, vy);
+            __m128i same = _mm_and_si128(_mm_cmpeq_epi32(nx, vx), _mm_cmpeq_epi32(ny, vy));
+            _mm_storeu_si128((__m128i*)(x + i), nx);
+            _mm_storeu_si128((__m128i*)(y + i), ny);
+            __m128i f = _mm_loadu_si128((const __m128i*)(flags + i));
+            _mm_storeu_si128((__m128i*)(flags + i), _mm_or_si128(f, _mm_andnot_si128(same, movedFlag)));
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if (dx[i] == 0 && dy[i] == 0)
+            continue;
+
+        int32_t nx = ClampAxis(x[i] + dx[i], w[i], m_desktop.left, m_desktop.right);
+        int32_t ny = ClampAxis(y[i] + dy[i], h[i], m_desktop.top, m_desktop.bottom);
+        if (nx == x[i] && ny == y[i])
+            continue;
+        x[i] = nx;
+        y[i] = ny;
+        flags[i] |= WINDOW_FLAG_MOVED;
+    }
+}
+
+void WindowBatch::ClampPositions()
+{
+    size_t count = Size();
+    size_t i = 0;
+    int32_t* x = m_x.data();
+    int32_t* y = m_y.data();
+    const int32_t* w = m_width.data();
+    const int32_t* h = m_height.data();
+
+#if defined(__AVX2__)
+    {
+        __m256i marginX = _mm256_set1_epi32(m_desktop.left + WINDOW_VISIBLE_MARGIN);
+        __m256i marginY = _mm256_set1_epi32(m_desktop.top + WINDOW_VISIBLE_MARGIN);
+        __m256i maxX = _mm256_set1_epi32(m_desktop.right - WINDOW_VISIBLE_MARGIN);
+        __m256i maxY = _mm256_set1_epi32(m_desktop.bottom - WINDOW_VISIBLE_MARGIN);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+            __m256i vy = _mm256_loadu_si256((const __m256i*)(y + i));
+            vx = _mm256_min_epi32(_mm256_max_epi32(vx, _mm256_sub_epi32(marginX, _mm256_loadu_si256((const __m256i*)(w + i)))), maxX);
+            vy = _mm256_min_epi32(_mm256_max_epi32(vy, _mm256_sub_epi32(marginY, _mm256_loadu_si256((const __m256i*)(h + i)))), maxY);
+            _mm256_storeu_si256((__m256i*)(x + i), vx);
+            _mm256_storeu_si256((__m256i*)(y + i), vy);
+        }
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    {
+        __m128i marginX = _mm_set1_epi32(m_desktop.left + WINDOW_VISIBLE_MARGIN);
+        __m128i marginY = _mm_set1_epi32(m_desktop.top + WINDOW_VISIBLE_MARGIN);
+        __m128i maxX = _mm_set1_epi32(m_desktop.right - WINDOW_VISIBLE_MARGIN);
+        __m128i maxY = _mm_set1_epi32(m_desktop.bottom - WINDOW_VISIBLE_MARGIN);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+            __m128i vy = _mm_loadu_si128((const __m128i*)(y + i));
+            vx = Min128(Max128(vx, _mm_sub_epi32(marginX, _mm_loadu_si128((const __m128i*)(w + i)))), maxX);
+            vy = Min128(Max128(vy, _mm_sub_epi32(marginY, _mm_loadu_si128((const __m128i*)(h + i)))), maxY);
+            _mm_storeu_si128((__m128i*)(x + i), vx);
+            _mm_storeu_si128((__m128i*)(y + i), vy);
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        x[i] = ClampAxis(x[i], w[i], m_desktop.left, m_desktop.right);
+        y[i] = ClampAxis(y[i], h[i], m_desktop.top, m_desktop.bottom);
+    }
+
+    // 没有跨过单元边界的窗口只更新矩形
+    if (m_snapping)
+    {
+        for (i = 0; i < count; ++i)
+            SyncGrid(i);
+    }
+}
+
+size_t WindowBatch::CheckBoundaries(int64_t nowUs)
+{
+    size_t count = Size();
+    size_t i = 0;
+    size_t triggered = 0;
+    const int32_t* x = m_x.data();
+    const int32_t* y = m_y.data();
+    const int32_t* w = m_width.data();
+    const int32_t* h = m_height.data();
+    uint32_t* flags = m_flags.data();
+    int64_t* lastMove = m_lastMoveUs.data();
+
+    // 向量部分只算出需要标记的窗口，标记本身按位处理（通常一个都没有）
+#if defined(__AVX2__)
+    {
+        __m256i firstX = _mm256_set1_epi32(m_desktop.left + 1);
+        __m256i firstY = _mm256_set1_epi32(m_desktop.top + 1);
+        __m256i lastX = _mm256_set1_epi32(m_desktop.right - 1);
+        __m256i lastY = _mm256_set1_epi32(m_desktop.bottom - 1);
+        __m256i resetFlag = _mm256_set1_epi32((int)WINDOW_FLAG_RESET_TRIGGERED);
+        __m256i zero = _mm256_setzero_si256();
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i vx = _mm256_loadu_si256((const __m256i*)(x + i));
+            __m256i vy = _mm256_loadu_si256((const __m256i*)(y + i));
+            __m256i right = _mm256_add_epi32(vx, _mm256_loadu_si256((const __m256i*)(w + i)));
+            __m256i bottom = _mm256_add_epi32(vy, _mm256_loadu_si256((const __m256i*)(h + i)));
+            __m256i off = _mm256_or_si256(
+                _mm256_or_si256(_mm256_cmpgt_epi32(firstX, right), _mm256_cmpgt_epi32(vx, lastX)),
+                _mm256_or_si256(_mm256_cmpgt_epi32(firstY, bottom), _mm256_cmpgt_epi32(vy, lastY)));
+            __m256i idle = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_loadu_si256((const __m256i*)(flags + i)), resetFlag), zero);
+
+            int bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_and_si256(off, idle)));
+            for (int lane = 0; bits; ++lane, bits >>= 1)
+            {
+                if (bits & 1)
+                {
+                    flags[i + lane] |= WINDOW_FLAG_RESET_TRIGGERED;
+                    lastMove[i + lane] = nowUs;
+                    ++triggered;
+                }
+            }
+        }
+    }
+#endif
+#if defined(MW_HAVE_SSE2)
+    {
+        __m128i firstX = _mm_set1_epi32(m_desktop.left + 1);
+        __m128i firstY = _mm_set1_epi32(m_desktop.top + 1);
+        __m128i lastX = _mm_set1_epi32(m_desktop.right - 1);
+        __m128i lastY = _mm_set1_epi32(m_desktop.bottom - 1);
+        __m128i resetFlag = _mm_set1_epi32((int)WINDOW_FLAG_RESET_TRIGGERED);
+        __m128i zero = _mm_setzero_si128();
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i vx = _mm_loadu_si128((const __m128i*)(x + i));
+            __m128i vy = _mm_loadu_si128((const __m128i*)(y + i));
+            __m128i right = _mm_add_epi32(vx, _mm_loadu_si128((const __m128i*)(w + i)));
+            __m128i bottom = _mm_add_epi32(vy, _mm_loadu_si128((const __m128i*)(h + i)));
+            __m128i off = _mm_or_si128(
+                _mm_or_si128(_mm_cmpgt_epi32(firstX, right), _mm_cmpgt_epi32(vx, lastX)),
+                _mm_or_si128(_mm_cmpgt_epi32(firstY, bottom), _mm_cmpgt_epi32(vy, lastY)));
+            __m128i idle = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(flags + i)), resetFlag), zero);
+
+            int bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(off, idle)));
+            for (int lane = 0; bits; ++lane, bits >>= 1)
+            {
+                if (bits & 1)
+                {
+                    flags[i + lane] |= WINDOW_FLAG_RESET_TRIGGERED;
+                    lastMove[i + lane] = nowUs;
+                    ++triggered;
+                }
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        bool off = x[i] + w[i] <= m_desktop.left || x[i] >= m_desktop.right ||
+                   y[i] + h[i] <= m_desktop.top || y[i] >= m_desktop.bottom;
+        if (off && (flags[i] & WINDOW_FLAG_RESET_TRIGGERED) == 0)
+        {
+            flags[i] |= WINDOW_FLAG_RESET_TRIGGERED;
+            lastMove[i] = nowUs;
+            ++triggered;
+        }
+    }
+    return triggered;
+}
+
+size_t WindowBatch::ResetDue(int64_t nowUs, int64_t delayUs)
+{
+    size_t count = Size();
+    size_t i = 0;
+    size_t reset = 0;
+    int32_t* x = m_x.data();
+    int32_t* y = m_y.data();
+    const int32_t* w = m_width.data();
+    const int32_t* h = m_height.data();
+    uint32_t* flags = m_flags.data();
+    const int64_t* lastMove = m_lastMoveUs.data();
+
+    // 截止时间之前最后一次移动的窗口才到期
+    int64_t threshold = nowUs - delayUs;
+
+    // 64 位比较需要 AVX2，SSE2 下交给标量循环（编译器会自动向量化）
+#if defined(__AVX2__)
+    {
+        __m256i limit = _mm256_set1_epi64x(threshold);
+        __m128i resetFlag = _mm_set1_epi32((int)WINDOW_FLAG_RESET_TRIGGERED);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i recent = _mm256_cmpgt_epi64(_mm256_loadu_si256((const __m256i*)(lastMove + i)), limit);
+            __m128i idle32 = _mm_cmpeq_epi32(_mm_and_si128(_mm_loadu_si128((const __m128i*)(flags + i)), resetFlag), _mm_setzero_si128());
+            __m256i skip = _mm256_or_si256(recent, _mm256_cvtepi32_epi64(idle32));
+
+            int bits = ~_mm256_movemask_pd(_mm256_castsi256_pd(skip)) & 0xF;
+            for (size_t k = i; bits; ++k, bits >>= 1)
+            {
+                if (bits & 1)
+                {
+                    x[k] = m_desktop.left + (RectWidth(m_desktop) - w[k]) / 2;
+                    y[k] = m_desktop.top + (RectHeight(m_desktop) - h[k]) / 2;
+                    flags[k] &= ~(WINDOW_FLAG_RESET_TRIGGERED | WINDOW_FLAG_MOVED);
+                    SyncGrid(k);
+                    ++reset;
+                }
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if ((flags[i] & WINDOW_FLAG_RESET_TRIGGERED) != 0 && lastMove[i] <= threshold)
+        {
+            x[i] = m_desktop.left + (RectWidth(m_desktop) - w[i]) / 2;
+            y[i] = m_desktop.top + (RectHeight(m_desktop) - h[i]) / 2;
+            flags[i] &= ~(WINDOW_FLAG_RESET_TRIGGERED | WINDOW_FLAG_MOVED);
+            SyncGrid(i);
+            ++reset;
+        }
+    }
+    return reset;
+}
+
+void WindowBatch::Tick(const int32_t* dx, const int32_t* dy, int64_t nowUs, int64_t resetDelayUs)
+{
+    MoveBy(dx, dy);
+    CheckBoundaries(nowUs);
+    ResetDue(nowUs, resetDelayUs);
+}
+
+void WindowBatch::SubmitPositions(MoveSink& sink) const
+{
+    MoveSink::Batch batch(sink);
+    size_t count = m_x.size();
+    for (size_t i = 0; i < count; ++i)
+        sink.Request((uint32_t)i, m_x[i], m_y[i]);
+}
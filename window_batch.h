@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "aligned_allocator.h"
+#include "geometry.h"
+#include "move_sink.h"
+#include "snap_grid.h"
+
+// 每个窗口的状态标志
+const uint32_t WINDOW_FLAG_RESET_TRIGGERED = 1u << 0;  // 已移出屏幕，等待自动重置
+const uint32_t WINDOW_FLAG_MOVED = 1u << 1;            // 上次重置后移动过
+
+const int WINDOW_VISIBLE_MARGIN = 20;                   // 夹紧时至少保留在屏幕内的像素
+
+// 多窗口控制器：按结构数组保存 N 个窗口
+// 夹紧、移出屏幕检测和自动重置判断都是对整列数据的批处理（SSE2/AVX2 加速）。
+// 桌面是一个矩形（通常取 DisplayLayout::VirtualBounds()）：夹紧规则和“夹紧后位置不变不算移动”
+// 与 WindowController::MoveWindowBy 相同；但移出检测和重置位置按整个矩形计算，
+// 不像 CheckWindowBoundary / ResetToCenter 那样区分各个显示器，只有一个显示器时两者一致。
+// 时间以微秒计，由调用者提供。
+// 启用吸附后窗口矩形登记在 SnapGrid 里，移动逐个窗口经过吸附和碰撞处理（不再走向量路径）。
+class WindowBatch
+{
+public:
+    template <typename T>
+    using Column = std::vector<T, AlignedAllocator<T>>;
+
+    explicit WindowBatch(const RectI& desktop);
+
+    // 添加一个窗口，返回它的下标
+    size_t Add(int x, int y, int width, int height, int64_t nowUs);
+    void Clear();
+    void Reserve(size_t count);
+
+    void SetDesktop(const RectI& desktop) { m_desktop = desktop; }
+    const RectI& Desktop() const { return m_desktop; }
+    size_t Size() const { return m_x.size(); }
+
+    // 每个窗口移动 (dx[i], dy[i]) 并夹紧，位移为 0 的窗口保持不变
+    // 只有位置真的变了才标记 WINDOW_FLAG_MOVED（顶在边缘时不算）
+    void MoveBy(const int32_t* dx, const int32_t* dy);
+
+    // 吸附到屏幕边缘和相邻窗口，可选防止重叠；启用时按当前位置建立网格
+    void EnableSnapping(const SnapOptions& options);
+    void DisableSnapping();
+    bool IsSnapping() const { return m_snapping; }
+    const SnapGrid& Grid() const { return m_grid; }
+
+    // 把所有窗口夹紧到桌面内（至少保留 WINDOW_VISIBLE_MARGIN 像素）
+    void ClampPositions();
+
+    // 标记完全移出桌面的窗口并重置它们的计时，返回新标记的数量
+    size_t CheckBoundaries(int64_t nowUs);
+
+    // 已标记且超过 delayUs 未移动的窗口回到桌面中央，返回重置的数量
+    size_t ResetDue(int64_t nowUs, int64_t delayUs);
+
+    // 一个节拍：移动、检测、重置
+    void Tick(const int32_t* dx, const int32_t* dy, int64_t nowUs, int64_t resetDelayUs);
+
+    // 把所有窗口的位置交给 sink，窗口编号就是下标
+    // 位置没变的窗口被丢弃，其余的合并成一次原生更新
+    void SubmitPositions(MoveSink& sink) const;
+
+    // 记录移动时间（按键按下时调用）
+    void Touch(size_t index, int64_t nowUs) { m_lastMoveUs[index] = nowUs; }
+
+    PointI Position(size_t index) const { return PointI{m_x[index], m_y[index]}; }
+    SizeI WindowSize(size_t index) const { return SizeI{m_width[index], m_height[index]}; }
+    uint32_t Flags(size_t index) const { return m_flags[index]; }
+    int64_t LastMoveUs(size_t index) const { return m_lastMoveUs[index]; }
+
+private:
+    void MoveSnapped(const int32_t* dx, const int32_t* dy);
+    void SyncGrid(size_t index);
+
+    RectI m_desktop;
+    Column<int32_t> m_x;
+    Column<int32_t> m_y;
+    Column<int32_t> m_width;
+    Column<int32_t> m_height;
+    Column<uint32_t> m_flags;
+    Column<int64_t> m_lastMoveUs;
+
+    bool m_snapping;
+    SnapOptions m_snap;
+    SnapGrid m_grid;
+};
@@ -0,0 +1,698 @@
+#include "window_controller.h"
+
+#include <algorithm>
+
+#include "latency_stats.h"
+
+// 历史记录的时间（毫秒）
+static int64_t HistoryMs(IClock::TimePoint time)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+
+WindowController::WindowController(IWindowHost& host, EventScheduler& scheduler)
+    : m_host(host),
+      m_scheduler(scheduler),
+      m_moves(host),
+      m_undoBefore(UINT64_MAX),
+      m_rewindCursor(0),
+      m_rewindMark(UINT64_MAX),
+      m_feed(nullptr),
+      m_published(),
+      m_windowPos(PointI{0, 0}),
+      m_windowSize(SizeI{0, 0}),
+      m_hasMoved(false),
+      m_lastMoveTime(),
+      m_resetTriggered(false),
+      m_heldKeys(EMPTY_KEY_MASK),
+      m_resetTween(0),
+      m_resetAnimation(RESET_ANIMATION_DURATION),
+      m_resetCount(0),
+      m_keyToMovePending(false),
+      m_keyDownTime(),
+      m_moveTickTimer(0),
+      m_resetTimer(0),
+      m_statusTimer(0),
+      m_animationTimer(0),
+      m_pathTimer(0),
+      m_resetDeadline(),
+      m_statusDeadline()
+{
+}
+
+void WindowController::Initialize(int x, int y, int width, int height)
+{
+    m_windowPos.x = x;
+    m_windowPos.y = y;
+    m_windowSize.cx = width;
+    m_windowSize.cy = height;
+    m_moves.SetKnownPosition(0, x, y);
+
+    // 初始化时间
+    m_lastMoveTime = m_scheduler.Clock().Now();
+    m_motion.Reset(m_lastMoveTime);
+
+    m_history.Clear();
+    m_history.Append(HistoryMs(m_lastMoveTime), m_windowPos);
+    m_undoBefore = UINT64_MAX;
+    PublishState();
+}
+
+void WindowController::SetWindowSize(int width, int height)
+{
+    m_windowSize.cx = width;
+    m_windowSize.cy = height;
+    PublishState();
+}
+
+void WindowController::SetPositionFeed(PositionFeedWriter* feed)
+{
+    m_feed = feed;
+    m_published = PositionSnapshot();
+    PublishState();
+}
+
+// 状态和上次发布的不同时写入共享内存；只是几次存储，不会被读者阻塞
+void WindowController::PublishState()
+{
+    if (!m_feed)
+        return;
+
+    PositionSnapshot snapshot = {};
+    snapshot.x = m_windowPos.x;
+    snapshot.y = m_windowPos.y;
+    snapshot.width = m_windowSize.cx;
+    snapshot.height = m_windowSize.cy;
+    snapshot.flags = (m_resetTriggered ? FEED_RESET_TRIGGERED : 0) | (m_resetTween != 0 ? FEED_ANIMATING : 0) |
+                     (m_hasMoved ? FEED_HAS_MOVED : 0);
+    snapshot.resetCount = m_resetCount;
+    if (snapshot.x == m_published.x && snapshot.y == m_published.y && snapshot.width == m_published.width &&
+        snapshot.height == m_published.height && snapshot.flags == m_published.flags &&
+        snapshot.resetCount == m_published.resetCount)
+        return;
+
+    snapshot.updateNs = LatencyNow();
+    m_feed->Publish(snapshot);
+    m_published = snapshot;
+}
+
+void WindowController::SetKeyBindings(const KeyBindings& bindings)
+{
+    m_bindings = bindings;
+    UpdateMotionDirection();
+    m_host.InvalidatePanel();
+}
+
+void WindowController::OnKeyDown(unsigned key)
+{
+    MoveSink::Batch batch(m_moves);
+    ApplyKeyEdge(KeyEdge{m_scheduler.Clock().Now(), key, true});
+    SyncSchedule();
+}
+
+void WindowController::OnKeyUp(unsigned key)
+{
+    MoveSink::Batch batch(m_moves);
+    ApplyKeyEdge(KeyEdge{m_scheduler.Clock().Now(), key, false});
+    SyncSchedule();
+}
+
+void WindowController::DrainInput()
+{
+    // 一次取出的所有边沿产生的移动合并成一次
+    MoveSink::Batch batch(m_moves);
+    KeyEdge edge;
+    bool any = false;
+    while (m_input.TryPop(edge))
+    {
+        ApplyKeyEdge(edge);
+        any = true;
+    }
+
+    if (any)
+        SyncSchedule();
+}
+
+// 在按键发生的时刻处理边沿，而不是在处理它的时刻
+void WindowController::ApplyKeyEdge(const KeyEdge& edge)
+{
+    // 先按旧的方向积分到边沿发生的时刻
+    IntegrateMotion(edge.time);
+
+    if (edge.down)
+    {
+        if (edge.key < 256)
+        {
+            m_heldKeys.Set(edge.key, true);
+            m_lastMoveTime = std::max(m_lastMoveTime, edge.time);
+
+            // 动画或路径途中按下方向键：停在按下时刻的位置，由用户接管
+            if (m_bindings.ActionOf(edge.key) < DIRECTION_ACTION_COUNT)
+            {
+                if (m_resetTween != 0)
+                    StopAnimation(edge.time);
+                StopPath();
+            }
+
+            // 空格键重置位置
+            if (m_bindings.ActionOf(edge.key) == ACTION_RESET)
+            {
+                ResetToCenter();
+                m_resetTriggered = true;
+            }
+            else if (m_bindings.ActionOf(edge.key) == ACTION_UNDO_RESET)
+            {
+                UndoReset();
+            }
+            else if (m_bindings.ActionOf(edge.key) == ACTION_REWIND)
+            {
+                Rewind();
+            }
+
+            UpdateMotionDirection();
+            m_host.InvalidatePanel();
+
+            // 从这次按下开始计算到窗口第一次移动的延迟
+            if (!m_keyToMovePending && IsMovementKeyHeld())
+            {
+                m_keyToMovePending = true;
+                m_keyDownTime = edge.time;
+            }
+        }
+        return;
+    }
+
+    m_heldKeys.Set(edge.key, false);
+
+    // ESC键不退出，只是取消重置标记
+    if (m_bindings.ActionOf(edge.key) == ACTION_CANCEL_RESET)
+    {
+        m_resetTriggered = false;
+    }
+
+    UpdateMotionDirection();
+    m_host.InvalidatePanel();
+}
+
+void WindowController::ApplyCommands(const WindowCommand* commands, size_t count)
+{
+    if (count == 0)
+        return;
+
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    bool changed = false;
+    {
+        MoveSink::Batch batch(m_moves);
+        for (size_t i = 0; i < count; ++i)
+            changed |= ApplyCommand(commands[i], now);
+
+        if (changed)
+            m_host.InvalidatePanel();
+        SyncSchedule();
+    }
+
+    // 批处理结束时窗口已经移动，从发出到这里是命令的应用延迟
+    uint64_t appliedNs = LatencyNow();
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (commands[i].sentNs != 0 && commands[i].sentNs <= appliedNs)
+            RecordLatency(LATENCY_COMMAND_APPLY, appliedNs - commands[i].sentNs);
+    }
+}
+
+// 外部命令和路径文件的位移不受控制，先限制在远大于任何桌面的范围内，避免相加溢出
+static int ClampCommandDelta(int64_t delta)
+{
+    const int64_t LIMIT = 1 << 24;
+    return (int)std::min(std::max(delta, -LIMIT), LIMIT);
+}
+
+// 应用一条命令，返回面板是否需要刷新
+bool WindowController::ApplyCommand(const WindowCommand& command, IClock::TimePoint now)
+{
+    switch (command.type)
+    {
+    case COMMAND_MOVE_TO:
+    case COMMAND_MOVE_BY:
+    {
+        // 与方向键一样：打断回到中央的动画和路径，并算作一次操作
+        if (m_resetTween != 0)
+            StopAnimation(now);
+        StopPath();
+        m_lastMoveTime = std::max(m_lastMoveTime, now);
+
+        int64_t dx = command.x;
+        int64_t dy = command.y;
+        if (command.type == COMMAND_MOVE_TO)
+        {
+            dx -= m_windowPos.x;
+            dy -= m_windowPos.y;
+        }
+        if (MoveWindowBy(ClampCommandDelta(dx), ClampCommandDelta(dy)))
+            CheckWindowBoundary();
+        return true;
+    }
+
+    case COMMAND_RESET:
+        // ResetToCenter 自己刷新面板
+        ResetToCenter();
+        return false;
+
+    case COMMAND_CANCEL_RESET:
+        m_resetTriggered = false;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void WindowController::RunDueEvents()
+{
+    // 执行到期的事件，再按新的状态重新安排；同时到期的移动节拍和动画帧只移动一次窗口
+    MoveSink::Batch batch(m_moves);
+    m_scheduler.RunDue();
+    SyncSchedule();
+}
+
+// 移动节拍：按键按下或仍在减速时持续，停下后不再唤醒
+void WindowController::MovementTick()
+{
+    m_moveTickTimer = 0;
+    DrainInput();
+    UpdateWindowMovement();
+
+    if (IsMovementKeyHeld() || m_motion.IsMoving())
+        m_moveTickTimer = m_scheduler.ScheduleAfter(MOVE_TICK_INTERVAL, [this] { MovementTick(); });
+    else
+        m_keyToMovePending = false;  // 短按没有产生整像素位移
+}
+
+// 自动重置：在最后一次移动后正好5秒执行
+void WindowController::AutoResetTick()
+{
+    m_resetTimer = 0;
+    if (ShouldResetPosition() && m_resetTriggered)
+    {
+        ResetToCenter(EASING_SPRING);
+        m_resetTriggered = false;
+    }
+}
+
+// 动画帧：每帧采样一次，把窗口放到采样的位置
+void WindowController::AnimationTick()
+{
+    m_animationTimer = 0;
+    if (m_resetTween == 0)
+        return;
+
+    m_tweens.Sample(m_scheduler.Clock().Now());
+    PointI pos = m_tweens.Position(m_resetTween);
+    if (pos.x != m_windowPos.x || pos.y != m_windowPos.y)
+    {
+        m_windowPos = pos;
+        m_moves.Request(0, m_windowPos.x, m_windowPos.y);
+        m_host.InvalidatePanel();
+    }
+
+    if (m_tweens.IsFinished(m_resetTween))
+    {
+        m_tweens.Cancel(m_resetTween);
+        m_resetTween = 0;
+    }
+    else
+    {
+        m_animationTimer = m_scheduler.ScheduleAfter(ANIMATION_FRAME_INTERVAL, [this] { AnimationTick(); });
+    }
+}
+
+// 开始动画；已经在动画中时从当前位置转向新的目标
+void WindowController::AnimateTo(const PointI& target, Easing easing)
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    if (m_resetTween == 0 || !m_tweens.Retarget(m_resetTween, target, m_resetAnimation, now))
+        m_resetTween = m_tweens.Start(m_windowPos, target, m_resetAnimation, easing, now);
+
+    if (m_animationTimer == 0)
+        m_animationTimer = m_scheduler.ScheduleAfter(ANIMATION_FRAME_INTERVAL, [this] { AnimationTick(); });
+}
+
+// 停止动画，窗口停在 at 时刻动画所在的位置
+void WindowController::StopAnimation(IClock::TimePoint at)
+{
+    PointI pos = m_tweens.Evaluate(m_resetTween, at);
+    m_tweens.Cancel(m_resetTween);
+    m_resetTween = 0;
+    m_scheduler.Cancel(m_animationTimer);
+    m_animationTimer = 0;
+
+    if (pos.x != m_windowPos.x || pos.y != m_windowPos.y)
+    {
+        m_windowPos = pos;
+        m_moves.Request(0, m_windowPos.x, m_windowPos.y);
+    }
+}
+
+void WindowController::FollowPath(std::unique_ptr<PathPlayer> path, float speed)
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    if (m_resetTween != 0)
+        StopAnimation(now);
+    StopPath();
+
+    m_path = std::move(path);
+    m_path->Start(now, speed);
+    m_pathTimer = m_scheduler.Schedule(now, [this] { PathTick(); });
+}
+
+void WindowController::StopPath()
+{
+    if (!m_path)
+        return;
+
+    m_path.reset();
+    m_scheduler.Cancel(m_pathTimer);
+    m_pathTimer = 0;
+}
+
+// 路径节拍：按经过的时间取路径上的点，像外部命令一样移过去
+void WindowController::PathTick()
+{
+    m_pathTimer = 0;
+    if (!m_path)
+        return;
+
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    PointI target = m_windowPos;
+    bool more = m_path->Sample(now, &target);
+
+    // 路径上的移动算作操作，走出屏幕时同样标记重置，路径结束后按正常的延迟回到中央
+    m_lastMoveTime = std::max(m_lastMoveTime, now);
+    if (MoveWindowBy(ClampCommandDelta((int64_t)target.x - m_windowPos.x),
+                     ClampCommandDelta((int64_t)target.y - m_windowPos.y)))
+    {
+        CheckWindowBoundary();
+        m_host.InvalidatePanel();
+    }
+
+    if (more)
+        m_pathTimer = m_scheduler.ScheduleAfter(MOVE_TICK_INTERVAL, [this] { PathTick(); });
+    else
+        m_path.reset();
+}
+
+// 状态栏倒计时刷新
+void WindowController::StatusTick()
+{
+    m_statusTimer = 0;
+    m_host.InvalidatePanel();
+}
+
+void WindowController::SyncSchedule()
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+
+    // 移动节拍
+    // 积分器的时间基准已在处理按键边沿时对齐，短按松开后仍要跑完剩余的位移
+    if (m_moveTickTimer == 0 && (IsMovementKeyHeld() || m_motion.IsMoving()))
+    {
+        m_moveTickTimer = m_scheduler.Schedule(now, [this] { MovementTick(); });
+    }
+
+    // 自动重置，截止时间随最后一次移动时间变化
+    if (m_resetTriggered)
+    {
+        IClock::TimePoint deadline = m_lastMoveTime + AUTO_RESET_DELAY;
+        if (m_resetTimer == 0 || deadline != m_resetDeadline)
+        {
+            m_scheduler.Cancel(m_resetTimer);
+            m_resetDeadline = deadline;
+            m_resetTimer = m_scheduler.Schedule(deadline, [this] { AutoResetTick(); });
+        }
+    }
+    else if (m_resetTimer != 0)
+    {
+        m_scheduler.Cancel(m_resetTimer);
+        m_resetTimer = 0;
+    }
+
+    // 状态栏在倒计时期间每整秒刷新（未触发重置时只在第4、5秒变化）
+    long long elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastMoveTime).count();
+    long long nextSecond = std::max<long long>(elapsed + 1, m_resetTriggered ? 1 : 4);
+    if (nextSecond <= 5)
+    {
+        IClock::TimePoint deadline = m_lastMoveTime + std::chrono::seconds(nextSecond);
+        if (m_statusTimer == 0 || deadline != m_statusDeadline)
+        {
+            m_scheduler.Cancel(m_statusTimer);
+            m_statusDeadline = deadline;
+            m_statusTimer = m_scheduler.Schedule(deadline, [this] { StatusTick(); });
+        }
+    }
+
+    // 每批事件结束时：动画帧、重置标记的变化也发布出去
+    PublishState();
+}
+
+bool WindowController::IsMovementKeyHeld() const
+{
+    return m_bindings.AnyDirectionHeld(m_heldKeys);
+}
+
+PanelState WindowController::CapturePanelState() const
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    long long elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastMoveTime).count();
+
+    PanelState state;
+    unsigned directions = m_bindings.DirectionBits(m_heldKeys);
+    state.upPressed = (directions >> ACTION_UP) & 1;
+    state.downPressed = (directions >> ACTION_DOWN) & 1;
+    state.leftPressed = (directions >> ACTION_LEFT) & 1;
+    state.rightPressed = (directions >> ACTION_RIGHT) & 1;
+    state.spacePressed = m_bindings.IsHeld(m_heldKeys, ACTION_RESET);
+    state.escPressed = m_bindings.IsHeld(m_heldKeys, ACTION_CANCEL_RESET);
+    state.resetTriggered = m_resetTriggered;
+    state.idleSeconds = (int)elapsed;
+    state.posX = m_windowPos.x;
+    state.posY = m_windowPos.y;
+    state.showLatency = false;
+    state.latencyText[0] = 0;
+    return state;
+}
+
+// 更新窗口移动
+void WindowController::UpdateWindowMovement()
+{
+    ScopedLatency timing(LATENCY_MOVEMENT);
+
+    // 按实际经过的时间积分，而不是按定时器次数
+    UpdateMotionDirection();
+    IntegrateMotion(m_scheduler.Clock().Now());
+}
+
+// 根据按键状态设置移动方向
+void WindowController::UpdateMotionDirection()
+{
+    // 按下的方向组合查表得到移动方向，相反的方向互相抵消
+    DirectionVector direction = m_bindings.Direction(m_heldKeys);
+    m_motion.SetDirection(direction.dx, direction.dy);
+}
+
+// 把积分器推进到 until，并应用得到的整像素位移
+void WindowController::IntegrateMotion(IClock::TimePoint until)
+{
+    MotionDelta delta = m_motion.Advance(until);
+
+    // 累积出整像素位移、并且夹紧后位置确实变化时才移动窗口
+    if (MoveWindowBy(delta.dx, delta.dy))
+    {
+        // 只在移动之后检查边界
+        CheckWindowBoundary();
+
+        // 更新窗口显示
+        m_host.InvalidatePanel();
+    }
+}
+
+// 移动窗口
+bool WindowController::MoveWindowBy(int dx, int dy)
+{
+    if (dx == 0 && dy == 0) return false;
+
+    // 整个虚拟桌面的范围
+    const RectI& desktop = m_host.Displays().VirtualBounds();
+
+    // 计算新位置
+    PointI pos = {m_windowPos.x + dx, m_windowPos.y + dy};
+
+    // 边界检查，确保窗口不会移出虚拟桌面
+    if (pos.x < desktop.left - m_windowSize.cx + 20)
+        pos.x = desktop.left - m_windowSize.cx + 20;
+    if (pos.y < desktop.top - m_windowSize.cy + 20)
+        pos.y = desktop.top - m_windowSize.cy + 20;
+    if (pos.x > desktop.right - 20)
+        pos.x = desktop.right - 20;
+    if (pos.y > desktop.bottom - 20)
+        pos.y = desktop.bottom - 20;
+
+    // 顶在边缘时夹紧后位置不变，不算移动
+    if (pos.x == m_windowPos.x && pos.y == m_windowPos.y)
+        return false;
+
+    // 移动窗口
+    m_windowPos = pos;
+    m_moves.Request(0, m_windowPos.x, m_windowPos.y);
+
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    m_history.Append(HistoryMs(now), m_windowPos);
+
+    if (m_keyToMovePending)
+    {
+        m_keyToMovePending = false;
+        RecordLatency(LATENCY_KEY_TO_MOVE, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                               now - m_keyDownTime).count());
+    }
+
+    m_hasMoved = true;
+    PublishState();
+    return true;
+}
+
+// 检查窗口边界
+void WindowController::CheckWindowBoundary()
+{
+    // 检查是否移动到所有显示器之外（完全不可见），落在副显示器上不算
+    RectI windowRect = MakeRect(m_windowPos.x, m_windowPos.y, m_windowSize.cx, m_windowSize.cy);
+    bool outOfBounds = m_host.Displays().IsFullyOffScreen(windowRect);
+
+    // 如果移出屏幕，标记需要重置
+    if (outOfBounds && !m_resetTriggered)
+    {
+        m_resetTriggered = true;
+        UpdateLastMoveTime();  // 重置计时器
+        m_host.InvalidatePanel();
+    }
+}
+
+// 重置窗口到屏幕中央
+void WindowController::ResetToCenter(Easing easing)
+{
+    // 回到中央优先于正在播放的路径
+    StopPath();
+
+    // 离窗口中心最近的显示器
+    PointI center = {m_windowPos.x + m_windowSize.cx / 2, m_windowPos.y + m_windowSize.cy / 2};
+    const RectI& monitor = m_host.Displays().NearestMonitor(center);
+
+    // 计算中心位置
+    PointI target = {monitor.left + (RectWidth(monitor) - m_windowSize.cx) / 2,
+                     monitor.top + (RectHeight(monitor) - m_windowSize.cy) / 2};
+
+    // 记下重置前后的位置，之后可以撤销；新的重置之后撤销从它开始
+    int64_t now = HistoryMs(m_scheduler.Clock().Now());
+    m_history.Append(now, m_windowPos);
+    m_history.Append(now, target, HISTORY_RESET);
+    m_undoBefore = UINT64_MAX;
+
+    // 移动窗口：按帧动画过去，没有动画时长时直接跳过去
+    if (m_resetAnimation > std::chrono::steady_clock::duration::zero())
+    {
+        AnimateTo(target, easing);
+    }
+    else
+    {
+        m_windowPos = target;
+        m_moves.Request(0, m_windowPos.x, m_windowPos.y);
+    }
+
+    // 丢弃残留速度和亚像素余量
+    m_motion.Stop();
+
+    m_hasMoved = false;
+    m_resetTriggered = false;
+    ++m_resetCount;
+    PublishState();
+
+    // 重绘窗口
+    m_host.InvalidatePanel();
+}
+
+bool WindowController::UndoReset()
+{
+    HistorySample reset, previous;
+    if (!m_history.FindReset(m_undoBefore, &reset, &previous))
+        return false;
+
+    ReturnTo(previous.pos, m_scheduler.Clock().Now());
+    m_undoBefore = reset.index;
+    return true;
+}
+
+bool WindowController::RewindTo(IClock::TimePoint time)
+{
+    HistorySample sample;
+    if (!m_history.At(HistoryMs(time), &sample) && !m_history.Oldest(&sample))
+        return false;
+
+    ReturnTo(sample.pos, m_scheduler.Clock().Now());
+    return true;
+}
+
+bool WindowController::Rewind(std::chrono::steady_clock::duration step)
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    int64_t from = m_history.AppendedCount() == m_rewindMark ? m_rewindCursor : HistoryMs(now);
+    int64_t target = from - std::chrono::duration_cast<std::chrono::milliseconds>(step).count();
+
+    HistorySample oldest;
+    if (!m_history.Oldest(&oldest))
+        return false;
+    target = std::max(target, oldest.timeMs);
+
+    HistorySample sample;
+    m_history.At(target, &sample);
+    ReturnTo(sample.pos, now);
+    m_rewindCursor = target;
+    m_rewindMark = m_history.AppendedCount();
+    return true;
+}
+
+// 后退和撤销：像重置一样动画过去，但算作一次移动
+void WindowController::ReturnTo(const PointI& target, IClock::TimePoint now)
+{
+    StopPath();
+    m_motion.Stop();
+    m_lastMoveTime = std::max(m_lastMoveTime, now);
+    m_history.Append(HistoryMs(now), target);
+
+    if (m_resetAnimation > std::chrono::steady_clock::duration::zero())
+    {
+        AnimateTo(target, EASING_CUBIC);
+    }
+    else
+    {
+        m_windowPos = target;
+        m_moves.Request(0, m_windowPos.x, m_windowPos.y);
+    }
+
+    // 回到的位置在所有显示器之外时照常标记重置，否则取消之前的标记
+    RectI windowRect = MakeRect(target.x, target.y, m_windowSize.cx, m_windowSize.cy);
+    m_resetTriggered = m_host.Displays().IsFullyOffScreen(windowRect);
+    m_hasMoved = true;
+    m_host.InvalidatePanel();
+}
+
+// 更新最后一次移动的时间
+void WindowController::UpdateLastMoveTime()
+{
+    m_lastMoveTime = m_scheduler.Clock().Now();
+}
+
+// 检查是否应该重置位置（超过5秒未操作且已触发重置）
+bool WindowController::ShouldResetPosition() const
+{
+    IClock::TimePoint now = m_scheduler.Clock().Now();
+    long long elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - m_lastMoveTime).count();
+    return elapsed >= 5;
+}
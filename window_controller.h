@@ -0,0 +1,188 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "command_channel.h"
+#include "control_panel.h"
+#include "display_layout.h"
+#include "geometry.h"
+#include "key_bindings.h"
+#include "motion.h"
+#include "move_sink.h"
+#include "position_feed.h"
+#include "position_history.h"
+#include "scheduler.h"
+#include "spsc_ring.h"
+#include "trajectory.h"
+#include "tween.h"
+
+const auto MOVE_TICK_INTERVAL = std::chrono::milliseconds(16);  // 按键按下时的移动节拍
+const auto AUTO_RESET_DELAY = std::chrono::seconds(5);          // 移出屏幕后自动重置的延迟
+const auto RESET_ANIMATION_DURATION = std::chrono::milliseconds(300);  // 回到中央的动画时长
+const auto ANIMATION_FRAME_INTERVAL = std::chrono::milliseconds(16);   // 动画每帧采样一次
+const auto REWIND_STEP = std::chrono::seconds(5);                      // 每按一次后退键回到多久以前
+
+// 带时间戳的按键边沿，在消息处理时采集
+struct KeyEdge
+{
+    IClock::TimePoint time;  // 按下或松开的时刻
+    unsigned key;
+    bool down;
+};
+
+// 按键采集到模拟节拍之间的无锁队列
+typedef SpscRing<KeyEdge, 256> KeyEdgeRing;
+
+// 控制器所在的宿主（Win32 窗口或无界面回放）
+// 窗口移动经过 MoveSink 去重合并后，通过 INativeMover::MoveWindows 交给宿主
+class IWindowHost : public INativeMover
+{
+public:
+    // 显示器布局（缓存，只在显示设置变化时更新）
+    virtual const DisplayLayout& Displays() const = 0;
+
+    // 面板显示的状态发生了变化
+    virtual void InvalidatePanel() = 0;
+};
+
+// 窗口控制逻辑：按键、移动、边界检查和自动重置
+// 与平台无关，Win32 窗口和无界面回放使用同一份逻辑
+class WindowController
+{
+public:
+    WindowController(IWindowHost& host, EventScheduler& scheduler);
+
+    // 设置初始位置和大小，并以当前时间作为最后一次移动时间
+    void Initialize(int x, int y, int width, int height);
+
+    // 客户区尺寸变化
+    void SetWindowSize(int width, int height);
+
+    // 回到中央的动画时长，0 表示直接跳过去
+    void SetResetAnimation(std::chrono::steady_clock::duration duration) { m_resetAnimation = duration; }
+
+    // 恢复上次退出时的重置标记，自动重置的倒计时从现在开始
+    void SetResetTriggered(bool triggered)
+    {
+        m_resetTriggered = triggered;
+        PublishState();
+    }
+
+    // 把位置、大小和重置状态发布到共享内存（不拥有 feed，nullptr 表示不发布）
+    // 每次 MoveWindowBy、ResetToCenter 之后和每批事件结束时状态有变化就写一次
+    void SetPositionFeed(PositionFeedWriter* feed);
+
+    // 替换按键绑定（启动时从配置文件加载）
+    void SetKeyBindings(const KeyBindings& bindings);
+    const KeyBindings& Bindings() const { return m_bindings; }
+
+    // 按键事件（以当前时间立即处理）
+    void OnKeyDown(unsigned key);
+    void OnKeyUp(unsigned key);
+
+    // 采集端：把按键边沿放入队列，不触碰模拟状态；队列满时返回 false
+    bool PushKeyEdge(const KeyEdge& edge) { return m_input.TryPush(edge); }
+
+    // 模拟端：按时间戳依次处理队列里的按键边沿
+    void DrainInput();
+
+    // 外部命令（IPC）：与按键相同的语义，一批命令里的移动合并成一次原生调用
+    void ApplyCommands(const WindowCommand* commands, size_t count);
+
+    // 沿路径匀速移动（每个移动节拍采样一次），位置经过与 MoveWindowBy 相同的夹紧和边界检查
+    // speed 为 0 时使用路径文件里的速度；方向键、重置和外部移动命令会停止播放
+    void FollowPath(std::unique_ptr<PathPlayer> path, float speed = 0.0f);
+    void StopPath();
+    bool IsFollowingPath() const { return m_path != nullptr; }
+
+    // 执行到期的定时事件
+    void RunDueEvents();
+
+    // 根据当前状态安排或取消定时事件
+    void SyncSchedule();
+
+    void UpdateWindowMovement();
+
+    // 移动并夹紧，返回位置是否真的变化
+    bool MoveWindowBy(int dx, int dy);
+    void CheckWindowBoundary();
+    void ResetToCenter(Easing easing = EASING_CUBIC);
+
+    // 撤销最近一次重置，回到重置之前的位置；连续撤销依次回到更早的重置之前
+    bool UndoReset();
+
+    // 回到 time 时刻所在的位置，早于保留的历史时回到最旧的位置
+    bool RewindTo(IClock::TimePoint time);
+
+    // 后退 step；连续后退（中间没有其他移动）从上一次后退到的时刻继续往前
+    bool Rewind(std::chrono::steady_clock::duration step = REWIND_STEP);
+    void UpdateLastMoveTime();
+    bool ShouldResetPosition() const;
+    bool IsMovementKeyHeld() const;
+
+    // 收集绘制控制面板所需的状态
+    PanelState CapturePanelState() const;
+
+    const PointI& WindowPos() const { return m_windowPos; }
+    const MoveSink& Moves() const { return m_moves; }
+    const PositionHistory& History() const { return m_history; }
+    const SizeI& WindowSize() const { return m_windowSize; }
+    bool HasMoved() const { return m_hasMoved; }
+    bool IsAnimating() const { return m_resetTween != 0; }
+    bool ResetTriggered() const { return m_resetTriggered; }
+    bool IsKeyDown(unsigned key) const { return m_heldKeys.Test(key); }
+    IClock::TimePoint LastMoveTime() const { return m_lastMoveTime; }
+    uint64_t ResetCount() const { return m_resetCount; }
+
+private:
+    void MovementTick();
+    void AutoResetTick();
+    void StatusTick();
+    void AnimationTick();
+    void PathTick();
+    void AnimateTo(const PointI& target, Easing easing);
+    void ReturnTo(const PointI& target, IClock::TimePoint now);
+    void StopAnimation(IClock::TimePoint at);
+    void ApplyKeyEdge(const KeyEdge& edge);
+    bool ApplyCommand(const WindowCommand& command, IClock::TimePoint now);
+    void IntegrateMotion(IClock::TimePoint until);
+    void UpdateMotionDirection();
+    void PublishState();
+
+    IWindowHost& m_host;
+    EventScheduler& m_scheduler;
+    MotionEngine m_motion;            // 运动积分器（固定步长，亚像素精度）
+    KeyEdgeRing m_input;              // 尚未处理的按键边沿
+    MoveSink m_moves;                 // 窗口移动命令，一批事件只提交一次
+    PositionHistory m_history;        // 走过的位置，用于后退和撤销重置
+    uint64_t m_undoBefore;            // 下一次撤销找这个序号之前的重置
+    int64_t m_rewindCursor;           // 上一次后退到的时刻（毫秒）
+    uint64_t m_rewindMark;            // 上一次后退之后历史的样本数，变了说明中间有过移动
+    PositionFeedWriter* m_feed;       // 共享内存中的状态，给外部订阅者
+    PositionSnapshot m_published;     // 最近一次发布的状态（不含时间）
+
+    PointI m_windowPos;               // 当前窗口位置
+    SizeI m_windowSize;               // 窗口大小
+    bool m_hasMoved;                  // 标记是否移动过（只算位置真的变化的移动）
+    IClock::TimePoint m_lastMoveTime; // 最后一次移动的时间
+    bool m_resetTriggered;            // 标记是否触发重置
+    KeyMask m_heldKeys;               // 按下的键，每个虚拟键一位
+    KeyBindings m_bindings;           // 键到动作的绑定
+    TweenEngine m_tweens;             // 位置动画
+    TweenId m_resetTween;             // 正在进行的回到中央的动画
+    std::unique_ptr<PathPlayer> m_path;   // 正在播放的路径
+    std::chrono::steady_clock::duration m_resetAnimation;
+    uint64_t m_resetCount;            // 重置到中心的次数
+    bool m_keyToMovePending;          // 按键按下后还没有移动过
+    IClock::TimePoint m_keyDownTime;  // 对应的按下时刻
+
+    TimerId m_moveTickTimer;          // 移动节拍
+    TimerId m_resetTimer;             // 自动重置
+    TimerId m_statusTimer;            // 状态栏倒计时刷新
+    TimerId m_animationTimer;         // 动画帧
+    TimerId m_pathTimer;              // 路径播放节拍
+    IClock::TimePoint m_resetDeadline;
+    IClock::TimePoint m_statusDeadline;
+};